@@ -14,7 +14,44 @@ Requirements:
 
 Compile the program with:
 
-  gcc ishigamiFunction.c ini.c -lm -o ishigamiFunction 
+  gcc ishigamiFunction.c -I../../../mex/src/Ini ../../../mex/src/Ini/cossan_ini.c \
+      -I../../../mex/src/Extractor ../../../mex/src/Extractor/cossan_result.c \
+      -pthread -lm -o ishigamiFunction
+
+The input file is parsed with the hashed INI parser of openCOSSAN
+(mex/src/Ini/cossan_ini.h).
+
+With the option --binary:
+
+  ishigamiFunction --binary filename
+
+the result is written in double precision in the binary result file
+"result.bin" (response "out", see mex/src/Extractor/cossan_result.h) to be
+read by a BinaryExtractor, instead of the text file "result.out".
+
+The program can also run as a persistent worker of the Connector (property
+SworkerCommand, POSIX only): it then evaluates the samples sent on the
+socket of the Connector (see mex/src/Worker/cossan_worker.h) instead of
+reading an input file. Compile the worker version with:
+
+  gcc -DCOSSAN_WORKER ishigamiFunction.c -I../../../mex/src/Ini \
+      ../../../mex/src/Ini/cossan_ini.c -I../../../mex/src/Extractor \
+      ../../../mex/src/Extractor/cossan_result.c -I../../../mex/src/Worker \
+      ../../../mex/src/Worker/cossan_worker.c -pthread -lm -o ishigamiFunction
+
+Batch mode, used to measure the throughput of the model alone:
+
+  ishigamiFunction --batch inputfile outputfile [nthreads]
+
+evaluates in double precision all the samples of inputfile and writes the
+results in outputfile. Files with extension .csv (or .txt) are text files
+with one sample per row; a header row with the names a, b, x1, x2, x3 (in
+any order, a and b optional with defaults 7 and 0.1) can be present,
+otherwise the columns are a, b, x1, x2, x3. The output has the header "out"
+and one value per row. Any other file is binary: N x 5 doubles stored
+sample by sample in the byte order of the machine, and N doubles on output.
+The samples are split across nthreads threads (default: number of
+processors; -pthread is not needed on Windows).
 
 
 Copyright 1993-2014, COSSAN Working Group, University of Liverpool, UK
@@ -46,66 +83,432 @@ Author: Matteo Broggi
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
-#include "ini.h"
+#include "cossan_ini.h"
+#include "cossan_result.h"
+#ifdef COSSAN_WORKER
+#include "cossan_worker.h"
+#endif
+
+#if !defined(_WIN32)
+#define THREADS
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
 
 typedef struct
 {
-    float a;
-    float b;
-    float x1;
-    float x2;
-    float x3;
+    double a;
+    double b;
+    double x1;
+    double x2;
+    double x3;
 } ishigamidata;
 
-static int handler(void* user, const char* section, const char* name,
-                   const char* value)
-{
-/* This subroutine links to the inih input file parser. It reads the 
-   required input and parse them. */
-
-    ishigamidata* data = (ishigamidata*)user;
-
-    #define MATCH(s, n) strcmp(section, s) == 0 && strcmp(name, n) == 0
-    if (MATCH("parameters", "a")) {
-        data->a = atof(value);
-    } else if (MATCH("parameters", "b")) {
-        data->b = atof(value);
-	} else if (MATCH("inputs", "x1")) {
-        data->x1 = atof(value);
-    } else if (MATCH("inputs", "x2")) {
-        data->x2 = atof(value);
-	} else if (MATCH("inputs", "x3")) {
-        data->x3 = atof(value);
+/* Keys of the input file, in the order of the fields of ishigamidata */
+static const char* keys[] = {"parameters.a", "parameters.b", "inputs.x1",
+                             "inputs.x2", "inputs.x3"};
+
+static int read_input(const char* filename, ishigamidata* data)
+{
+/* Parse the input file. The perfect hash of the keys is computed once and
+   each value is read in place from the mapped file. */
+
+    static cini_schema schema;
+    cini_value values[5];
+    cini_file file;
+    double* fields[5];
+    double x;
+    int k, errline;
+
+    fields[0] = &data->a;
+    fields[1] = &data->b;
+    fields[2] = &data->x1;
+    fields[3] = &data->x2;
+    fields[4] = &data->x3;
+    if (cini_schema_init(&schema, keys, 5) != CINI_SUCCESS)
+        return -1;
+    if (cini_parse_file(&schema, filename, &file, values, &errline) == CINI_FILE_ERROR)
+        return -1;
+    for (k = 0; k < 5; k++) {
+        if (cini_double(file.text, &values[k], &x) != 0) {
+            printf("Missing or wrong value of %s in '%s'\n", keys[k], filename);
+            cini_unmap(&file);
+            return -1;
+        }
+        *fields[k] = x;
+    }
+    cini_unmap(&file);
+    return 0;
+}
+
+#ifdef COSSAN_WORKER
+static int ishigami(const double* x, double* y, void* user)
+{
+/* Model evaluated in worker mode: x = [a b x1 x2 x3], y = out */
+    (void)user;
+    y[0] = sin(x[2]) + x[0]*pow(sin(x[3]),2) + x[1]*pow(x[4],4)*sin(x[2]);
+    return 0;
+}
+#endif
+
+/* Batch mode */
+
+#define NVARS 5
+static const char* varnames[NVARS] = {"a", "b", "x1", "x2", "x3"};
+
+typedef struct
+{
+    long n;
+    double* v[NVARS];  /* columns a, b, x1, x2, x3 */
+    double* out;
+} ishigamibatch;
+
+typedef struct
+{
+    ishigamibatch* batch;
+    long first, last;
+} ishigamichunk;
+
+static double now(void)
+{
+#ifdef THREADS
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9*(double)ts.tv_nsec;
+#else
+    return (double)clock()/CLOCKS_PER_SEC;
+#endif
+}
+
+static void* evaluate_chunk(void* arg)
+{
+/* Ishigami function of the samples first..last-1. The loop has no branches
+   and the powers are written as products, so that it can be vectorized. */
+    ishigamichunk* c = (ishigamichunk*)arg;
+    const double *a = c->batch->v[0], *b = c->batch->v[1];
+    const double *x1 = c->batch->v[2], *x2 = c->batch->v[3], *x3 = c->batch->v[4];
+    double* out = c->batch->out;
+    long i;
+    for (i = c->first; i < c->last; i++) {
+        double s1 = sin(x1[i]), s2 = sin(x2[i]), x32 = x3[i]*x3[i];
+        out[i] = s1 + a[i]*s2*s2 + b[i]*x32*x32*s1;
+    }
+    return NULL;
+}
+
+static void evaluate_batch(ishigamibatch* batch, int nthreads)
+{
+    ishigamichunk* chunks;
+    long chunk;
+    int k;
+#ifdef THREADS
+    pthread_t* threads;
+#endif
+
+    if (nthreads < 1) nthreads = 1;
+    if (nthreads > batch->n) nthreads = batch->n > 0 ? (int)batch->n : 1;
+    chunks = (ishigamichunk*)malloc(nthreads*sizeof(ishigamichunk));
+    if (chunks == NULL) nthreads = 0;
+    chunk = nthreads > 0 ? (batch->n + nthreads - 1)/nthreads : 0;
+    for (k = 0; k < nthreads; k++) {
+        chunks[k].batch = batch;
+        chunks[k].first = k*chunk < batch->n ? k*chunk : batch->n;
+        chunks[k].last = (k+1)*chunk < batch->n ? (k+1)*chunk : batch->n;
+    }
+#ifdef THREADS
+    threads = (pthread_t*)malloc(nthreads*sizeof(pthread_t));
+    if (threads != NULL) {
+        /* the first chunk is evaluated by the calling thread */
+        for (k = 1; k < nthreads; k++)
+            if (pthread_create(&threads[k], NULL, evaluate_chunk, &chunks[k]) != 0)
+                threads[k] = pthread_self();
+        if (nthreads > 0) evaluate_chunk(&chunks[0]);
+        for (k = 1; k < nthreads; k++) {
+            if (pthread_equal(threads[k], pthread_self()))
+                evaluate_chunk(&chunks[k]);
+            else
+                pthread_join(threads[k], NULL);
+        }
+        free(threads);
+        free(chunks);
+        return;
+    }
+#endif
+    if (chunks == NULL) {
+        ishigamichunk c;
+        c.batch = batch;
+        c.first = 0;
+        c.last = batch->n;
+        evaluate_chunk(&c);
+        return;
+    }
+    for (k = 0; k < nthreads; k++) evaluate_chunk(&chunks[k]);
+    free(chunks);
+}
+
+static char* read_file(const char* filename, long* size)
+{
+    FILE* file = fopen(filename, "rb");
+    char* buffer;
+    if (file == NULL) return NULL;
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    buffer = (char*)malloc(*size + 1);
+    if (buffer != NULL && fread(buffer, 1, *size, file) != (size_t)*size) {
+        free(buffer);
+        buffer = NULL;
+    }
+    fclose(file);
+    if (buffer != NULL) buffer[*size] = '\0';
+    return buffer;
+}
+
+static int is_text(const char* filename)
+{
+    const char* ext = strrchr(filename, '.');
+    return ext != NULL && (strcmp(ext, ".csv") == 0 || strcmp(ext, ".txt") == 0 ||
+        strcmp(ext, ".CSV") == 0 || strcmp(ext, ".TXT") == 0);
+}
+
+static int allocate_batch(ishigamibatch* batch, long n)
+{
+    int k;
+    batch->n = n;
+    for (k = 0; k < NVARS; k++)
+        batch->v[k] = (double*)malloc((n > 0 ? n : 1)*sizeof(double));
+    batch->out = (double*)malloc((n > 0 ? n : 1)*sizeof(double));
+    for (k = 0; k < NVARS; k++)
+        if (batch->v[k] == NULL) return -1;
+    return batch->out == NULL ? -1 : 0;
+}
+
+static void free_batch(ishigamibatch* batch)
+{
+    int k;
+    for (k = 0; k < NVARS; k++) free(batch->v[k]);
+    free(batch->out);
+}
+
+/* binary input: n x 5 doubles, sample by sample */
+static int read_binary(const char* filename, ishigamibatch* batch)
+{
+    long size, i;
+    int k;
+    char* buffer = read_file(filename, &size);
+    const double* x = (const double*)buffer;
+    if (buffer == NULL || size % (NVARS*sizeof(double)) != 0) {
+        free(buffer);
+        return -1;
+    }
+    if (allocate_batch(batch, size/(long)(NVARS*sizeof(double)))) {
+        free(buffer);
+        return -1;
+    }
+    for (i = 0; i < batch->n; i++)
+        for (k = 0; k < NVARS; k++)
+            batch->v[k][i] = x[i*NVARS+k];
+    free(buffer);
+    return 0;
+}
+
+static char* next_field(char* p)
+{
+    while (*p != '\0' && *p != ',' && *p != ';' && *p != '\n') p++;
+    return p;
+}
+
+/* text input: one sample per row, optional header with the names */
+static int read_text(const char* filename, ishigamibatch* batch)
+{
+    int column[64], ncolumns = 0, lheader, k;
+    int ldefault[NVARS] = {0, 0, 0, 0, 0}; /* variables not in the file */
+    double defaults[NVARS] = {7.0, 0.1, 0.0, 0.0, 0.0};
+    long size, n = 0, i;
+    char *buffer = read_file(filename, &size), *p, *end;
+
+    if (buffer == NULL) return -1;
+    p = buffer;
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+    lheader = *p != '\0' && strchr("0123456789+-.", *p) == NULL;
+    if (lheader) {
+        /* map the columns on the variables (-1 for the other columns) */
+        int found[NVARS] = {0, 0, 0, 0, 0};
+        for (;;) {
+            char* e = next_field(p);
+            char* s = p;
+            char c = *e;
+            while (*s == ' ' || *s == '\t' || *s == '"') s++;
+            *e = '\0';
+            for (end = e; end > s && strchr(" \t\r\"", end[-1]) != NULL; end--) *(end-1) = '\0';
+            if (ncolumns == 64) { free(buffer); return -1; }
+            column[ncolumns] = -1;
+            for (k = 0; k < NVARS; k++)
+                if (strcmp(s, varnames[k]) == 0) { column[ncolumns] = k; found[k] = 1; }
+            ncolumns++;
+            /* stop at the end of the buffer (header without newline) */
+            p = c != '\0' ? e + 1 : e;
+            if (c != ',' && c != ';') break;
+        }
+        if (!found[2] || !found[3] || !found[4]) {
+            printf("The header of '%s' must contain x1, x2 and x3\n", filename);
+            free(buffer);
+            return -1;
+        }
+        for (k = 0; k < NVARS; k++)
+            ldefault[k] = !found[k];
     } else {
-        return 0;  /* unknown section/name, error */
+        for (k = 0; k < NVARS; k++) column[k] = k;
+        ncolumns = NVARS;
+    }
+
+    /* number of rows (upper bound) */
+    for (end = p; *end != '\0'; end++) if (*end == '\n') n++;
+    if (allocate_batch(batch, n + 1)) { free(buffer); return -1; }
+    for (i = 0; ; i++) {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+        if (*p == '\0') break;
+        for (k = 0; k < ncolumns; k++) {
+            double v = strtod(p, &end);
+            if (end == p) {
+                printf("Wrong value in row %ld, column %d of '%s'\n", i+1, k+1, filename);
+                free(buffer);
+                return -1;
+            }
+            if (column[k] >= 0) batch->v[column[k]][i] = v;
+            p = end;
+            while (*p == ' ' || *p == '\t') p++;
+            if (k < ncolumns - 1) {
+                if (*p != ',' && *p != ';') {
+                    printf("Row %ld of '%s' has less than %d columns\n", i+1, filename, ncolumns);
+                    free(buffer);
+                    return -1;
+                }
+                p++;
+            }
+        }
+        for (k = 0; k < NVARS; k++)
+            if (ldefault[k]) batch->v[k][i] = defaults[k];
+        p = next_field(p);
     }
-    return 1;
+    batch->n = i;
+    free(buffer);
+    return 0;
+}
+
+/* results written with a single write */
+static int write_results(const char* filename, const ishigamibatch* batch)
+{
+    FILE* file;
+    char *buffer, *p;
+    size_t size;
+    long i;
+    int rc;
+
+    if (is_text(filename)) {
+        if ((buffer = (char*)malloc(32*(batch->n + 1))) == NULL) return -1;
+        p = buffer + sprintf(buffer, "out\n");
+        for (i = 0; i < batch->n; i++)
+            p += sprintf(p, "%.17g\n", batch->out[i]);
+        size = p - buffer;
+    } else {
+        buffer = (char*)batch->out;
+        size = batch->n*sizeof(double);
+    }
+    file = fopen(filename, "wb");
+    rc = file == NULL || fwrite(buffer, 1, size, file) != size;
+    if (file != NULL && fclose(file) != 0) rc = 1;
+    if (buffer != (char*)batch->out) free(buffer);
+    return rc ? -1 : 0;
+}
+
+static int run_batch(int argc, char* argv[])
+{
+    ishigamibatch batch;
+    double t0, t1, t2, t3;
+    int nthreads = 1, rc;
+
+#ifdef THREADS
+    nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (argc == 5) nthreads = atoi(argv[4]);
+    if (argc < 4 || argc > 5 || nthreads < 1) {
+        printf("usage: %s --batch inputfile outputfile [nthreads]\n", argv[0]);
+        return 1;
+    }
+
+    memset(&batch, 0, sizeof(batch));
+    t0 = now();
+    rc = is_text(argv[2]) ? read_text(argv[2], &batch) : read_binary(argv[2], &batch);
+    if (rc) {
+        printf("Can't load '%s'\n", argv[2]);
+        free_batch(&batch);
+        return 1;
+    }
+    t1 = now();
+    evaluate_batch(&batch, nthreads);
+    t2 = now();
+    if (write_results(argv[3], &batch)) {
+        printf("Can't write '%s'\n", argv[3]);
+        free_batch(&batch);
+        return 1;
+    }
+    t3 = now();
+    printf("%ld samples evaluated with %d threads: read %g s, evaluate %g s, write %g s\n",
+        batch.n, nthreads, t1-t0, t2-t1, t3-t2);
+    free_batch(&batch);
+    return 0;
 }
 
 int main(int argc, char* argv[])
 {
     ishigamidata data;
-	float out;
+    double out;
+    int binary;
+    char message[256];
+    cres_response response = {"out", 1, 1, NULL};
 	
-    if ( argc != 2 ) /* argc should be 2 for correct execution */
+#ifdef COSSAN_WORKER
+    /* started by the Connector as a persistent worker */
+    if (cwk_worker_fd() >= 0) {
+        static const char* inputs[] = {"a", "b", "x1", "x2", "x3"};
+        static const char* outputs[] = {"out"};
+        return cwk_serve(cwk_worker_fd(), 5, inputs, 1, outputs, ishigami, NULL) ? 1 : 0;
+    }
+#endif
+
+    if ( argc > 1 && strcmp(argv[1], "--batch") == 0 )
+        return run_batch(argc, argv);
+
+    binary = argc > 1 && strcmp(argv[1], "--binary") == 0;
+    if ( argc != 2 + binary ) /* argc should be 2 for correct execution */
     {
         /* We print argv[0] assuming it is the program name */
-        printf( "usage: %s filename\n", argv[0] );
+        printf( "usage: %s [--binary] filename\n", argv[0] );
 		return 1;
     }
 	
     /* call the parser and check if it worked */	
-    if (ini_parse(argv[1], handler, &data) < 0) {
-        printf("Can't load '%s'\n", argv[1]);
+    if (read_input(argv[1 + binary], &data) < 0) {
+        printf("Can't load '%s'\n", argv[1 + binary]);
         return 1;
     }
     printf("data loaded from '%s': a=%f, b=%f, x1=%f, x2=%f, x3=%f\n",
-    argv[1], data.a, data.b, data.x1, data.x2, data.x3);
+    argv[1 + binary], data.a, data.b, data.x1, data.x2, data.x3);
     
     /* Conpute the value of the ishigami function */
     out = sin(data.x1) + data.a*pow(sin(data.x2),2) + data.b*pow(data.x3,4)*sin(data.x1);
     
     /* write the result */
+    if (binary) {
+        response.data = &out;
+        if (cres_write("result.bin", 1, &response, message, sizeof(message)) != CRES_SUCCESS) {
+            printf("%s\n", message);
+            return 1;
+        }
+        return 0;
+    }
     FILE *file = fopen( "result.out", "w" );	
     fprintf(file,"%s\n", "Result");
     fprintf(file,"%f\n", out);
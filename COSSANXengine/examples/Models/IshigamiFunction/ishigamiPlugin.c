@@ -0,0 +1,80 @@
+/* ishigamiPlugin.c
+
+In-process version of ishigamiFunction.c. The Ishigami function is compiled 
+as a shared library implementing the plugin interface of openCOSSAN 
+(mex/src/Plugin/cossan_plugin.h) and it is evaluated by the Connector on a 
+batch of samples without input/output files and external processes.
+
+Inputs:  a, b (shape parameters), x1, x2, x3
+Outputs: out
+
+Compile the plugin with:
+
+  Linux: gcc -shared -fPIC -O2 -I../../../mex/src/Plugin ishigamiPlugin.c -lm -o libishigami.so
+  MAC:   gcc -shared -fPIC -O2 -I../../../mex/src/Plugin ishigamiPlugin.c -lm -o libishigami.dylib
+  Windows (MinGW): gcc -shared -O2 -I../../../mex/src/Plugin ishigamiPlugin.c -o ishigami.dll
+
+Copyright 1993-2014, COSSAN Working Group, University of Liverpool, UK
+
+*/
+
+/*
+=====================================================================
+ This file is part of openCOSSAN.  The open general purpose matlab
+ toolbox for numerical analysis, risk and uncertainty quantification.
+
+ openCOSSAN is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License.
+
+ openCOSSAN is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+=====================================================================
+*/
+
+#include <math.h>
+#include "cossan_plugin.h"
+
+static const char *const inputs[] = {"a", "b", "x1", "x2", "x3"};
+static const char *const outputs[] = {"out"};
+
+/* The function has no state: the batch can be split among threads */
+static int evaluate_batch(void *state, long n, long ld, const double *x,
+                          double *y)
+{
+    const double *a = x, *b = x + ld, *x1 = x + 2*ld, *x2 = x + 3*ld,
+        *x3 = x + 4*ld;
+    double s1, s2, x32;
+    long i;
+
+    (void)state;
+    for (i=0; i<n; i++) {
+        /* Compute the value of the ishigami function */
+        s1 = sin(x1[i]);
+        s2 = sin(x2[i]);
+        x32 = x3[i]*x3[i];
+        y[i] = s1 + a[i]*s2*s2 + b[i]*x32*x32*s1;
+    }
+    return 0;
+}
+
+static const cossan_plugin ishigami = {
+    COSSAN_PLUGIN_ABI_VERSION,
+    "ishigami",
+    COSSAN_PLUGIN_THREAD_SAFE,
+    5, inputs,
+    1, outputs,
+    NULL,
+    evaluate_batch,
+    NULL
+};
+
+COSSAN_PLUGIN_EXPORT const cossan_plugin *cossan_plugin_entry(void)
+{
+    return &ishigami;
+}
@@ -0,0 +1,201 @@
+%% Benchmark of the Connector pipeline with the ISHIGAMI FUNCTION
+% This script measures where the time of a Connector goes. The Ishigami
+% function is evaluated through the Connector in the available execution
+% modes and, for each mode and number of samples, it reports:
+%  * the time of each stage of a simulation (folder creation, copyFiles,
+%    inject, pre-execution command, solver, checkForErrors, post-execution
+%    command, extract and cleanup) as mean and percentiles over the samples
+%    (see the output MstageTimes of Connector.run);
+%  * the throughput of Connector.run and of Evaluator.apply (samples/s).
+%
+% Execution modes:
+%  'local'      : one solver process after the other (Connector.run)
+%  'binary'     : as 'local' with the binary result file (BinaryExtractor)
+%  'concurrent' : NconcurrentRuns solver processes (see runpoolx)
+%  'plugin'     : the model is evaluated in the MATLAB process (SpluginLibrary)
+%  'worker'     : NconcurrentRuns persistent workers (SworkerCommand)
+%
+% The solver is the program ishigamiFunction, compiled with the worker
+% support, and the plugin the library ishigamiPlugin. In
+% /examples/Models/IshigamiFunction/ run:
+%
+% gcc -DCOSSAN_WORKER ishigamiFunction.c -I../../../mex/src/Ini ../../../mex/src/Ini/cossan_ini.c -I../../../mex/src/Extractor ../../../mex/src/Extractor/cossan_result.c -I../../../mex/src/Worker ../../../mex/src/Worker/cossan_worker.c -pthread -lm -o ishigamiFunction
+% gcc -shared -fPIC -O2 -I../../../mex/src/Plugin ishigamiPlugin.c -lm -o libishigami.so
+%
+% The modes that are not available (missing mex files or binaries) are
+% skipped. The file based modes are limited to NmaxFileSamples samples.
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+%% Settings of the benchmark
+CSmodes={'local','binary','concurrent','plugin','worker'}; % execution modes
+VNsamples=[1e3 1e4 1e5];    % number of samples
+NmaxFileSamples=1e3;        % maximum number of samples of the file based modes
+NconcurrentRuns=4;          % processes or workers of the concurrent modes
+Vpercentiles=[50 90 99];    % percentiles of the stage times
+SresultFile='';             % CSV file with the results (optional)
+
+OpenCossan.reset
+OpenCossan.setVerbosityLevel(0);
+SsolverBinaryPath=fullfile(OpenCossan.getCossanRoot,'examples','Models','IshigamiFunction');
+if ispc
+    SsolverBinaryFile=fullfile(SsolverBinaryPath,'ishigamiFunction.exe');
+    SpluginLibrary=fullfile(SsolverBinaryPath,'ishigami.dll');
+elseif ismac
+    SsolverBinaryFile=fullfile(SsolverBinaryPath,'ishigamiFunction');
+    SpluginLibrary=fullfile(SsolverBinaryPath,'libishigami.dylib');
+else
+    SsolverBinaryFile=fullfile(SsolverBinaryPath,'ishigamiFunction');
+    SpluginLibrary=fullfile(SsolverBinaryPath,'libishigami.so');
+end
+
+%% Input Definition
+% Same model of TutorialIshigamiFunction
+Xrv1=RandomVariable('Sdistribution','uniform','lowerbound',-pi,'upperbound',pi);
+Xrv2=RandomVariable('Sdistribution','uniform','lowerbound',-pi,'upperbound',pi);
+Xrv3=RandomVariable('Sdistribution','uniform','lowerbound',-pi,'upperbound',pi);
+Xrvset = RandomVariableSet('Cmembers',{'Xrv1','Xrv2','Xrv3'},'CXrv',{Xrv1,Xrv2,Xrv3});
+parameterA = Parameter('value',7);
+parameterB = Parameter('value',0.05);
+Xinput = Input('CXmembers',{Xrvset,parameterA,parameterB},...
+    'CSmembers',{'Xrvset','parameterA','parameterB'});
+% names of the inputs in the order of the plugin and of the worker (a, b,
+% x1, x2, x3)
+CSmodelInputs={'parameterA','parameterB','Xrv1','Xrv2','Xrv3'};
+
+%% Injector and Extractor of the file based modes
+Xinjector = Injector('Sscanfilepath',SsolverBinaryPath,...
+    'Sscanfilename','input.dat.cossan','Sfile','input.dat');
+Xresponse = Response('Sname','out','ClookOutFor',{'Result'}, ...
+    'Ncol',1,'Nrow',1,'Sformat','%9e');
+Xextractor = Extractor('Sfile','result.out','Xresponse',Xresponse);
+XbinaryExtractor = BinaryExtractor('Sfile','result.bin','CSresponseNames',{'out'});
+
+%% Run the benchmark
+CSstages=Connector.CSstageNames;
+CSpercentiles=arrayfun(@(p) sprintf('p%i',p),Vpercentiles,'UniformOutput',false);
+Tbenchmark=struct('Smode',{},'Nsamples',{},'Trun',{},'Tapply',{},...
+    'VmeanStage',{},'MpercentileStage',{});
+for imode=1:length(CSmodes)
+    Smode=CSmodes{imode};
+    % Connector of the execution mode
+    switch Smode
+        case {'local','concurrent'}
+            if ~exist(SsolverBinaryFile,'file') || ...
+                    (strcmp(Smode,'concurrent') && ~(isunix && exist('runpoolx','file')==3))
+                fprintf('Mode %s skipped: solver or runpoolx not available\n',Smode);
+                continue
+            end
+            Xconnector = Connector('Sexecmd','%SsolverBinary %SmainInputFile', ...
+                'SmainInputPath',SsolverBinaryPath,'SmainInputFile','input.dat',...
+                'SsolverBinary',SsolverBinaryFile,'LkeepSimulationFiles',false,...
+                'NconcurrentRuns',1+(NconcurrentRuns-1)*strcmp(Smode,'concurrent'),...
+                'CXmembers',{Xinjector,Xextractor});
+        case 'binary'
+            if ~exist(SsolverBinaryFile,'file')
+                fprintf('Mode %s skipped: solver not available\n',Smode);
+                continue
+            end
+            Xconnector = Connector('Sexecmd','%SsolverBinary --binary %SmainInputFile', ...
+                'SmainInputPath',SsolverBinaryPath,'SmainInputFile','input.dat',...
+                'SsolverBinary',SsolverBinaryFile,'LkeepSimulationFiles',false,...
+                'CXmembers',{Xinjector,XbinaryExtractor});
+        case 'plugin'
+            if ~exist(SpluginLibrary,'file') || exist('pluginx','file')~=3
+                fprintf('Mode %s skipped: plugin or pluginx not available\n',Smode);
+                continue
+            end
+            Xconnector = Connector('SpluginLibrary',SpluginLibrary,...
+                'NconcurrentRuns',NconcurrentRuns,'CSpluginInputNames',CSmodelInputs);
+        case 'worker'
+            if ~exist(SsolverBinaryFile,'file') || ~isunix || exist('workerx','file')~=3
+                fprintf('Mode %s skipped: solver or workerx not available\n',Smode);
+                continue
+            end
+            Xconnector = Connector('SworkerCommand',SsolverBinaryFile,...
+                'SmainInputPath',SsolverBinaryPath,...
+                'NconcurrentRuns',NconcurrentRuns,'CSpluginInputNames',CSmodelInputs);
+        otherwise
+            error('openCOSSAN:BenchmarkIshigamiConnector','Unknown mode %s',Smode)
+    end
+    Xevaluator = Evaluator('CXmembers',{Xconnector},'CSnames',{'ishigami'});
+
+    for Nsamples=VNsamples
+        if ismember(Smode,{'local','binary','concurrent'}) && Nsamples>NmaxFileSamples
+            continue
+        end
+        Xinput = Xinput.sample('Nsamples',Nsamples);
+        Tinput = Xinput.getStructure;
+
+        % Stages of Connector.run
+        Ntic=tic;
+        [~,~,~,~,MstageTimes]=Xconnector.run(Tinput);
+        Trun=toc(Ntic);
+        % End to end through the Evaluator
+        Ntic=tic;
+        Xevaluator.apply(Xinput);
+        Tapply=toc(Ntic);
+
+        % Percentiles of the stage times (nearest rank)
+        MsortedTimes=sort(MstageTimes,1);
+        Vrank=max(1,ceil(Vpercentiles/100*Nsamples));
+        Tbenchmark(end+1).Smode=Smode; %#ok<SAGROW>
+        Tbenchmark(end).Nsamples=Nsamples;
+        Tbenchmark(end).Trun=Trun;
+        Tbenchmark(end).Tapply=Tapply;
+        Tbenchmark(end).VmeanStage=mean(MstageTimes,1);
+        Tbenchmark(end).MpercentileStage=MsortedTimes(Vrank,:);
+
+        %% Report
+        fprintf('\n%s, %i samples: run %.3g s (%.4g samples/s), apply %.3g s (%.4g samples/s)\n',...
+            Smode,Nsamples,Trun,Nsamples/Trun,Tapply,Nsamples/Tapply);
+        fprintf('%16s %12s%s\n','stage [ms]','mean',sprintf(' %12s',CSpercentiles{:}));
+        for istage=1:length(CSstages)
+            fprintf('%16s %12.4g',CSstages{istage},1e3*Tbenchmark(end).VmeanStage(istage));
+            fprintf(' %12.4g',1e3*Tbenchmark(end).MpercentileStage(:,istage));
+            fprintf('\n');
+        end
+    end
+    if strcmp(Smode,'plugin')
+        pluginx('clear');
+    elseif strcmp(Smode,'worker')
+        workerx('clear');
+    end
+end
+
+%% Export the results
+if ~isempty(SresultFile)
+    Nfid=fopen(SresultFile,'w');
+    fprintf(Nfid,'mode,nsamples,stage,mean%s,run_throughput,apply_throughput\n',...
+        sprintf(',p%i',Vpercentiles));
+    for n=1:length(Tbenchmark)
+        for istage=1:length(CSstages)
+            fprintf(Nfid,'%s,%i,%s,%.6g%s,%.6g,%.6g\n',Tbenchmark(n).Smode,...
+                Tbenchmark(n).Nsamples,CSstages{istage},Tbenchmark(n).VmeanStage(istage),...
+                sprintf(',%.6g',Tbenchmark(n).MpercentileStage(:,istage)),...
+                Tbenchmark(n).Nsamples/Tbenchmark(n).Trun,...
+                Tbenchmark(n).Nsamples/Tbenchmark(n).Tapply);
+        end
+    end
+    fclose(Nfid);
+end
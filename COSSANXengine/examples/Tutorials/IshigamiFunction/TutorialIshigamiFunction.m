@@ -7,7 +7,7 @@
 % The source code is in /examples/Models/IshigamiFunction/ and to compile
 % the solver run in the terminal:
 %
-% gcc ini.c ishigamiFunction.c -lm -o ishigamiFunction
+% gcc ishigamiFunction.c -I../../../mex/src/Ini ../../../mex/src/Ini/cossan_ini.c -I../../../mex/src/Extractor ../../../mex/src/Extractor/cossan_result.c -pthread -lm -o ishigamiFunction
 %
 % This will generate the executable (external solver).
 
@@ -0,0 +1,440 @@
+/*******************************************************************************
+ * optbench: benchmark of the native optimizers (BOBYQA, COBYLA, SRES)
+ *
+ * Standalone program (no matlab required) that links the cores of the
+ * optimizers (Bobyqa/bobyqa.c, Cobyla/cobyla.c, SRES/sres.c) and runs them on
+ * the test problems of optbench_problems.c. For each run it reports, in CSV
+ * (default) or JSON lines:
+ *
+ *   solver, problem, n, m, seed, rc   identification and return code
+ *   nevals         number of function evaluations
+ *   evals_to_tol   evaluations needed to reach a feasible point with
+ *                  |f-f*| <= tol*max(1,|f*|) (-1 if never reached)
+ *   time           wall time of the run [s]
+ *   fun_time       time spent in the test function [s]
+ *   overhead       (time - fun_time)/nevals [us], cost of the optimizer
+ *   f, fstar, error, violation, success
+ *
+ * The results of a previous run (CSV) can be given with -b: the program
+ * then returns a non-zero exit status if a run that was successful in the
+ * baseline fails, or needs more than ratio times the baseline evaluations
+ * to reach the tolerance (regression gate).
+ *
+ * Compile with:
+ *
+ *   gcc -O2 -D_GNU_SOURCE -I../SRES -I../Random -I../Cobyla \
+ *     optbench.c optbench_problems.c ../Bobyqa/bobyqa.c ../Cobyla/cobyla.c \
+ *     ../SRES/sres.c ../SRES/srank.c ../SRES/recomb.c ../Random/cossan_rng.c \
+ *     -pthread -lm -o optbench
+ *
+ * usage: optbench [-s solver] [-p problem] [-n n1,n2,...] [-r runs]
+ *                 [-e maxevals] [-t tol] [-c ctol] [-l lambda] [-S] [-j]
+ *                 [-b baseline.csv [-g ratio]] [-L]
+ *   -s  bobyqa, cobyla, sres or all (default)
+ *   -p  name of a problem, "constrained", "bound" or all (default)
+ *   -n  number of variables of the scalable problems (default: the problem's)
+ *   -r  number of runs (seeds) of the stochastic solvers (default 5)
+ *   -e  maximum number of function evaluations (default 20000)
+ *   -t  relative tolerance on the objective function (default 1e-4)
+ *   -c  tolerance on the constraint violation (default 1e-6)
+ *   -l  population size of SRES (default 100)
+ *   -S  stop each run as soon as the tolerance is reached
+ *   -j  JSON lines output
+ *   -L  list the problems
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "optbench_problems.h"
+#include "../Bobyqa/include/bobyqa.h"
+#include "cobyla.h"
+#include "sres.h"
+
+#define MAXN_LIST 32
+
+typedef struct {
+  const optbench_problem *p;
+  int n, m;
+  const double *lb, *ub;
+  double fstar, tol, ctol;
+  int lstop;          /* stop at the tolerance */
+  double *g, *x;      /* work vectors (m and n) */
+  long nevals, nevals_tol;
+  double tfun;
+  double fbest, vbest;
+} bench_state;
+
+typedef struct {
+  char solver[16], problem[32];
+  int n, seed, success;
+  long evals_to_tol;
+} bench_record;
+
+static double now(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1e-9*t.tv_nsec;
+}
+
+/* evaluate the problem and keep track of the best point */
+static double evaluate(bench_state *s, const double *x, double *g)
+{
+  double t0, f, v = 0.0;
+  int i;
+
+  t0 = now();
+  f = s->p->fun(s->n, x, g);
+  s->tfun += now() - t0;
+  s->nevals++;
+
+  for (i=0; i<s->m; i++)
+    if (g[i] > v) v = g[i];
+  for (i=0; i<s->n; i++) {
+    if (s->lb[i] - x[i] > v) v = s->lb[i] - x[i];
+    if (x[i] - s->ub[i] > v) v = x[i] - s->ub[i];
+  }
+  if (v <= s->ctol) {
+    if (s->vbest > s->ctol || f < s->fbest) { s->fbest = f; s->vbest = v; }
+    if (s->nevals_tol < 0 &&
+        fabs(f - s->fstar) <= s->tol*(fabs(s->fstar) > 1.0 ? fabs(s->fstar) : 1.0))
+      s->nevals_tol = s->nevals;
+  } else if (s->vbest > s->ctol && v < s->vbest) {
+    s->fbest = f; s->vbest = v;
+  }
+  return f;
+}
+
+/* BOBYQA */
+static double bobyqa_fun(int n, double *x, void *data)
+{
+  bench_state *s = (bench_state *)data;
+  (void)n;
+  return evaluate(s, x, s->g);
+}
+
+static int run_bobyqa(bench_state *s, const double *x0, long maxevals)
+{
+  double *x, *dx, minf;
+  int i, nevals, rc;
+
+  x = (double *)malloc(s->n*sizeof(double));
+  dx = (double *)malloc(s->n*sizeof(double));
+  for (i=0; i<s->n; i++) {
+    x[i] = x0[i];
+    dx[i] = 0.1*(s->ub[i] - s->lb[i]) < 1.0 ? 0.1*(s->ub[i] - s->lb[i]) : 1.0;
+  }
+  /* minf_max stops BOBYQA at the tolerance (no constraints in this set) */
+  rc = bobyqa(s->n, 2*s->n+1, x, s->lb, s->ub, dx, 1e-8, 0.0,
+    s->lstop ? s->fstar + s->tol*(fabs(s->fstar) > 1.0 ? fabs(s->fstar) : 1.0) : -HUGE_VAL,
+    0.0, 0.0, (int)maxevals, &nevals, &minf, bobyqa_fun, s, NULL, 0);
+  free(x); free(dx);
+  return rc;
+}
+
+/* COBYLA: constraints con >= 0, the bounds are added as 2n constraints */
+static int cobyla_fun(int n, int m, double *x, double *f, double *con,
+  void *data)
+{
+  bench_state *s = (bench_state *)data;
+  int i;
+  (void)m;
+  *f = evaluate(s, x, s->g);
+  for (i=0; i<s->m; i++) con[i] = -s->g[i];
+  for (i=0; i<n; i++) {
+    con[s->m+i] = x[i] - s->lb[i];
+    con[s->m+n+i] = s->ub[i] - x[i];
+  }
+  return s->lstop && s->nevals_tol >= 0;
+}
+
+static int run_cobyla(bench_state *s, const double *x0, long maxevals)
+{
+  double *x, rhobeg = HUGE_VAL;
+  int i, maxfun = (int)maxevals, rc;
+
+  x = (double *)malloc(s->n*sizeof(double));
+  for (i=0; i<s->n; i++) {
+    x[i] = x0[i];
+    if (0.1*(s->ub[i] - s->lb[i]) < rhobeg) rhobeg = 0.1*(s->ub[i] - s->lb[i]);
+  }
+  if (rhobeg > 1.0) rhobeg = 1.0;
+  rc = cobyla(s->n, s->m + 2*s->n, x, rhobeg, 1e-8, 0, &maxfun, cobyla_fun, s);
+  free(x);
+  return rc;
+}
+
+/* SRES */
+static int sres_fun(int nrows, int ld, int n, int m, const double *x,
+  double *f, double *phi, void *data)
+{
+  bench_state *s = (bench_state *)data;
+  int i, j;
+  for (i=0; i<nrows; i++) {
+    for (j=0; j<n; j++) s->x[j] = x[j*ld+i];
+    f[i] = evaluate(s, s->x, s->g);
+    for (j=0; j<m; j++) phi[j*ld+i] = s->g[j];
+  }
+  return 0;
+}
+
+static int sres_stop(const sres_status *status, void *data)
+{
+  bench_state *s = (bench_state *)data;
+  (void)status;
+  return s->lstop && s->nevals_tol >= 0;
+}
+
+static int run_sres(bench_state *s, int lambda, int seed, long maxevals)
+{
+  sres_options o;
+  sres_results r;
+  int rc;
+
+  sres_default_options(&o, s->n, s->m);
+  o.lambda = lambda;
+  o.mu = lambda/7 > 0 ? lambda/7 : 1;
+  o.maxgen = (int)(maxevals/lambda) > 0 ? (int)(maxevals/lambda) : 1;
+  o.lb = s->lb; o.ub = s->ub;
+  o.seed = (unsigned long)seed;
+  rc = sres(&o, sres_fun, sres_stop, s, &r);
+  sres_free_results(&r);
+  return rc;
+}
+
+/* baseline */
+static bench_record *read_baseline(const char *Sfile, int *nrec)
+{
+  FILE *fp = fopen(Sfile, "r");
+  char line[1024], *tok[16], *p;
+  bench_record *rec = NULL, *tmp;
+  int nalloc = 0, k;
+
+  *nrec = 0;
+  if (fp == NULL) return NULL;
+  while (fgets(line, sizeof(line), fp)) {
+    if (strncmp(line, "solver,", 7) == 0) continue;
+    for (k=0, p=strtok(line, ",\n"); p != NULL && k<16; p=strtok(NULL, ",\n"))
+      tok[k++] = p;
+    if (k < 16) continue;
+    if (*nrec == nalloc) {
+      nalloc = nalloc ? 2*nalloc : 64;
+      if ((tmp = (bench_record *)realloc(rec, nalloc*sizeof(bench_record))) == NULL)
+        break;
+      rec = tmp;
+    }
+    strncpy(rec[*nrec].solver, tok[0], sizeof(rec->solver)-1);
+    rec[*nrec].solver[sizeof(rec->solver)-1] = '\0';
+    strncpy(rec[*nrec].problem, tok[1], sizeof(rec->problem)-1);
+    rec[*nrec].problem[sizeof(rec->problem)-1] = '\0';
+    rec[*nrec].n = atoi(tok[2]);
+    rec[*nrec].seed = atoi(tok[4]);
+    rec[*nrec].evals_to_tol = atol(tok[7]);
+    rec[*nrec].success = atoi(tok[15]);
+    (*nrec)++;
+  }
+  fclose(fp);
+  return rec;
+}
+
+static int check_baseline(const bench_record *base, int nbase,
+  const bench_record *r, double ratio)
+{
+  int k;
+  for (k=0; k<nbase; k++) {
+    if (strcmp(base[k].solver, r->solver) || strcmp(base[k].problem, r->problem) ||
+        base[k].n != r->n || base[k].seed != r->seed)
+      continue;
+    if (base[k].success && !r->success) {
+      fprintf(stderr, "REGRESSION %s %s n=%d seed=%d: tolerance not reached\n",
+        r->solver, r->problem, r->n, r->seed);
+      return 1;
+    }
+    if (base[k].success && base[k].evals_to_tol > 0 &&
+        r->evals_to_tol > ratio*base[k].evals_to_tol) {
+      fprintf(stderr, "REGRESSION %s %s n=%d seed=%d: %ld evaluations to "
+        "tolerance (baseline %ld)\n", r->solver, r->problem, r->n, r->seed,
+        r->evals_to_tol, base[k].evals_to_tol);
+      return 1;
+    }
+    return 0;
+  }
+  return 0;
+}
+
+static int parse_list(const char *S, int *v, int nmax)
+{
+  int k = 0;
+  char *end;
+  while (*S && k < nmax) {
+    v[k++] = (int)strtol(S, &end, 10);
+    if (end == S) return -1;
+    S = (*end == ',') ? end+1 : end;
+  }
+  return k;
+}
+
+static void usage(const char *Sprog)
+{
+  fprintf(stderr, "usage: %s [-s solver] [-p problem] [-n n1,n2,...] [-r runs] "
+    "[-e maxevals] [-t tol] [-c ctol] [-l lambda] [-S] [-j] "
+    "[-b baseline.csv [-g ratio]] [-L]\n", Sprog);
+}
+
+int main(int argc, char *argv[])
+{
+  static const char *Csolver[3] = {"bobyqa", "cobyla", "sres"};
+  const char *Ssolver = "all", *Sproblem = "all", *Sbaseline = NULL;
+  int nlist[MAXN_LIST], nn = 0, nruns = 5, lambda = 100, ljson = 0;
+  int lstop = 0, ip, in, is, ir, nrun, n, m, i, rc, nbase = 0, nregress = 0;
+  long maxevals = 20000;
+  double tol = 1e-4, ctol = 1e-6, ratio = 1.1, t0, time, err;
+  double *lb, *ub, *x0, fstar;
+  const optbench_problem *p;
+  bench_state s;
+  bench_record rec, *base = NULL;
+
+  for (i=1; i<argc; i++) {
+    if (argv[i][0] != '-' || argv[i][1] == '\0' || argv[i][2] != '\0') {
+      usage(argv[0]); return 2;
+    }
+    switch (argv[i][1]) {
+    case 'S': lstop = 1; continue;
+    case 'j': ljson = 1; continue;
+    case 'L':
+      for (ip=0; ip<optbench_nproblems; ip++)
+        printf("%-8s %-12s n=%d%s m=%d\n", optbench_problems[ip].name,
+          optbench_problems[ip].lbound ? "bound" : "constrained",
+          optbench_problems[ip].n, optbench_problems[ip].lscalable ? "*" : "",
+          optbench_problems[ip].ncons(optbench_problems[ip].n));
+      return 0;
+    }
+    if (i+1 >= argc) { usage(argv[0]); return 2; }
+    switch (argv[i][1]) {
+    case 's': Ssolver = argv[++i]; break;
+    case 'p': Sproblem = argv[++i]; break;
+    case 'n':
+      if ((nn = parse_list(argv[++i], nlist, MAXN_LIST)) < 1) { usage(argv[0]); return 2; }
+      break;
+    case 'r': nruns = atoi(argv[++i]); break;
+    case 'e': maxevals = atol(argv[++i]); break;
+    case 't': tol = atof(argv[++i]); break;
+    case 'c': ctol = atof(argv[++i]); break;
+    case 'l': lambda = atoi(argv[++i]); break;
+    case 'b': Sbaseline = argv[++i]; break;
+    case 'g': ratio = atof(argv[++i]); break;
+    default: usage(argv[0]); return 2;
+    }
+  }
+  if (nruns < 1 || maxevals < 1 || lambda < 2) { usage(argv[0]); return 2; }
+  if (Sbaseline != NULL && (base = read_baseline(Sbaseline, &nbase)) == NULL) {
+    fprintf(stderr, "cannot read the baseline %s\n", Sbaseline);
+    return 2;
+  }
+
+  if (!ljson)
+    printf("solver,problem,n,m,seed,rc,nevals,evals_to_tol,time,fun_time,"
+      "overhead,f,fstar,error,violation,success\n");
+
+  for (ip=0; ip<optbench_nproblems; ip++) {
+    p = &optbench_problems[ip];
+    if (strcmp(Sproblem, "all") && strcmp(Sproblem, p->name) &&
+        !(strcmp(Sproblem, "bound") == 0 && p->lbound) &&
+        !(strcmp(Sproblem, "constrained") == 0 && !p->lbound))
+      continue;
+    for (in=0; in<(p->lscalable && nn > 0 ? nn : 1); in++) {
+      n = (p->lscalable && nn > 0) ? nlist[in] : p->n;
+      if (n < 2) continue;
+      m = p->ncons(n);
+      lb = (double *)malloc(n*sizeof(double));
+      ub = (double *)malloc(n*sizeof(double));
+      x0 = (double *)malloc(n*sizeof(double));
+      s.g = (double *)malloc((m > 0 ? m : 1)*sizeof(double));
+      s.x = (double *)malloc(n*sizeof(double));
+      p->setup(n, lb, ub, x0, &fstar);
+
+      for (is=0; is<3; is++) {
+        if (strcmp(Ssolver, "all") && strcmp(Ssolver, Csolver[is])) continue;
+        /* BOBYQA handles bounds only */
+        if (is == 0 && m > 0) continue;
+        nrun = (is == 2) ? nruns : 1;
+        for (ir=0; ir<nrun; ir++) {
+          s.p = p; s.n = n; s.m = m; s.lb = lb; s.ub = ub;
+          s.fstar = fstar; s.tol = tol; s.ctol = ctol; s.lstop = lstop;
+          s.nevals = 0; s.nevals_tol = -1; s.tfun = 0.0;
+          s.fbest = HUGE_VAL; s.vbest = HUGE_VAL;
+
+          t0 = now();
+          if (is == 0)
+            rc = run_bobyqa(&s, x0, maxevals);
+          else if (is == 1)
+            rc = run_cobyla(&s, x0, maxevals);
+          else
+            rc = run_sres(&s, lambda, ir+1, maxevals);
+          time = now() - t0;
+
+          err = fabs(s.fbest - fstar)/(fabs(fstar) > 1.0 ? fabs(fstar) : 1.0);
+          strcpy(rec.solver, Csolver[is]);
+          strncpy(rec.problem, p->name, sizeof(rec.problem)-1);
+          rec.problem[sizeof(rec.problem)-1] = '\0';
+          rec.n = n; rec.seed = (is == 2) ? ir+1 : 0;
+          rec.evals_to_tol = s.nevals_tol;
+          rec.success = s.nevals_tol >= 0;
+
+          if (ljson)
+            printf("{\"solver\":\"%s\",\"problem\":\"%s\",\"n\":%d,\"m\":%d,"
+              "\"seed\":%d,\"rc\":%d,\"nevals\":%ld,\"evals_to_tol\":%ld,"
+              "\"time\":%.6g,\"fun_time\":%.6g,\"overhead\":%.6g,\"f\":%.15g,"
+              "\"fstar\":%.15g,\"error\":%.6g,\"violation\":%.6g,\"success\":%d}\n",
+              rec.solver, rec.problem, n, m, rec.seed, rc, s.nevals,
+              s.nevals_tol, time, s.tfun,
+              s.nevals > 0 ? 1e6*(time - s.tfun)/s.nevals : 0.0,
+              s.fbest, fstar, err, s.vbest, rec.success);
+          else
+            printf("%s,%s,%d,%d,%d,%d,%ld,%ld,%.6g,%.6g,%.6g,%.15g,%.15g,"
+              "%.6g,%.6g,%d\n", rec.solver, rec.problem, n, m, rec.seed, rc,
+              s.nevals, s.nevals_tol, time, s.tfun,
+              s.nevals > 0 ? 1e6*(time - s.tfun)/s.nevals : 0.0,
+              s.fbest, fstar, err, s.vbest, rec.success);
+          fflush(stdout);
+          if (base != NULL)
+            nregress += check_baseline(base, nbase, &rec, ratio);
+        }
+      }
+      free(lb); free(ub); free(x0); free(s.g); free(s.x);
+    }
+  }
+  free(base);
+  if (nregress > 0) {
+    fprintf(stderr, "%d regression(s) with respect to %s\n", nregress, Sbaseline);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,392 @@
+/*******************************************************************************
+ * optbench_problems.c: test problems of the optimizer benchmark (optbench)
+ *
+ * References:
+ *  J.J. Liang et al., "Problem definitions and evaluation criteria for the
+ *  CEC 2006 special session on constrained real-parameter optimization", 2006
+ *  W. Hock and K. Schittkowski, "Test examples for nonlinear programming
+ *  codes", Lecture Notes in Economics and Mathematical Systems 187, 1981
+ *  M.J.D. Powell, "The BOBYQA algorithm for bound constrained optimization
+ *  without derivatives", DAMTP 2009/NA06 (and the NEWUOA test set)
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <math.h>
+#include "optbench_problems.h"
+
+#define PI 3.14159265358979323846
+
+static void box(int n, double *lb, double *ub, double l, double u)
+{
+  int i;
+  for (i=0; i<n; i++) { lb[i] = l; ub[i] = u; }
+}
+
+static int m0(int n) { (void)n; return 0; }
+static int m2(int n) { (void)n; return 2; }
+
+/* ----------------------------------------------------------------------------
+ * Constrained set
+ * ------------------------------------------------------------------------- */
+
+/* CEC 2006 g01: n=13, m=9, f* = -15 */
+static int g01_m(int n) { (void)n; return 9; }
+static void g01_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  int i;
+  box(n, lb, ub, 0.0, 1.0);
+  ub[9] = ub[10] = ub[11] = 100.0;
+  for (i=0; i<n; i++) x0[i] = 0.5*(lb[i] + ub[i]);
+  *fstar = -15.0;
+}
+static double g01_fun(int n, const double *x, double *g)
+{
+  double f = 0.0;
+  int i;
+  (void)n;
+  for (i=0; i<4; i++) f += 5.0*x[i] - 5.0*x[i]*x[i];
+  for (i=4; i<13; i++) f -= x[i];
+  g[0] = 2*x[0] + 2*x[1] + x[9] + x[10] - 10;
+  g[1] = 2*x[0] + 2*x[2] + x[9] + x[11] - 10;
+  g[2] = 2*x[1] + 2*x[2] + x[10] + x[11] - 10;
+  g[3] = -8*x[0] + x[9];
+  g[4] = -8*x[1] + x[10];
+  g[5] = -8*x[2] + x[11];
+  g[6] = -2*x[3] - x[4] + x[9];
+  g[7] = -2*x[5] - x[6] + x[10];
+  g[8] = -2*x[7] - x[8] + x[11];
+  return f;
+}
+
+/* CEC 2006 g04: n=5, m=6, f* = -30665.538671783317 */
+static int g04_m(int n) { (void)n; return 6; }
+static void g04_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  int i;
+  lb[0] = 78; ub[0] = 102; lb[1] = 33; ub[1] = 45;
+  for (i=2; i<5; i++) { lb[i] = 27; ub[i] = 45; }
+  for (i=0; i<n; i++) x0[i] = 0.5*(lb[i] + ub[i]);
+  *fstar = -30665.538671783317;
+}
+static double g04_fun(int n, const double *x, double *g)
+{
+  double u, v, w;
+  (void)n;
+  u = 85.334407 + 0.0056858*x[1]*x[4] + 0.0006262*x[0]*x[3] - 0.0022053*x[2]*x[4];
+  v = 80.51249 + 0.0071317*x[1]*x[4] + 0.0029955*x[0]*x[1] + 0.0021813*x[2]*x[2];
+  w = 9.300961 + 0.0047026*x[2]*x[4] + 0.0012547*x[0]*x[2] + 0.0019085*x[2]*x[3];
+  g[0] = u - 92; g[1] = -u;
+  g[2] = v - 110; g[3] = -v + 90;
+  g[4] = w - 25; g[5] = -w + 20;
+  return 5.3578547*x[2]*x[2] + 0.8356891*x[0]*x[4] + 37.293239*x[0] - 40792.141;
+}
+
+/* CEC 2006 g06: n=2, m=2, f* = -6961.81387558015 */
+static void g06_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  (void)n;
+  lb[0] = 13; ub[0] = 100; lb[1] = 0; ub[1] = 100;
+  x0[0] = 20; x0[1] = 10;
+  *fstar = -6961.81387558015;
+}
+static double g06_fun(int n, const double *x, double *g)
+{
+  (void)n;
+  g[0] = -(x[0]-5)*(x[0]-5) - (x[1]-5)*(x[1]-5) + 100;
+  g[1] = (x[0]-6)*(x[0]-6) + (x[1]-5)*(x[1]-5) - 82.81;
+  return pow(x[0]-10, 3) + pow(x[1]-20, 3);
+}
+
+/* CEC 2006 g08: n=2, m=2, f* = -0.0958250414180359 */
+static void g08_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  box(n, lb, ub, 0.0, 10.0);
+  x0[0] = 1.0; x0[1] = 4.0;
+  *fstar = -0.0958250414180359;
+}
+static double g08_fun(int n, const double *x, double *g)
+{
+  (void)n;
+  g[0] = x[0]*x[0] - x[1] + 1;
+  g[1] = 1 - x[0] + (x[1]-4)*(x[1]-4);
+  if (x[0] <= 0.0) return 0.0;
+  return -pow(sin(2*PI*x[0]), 3)*sin(2*PI*x[1])/(pow(x[0], 3)*(x[0] + x[1]));
+}
+
+/* CEC 2006 g09: n=7, m=4, f* = 680.630057374402 */
+static int g09_m(int n) { (void)n; return 4; }
+static void g09_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  int i;
+  box(n, lb, ub, -10.0, 10.0);
+  for (i=0; i<n; i++) x0[i] = 0.0;
+  x0[0] = 1.0; x0[1] = 2.0;
+  *fstar = 680.630057374402;
+}
+static double g09_fun(int n, const double *x, double *g)
+{
+  (void)n;
+  g[0] = -127 + 2*x[0]*x[0] + 3*pow(x[1], 4) + x[2] + 4*x[3]*x[3] + 5*x[4];
+  g[1] = -282 + 7*x[0] + 3*x[1] + 10*x[2]*x[2] + x[3] - x[4];
+  g[2] = -196 + 23*x[0] + x[1]*x[1] + 6*x[5]*x[5] - 8*x[6];
+  g[3] = 4*x[0]*x[0] + x[1]*x[1] - 3*x[0]*x[1] + 2*x[2]*x[2] + 5*x[5] - 11*x[6];
+  return (x[0]-10)*(x[0]-10) + 5*(x[1]-12)*(x[1]-12) + pow(x[2], 4) +
+    3*(x[3]-11)*(x[3]-11) + 10*pow(x[4], 6) + 7*x[5]*x[5] + pow(x[6], 4) -
+    4*x[5]*x[6] - 10*x[5] - 8*x[6];
+}
+
+/* CEC 2006 g24: n=2, m=2, f* = -5.50801327159536 */
+static void g24_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  (void)n;
+  lb[0] = 0; ub[0] = 3; lb[1] = 0; ub[1] = 4;
+  x0[0] = 0.5; x0[1] = 0.5;
+  *fstar = -5.50801327159536;
+}
+static double g24_fun(int n, const double *x, double *g)
+{
+  double x1 = x[0], x2 = x[1];
+  (void)n;
+  g[0] = -2*pow(x1, 4) + 8*pow(x1, 3) - 8*x1*x1 + x2 - 2;
+  g[1] = -4*pow(x1, 4) + 32*pow(x1, 3) - 88*x1*x1 + 96*x1 + x2 - 36;
+  return -x1 - x2;
+}
+
+/* Hock-Schittkowski 21: n=2, m=1, f* = -99.96 */
+static int m1(int n) { (void)n; return 1; }
+static void hs21_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  (void)n;
+  lb[0] = 2; ub[0] = 50; lb[1] = -50; ub[1] = 50;
+  x0[0] = 2; x0[1] = -1;
+  *fstar = -99.96;
+}
+static double hs21_fun(int n, const double *x, double *g)
+{
+  (void)n;
+  g[0] = 10 - 10*x[0] + x[1];
+  return 0.01*x[0]*x[0] + x[1]*x[1] - 100;
+}
+
+/* Hock-Schittkowski 35: n=3, m=1, f* = 1/9 */
+static void hs35_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  int i;
+  box(n, lb, ub, 0.0, 3.0);
+  for (i=0; i<n; i++) x0[i] = 0.5;
+  *fstar = 1.0/9.0;
+}
+static double hs35_fun(int n, const double *x, double *g)
+{
+  (void)n;
+  g[0] = x[0] + x[1] + 2*x[2] - 3;
+  return 9 - 8*x[0] - 6*x[1] - 4*x[2] + 2*x[0]*x[0] + 2*x[1]*x[1] +
+    x[2]*x[2] + 2*x[0]*x[1] + 2*x[0]*x[2];
+}
+
+/* Constrained sphere: min sum x_i^2 s.t. x_i >= 1 (i<m=n/2) and
+   sum x_i >= n/2+1. Scalable in n and m, f* = n/2 + 1/(n-n/2) */
+static int csphere_m(int n) { return n/2 + 1; }
+static void csphere_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  int i, k = n/2;
+  box(n, lb, ub, -5.0, 5.0);
+  for (i=0; i<n; i++) x0[i] = 3.0;
+  /* x_i = 1 (i<k), the remaining n-k variables share the residual 1 */
+  *fstar = k + 1.0/(n-k);
+}
+static double csphere_fun(int n, const double *x, double *g)
+{
+  double f = 0.0, s = 0.0;
+  int i, k = n/2;
+  for (i=0; i<n; i++) { f += x[i]*x[i]; s += x[i]; }
+  for (i=0; i<k; i++) g[i] = 1.0 - x[i];
+  g[k] = (k + 1.0) - s;
+  return f;
+}
+
+/* ----------------------------------------------------------------------------
+ * Bound constrained set (Powell)
+ * ------------------------------------------------------------------------- */
+
+/* ARWHEAD: f* = 0 at x = (1,...,1,0) */
+static void arwhead_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  int i;
+  box(n, lb, ub, -10.0, 10.0);
+  for (i=0; i<n; i++) x0[i] = 1.0;
+  *fstar = 0.0;
+}
+static double arwhead_fun(int n, const double *x, double *g)
+{
+  double f = 0.0, t;
+  int i;
+  (void)g;
+  for (i=0; i<n-1; i++) {
+    t = x[i]*x[i] + x[n-1]*x[n-1];
+    f += t*t - 4.0*x[i] + 3.0;
+  }
+  return f;
+}
+
+/* CHROSEN (chained Rosenbrock): f* = 0 at x = (1,...,1) */
+static void chrosen_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  int i;
+  box(n, lb, ub, -10.0, 10.0);
+  for (i=0; i<n; i++) x0[i] = -1.0;
+  *fstar = 0.0;
+}
+static double chrosen_fun(int n, const double *x, double *g)
+{
+  double f = 0.0;
+  int i;
+  (void)g;
+  for (i=0; i<n-1; i++)
+    f += 4.0*(x[i] - x[i+1]*x[i+1])*(x[i] - x[i+1]*x[i+1]) +
+      (1.0 - x[i+1])*(1.0 - x[i+1]);
+  return f;
+}
+
+/* DQRTIC: f* = 0 at x_i = i */
+static void dqrtic_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  int i;
+  box(n, lb, ub, -2.0*n, 2.0*n);
+  for (i=0; i<n; i++) x0[i] = 2.0;
+  *fstar = 0.0;
+}
+static double dqrtic_fun(int n, const double *x, double *g)
+{
+  double f = 0.0, t;
+  int i;
+  (void)g;
+  for (i=0; i<n; i++) { t = x[i] - (i+1); f += t*t*t*t; }
+  return f;
+}
+
+/* VARDIM: f* = 0 at x = (1,...,1) */
+static void vardim_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  int i;
+  box(n, lb, ub, -10.0, 10.0);
+  for (i=0; i<n; i++) x0[i] = 1.0 - (double)(i+1)/n;
+  *fstar = 0.0;
+}
+static double vardim_fun(int n, const double *x, double *g)
+{
+  double f = 0.0, s = 0.0;
+  int i;
+  (void)g;
+  for (i=0; i<n; i++) {
+    f += (x[i] - 1.0)*(x[i] - 1.0);
+    s += (i+1)*(x[i] - 1.0);
+  }
+  return f + s*s + s*s*s*s;
+}
+
+/* Extended Powell singular (n multiple of 4): f* = 0 at x = 0 */
+static void powsing_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  static const double x0p[4] = {3.0, -1.0, 0.0, 1.0};
+  int i;
+  box(n, lb, ub, -10.0, 10.0);
+  for (i=0; i<n; i++) x0[i] = x0p[i%4];
+  *fstar = 0.0;
+}
+static double powsing_fun(int n, const double *x, double *g)
+{
+  double f = 0.0, a, b, c, d;
+  int i;
+  (void)g;
+  for (i=0; i+3<n; i+=4) {
+    a = x[i] + 10.0*x[i+1];
+    b = x[i+2] - x[i+3];
+    c = x[i+1] - 2.0*x[i+2];
+    d = x[i] - x[i+3];
+    f += a*a + 5.0*b*b + c*c*c*c + 10.0*d*d*d*d;
+  }
+  return f;
+}
+
+/* Box constrained quadratic: sum i*(x_i - c_i)^2 with c_i outside [-1,1]
+   for odd i, so that half of the bounds are active at the optimum */
+static double bquad_c(int i) { return (i%2) ? 2.0 + 0.1*i : 0.5*sin((double)i); }
+static void bquad_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  int i;
+  double d;
+  box(n, lb, ub, -1.0, 1.0);
+  *fstar = 0.0;
+  for (i=0; i<n; i++) {
+    x0[i] = 0.0;
+    d = bquad_c(i) > 1.0 ? bquad_c(i) - 1.0 : 0.0;
+    *fstar += (i+1)*d*d;
+  }
+}
+static double bquad_fun(int n, const double *x, double *g)
+{
+  double f = 0.0, t;
+  int i;
+  (void)g;
+  for (i=0; i<n; i++) { t = x[i] - bquad_c(i); f += (i+1)*t*t; }
+  return f;
+}
+
+/* DQRTIC with the upper bounds x_i <= i/2 active at the optimum */
+static void bdqrtic_setup(int n, double *lb, double *ub, double *x0, double *fstar)
+{
+  int i;
+  *fstar = 0.0;
+  for (i=0; i<n; i++) {
+    lb[i] = -2.0*n; ub[i] = 0.5*(i+1); x0[i] = 0.0;
+    *fstar += pow(0.5*(i+1), 4);
+  }
+}
+
+const optbench_problem optbench_problems[] = {
+  /* constrained set */
+  {"g01",     0, 13, 0, g01_m,     g01_setup,     g01_fun},
+  {"g04",     0,  5, 0, g04_m,     g04_setup,     g04_fun},
+  {"g06",     0,  2, 0, m2,        g06_setup,     g06_fun},
+  {"g08",     0,  2, 0, m2,        g08_setup,     g08_fun},
+  {"g09",     0,  7, 0, g09_m,     g09_setup,     g09_fun},
+  {"g24",     0,  2, 0, m2,        g24_setup,     g24_fun},
+  {"hs21",    0,  2, 0, m1,        hs21_setup,    hs21_fun},
+  {"hs35",    0,  3, 0, m1,        hs35_setup,    hs35_fun},
+  {"csphere", 0, 10, 1, csphere_m, csphere_setup, csphere_fun},
+  /* bound constrained set */
+  {"arwhead", 1, 10, 1, m0,        arwhead_setup, arwhead_fun},
+  {"chrosen", 1, 10, 1, m0,        chrosen_setup, chrosen_fun},
+  {"dqrtic",  1, 10, 1, m0,        dqrtic_setup,  dqrtic_fun},
+  {"vardim",  1, 10, 1, m0,        vardim_setup,  vardim_fun},
+  {"powsing", 1, 12, 1, m0,        powsing_setup, powsing_fun},
+  {"bquad",   1, 10, 1, m0,        bquad_setup,   bquad_fun},
+  {"bdqrtic", 1, 10, 1, m0,        bdqrtic_setup, dqrtic_fun}
+};
+
+const int optbench_nproblems =
+  (int)(sizeof(optbench_problems)/sizeof(optbench_problems[0]));
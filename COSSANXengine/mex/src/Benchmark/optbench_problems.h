@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * optbench_problems.h: test problems of the optimizer benchmark (optbench)
+ *
+ * Two sets of problems are defined:
+ *  - constrained problems (CEC 2006 g01, g04, g06, g08, g09, g24,
+ *    Hock-Schittkowski 21 and 35, and a scalable constrained sphere) with
+ *    inequality constraints g(x) <= 0 and bounds;
+ *  - Powell's bound constrained set (ARWHEAD, CHROSEN, DQRTIC, VARDIM,
+ *    extended Powell singular, and the box-constrained quadratic and quartic
+ *    problems with active bounds), scalable in the number of variables.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _OPTBENCH_PROBLEMS_H
+#define _OPTBENCH_PROBLEMS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  const char *name;
+  int lbound;          /* 1: bound constrained set, 0: constrained set */
+  int n;               /* default number of variables */
+  int lscalable;       /* 1 if the number of variables can be changed */
+  /* number of inequality constraints for n variables */
+  int (*ncons)(int n);
+  /* bounds, starting point and optimum for n variables */
+  void (*setup)(int n, double *lb, double *ub, double *x0, double *fstar);
+  /* objective function; g[m] on output, the constraints (g<=0 feasible) */
+  double (*fun)(int n, const double *x, double *g);
+} optbench_problem;
+
+extern const optbench_problem optbench_problems[];
+extern const int optbench_nproblems;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTBENCH_PROBLEMS_H */
@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * bundlex: compressed bundles of the simulation folders - matlab MEX
+ *
+ * Pack many folders in one gzip compressed tar stream, or unpack it, so
+ * that the folders of the jobs are moved to and from a remote host with a
+ * single transfer (see cossan_bundle.h and the program cossanbundle).
+ *
+ * usage:
+ *   Tstats = bundlex('pack',Sbundle,Sroot,CSpaths,Nlevel)
+ *   Tstats = bundlex('unpack',Sbundle,Sroot)
+ * where
+ *   Sbundle : name of the bundle
+ *   Sroot   : folder of the paths (pack) or destination folder (unpack)
+ *   CSpaths : cell array of files and folders, relative to Sroot; the
+ *             folders are packed recursively and the missing paths are
+ *             skipped
+ *   Nlevel  : compression level from 1 (fast) to 9 (small), default 6
+ *
+ *   Tstats  : structure with the fields Nfiles, Nfolders, Nbytes (size of
+ *             the files before compression) and Nmissing
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+
+#include <string.h>
+#include "mex.h"
+#include "cossan_bundle.h"
+
+static const char *stats_fields[] = {"Nfiles", "Nfolders", "Nbytes", "Nmissing"};
+
+static mxArray *stats_struct(const cbundle_stats *stats)
+{
+    mxArray *T = mxCreateStructMatrix(1, 1, 4, stats_fields);
+    mxSetField(T, 0, "Nfiles", mxCreateDoubleScalar((double)stats->files));
+    mxSetField(T, 0, "Nfolders", mxCreateDoubleScalar((double)stats->directories));
+    mxSetField(T, 0, "Nbytes", mxCreateDoubleScalar((double)stats->bytes));
+    mxSetField(T, 0, "Nmissing", mxCreateDoubleScalar((double)stats->missing));
+    return T;
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    char Saction[8], message[512];
+    char *Sbundle, *Sroot, **paths;
+    cbundle_stats stats;
+    double Nlevel = 0;
+    mwSize n, i;
+    int rc;
+
+    if (nrhs < 1 || !mxIsChar(prhs[0]) || mxGetString(prhs[0], Saction, sizeof(Saction)) != 0)
+        mexErrMsgTxt("usage: Tstats = bundlex(Saction,...) ; (pack or unpack)");
+
+    if (strcmp(Saction, "pack") == 0) {
+        if (nlhs > 1 || nrhs < 4 || nrhs > 5 || !mxIsChar(prhs[1]) || !mxIsChar(prhs[2]) ||
+            !mxIsCell(prhs[3]))
+            mexErrMsgTxt("usage: Tstats = bundlex('pack',Sbundle,Sroot,CSpaths,Nlevel) ;");
+        if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+            Nlevel = mxGetScalar(prhs[4]);
+            if (!(Nlevel >= 1 && Nlevel <= 9))
+                mexErrMsgIdAndTxt("openCOSSAN:bundlex", "Nlevel must be an integer from 1 to 9");
+        }
+        n = mxGetNumberOfElements(prhs[3]);
+        paths = (char **)mxCalloc(n > 0 ? n : 1, sizeof(char *));
+        for (i=0; i<n; i++) {
+            if (mxGetCell(prhs[3], i) == NULL || !mxIsChar(mxGetCell(prhs[3], i)))
+                mexErrMsgIdAndTxt("openCOSSAN:bundlex", "The paths must be strings");
+            paths[i] = mxArrayToString(mxGetCell(prhs[3], i));
+        }
+        Sbundle = mxArrayToString(prhs[1]);
+        Sroot = mxArrayToString(prhs[2]);
+        rc = cbundle_pack(Sbundle, Sroot, (const char *const *)paths, (int)n, (int)Nlevel,
+                          &stats, message, sizeof(message));
+        for (i=0; i<n; i++) mxFree(paths[i]);
+        mxFree(paths);
+
+    } else if (strcmp(Saction, "unpack") == 0) {
+        if (nlhs > 1 || nrhs != 3 || !mxIsChar(prhs[1]) || !mxIsChar(prhs[2]))
+            mexErrMsgTxt("usage: Tstats = bundlex('unpack',Sbundle,Sroot) ;");
+        Sbundle = mxArrayToString(prhs[1]);
+        Sroot = mxArrayToString(prhs[2]);
+        rc = cbundle_unpack(Sbundle, Sroot, &stats, message, sizeof(message));
+
+    } else {
+        mexErrMsgIdAndTxt("openCOSSAN:bundlex", "Unknown action %s", Saction);
+        return;
+    }
+
+    mxFree(Sbundle);
+    mxFree(Sroot);
+    if (rc != CBUNDLE_SUCCESS)
+        mexErrMsgIdAndTxt(rc == CBUNDLE_FORMAT_ERROR ? "openCOSSAN:bundlex:formatError" :
+                          "openCOSSAN:bundlex", "%s",
+                          message[0] ? message : cbundle_rc_string(rc));
+    plhs[0] = stats_struct(&stats);
+}
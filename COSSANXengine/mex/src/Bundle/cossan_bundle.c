@@ -0,0 +1,684 @@
+/*******************************************************************************
+ * cossan_bundle.c: compressed bundles of the folders of the simulations
+ *
+ * The bundle is a ustar archive compressed with zlib (gzip format). The
+ * names longer than 100 characters are split in the prefix field or, when
+ * that is not possible, written in a GNU long name entry (././@LongLink);
+ * the files larger than 8 GB have their size in base-256. Both extensions
+ * are understood by GNU and BSD tar. The path and size records of the pax
+ * extended headers (tar --format=pax) are read when unpacking.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "cossan_bundle.h"
+
+#if !defined(_WIN32)
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <zlib.h>
+
+#define BUNDLE_BLOCK 512
+#define BUNDLE_BUFFER (1<<16)
+#define BUNDLE_MAXDEPTH 64   /* folders nested through links */
+#define BUNDLE_MAXNAME 4095  /* longest name of an entry */
+
+typedef struct {
+  char name[100];
+  char mode[8];
+  char uid[8];
+  char gid[8];
+  char size[12];
+  char mtime[12];
+  char chksum[8];
+  char typeflag;
+  char linkname[100];
+  char magic[6];
+  char version[2];
+  char uname[32];
+  char gname[32];
+  char devmajor[8];
+  char devminor[8];
+  char prefix[155];
+  char pad[12];
+} ustar_header;
+
+typedef struct {
+  gzFile gz;
+  char *buffer;
+  cbundle_stats stats;
+  char *message;
+  size_t lmessage;
+} bundle;
+
+static int fail(bundle *b, int rc, const char *what, const char *name)
+{
+  if (b->message != NULL && b->lmessage > 0) {
+    if (rc == CBUNDLE_IO_ERROR)
+      snprintf(b->message, b->lmessage, "%s %s: %s", what, name, strerror(errno));
+    else
+      snprintf(b->message, b->lmessage, "%s %s", what, name);
+  }
+  return rc;
+}
+
+static char *join(const char *a, const char *b)
+{
+  size_t na = strlen(a), nb = strlen(b);
+  char *s = (char *)malloc(na+nb+2);
+  if (s == NULL) return NULL;
+  memcpy(s, a, na);
+  s[na] = '/';
+  memcpy(s+na+1, b, nb+1);
+  return s;
+}
+
+/* create the folder path and its parents (or only the parents) */
+static int make_dirs(const char *path, int parents_only)
+{
+  char *p, *s;
+  size_t n = strlen(path);
+
+  if ((s = (char *)malloc(n+1)) == NULL) return -1;
+  memcpy(s, path, n+1);
+  for (p=s+1; *p; p++) {
+    if (*p != '/') continue;
+    *p = '\0';
+    if (mkdir(s, 0777) != 0 && errno != EEXIST) { free(s); return -1; }
+    *p = '/';
+  }
+  free(s);
+  if (!parents_only && mkdir(path, 0777) != 0 && errno != EEXIST) return -1;
+  return 0;
+}
+
+/* relative names only, without ".." components */
+static int safe_name(const char *name)
+{
+  const char *p = name;
+  size_t n;
+
+  if (name[0] == '\0' || name[0] == '/') return 0;
+  while (*p) {
+    n = strcspn(p, "/");
+    if (n == 2 && p[0] == '.' && p[1] == '.') return 0;
+    p += n;
+    while (*p == '/') p++;
+  }
+  return 1;
+}
+
+/* octal number, or base-256 if it does not fit in a 12 bytes field */
+static void put_number(char *field, size_t n, uint64_t value)
+{
+  size_t k;
+
+  if (n < 12 || value < ((uint64_t)1 << (3*(n-1)))) {
+    field[n-1] = '\0';
+    for (k=n-1; k>0; k--) {
+      field[k-1] = (char)('0' + (value & 7));
+      value >>= 3;
+    }
+  } else {
+    for (k=n-1; k>0; k--) {
+      field[k] = (char)(value & 0xff);
+      value >>= 8;
+    }
+    field[0] = (char)0x80;
+  }
+}
+
+static int get_number(const char *field, size_t n, uint64_t *value)
+{
+  size_t k = 0;
+
+  *value = 0;
+  if ((unsigned char)field[0] & 0x80) {
+    for (k=1; k<n; k++) *value = (*value << 8) | (unsigned char)field[k];
+    return 0;
+  }
+  while (k < n && field[k] == ' ') k++;
+  for (; k < n && field[k] != '\0' && field[k] != ' '; k++) {
+    if (field[k] < '0' || field[k] > '7') return -1;
+    *value = (*value << 3) | (uint64_t)(field[k] - '0');
+  }
+  return 0;
+}
+
+static unsigned long checksum(const ustar_header *h, long *signed_sum)
+{
+  const unsigned char *u = (const unsigned char *)h;
+  const signed char *s = (const signed char *)h;
+  unsigned long sum = 0;
+  size_t k;
+
+  *signed_sum = 0;
+  for (k=0; k<BUNDLE_BLOCK; k++) {
+    if (k >= offsetof(ustar_header, chksum) &&
+        k < offsetof(ustar_header, chksum) + sizeof(h->chksum)) {
+      sum += ' ';
+      *signed_sum += ' ';
+    } else {
+      sum += u[k];
+      *signed_sum += s[k];
+    }
+  }
+  return sum;
+}
+
+/* split name in the prefix and name fields */
+static int set_name(ustar_header *h, const char *name)
+{
+  size_t n = strlen(name), k;
+
+  if (n <= sizeof(h->name)) {
+    memcpy(h->name, name, n);
+    return 0;
+  }
+  for (k=1; k<n-1; k++) {
+    if (name[k] != '/' || k > sizeof(h->prefix)) continue;
+    if (n-k-1 <= sizeof(h->name)) {
+      memcpy(h->prefix, name, k);
+      memcpy(h->name, name+k+1, n-k-1);
+      return 0;
+    }
+  }
+  return -1;
+}
+
+/* fields of the header, except the name */
+static void fill_header(ustar_header *h, uint64_t mode, uint64_t mtime,
+                        char typeflag, uint64_t size)
+{
+  long unused;
+
+  put_number(h->mode, sizeof(h->mode), mode);
+  put_number(h->uid, sizeof(h->uid), 0);
+  put_number(h->gid, sizeof(h->gid), 0);
+  put_number(h->size, sizeof(h->size), size);
+  put_number(h->mtime, sizeof(h->mtime), mtime);
+  h->typeflag = typeflag;
+  memcpy(h->magic, "ustar", 6);
+  memcpy(h->version, "00", 2);
+  snprintf(h->chksum, sizeof(h->chksum), "%06lo", checksum(h, &unused));
+  h->chksum[7] = ' ';
+}
+
+static int write_header(bundle *b, const char *name, const struct stat *st,
+                        char typeflag, uint64_t size)
+{
+  ustar_header h;
+  size_t n = strlen(name), lpadded;
+
+  memset(&h, 0, sizeof(h));
+  if (set_name(&h, name) != 0) {
+    /* GNU long name entry followed by the header with the truncated name */
+    if (n > BUNDLE_MAXNAME)
+      return fail(b, CBUNDLE_INVALID, "Name too long for the bundle:", name);
+    memcpy(h.name, "././@LongLink", 14);
+    fill_header(&h, 0, 0, 'L', (uint64_t)n+1);
+    lpadded = (n + BUNDLE_BLOCK) / BUNDLE_BLOCK * BUNDLE_BLOCK;
+    memset(b->buffer, 0, lpadded);
+    memcpy(b->buffer, name, n);
+    if (gzwrite(b->gz, &h, BUNDLE_BLOCK) != BUNDLE_BLOCK ||
+        gzwrite(b->gz, b->buffer, (unsigned)lpadded) != (int)lpadded)
+      return fail(b, CBUNDLE_IO_ERROR, "Cannot write the header of", name);
+    memset(&h, 0, sizeof(h));
+    memcpy(h.name, name, sizeof(h.name));
+  }
+  fill_header(&h, (uint64_t)(st->st_mode & 07777),
+              st->st_mtime > 0 ? (uint64_t)st->st_mtime : 0, typeflag, size);
+  if (gzwrite(b->gz, &h, BUNDLE_BLOCK) != BUNDLE_BLOCK)
+    return fail(b, CBUNDLE_IO_ERROR, "Cannot write the header of", name);
+  return CBUNDLE_SUCCESS;
+}
+
+static int pack_file(bundle *b, const char *path, const char *name, const struct stat *st)
+{
+  uint64_t left = (uint64_t)st->st_size;
+  size_t chunk;
+  ssize_t nr;
+  int fd, rc;
+
+  if ((fd = open(path, O_RDONLY)) < 0)
+    return fail(b, CBUNDLE_IO_ERROR, "Cannot open", path);
+  if ((rc = write_header(b, name, st, '0', left)) != CBUNDLE_SUCCESS) {
+    close(fd);
+    return rc;
+  }
+  while (left > 0) {
+    chunk = left < BUNDLE_BUFFER ? (size_t)left : BUNDLE_BUFFER;
+    nr = read(fd, b->buffer, chunk);
+    if (nr < 0 && errno == EINTR) continue;
+    if (nr <= 0) {
+      close(fd);
+      if (nr == 0) errno = EIO; /* the file has been truncated */
+      return fail(b, CBUNDLE_IO_ERROR, "Cannot read", path);
+    }
+    if (gzwrite(b->gz, b->buffer, (unsigned)nr) != (int)nr) {
+      close(fd);
+      return fail(b, CBUNDLE_IO_ERROR, "Cannot write the content of", name);
+    }
+    left -= (uint64_t)nr;
+  }
+  close(fd);
+  /* padding of the last block */
+  chunk = (size_t)((uint64_t)st->st_size % BUNDLE_BLOCK);
+  if (chunk > 0) {
+    memset(b->buffer, 0, BUNDLE_BLOCK);
+    if (gzwrite(b->gz, b->buffer, BUNDLE_BLOCK - chunk) != (int)(BUNDLE_BLOCK - chunk))
+      return fail(b, CBUNDLE_IO_ERROR, "Cannot write the content of", name);
+  }
+  b->stats.files++;
+  b->stats.bytes += (uint64_t)st->st_size;
+  return CBUNDLE_SUCCESS;
+}
+
+static int pack(bundle *b, const char *path, const char *name, int depth)
+{
+  struct stat st;
+  struct dirent *e;
+  DIR *d;
+  char *s, *t, *dname;
+  int rc = CBUNDLE_SUCCESS;
+
+  if (stat(path, &st) != 0)
+    return fail(b, CBUNDLE_IO_ERROR, "Cannot read", path);
+
+  if (S_ISREG(st.st_mode))
+    return pack_file(b, path, name, &st);
+  if (!S_ISDIR(st.st_mode))
+    return CBUNDLE_SUCCESS; /* devices, sockets and pipes */
+
+  if (depth > BUNDLE_MAXDEPTH) {
+    errno = ELOOP;
+    return fail(b, CBUNDLE_IO_ERROR, "Cannot read", path);
+  }
+  if ((dname = (char *)malloc(strlen(name)+2)) == NULL) return CBUNDLE_OUT_OF_MEMORY;
+  strcpy(dname, name);
+  strcat(dname, "/");
+  rc = write_header(b, dname, &st, '5', 0);
+  free(dname);
+  if (rc != CBUNDLE_SUCCESS) return rc;
+  b->stats.directories++;
+
+  if ((d = opendir(path)) == NULL)
+    return fail(b, CBUNDLE_IO_ERROR, "Cannot read", path);
+  while ((e = readdir(d)) != NULL) {
+    if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0) continue;
+    s = join(path, e->d_name);
+    t = join(name, e->d_name);
+    rc = (s && t) ? pack(b, s, t, depth+1) : CBUNDLE_OUT_OF_MEMORY;
+    free(s); free(t);
+    if (rc != CBUNDLE_SUCCESS) break;
+  }
+  closedir(d);
+  return rc;
+}
+
+/* name of a path given to cbundle_pack, without "./" and trailing '/' */
+static char *entry_name(const char *path)
+{
+  char *name;
+  size_t n;
+
+  while (path[0] == '.' && path[1] == '/') path += 2;
+  n = strlen(path);
+  while (n > 1 && path[n-1] == '/') n--;
+  if ((name = (char *)malloc(n+1)) == NULL) return NULL;
+  memcpy(name, path, n);
+  name[n] = '\0';
+  return name;
+}
+
+int cbundle_pack(const char *archive, const char *root,
+                 const char *const *paths, int npaths, int level,
+                 cbundle_stats *stats, char *message, size_t lmessage)
+{
+  bundle b;
+  struct stat st;
+  char mode[8], *name, *path;
+  int k, fd, rc = CBUNDLE_SUCCESS, tostdout;
+
+  if (message != NULL && lmessage > 0) message[0] = '\0';
+  if (archive == NULL || root == NULL || npaths < 0 || (npaths > 0 && paths == NULL) ||
+      level < 0 || level > 9)
+    return CBUNDLE_INVALID;
+  memset(&b, 0, sizeof(b));
+  b.message = message;
+  b.lmessage = lmessage;
+  for (k=0; k<npaths; k++)
+    if (paths[k] == NULL || !safe_name(paths[k]))
+      return fail(&b, CBUNDLE_INVALID, "Not a relative path:", paths[k] ? paths[k] : "");
+
+  if ((b.buffer = (char *)malloc(BUNDLE_BUFFER)) == NULL) return CBUNDLE_OUT_OF_MEMORY;
+  snprintf(mode, sizeof(mode), "wb%d", level > 0 ? level : 6);
+  tostdout = strcmp(archive, "-") == 0;
+  if (tostdout) {
+    fd = dup(STDOUT_FILENO);
+    b.gz = fd < 0 ? NULL : gzdopen(fd, mode);
+    if (b.gz == NULL && fd >= 0) close(fd);
+  } else {
+    b.gz = gzopen(archive, mode);
+  }
+  if (b.gz == NULL) {
+    free(b.buffer);
+    return fail(&b, CBUNDLE_IO_ERROR, "Cannot create the bundle", archive);
+  }
+  gzbuffer(b.gz, BUNDLE_BUFFER);
+
+  for (k=0; k<npaths && rc == CBUNDLE_SUCCESS; k++) {
+    name = entry_name(paths[k]);
+    path = name ? join(root, name) : NULL;
+    if (path == NULL)
+      rc = CBUNDLE_OUT_OF_MEMORY;
+    else if (stat(path, &st) != 0 && errno == ENOENT)
+      b.stats.missing++;
+    else
+      rc = pack(&b, path, name, 0);
+    free(name); free(path);
+  }
+
+  /* end of the archive: two empty blocks */
+  if (rc == CBUNDLE_SUCCESS) {
+    memset(b.buffer, 0, 2*BUNDLE_BLOCK);
+    if (gzwrite(b.gz, b.buffer, 2*BUNDLE_BLOCK) != 2*BUNDLE_BLOCK)
+      rc = fail(&b, CBUNDLE_IO_ERROR, "Cannot write the bundle", archive);
+  }
+  if (gzclose(b.gz) != Z_OK && rc == CBUNDLE_SUCCESS)
+    rc = fail(&b, CBUNDLE_IO_ERROR, "Cannot write the bundle", archive);
+  free(b.buffer);
+  if (rc != CBUNDLE_SUCCESS && !tostdout) unlink(archive);
+  if (stats != NULL) *stats = b.stats;
+  return rc;
+}
+
+/* read n bytes of the bundle and write them in fd (discarded if fd < 0) */
+static int read_data(bundle *b, uint64_t n, int fd, const char *name)
+{
+  size_t chunk;
+  ssize_t nw;
+  int nr, k;
+
+  while (n > 0) {
+    chunk = n < BUNDLE_BUFFER ? (size_t)n : BUNDLE_BUFFER;
+    nr = gzread(b->gz, b->buffer, (unsigned)chunk);
+    if (nr != (int)chunk)
+      return fail(b, CBUNDLE_FORMAT_ERROR, "Truncated or corrupt bundle at", name);
+    for (k=0; fd >= 0 && k<nr; k+=(int)nw) {
+      if ((nw = write(fd, b->buffer+k, (size_t)(nr-k))) < 0) {
+        if (errno == EINTR) { nw = 0; continue; }
+        return fail(b, CBUNDLE_IO_ERROR, "Cannot write", name);
+      }
+    }
+    n -= chunk;
+  }
+  return CBUNDLE_SUCCESS;
+}
+
+static int unpack_file(bundle *b, const char *path, const char *name,
+                       uint64_t mode, uint64_t mtime, uint64_t size)
+{
+  struct stat st;
+  struct timespec times[2];
+  int fd, rc;
+
+  if (make_dirs(path, 1) != 0)
+    return fail(b, CBUNDLE_IO_ERROR, "Cannot create the folder of", path);
+  /* replace the file (never write through an existing link) */
+  if (lstat(path, &st) == 0) {
+    if (S_ISDIR(st.st_mode)) {
+      errno = EISDIR;
+      return fail(b, CBUNDLE_IO_ERROR, "Cannot create", path);
+    }
+    if (unlink(path) != 0) return fail(b, CBUNDLE_IO_ERROR, "Cannot replace", path);
+  }
+  if ((fd = open(path, O_WRONLY|O_CREAT|O_EXCL, (mode_t)(mode & 07777))) < 0)
+    return fail(b, CBUNDLE_IO_ERROR, "Cannot create", path);
+  rc = read_data(b, size, fd, name);
+  if (rc == CBUNDLE_SUCCESS) {
+    times[0].tv_sec = times[1].tv_sec = (time_t)mtime;
+    times[0].tv_nsec = times[1].tv_nsec = 0;
+    futimens(fd, times);
+  }
+  if (close(fd) != 0 && rc == CBUNDLE_SUCCESS)
+    rc = fail(b, CBUNDLE_IO_ERROR, "Cannot write", path);
+  if (rc == CBUNDLE_SUCCESS) {
+    b->stats.files++;
+    b->stats.bytes += size;
+  }
+  return rc;
+}
+
+/*
+ * records "length keyword=value\n" of a pax extended header: the path and
+ * the size of the next entry. Returns -1 if the header is corrupt.
+ */
+static int pax_records(const char *p, size_t n, char *name, int *lname,
+                       uint64_t *size, int *lsize)
+{
+  const char *end = p + n, *e, *v;
+  uint64_t len;
+
+  while (p < end && *p != '\0') {
+    for (len=0, e=p; e < end && *e >= '0' && *e <= '9' && len <= n; e++)
+      len = 10*len + (uint64_t)(*e - '0');
+    if (e == p || e >= end || *e != ' ' || len > (uint64_t)(end - p) ||
+        len < (uint64_t)(e - p) + 2 || p[len-1] != '\n')
+      return -1;
+    v = e + 1;       /* keyword=value */
+    e = p + len - 1; /* newline */
+    if (e - v > 5 && memcmp(v, "path=", 5) == 0) {
+      if (e - v - 5 > BUNDLE_MAXNAME) return -1;
+      memcpy(name, v + 5, (size_t)(e - v - 5));
+      name[e - v - 5] = '\0';
+      *lname = 1;
+    } else if (e - v > 5 && memcmp(v, "size=", 5) == 0) {
+      for (*size=0, v+=5; v < e && *v >= '0' && *v <= '9'; v++)
+        *size = 10*(*size) + (uint64_t)(*v - '0');
+      if (v != e) return -1;
+      *lsize = 1;
+    }
+    p += len;
+  }
+  return 0;
+}
+
+int cbundle_unpack(const char *archive, const char *root,
+                   cbundle_stats *stats, char *message, size_t lmessage)
+{
+  bundle b;
+  ustar_header h;
+  char name[BUNDLE_MAXNAME + 1], *path;
+  uint64_t size, skip, mode, mtime, value, paxsize = 0;
+  unsigned long sum;
+  long signed_sum;
+  size_t n;
+  int fd, nr, longname = 0, lpaxsize = 0, rc = CBUNDLE_SUCCESS;
+
+  if (message != NULL && lmessage > 0) message[0] = '\0';
+  if (archive == NULL || root == NULL) return CBUNDLE_INVALID;
+  memset(&b, 0, sizeof(b));
+  b.message = message;
+  b.lmessage = lmessage;
+
+  if (make_dirs(root, 0) != 0)
+    return fail(&b, CBUNDLE_IO_ERROR, "Cannot create the folder", root);
+  if ((b.buffer = (char *)malloc(BUNDLE_BUFFER)) == NULL) return CBUNDLE_OUT_OF_MEMORY;
+  if (strcmp(archive, "-") == 0) {
+    fd = dup(STDIN_FILENO);
+    b.gz = fd < 0 ? NULL : gzdopen(fd, "rb");
+    if (b.gz == NULL && fd >= 0) close(fd);
+  } else {
+    b.gz = gzopen(archive, "rb");
+  }
+  if (b.gz == NULL) {
+    free(b.buffer);
+    return fail(&b, CBUNDLE_IO_ERROR, "Cannot open the bundle", archive);
+  }
+  gzbuffer(b.gz, BUNDLE_BUFFER);
+
+  for (;;) {
+    nr = gzread(b.gz, &h, BUNDLE_BLOCK);
+    if (nr != BUNDLE_BLOCK) {
+      rc = fail(&b, CBUNDLE_FORMAT_ERROR, "Truncated or corrupt bundle", archive);
+      break;
+    }
+    /* end of the archive */
+    for (n=0; n<BUNDLE_BLOCK && ((const char *)&h)[n] == '\0'; n++) ;
+    if (n == BUNDLE_BLOCK) break;
+
+    sum = checksum(&h, &signed_sum);
+    if (memcmp(h.magic, "ustar", 5) != 0 || get_number(h.chksum, sizeof(h.chksum), &value) != 0 ||
+        (value != sum && (long)value != signed_sum) ||
+        get_number(h.size, sizeof(h.size), &size) != 0 ||
+        get_number(h.mode, sizeof(h.mode), &mode) != 0 ||
+        get_number(h.mtime, sizeof(h.mtime), &mtime) != 0) {
+      rc = fail(&b, CBUNDLE_FORMAT_ERROR, "Not a bundle or corrupt header in", archive);
+      break;
+    }
+    if (lpaxsize && h.typeflag != 'x' && h.typeflag != 'g') {
+      size = paxsize;
+      lpaxsize = 0;
+    }
+    /* content of the entry and padding of its last block */
+    skip = size + (BUNDLE_BLOCK - size % BUNDLE_BLOCK) % BUNDLE_BLOCK;
+
+    if (h.typeflag == 'x') {
+      /* pax extended header of the next entry */
+      if (skip > BUNDLE_BUFFER ||
+          gzread(b.gz, b.buffer, (unsigned)skip) != (int)skip ||
+          pax_records(b.buffer, (size_t)size, name, &longname, &paxsize, &lpaxsize) != 0) {
+        rc = fail(&b, CBUNDLE_FORMAT_ERROR, "Corrupt extended header in", archive);
+        break;
+      }
+      continue;
+    }
+
+    if (h.typeflag == 'L') {
+      /* GNU long name of the next entry */
+      if (size < 1 || size > BUNDLE_MAXNAME ||
+          gzread(b.gz, b.buffer, (unsigned)skip) != (int)skip) {
+        rc = fail(&b, CBUNDLE_FORMAT_ERROR, "Corrupt long name in", archive);
+        break;
+      }
+      memcpy(name, b.buffer, (size_t)size);
+      name[size] = '\0';
+      longname = 1;
+      continue;
+    }
+    if (!longname) {
+      n = 0;
+      if (h.prefix[0] != '\0') {
+        n = strnlen(h.prefix, sizeof(h.prefix));
+        memcpy(name, h.prefix, n);
+        name[n++] = '/';
+      }
+      nr = (int)strnlen(h.name, sizeof(h.name));
+      memcpy(name+n, h.name, (size_t)nr);
+      name[n+(size_t)nr] = '\0';
+    }
+    longname = 0;
+    n = strlen(name);
+    while (n > 1 && name[n-1] == '/') name[--n] = '\0';
+
+    switch (h.typeflag) {
+    case '0': case '\0': case '7':
+    case '5':
+      if (!safe_name(name)) {
+        rc = fail(&b, CBUNDLE_FORMAT_ERROR, "Unsafe name in the bundle:", name);
+        break;
+      }
+      if ((path = join(root, name)) == NULL) {
+        rc = CBUNDLE_OUT_OF_MEMORY;
+        break;
+      }
+      if (h.typeflag != '5') {
+        rc = unpack_file(&b, path, name, mode, mtime, size);
+        skip -= size;
+      } else if (make_dirs(path, 0) != 0) {
+        rc = fail(&b, CBUNDLE_IO_ERROR, "Cannot create the folder", path);
+      } else {
+        b.stats.directories++;
+      }
+      free(path);
+      break;
+    default:
+      /* links and global extended headers are ignored */
+      break;
+    }
+    if (rc != CBUNDLE_SUCCESS) break;
+    if ((rc = read_data(&b, skip, -1, name)) != CBUNDLE_SUCCESS) break;
+  }
+
+  gzclose(b.gz);
+  free(b.buffer);
+  if (stats != NULL) *stats = b.stats;
+  return rc;
+}
+
+#else /* _WIN32 */
+
+int cbundle_pack(const char *archive, const char *root,
+                 const char *const *paths, int npaths, int level,
+                 cbundle_stats *stats, char *message, size_t lmessage)
+{
+  (void)archive; (void)root; (void)paths; (void)npaths; (void)level;
+  if (stats != NULL) memset(stats, 0, sizeof(*stats));
+  if (message != NULL && lmessage > 0)
+    snprintf(message, lmessage, "Bundles are not supported on this system");
+  return CBUNDLE_INVALID;
+}
+
+int cbundle_unpack(const char *archive, const char *root,
+                   cbundle_stats *stats, char *message, size_t lmessage)
+{
+  (void)archive; (void)root;
+  if (stats != NULL) memset(stats, 0, sizeof(*stats));
+  if (message != NULL && lmessage > 0)
+    snprintf(message, lmessage, "Bundles are not supported on this system");
+  return CBUNDLE_INVALID;
+}
+
+#endif
+
+const char *cbundle_rc_string(int rc)
+{
+  switch (rc) {
+  case CBUNDLE_SUCCESS:       return "Success";
+  case CBUNDLE_INVALID:       return "Invalid arguments or unsupported system";
+  case CBUNDLE_OUT_OF_MEMORY: return "Out of memory";
+  case CBUNDLE_IO_ERROR:      return "Input/output error";
+  case CBUNDLE_FORMAT_ERROR:  return "Not a bundle or corrupt bundle";
+  default:                    return "Unknown error";
+  }
+}
@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * cossan_bundle.h: compressed bundles of the folders of the simulations
+ *
+ * A bundle packs many folders (e.g. the input decks of all the jobs of a
+ * batch, or their results) in a single gzip compressed tar stream (ustar
+ * format), so that they are moved to or from a remote host with one
+ * transfer instead of one transfer per file. The bundle is unpacked by
+ * the same code (mex file bundlex or program cossanbundle) or, if that is
+ * not available on the remote host, by tar -xzf.
+ *
+ * Regular files and directories are packed with their permissions and
+ * modification time; symbolic links are followed (the staged files of a
+ * working directory can be links to the original files). Unpacking
+ * rejects absolute names and names containing "..", and ignores the
+ * other types of entries.
+ *
+ * Bundles are available on POSIX systems only.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _COSSAN_BUNDLE_H
+#define _COSSAN_BUNDLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Possible return values of the functions
+ */
+typedef enum {
+  CBUNDLE_FORMAT_ERROR  = -4, /* not a bundle, corrupt or unsafe entry */
+  CBUNDLE_IO_ERROR      = -3, /* a file cannot be read or written */
+  CBUNDLE_OUT_OF_MEMORY = -2, /* memory allocation failed */
+  CBUNDLE_INVALID       = -1, /* invalid argument or unsupported system */
+  CBUNDLE_SUCCESS       =  0
+} cbundle_result;
+
+/* content of a bundle */
+typedef struct {
+  uint64_t files;       /* regular files */
+  uint64_t directories; /* directories */
+  uint64_t bytes;       /* bytes of the regular files */
+  uint64_t missing;     /* paths not found (pack only) */
+} cbundle_stats;
+
+/*
+ * Pack the npaths paths (files or folders, relative to root) in the
+ * bundle archive ("-": standard output) with the compression level (1-9,
+ * 0: default). The folders are packed recursively; the missing paths are
+ * skipped and counted in stats (can be NULL). On error a description is
+ * written in message.
+ */
+int cbundle_pack(const char *archive, const char *root,
+                 const char *const *paths, int npaths, int level,
+                 cbundle_stats *stats, char *message, size_t lmessage);
+
+/*
+ * Unpack the bundle archive ("-": standard input) in the folder root,
+ * which is created if necessary. Existing files are replaced.
+ */
+int cbundle_unpack(const char *archive, const char *root,
+                   cbundle_stats *stats, char *message, size_t lmessage);
+
+/* description of a return value */
+const char *cbundle_rc_string(int rc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_BUNDLE_H */
@@ -0,0 +1,271 @@
+/*******************************************************************************
+ * cossan_bundle_check: pack/unpack round trip of the bundles
+ *
+ * Standalone program (no matlab required) that packs a folder with short
+ * names, names split in the prefix field, GNU long names, an empty file
+ * and a file larger than the buffers, unpacks it in another folder and
+ * compares the content. It also checks that the missing paths are
+ * counted, that the ".." and absolute names are refused by pack and by
+ * unpack, and that the path records of the pax extended headers (tar
+ * --format=pax) are read. The program returns a non-zero exit status when
+ * a check fails.
+ *
+ * Compile and run with (see Makefile):
+ *
+ *   make check
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ftw.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <zlib.h>
+#include "cossan_bundle.h"
+
+#define NFILES 5
+
+static char top[64], src[128], dst[128];
+static char *names[NFILES];
+static size_t sizes[NFILES] = {6, 0, 200000, 1000, 513};
+static int nfailed = 0;
+
+static void check(int ok, const char *what)
+{
+  printf("%-60s %s\n", what, ok ? "ok" : "FAILED");
+  if (!ok) nfailed++;
+}
+
+static char *repeat(char c, size_t n, const char *tail)
+{
+  char *s = (char *)malloc(n + strlen(tail) + 1);
+  memset(s, c, n);
+  strcpy(s + n, tail);
+  return s;
+}
+
+/* content of the file k: deterministic bytes */
+static unsigned char byte(int k, size_t i)
+{
+  return (unsigned char)((i * 2654435761u + (unsigned)k * 40503u) >> 13);
+}
+
+static int write_file(const char *root, int k)
+{
+  char path[8192];
+  FILE *f;
+  size_t i;
+
+  snprintf(path, sizeof(path), "%s/%s", root, names[k]);
+  for (i=strlen(root)+1; path[i]; i++) {
+    if (path[i] != '/') continue;
+    path[i] = '\0';
+    mkdir(path, 0777);
+    path[i] = '/';
+  }
+  if ((f = fopen(path, "wb")) == NULL) return -1;
+  for (i=0; i<sizes[k]; i++) fputc(byte(k, i), f);
+  return fclose(f);
+}
+
+static int same_file(const char *root, int k)
+{
+  char path[8192];
+  FILE *f;
+  size_t i;
+  int c, ok = 1;
+
+  snprintf(path, sizeof(path), "%s/%s", root, names[k]);
+  if ((f = fopen(path, "rb")) == NULL) return 0;
+  for (i=0; ok && (c = fgetc(f)) != EOF; i++)
+    ok = i < sizes[k] && (unsigned char)c == byte(k, i);
+  fclose(f);
+  return ok && i == sizes[k];
+}
+
+static int exists(const char *root, const char *name)
+{
+  char path[8192];
+  struct stat st;
+
+  snprintf(path, sizeof(path), "%s/%s", root, name);
+  return lstat(path, &st) == 0;
+}
+
+/* ustar header written by other programs */
+static void header(char *h, const char *name, char typeflag, size_t size)
+{
+  unsigned long sum = 0;
+  size_t n = strlen(name);
+  int k;
+
+  memset(h, 0, 512);
+  memcpy(h, name, n < 100 ? n : 100);
+  sprintf(h+100, "%07o", 0644);
+  sprintf(h+108, "%07o", 0);
+  sprintf(h+116, "%07o", 0);
+  sprintf(h+124, "%011lo", (unsigned long)size);
+  sprintf(h+136, "%011o", 0);
+  h[156] = typeflag;
+  memcpy(h+257, "ustar", 6);
+  memcpy(h+263, "00", 2);
+  memset(h+148, ' ', 8);
+  for (k=0; k<512; k++) sum += (unsigned char)h[k];
+  sprintf(h+148, "%06lo", sum);
+  h[155] = ' ';
+}
+
+/* entry of a file with content, padded to the blocks */
+static void write_entry(gzFile gz, const char *name, char typeflag,
+                        const char *data, size_t size)
+{
+  char h[512], pad[512] = {0};
+
+  header(h, name, typeflag, size);
+  gzwrite(gz, h, 512);
+  if (size > 0) gzwrite(gz, data, (unsigned)size);
+  if (size % 512) gzwrite(gz, pad, (unsigned)(512 - size % 512));
+}
+
+/* bundle of a single file named name, preceded by a pax path record */
+static void write_bundle(const char *archive, const char *name, int pax)
+{
+  char record[8192], end[1024] = {0};
+  size_t n, len;
+  gzFile gz = gzopen(archive, "wb");
+
+  if (pax) {
+    /* "length path=name\n", the length includes its own digits */
+    n = strlen(" path=\n") + strlen(name);
+    for (len=n+1; snprintf(NULL, 0, "%lu", (unsigned long)len) + n != len; len++) ;
+    snprintf(record, sizeof(record), "%lu path=%s\n", (unsigned long)len, name);
+    write_entry(gz, "PaxHeaders/x", 'x', record, len);
+  }
+  write_entry(gz, name, '0', "pax\n", 4);
+  gzwrite(gz, end, sizeof(end));
+  gzclose(gz);
+}
+
+static int remove_entry(const char *path, const struct stat *st, int flag, struct FTW *ftw)
+{
+  (void)st; (void)flag; (void)ftw;
+  return remove(path);
+}
+
+int main(void)
+{
+  cbundle_stats stats;
+  char archive[256], message[512], longpax[300];
+  const char *paths[NFILES+3], *bad[1];
+  int k, rc;
+
+  strcpy(top, "/tmp/cossan_bundle_XXXXXX");
+  if (mkdtemp(top) == NULL) {
+    printf("FAILED: cannot create a temporary folder\n");
+    return 1;
+  }
+  snprintf(src, sizeof(src), "%s/src", top);
+  snprintf(dst, sizeof(dst), "%s/dst", top);
+  snprintf(archive, sizeof(archive), "%s/bundle.tgz", top);
+  mkdir(src, 0777);
+
+  /* short name, empty file, large file, name split in the prefix field,
+     name longer than the prefix and name fields (GNU long name) */
+  names[0] = repeat('a', 3, ".txt");
+  names[1] = repeat('e', 5, "");
+  names[2] = repeat('s', 3, "/large.bin");
+  names[3] = repeat('p', 80, "/0123456789012345678901234567890123456789012345678901234567890");
+  names[4] = repeat('l', 150, "/01234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789");
+  for (k=0; k<NFILES; k++)
+    if (write_file(src, k) != 0) {
+      printf("FAILED: cannot write %s\n", names[k]);
+      return 1;
+    }
+
+  /* round trip, with a missing path and names given as "./name" and "name/" */
+  paths[0] = "./aaa.txt";
+  paths[1] = names[1];
+  paths[2] = "sss/";
+  paths[3] = names[3];
+  paths[4] = repeat('l', 150, "");
+  paths[5] = "missing";
+  rc = cbundle_pack(archive, src, paths, 6, 0, &stats, message, sizeof(message));
+  check(rc == CBUNDLE_SUCCESS, "pack");
+  check(stats.files == NFILES && stats.missing == 1, "pack: files and missing paths");
+  rc = cbundle_unpack(archive, dst, &stats, message, sizeof(message));
+  check(rc == CBUNDLE_SUCCESS, "unpack");
+  check(stats.files == NFILES, "unpack: files");
+  for (k=0; k<NFILES; k++) {
+    char what[64];
+    snprintf(what, sizeof(what), "round trip of the file %d (%lu bytes, name of %lu)",
+      k+1, (unsigned long)sizes[k], (unsigned long)strlen(names[k]));
+    check(same_file(dst, k), what);
+  }
+
+  /* unsafe paths refused by pack */
+  bad[0] = "../src";
+  rc = cbundle_pack(archive, src, bad, 1, 0, &stats, message, sizeof(message));
+  check(rc == CBUNDLE_INVALID, "pack: .. refused");
+  bad[0] = "/etc";
+  rc = cbundle_pack(archive, src, bad, 1, 0, &stats, message, sizeof(message));
+  check(rc == CBUNDLE_INVALID, "pack: absolute path refused");
+
+  /* unsafe names refused by unpack */
+  write_bundle(archive, "../evil.txt", 0);
+  rc = cbundle_unpack(archive, dst, &stats, message, sizeof(message));
+  check(rc == CBUNDLE_FORMAT_ERROR && !exists(top, "evil.txt"), "unpack: .. refused");
+  write_bundle(archive, "a/../../evil.txt", 0);
+  rc = cbundle_unpack(archive, dst, &stats, message, sizeof(message));
+  check(rc == CBUNDLE_FORMAT_ERROR && !exists(top, "evil.txt"), "unpack: inner .. refused");
+  snprintf(message, sizeof(message), "%s/evil.txt", top);
+  write_bundle(archive, message, 0);
+  rc = cbundle_unpack(archive, dst, &stats, message, sizeof(message));
+  check(rc == CBUNDLE_FORMAT_ERROR && !exists(top, "evil.txt"), "unpack: absolute name refused");
+  write_bundle(archive, "../evil.txt", 1);
+  rc = cbundle_unpack(archive, dst, &stats, message, sizeof(message));
+  check(rc == CBUNDLE_FORMAT_ERROR && !exists(top, "evil.txt"), "unpack: .. of a pax path refused");
+
+  /* pax path longer than 100 characters */
+  memset(longpax, 'x', 120);
+  longpax[120] = '/';
+  memset(longpax+121, 'y', 150);
+  strcpy(longpax+271, ".txt");
+  write_bundle(archive, longpax, 1);
+  rc = cbundle_unpack(archive, dst, &stats, message, sizeof(message));
+  check(rc == CBUNDLE_SUCCESS && exists(dst, longpax), "unpack: pax path");
+
+  nftw(top, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+  for (k=0; k<NFILES; k++) free(names[k]);
+  free((char *)paths[4]);
+  if (nfailed > 0) {
+    printf("FAILED: %d checks\n", nfailed);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * cossanbundle: pack and unpack the bundles of the simulation folders
+ *
+ * Program executed on the remote host by the bundled transfer of the
+ * Connector (see cossan_bundle.h):
+ *
+ *   cossanbundle pack [-1..-9] Sbundle Sroot Spath [Spath ...]
+ *   cossanbundle unpack Sbundle Sroot
+ *
+ * pack writes the paths (relative to Sroot, missing paths are skipped) in
+ * the bundle Sbundle; unpack extracts Sbundle in the folder Sroot. A
+ * bundle named "-" is written to the standard output or read from the
+ * standard input. The number of files and bytes is written to the
+ * standard error.
+ *
+ * Compile (see makeBundle.m):
+ *   gcc -O2 cossanbundle.c cossan_bundle.c -lz -o cossanbundle
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include "cossan_bundle.h"
+
+static int usage(void)
+{
+  fprintf(stderr, "usage: cossanbundle pack [-1..-9] bundle root path [path ...]\n"
+                  "       cossanbundle unpack bundle root\n");
+  return 2;
+}
+
+int main(int argc, char *argv[])
+{
+  cbundle_stats stats;
+  char message[512];
+  int rc, level = 0, first = 2;
+
+  if (argc < 2) return usage();
+
+  if (strcmp(argv[1], "pack") == 0) {
+    if (argc > 2 && argv[2][0] == '-' && argv[2][1] >= '1' && argv[2][1] <= '9' &&
+        argv[2][2] == '\0') {
+      level = argv[2][1] - '0';
+      first = 3;
+    }
+    if (argc < first + 3) return usage();
+    rc = cbundle_pack(argv[first], argv[first+1], (const char *const *)(argv + first + 2),
+                      argc - first - 2, level, &stats, message, sizeof(message));
+  } else if (strcmp(argv[1], "unpack") == 0) {
+    if (argc != 4) return usage();
+    rc = cbundle_unpack(argv[2], argv[3], &stats, message, sizeof(message));
+  } else {
+    return usage();
+  }
+
+  if (rc != CBUNDLE_SUCCESS) {
+    fprintf(stderr, "cossanbundle: %s\n", message[0] ? message : cbundle_rc_string(rc));
+    return 1;
+  }
+  fprintf(stderr, "cossanbundle: %llu files, %llu folders, %llu bytes",
+          (unsigned long long)stats.files, (unsigned long long)stats.directories,
+          (unsigned long long)stats.bytes);
+  if (stats.missing > 0)
+    fprintf(stderr, ", %llu missing paths", (unsigned long long)stats.missing);
+  fprintf(stderr, "\n");
+  return 0;
+}
@@ -0,0 +1,41 @@
+% Script to generate the mex file of the compressed bundles of the
+% simulation folders (see cossan_bundle.h) and the program cossanbundle,
+% used on the remote host by the bundled transfer of the Connector
+% (LbundledTransfer). Available on POSIX systems only; requires zlib.
+
+disp('Compiling the bundle mex files ..');
+
+assert(~isempty(OpenCossan.getCossanRoot),'openCOSSAN:makeBundle','Please initialize OpenCossan')
+
+% mex of the bundles (Connector.runJobRemoteInjectExtractSSH)
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" bundlex.c cossan_bundle.c -lz
+
+% List of created mex files
+r=dir('*.mex*');
+
+Spath=fullfile(OpenCossan.getCossanRoot,'mex','bin');
+
+
+for n=1:length(r)
+    % Move the compiled file in the appropriate folder
+    [status,message,messageid]=movefile(r(n).name,Spath,'f');
+
+    if status
+        disp(['MEX FILE ' r(n).name ' created and moved in ' Spath ]);
+    else
+        disp(message);
+        disp(messageid);
+    end
+end
+
+% cossanbundle is executed on the remote host: it must be compiled there
+% with the same command and copied next to the compiled Connector wrapper
+% (SconnectorRelativePath of the remote external path). Without it the
+% bundles are unpacked with tar.
+[status,message]=system(['gcc -std=c99 -D_GNU_SOURCE -D_FILE_OFFSET_BITS=64 -O2 ' ...
+    'cossanbundle.c cossan_bundle.c -lz -o ' fullfile(Spath,'cossanbundle')]);
+if status==0
+    disp(['PROGRAM cossanbundle created in ' Spath ]);
+else
+    disp(message);
+end
@@ -0,0 +1,240 @@
+/*******************************************************************************
+ * cachex: persistent evaluation cache of the Evaluator - matlab MEX
+ *
+ * Content-addressed cache of the outputs of the model evaluations in a
+ * memory mapped file (see cossan_cache.h). One cache file is open at a
+ * time; it is closed by 'close', by the 'open' of another file or when
+ * the mex file is cleared.
+ *
+ * usage:
+ *   cachex('open',Sfile,Nentries,NmaxOutputs)
+ *   [Lfound,Moutputs] = cachex('lookup',Vmodel,Minputs,Noutputs)
+ *   cachex('insert',Vmodel,Minputs,Moutputs)
+ *   Tstats = cachex('stats')
+ *   cachex('clear')
+ *   cachex('close')
+ * where
+ *   Sfile       : cache file (created if it does not exist)
+ *   Nentries    : capacity of a new cache (number of samples)
+ *   NmaxOutputs : maximum number of outputs of the samples of a new cache
+ *   Vmodel      : definition of the model (uint8 array, e.g. serialized
+ *                 object), part of the key of the samples
+ *   Minputs     : values of the inputs, one row per sample
+ *   Lfound      : true for the samples in the cache
+ *   Moutputs    : values of the outputs, one row per sample (NaN for the
+ *                 samples not found)
+ *   Tstats      : statistics of the cache (Nhits, Nmisses, Ninserts,
+ *                 Nevictions, Nentries, Ncapacity, NmaxOutputs) and of
+ *                 the lookups of this session (NsessionHits,
+ *                 NsessionMisses)
+ *
+ * 'clear' removes all the entries of the cache file.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+#include "cossan_cache.h"
+
+static ccache *cache = NULL;
+static char *cache_file = NULL;
+static double session_hits = 0, session_misses = 0;
+
+static void close_cache(void)
+{
+    ccache_close(cache);
+    cache = NULL;
+    free(cache_file);
+    cache_file = NULL;
+}
+
+static void check_rc(int rc)
+{
+    switch (rc) {
+    case CCACHE_FILE_ERROR:
+        mexErrMsgIdAndTxt("openCOSSAN:cachex:fileError", "Cannot access the cache file");
+        break;
+    case CCACHE_OUT_OF_MEMORY:
+        mexErrMsgIdAndTxt("openCOSSAN:cachex", "Out of memory");
+        break;
+    case CCACHE_INVALID:
+        mexErrMsgIdAndTxt("openCOSSAN:cachex", "Invalid arguments or unsupported system");
+        break;
+    }
+}
+
+static const double *get_matrix(const mxArray *M, int k)
+{
+    if (!mxIsDouble(M) || mxIsComplex(M) || mxIsSparse(M))
+        mexErrMsgIdAndTxt("openCOSSAN:cachex", "Argument %d must be a real matrix", k+1);
+    return mxGetPr(M);
+}
+
+static double get_scalar(int nrhs, const mxArray *prhs[], int k, double value)
+{
+    if (nrhs <= k || mxIsEmpty(prhs[k]))
+        return value;
+    if (!mxIsNumeric(prhs[k]) || mxGetNumberOfElements(prhs[k]) != 1)
+        mexErrMsgIdAndTxt("openCOSSAN:cachex", "Argument %d must be a scalar", k+1);
+    return mxGetScalar(prhs[k]);
+}
+
+/* hash of the definition of the model */
+static void get_model(const mxArray *Vmodel, uint64_t hmodel[2])
+{
+    if (!mxIsUint8(Vmodel))
+        mexErrMsgIdAndTxt("openCOSSAN:cachex", "The definition of the model must be a uint8 array");
+    ccache_model(mxGetData(Vmodel), mxGetNumberOfElements(Vmodel), hmodel);
+}
+
+static void set_field(mxArray *T, const char *name, double value)
+{
+    mxSetField(T, 0, name, mxCreateDoubleScalar(value));
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    static const char *CSstats[] = {"Nhits", "Nmisses", "Ninserts", "Nevictions",
+        "Nentries", "Ncapacity", "NmaxOutputs", "NsessionHits", "NsessionMisses"};
+    char Saction[16], message[512];
+    char *Sfile;
+    const double *Minputs, *Moutputs;
+    double *Mfound;
+    mxLogical *Lfound;
+    mwSize nsamples, ninputs, k, i;
+    uint64_t hmodel[2], key[2];
+    ccache_stats stats;
+    int noutputs, rc;
+
+    mexAtExit(close_cache);
+
+    if (nrhs < 1 || !mxIsChar(prhs[0]) || mxGetString(prhs[0], Saction, sizeof(Saction)) != 0)
+        mexErrMsgTxt("usage: cachex(Saction,...) ; (open, lookup, insert, stats, clear or close)");
+
+    if (strcmp(Saction, "close") == 0) {
+        close_cache();
+        return;
+    }
+
+    if (strcmp(Saction, "open") == 0) {
+        if (nrhs < 2 || nrhs > 4 || nlhs > 0 || !mxIsChar(prhs[1]))
+            mexErrMsgTxt("usage: cachex('open',Sfile,Nentries,NmaxOutputs) ;");
+        Sfile = mxArrayToString(prhs[1]);
+        if (cache_file != NULL && strcmp(cache_file, Sfile) == 0) {
+            mxFree(Sfile);
+            return;
+        }
+        close_cache();
+        message[0] = '\0';
+        rc = ccache_open(Sfile, (size_t)get_scalar(nrhs, prhs, 2, 262144),
+                         (int)get_scalar(nrhs, prhs, 3, 16), &cache, message, sizeof(message));
+        if (rc == CCACHE_SUCCESS && (cache_file = malloc(strlen(Sfile) + 1)) != NULL)
+            strcpy(cache_file, Sfile);
+        mxFree(Sfile);
+        if (rc != CCACHE_SUCCESS && message[0] != '\0')
+            mexErrMsgIdAndTxt(rc == CCACHE_FORMAT_ERROR ? "openCOSSAN:cachex:formatError" :
+                              "openCOSSAN:cachex:fileError", "%s", message);
+        check_rc(rc);
+        session_hits = session_misses = 0;
+        return;
+    }
+
+    if (cache == NULL)
+        mexErrMsgIdAndTxt("openCOSSAN:cachex", "The cache is not open");
+
+    if (strcmp(Saction, "lookup") == 0) {
+        if (nrhs != 4 || nlhs > 2)
+            mexErrMsgTxt("usage: [Lfound,Moutputs] = cachex('lookup',Vmodel,Minputs,Noutputs) ;");
+        get_model(prhs[1], hmodel);
+        Minputs = get_matrix(prhs[2], 2);
+        nsamples = mxGetM(prhs[2]);
+        ninputs = mxGetN(prhs[2]);
+        noutputs = (int)get_scalar(nrhs, prhs, 3, 0);
+        plhs[0] = mxCreateLogicalMatrix(nsamples, 1);
+        Lfound = mxGetLogicals(plhs[0]);
+        plhs[1] = mxCreateDoubleMatrix(nsamples, noutputs, mxREAL);
+        Mfound = mxGetPr(plhs[1]);
+        check_rc(ccache_lock(cache));
+        for (k=0; k<nsamples; k++) {
+            ccache_key(hmodel, Minputs+k, ninputs, nsamples, key);
+            Lfound[k] = ccache_lookup(cache, key, Mfound+k, nsamples, noutputs) == 1;
+            if (!Lfound[k])
+                for (i=0; i<(mwSize)noutputs; i++)
+                    Mfound[k + i*nsamples] = mxGetNaN();
+            if (Lfound[k])
+                session_hits++;
+            else
+                session_misses++;
+        }
+        check_rc(ccache_unlock(cache));
+
+    } else if (strcmp(Saction, "insert") == 0) {
+        if (nrhs != 4 || nlhs > 0)
+            mexErrMsgTxt("usage: cachex('insert',Vmodel,Minputs,Moutputs) ;");
+        get_model(prhs[1], hmodel);
+        Minputs = get_matrix(prhs[2], 2);
+        Moutputs = get_matrix(prhs[3], 3);
+        nsamples = mxGetM(prhs[2]);
+        ninputs = mxGetN(prhs[2]);
+        noutputs = (int)mxGetN(prhs[3]);
+        if (mxGetM(prhs[3]) != nsamples)
+            mexErrMsgIdAndTxt("openCOSSAN:cachex", "Minputs and Moutputs must have one row per sample");
+        ccache_get_stats(cache, &stats);
+        if (noutputs > stats.maxvalues)
+            mexErrMsgIdAndTxt("openCOSSAN:cachex",
+                "The cache stores at most %d outputs per sample", stats.maxvalues);
+        check_rc(ccache_lock(cache));
+        for (k=0; k<nsamples; k++) {
+            ccache_key(hmodel, Minputs+k, ninputs, nsamples, key);
+            ccache_insert(cache, key, Moutputs+k, nsamples, noutputs);
+        }
+        check_rc(ccache_unlock(cache));
+
+    } else if (strcmp(Saction, "stats") == 0) {
+        ccache_get_stats(cache, &stats);
+        plhs[0] = mxCreateStructMatrix(1, 1, 9, CSstats);
+        set_field(plhs[0], "Nhits", (double)stats.hits);
+        set_field(plhs[0], "Nmisses", (double)stats.misses);
+        set_field(plhs[0], "Ninserts", (double)stats.inserts);
+        set_field(plhs[0], "Nevictions", (double)stats.evictions);
+        set_field(plhs[0], "Nentries", (double)stats.entries);
+        set_field(plhs[0], "Ncapacity", (double)stats.capacity);
+        set_field(plhs[0], "NmaxOutputs", stats.maxvalues);
+        set_field(plhs[0], "NsessionHits", session_hits);
+        set_field(plhs[0], "NsessionMisses", session_misses);
+
+    } else if (strcmp(Saction, "clear") == 0) {
+        check_rc(ccache_lock(cache));
+        ccache_clear(cache);
+        check_rc(ccache_unlock(cache));
+        session_hits = session_misses = 0;
+
+    } else
+        mexErrMsgIdAndTxt("openCOSSAN:cachex", "Unknown action %s", Saction);
+}
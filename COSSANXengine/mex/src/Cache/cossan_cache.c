@@ -0,0 +1,368 @@
+/*******************************************************************************
+ * cossan_cache.c: persistent evaluation cache of the Evaluator (see
+ * cossan_cache.h)
+ *
+ * Layout of the file: a header of LHEADER bytes followed by nsets sets of
+ * CCACHE_WAYS slots. A slot holds the key, the time of its last use (value
+ * of a clock incremented at each access), the number of outputs and
+ * maxvalues outputs.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cossan_cache.h"
+
+#define ENDIAN_CHECK 0x01020304u
+#define MAX_VALUES   4096
+
+static uint64_t mix(uint64_t z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+/* two FNV-1a streams started from h */
+static void hash_bytes(const unsigned char *b, size_t n, uint64_t h[2])
+{
+  size_t i;
+  for (i=0; i<n; i++) {
+    h[0] = (h[0] ^ b[i]) * 1099511628211ull;
+    h[1] = (h[1] ^ b[i]) * 1099511628211ull;
+  }
+}
+
+void ccache_model(const void *model, size_t lmodel, uint64_t hmodel[2])
+{
+  hmodel[0] = 14695981039346656037ull;
+  hmodel[1] = 0x6c62272e07bb0142ull;
+  hash_bytes(model, lmodel, hmodel);
+  hmodel[0] = mix(hmodel[0]);
+  hmodel[1] = mix(hmodel[1] ^ hmodel[0]);
+}
+
+void ccache_key(const uint64_t hmodel[2], const double *x, size_t n,
+                size_t stride, uint64_t key[2])
+{
+  unsigned char b[8];
+  uint64_t u;
+  double v;
+  size_t i;
+  int k;
+
+  key[0] = hmodel[0];
+  key[1] = hmodel[1];
+  for (i=0; i<n; i++) {
+    v = x[i*stride];
+    if (v == 0)
+      u = 0;
+    else if (v != v)
+      u = 0x7ff8000000000000ull;
+    else
+      memcpy(&u, &v, sizeof(u));
+    for (k=0; k<8; k++)
+      b[k] = (unsigned char)(u >> (8*k));
+    hash_bytes(b, 8, key);
+  }
+  key[0] = mix(key[0] ^ (uint64_t)n);
+  key[1] = mix(key[1] ^ key[0]);
+}
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define LHEADER 4096 /* size of the header (one page) */
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t endian;
+  uint64_t nsets;
+  uint32_t maxvalues;
+  uint32_t lslot;
+  uint64_t clock;     /* time of the last access */
+  uint64_t hits, misses, inserts, evictions, entries;
+} cache_header;
+
+typedef struct {
+  uint64_t key[2];
+  uint64_t stamp;     /* time of the last use */
+  uint32_t nvalues;
+  uint32_t used;
+  /* maxvalues doubles */
+} cache_slot;
+
+struct ccache {
+  int fd;
+  size_t size;
+  unsigned char *map;
+  cache_header *header;
+};
+
+static void set_message(char *message, size_t lmessage, const char *text,
+                        const char *file)
+{
+  if (message != NULL && lmessage > 0)
+    snprintf(message, lmessage, text, file);
+}
+
+static cache_slot *get_slot(const ccache *cache, uint64_t set, int way)
+{
+  return (cache_slot *)(cache->map + LHEADER +
+    (size_t)(set*CCACHE_WAYS + (uint64_t)way) * cache->header->lslot);
+}
+
+static double *slot_values(cache_slot *slot)
+{
+  return (double *)(slot + 1);
+}
+
+int ccache_open(const char *file, size_t nentries, int maxvalues,
+                ccache **cache, char *message, size_t lmessage)
+{
+  ccache *c;
+  cache_header *h;
+  struct stat st;
+  uint64_t nsets;
+  size_t lslot;
+  int rc = CCACHE_SUCCESS;
+
+  *cache = NULL;
+  if (maxvalues < 1 || maxvalues > MAX_VALUES || nentries < 1)
+    return CCACHE_INVALID;
+  if ((c = calloc(1, sizeof(ccache))) == NULL)
+    return CCACHE_OUT_OF_MEMORY;
+  if ((c->fd = open(file, O_RDWR | O_CREAT, 0666)) < 0) {
+    set_message(message, lmessage, "Cannot open the cache %s", file);
+    free(c);
+    return CCACHE_FILE_ERROR;
+  }
+  flock(c->fd, LOCK_EX);
+  if (fstat(c->fd, &st) != 0) {
+    rc = CCACHE_FILE_ERROR;
+  } else if (st.st_size == 0) {
+    /* new cache (sparse file) */
+    lslot = sizeof(cache_slot) + (size_t)maxvalues*sizeof(double);
+    nsets = (nentries + CCACHE_WAYS - 1) / CCACHE_WAYS;
+    c->size = LHEADER + (size_t)nsets*CCACHE_WAYS*lslot;
+    if (ftruncate(c->fd, (off_t)c->size) != 0)
+      rc = CCACHE_FILE_ERROR;
+    else if ((c->map = mmap(NULL, c->size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                            c->fd, 0)) == MAP_FAILED)
+      rc = CCACHE_FILE_ERROR;
+    else {
+      h = c->header = (cache_header *)c->map;
+      h->version = CCACHE_VERSION;
+      h->endian = ENDIAN_CHECK;
+      h->nsets = nsets;
+      h->maxvalues = (uint32_t)maxvalues;
+      h->lslot = (uint32_t)lslot;
+      memcpy(h->magic, CCACHE_MAGIC, 8);
+    }
+    if (rc != CCACHE_SUCCESS)
+      set_message(message, lmessage, "Cannot create the cache %s", file);
+  } else {
+    c->size = (size_t)st.st_size;
+    if (c->size < LHEADER ||
+        (c->map = mmap(NULL, c->size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       c->fd, 0)) == MAP_FAILED) {
+      c->map = NULL;
+      rc = CCACHE_FORMAT_ERROR;
+    } else {
+      h = c->header = (cache_header *)c->map;
+      if (memcmp(h->magic, CCACHE_MAGIC, 8) != 0 || h->version != CCACHE_VERSION ||
+          h->endian != ENDIAN_CHECK || h->nsets == 0 ||
+          h->lslot != sizeof(cache_slot) + h->maxvalues*sizeof(double) ||
+          c->size < LHEADER + h->nsets*CCACHE_WAYS*h->lslot)
+        rc = CCACHE_FORMAT_ERROR;
+    }
+    if (rc != CCACHE_SUCCESS)
+      set_message(message, lmessage, "The file %s is not a cache of this machine", file);
+  }
+  flock(c->fd, LOCK_UN);
+  if (rc != CCACHE_SUCCESS) {
+    ccache_close(c);
+    return rc;
+  }
+  *cache = c;
+  return CCACHE_SUCCESS;
+}
+
+void ccache_close(ccache *cache)
+{
+  if (cache == NULL)
+    return;
+  if (cache->map != NULL)
+    munmap(cache->map, cache->size);
+  close(cache->fd);
+  free(cache);
+}
+
+int ccache_lock(ccache *cache)
+{
+  return flock(cache->fd, LOCK_EX) == 0 ? CCACHE_SUCCESS : CCACHE_FILE_ERROR;
+}
+
+int ccache_unlock(ccache *cache)
+{
+  return flock(cache->fd, LOCK_UN) == 0 ? CCACHE_SUCCESS : CCACHE_FILE_ERROR;
+}
+
+int ccache_lookup(ccache *cache, const uint64_t key[2], double *values,
+                  size_t stride, int nvalues)
+{
+  cache_header *h = cache->header;
+  uint64_t set = key[0] % h->nsets;
+  cache_slot *slot;
+  double *v;
+  int way, i;
+
+  for (way=0; way<CCACHE_WAYS; way++) {
+    slot = get_slot(cache, set, way);
+    if (slot->used && slot->key[0] == key[0] && slot->key[1] == key[1] &&
+        slot->nvalues == (uint32_t)nvalues) {
+      v = slot_values(slot);
+      for (i=0; i<nvalues; i++)
+        values[(size_t)i*stride] = v[i];
+      slot->stamp = ++h->clock;
+      h->hits++;
+      return 1;
+    }
+  }
+  h->misses++;
+  return 0;
+}
+
+int ccache_insert(ccache *cache, const uint64_t key[2], const double *values,
+                  size_t stride, int nvalues)
+{
+  cache_header *h = cache->header;
+  uint64_t set = key[0] % h->nsets;
+  cache_slot *slot, *target = NULL;
+  double *v;
+  int way, i;
+
+  if (nvalues < 0 || (uint32_t)nvalues > h->maxvalues)
+    return CCACHE_INVALID;
+  /* same key, free slot or least recently used slot of the set */
+  for (way=0; way<CCACHE_WAYS; way++) {
+    slot = get_slot(cache, set, way);
+    if (slot->used && slot->key[0] == key[0] && slot->key[1] == key[1]) {
+      target = slot;
+      break;
+    }
+    if (target == NULL || (target->used && (!slot->used || slot->stamp < target->stamp)))
+      target = slot;
+  }
+  if (!target->used)
+    h->entries++;
+  else if (target->key[0] != key[0] || target->key[1] != key[1])
+    h->evictions++;
+
+  /* the slot is marked as used once complete */
+  target->used = 0;
+  v = slot_values(target);
+  for (i=0; i<nvalues; i++)
+    v[i] = values[(size_t)i*stride];
+  target->key[0] = key[0];
+  target->key[1] = key[1];
+  target->nvalues = (uint32_t)nvalues;
+  target->stamp = ++h->clock;
+  target->used = 1;
+  h->inserts++;
+  return CCACHE_SUCCESS;
+}
+
+void ccache_get_stats(const ccache *cache, ccache_stats *stats)
+{
+  const cache_header *h = cache->header;
+
+  stats->hits = h->hits;
+  stats->misses = h->misses;
+  stats->inserts = h->inserts;
+  stats->evictions = h->evictions;
+  stats->entries = h->entries;
+  stats->capacity = h->nsets*CCACHE_WAYS;
+  stats->maxvalues = (int)h->maxvalues;
+}
+
+int ccache_clear(ccache *cache)
+{
+  cache_header *h = cache->header;
+
+  memset(cache->map + LHEADER, 0, (size_t)(h->nsets*CCACHE_WAYS*h->lslot));
+  h->clock = 0;
+  h->hits = h->misses = h->inserts = h->evictions = h->entries = 0;
+  return CCACHE_SUCCESS;
+}
+
+#else /* _WIN32 */
+
+int ccache_open(const char *file, size_t nentries, int maxvalues,
+                ccache **cache, char *message, size_t lmessage)
+{
+  (void)file; (void)nentries; (void)maxvalues; (void)message; (void)lmessage;
+  *cache = NULL;
+  return CCACHE_INVALID;
+}
+
+void ccache_close(ccache *cache) { (void)cache; }
+
+int ccache_lock(ccache *cache) { (void)cache; return CCACHE_INVALID; }
+
+int ccache_unlock(ccache *cache) { (void)cache; return CCACHE_INVALID; }
+
+int ccache_lookup(ccache *cache, const uint64_t key[2], double *values,
+                  size_t stride, int nvalues)
+{
+  (void)cache; (void)key; (void)values; (void)stride; (void)nvalues;
+  return 0;
+}
+
+int ccache_insert(ccache *cache, const uint64_t key[2], const double *values,
+                  size_t stride, int nvalues)
+{
+  (void)cache; (void)key; (void)values; (void)stride; (void)nvalues;
+  return CCACHE_INVALID;
+}
+
+void ccache_get_stats(const ccache *cache, ccache_stats *stats)
+{
+  (void)cache;
+  memset(stats, 0, sizeof(*stats));
+}
+
+int ccache_clear(ccache *cache) { (void)cache; return CCACHE_INVALID; }
+
+#endif /* _WIN32 */
@@ -0,0 +1,127 @@
+/*******************************************************************************
+ * cossan_cache.h: persistent evaluation cache of the Evaluator
+ *
+ * Content-addressed cache of the outputs of the model evaluations, shared
+ * by all the analyses (and the processes) that use the same cache file.
+ * An entry is addressed by a 128-bit key: the hash of the definition of
+ * the model combined with the hash of the values of the inputs.
+ *
+ * The file is memory mapped and holds a set-associative hash table: a key
+ * selects a set of CCACHE_WAYS slots, and when the set is full the least
+ * recently used entry of the set is replaced. The statistics (hits,
+ * misses, insertions and evictions) are stored in the file. The file uses
+ * the byte order of the machine that created it. The operations are
+ * serialized between processes with a lock on the file (ccache_lock).
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+
+#ifndef _COSSAN_CACHE_H
+#define _COSSAN_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CCACHE_MAGIC   "COSSANCH"
+#define CCACHE_VERSION 1
+#define CCACHE_WAYS    8 /* slots of a set */
+
+/*
+ * Possible return values of the functions
+ */
+typedef enum {
+  CCACHE_FORMAT_ERROR  = -4, /* the file is not a cache */
+  CCACHE_FILE_ERROR    = -3, /* the file cannot be created or mapped */
+  CCACHE_OUT_OF_MEMORY = -2, /* memory allocation failed */
+  CCACHE_INVALID       = -1, /* invalid argument or unsupported system */
+  CCACHE_SUCCESS       =  0
+} ccache_result;
+
+/*
+ * Statistics of the cache (since its creation)
+ */
+typedef struct {
+  uint64_t hits, misses, inserts, evictions;
+  uint64_t entries;      /* entries in the cache */
+  uint64_t capacity;     /* maximum number of entries */
+  int maxvalues;         /* maximum number of outputs of an entry */
+} ccache_stats;
+
+typedef struct ccache ccache;
+
+/*
+ * Open the cache file. A new file is created with room for nentries
+ * entries (rounded up to a multiple of CCACHE_WAYS) of at most maxvalues
+ * outputs; the size of an existing file is not changed.
+ */
+int ccache_open(const char *file, size_t nentries, int maxvalues,
+                ccache **cache, char *message, size_t lmessage);
+
+void ccache_close(ccache *cache);
+
+/* Hash of the definition of the model (any sequence of bytes) */
+void ccache_model(const void *model, size_t lmodel, uint64_t hmodel[2]);
+
+/*
+ * Key of the sample with the n inputs x[0], x[stride], ... for the model
+ * hmodel. -0 and 0, and all the NaN, have the same key.
+ */
+void ccache_key(const uint64_t hmodel[2], const double *x, size_t n,
+                size_t stride, uint64_t key[2]);
+
+/* Exclusive access to the cache for the calling process */
+int ccache_lock(ccache *cache);
+int ccache_unlock(ccache *cache);
+
+/*
+ * Copy the nvalues outputs of the entry key in values[0], values[stride],
+ * ... Returns 1 on a hit, 0 on a miss.
+ */
+int ccache_lookup(ccache *cache, const uint64_t key[2], double *values,
+                  size_t stride, int nvalues);
+
+/*
+ * Store the nvalues outputs values[0], values[stride], ... of the entry
+ * key (replacing the least recently used entry of its set if necessary).
+ */
+int ccache_insert(ccache *cache, const uint64_t key[2], const double *values,
+                  size_t stride, int nvalues);
+
+void ccache_get_stats(const ccache *cache, ccache_stats *stats);
+
+/* Remove all the entries and reset the statistics */
+int ccache_clear(ccache *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_CACHE_H */
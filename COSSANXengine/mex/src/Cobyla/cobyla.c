@@ -38,7 +38,11 @@ static char const rcsid[] =
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+/* mex.h redirects printf to the matlab command window. It is skipped when
+   cobyla.c is compiled without matlab (e.g. Benchmark/optbench.c) */
+#ifdef MATLAB_MEX_FILE
 #include "mex.h"
+#endif
 #include "cobyla.h"
 
 #define min(a,b) ((a) <= (b) ? (a) : (b))
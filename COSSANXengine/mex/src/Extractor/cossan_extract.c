@@ -0,0 +1,951 @@
+/*******************************************************************************
+ * cossan_extract.c: single pass extraction of the Responses of an Extractor
+ *
+ * Positions in the file are expressed as line numbers: all the movements of
+ * Response.findRelativePosition (fgetl, ftell, fseek to a previous ftell)
+ * start and end at the beginning of a line. The history of the positions
+ * (TfileInfo.Vpos) is stored as runs of consecutive lines, so that skipping
+ * to the next occurrence of an anchor does not depend on the number of
+ * lines skipped.
+ *
+ * Differences with the MATLAB implementation: when an anchor is not found
+ * after the position has been reset to the beginning of the file, the
+ * response is NaN (findRelativePosition never sets Lreset and loops
+ * forever).
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <ctype.h>
+#include "cossan_extract.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/*******************************************************************************
+ * Fast conversion of the numbers
+ ******************************************************************************/
+
+static const double pow10_exact[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+  1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* strtod of the characters [s,end) */
+static double slow_strtod(const char *s, const char *end, const char **next)
+{
+  char local[64], *buf = local, *e;
+  size_t n = end - s;
+  double v;
+
+  if (n >= sizeof(local) && (buf = (char *)malloc(n+1)) == NULL) {
+    *next = s;
+    return 0.0;
+  }
+  memcpy(buf, s, n);
+  buf[n] = '\0';
+  v = strtod(buf, &e);
+  *next = s + (e - buf);
+  if (buf != local) free(buf);
+  return v;
+}
+
+double cext_strtod(const char *s, const char *end, const char **next)
+{
+  const char *p = s, *q;
+  unsigned long long m = 0;
+  int neg = 0, ndigits = 0, nsig = 0, exp10 = 0, e = 0, eneg = 0;
+  double v;
+
+  if (p < end && (*p == '+' || *p == '-')) neg = *p++ == '-';
+  for (; p < end && *p >= '0' && *p <= '9'; p++, ndigits++) {
+    if (nsig < 19) { m = 10*m + (*p - '0'); if (m) nsig++; }
+    else exp10++;
+  }
+  if (p < end && *p == '.') {
+    for (p++; p < end && *p >= '0' && *p <= '9'; p++, ndigits++) {
+      if (nsig < 19) { m = 10*m + (*p - '0'); if (m) nsig++; exp10--; }
+    }
+  }
+  if (ndigits == 0)
+    /* inf, nan or not a number */
+    return slow_strtod(s, end, next);
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    q = p + 1;
+    if (q < end && (*q == '+' || *q == '-')) eneg = *q++ == '-';
+    if (q < end && *q >= '0' && *q <= '9') {
+      for (; q < end && *q >= '0' && *q <= '9'; q++)
+        if (e < 10000) e = 10*e + (*q - '0');
+      exp10 += eneg ? -e : e;
+      p = q;
+    }
+  }
+  /* exact when the mantissa and the power of ten are exact doubles */
+  if (nsig >= 19 || m > (1ULL << 53) || exp10 < -22 || exp10 > 22)
+    return slow_strtod(s, p, next);
+  v = (double)m;
+  v = exp10 < 0 ? v/pow10_exact[-exp10] : v*pow10_exact[exp10];
+  *next = p;
+  return neg ? -v : v;
+}
+
+/*******************************************************************************
+ * Aho-Corasick automaton
+ ******************************************************************************/
+
+struct cext_scanner {
+  int nstates, npatterns;
+  int *start;              /* edges of the state k: start[k]..start[k+1]-1 */
+  unsigned char *label;    /* sorted labels of the edges */
+  int *to;                 /* target of the edges */
+  int root[256];           /* transitions of the root */
+  unsigned char stop[256]; /* bytes that leave the root (or end a line) */
+  int *fail;               /* failure links */
+  int *term;               /* pattern ending in the state (-1 if none) */
+  int *dict;               /* next state with a pattern on the fail chain */
+  int *same;               /* next pattern with the same text (-1 if none) */
+};
+
+typedef struct { int child, sibling; unsigned char c; } trie_node;
+
+static int step(const cext_scanner *s, int state, unsigned char c)
+{
+  int lo, hi, mid;
+  if (state == 0) return s->root[c];
+  lo = s->start[state];
+  hi = s->start[state+1] - 1;
+  while (lo <= hi) {
+    mid = (lo + hi)/2;
+    if (s->label[mid] == c) return s->to[mid];
+    if (s->label[mid] < c) lo = mid + 1; else hi = mid - 1;
+  }
+  return -1;
+}
+
+cext_scanner *cext_scanner_compile(const char *const *patterns, int npatterns)
+{
+  cext_scanner *s;
+  trie_node *t = NULL;
+  int *queue = NULL, *count = NULL;
+  int n = 1, cap = 0, k, st, c, f, nedges = 0, head, tail, v, r;
+  size_t total = 1;
+  const unsigned char *p;
+
+  for (k=0; k<npatterns; k++) total += strlen(patterns[k]);
+  if ((s = (cext_scanner *)calloc(1, sizeof(cext_scanner))) == NULL) return NULL;
+  cap = (int)total;
+  t = (trie_node *)calloc(cap, sizeof(trie_node));
+  s->term = (int *)malloc(cap*sizeof(int));
+  s->same = (int *)malloc((npatterns > 0 ? npatterns : 1)*sizeof(int));
+  if (t == NULL || s->term == NULL || s->same == NULL) goto nomem;
+  s->npatterns = npatterns;
+  t[0].child = -1;
+  s->term[0] = -1;
+
+  /* trie */
+  for (k=0; k<npatterns; k++) {
+    s->same[k] = -1;
+    if (patterns[k][0] == '\0') continue; /* never found (as regexp) */
+    for (st=0, p=(const unsigned char *)patterns[k]; *p; p++) {
+      for (c=t[st].child; c >= 0 && t[c].c != *p; c=t[c].sibling) ;
+      if (c < 0) {
+        c = n++;
+        t[c].c = *p;
+        t[c].child = -1;
+        t[c].sibling = t[st].child;
+        t[st].child = c;
+        s->term[c] = -1;
+        nedges++;
+      }
+      st = c;
+    }
+    if (s->term[st] >= 0) {
+      /* same text of a previous pattern */
+      for (c=s->term[st]; s->same[c] >= 0; c=s->same[c]) ;
+      s->same[c] = k;
+    } else {
+      s->term[st] = k;
+    }
+  }
+  s->nstates = n;
+
+  /* sorted edges (CSR) */
+  s->start = (int *)calloc(n+1, sizeof(int));
+  s->label = (unsigned char *)malloc(nedges > 0 ? nedges : 1);
+  s->to = (int *)malloc((nedges > 0 ? nedges : 1)*sizeof(int));
+  s->fail = (int *)calloc(n, sizeof(int));
+  s->dict = (int *)calloc(n, sizeof(int));
+  queue = (int *)malloc(n*sizeof(int));
+  count = (int *)calloc(256, sizeof(int));
+  if (!s->start || !s->label || !s->to || !s->fail || !s->dict || !queue || !count)
+    goto nomem;
+  for (st=0, k=0; st<n; st++) {
+    int first = k, a, b;
+    s->start[st] = k;
+    for (c=t[st].child; c >= 0; c=t[c].sibling) {
+      s->label[k] = t[c].c;
+      s->to[k++] = c;
+    }
+    /* insertion sort of the labels (few children per state) */
+    for (a=first+1; a<k; a++) {
+      unsigned char l = s->label[a];
+      int to = s->to[a];
+      for (b=a-1; b >= first && s->label[b] > l; b--) {
+        s->label[b+1] = s->label[b];
+        s->to[b+1] = s->to[b];
+      }
+      s->label[b+1] = l;
+      s->to[b+1] = to;
+    }
+  }
+  s->start[n] = k;
+  for (c=0; c<256; c++) s->root[c] = 0;
+  for (k=s->start[0]; k<s->start[1]; k++) {
+    s->root[s->label[k]] = s->to[k];
+    s->stop[s->label[k]] = 1;
+  }
+  s->stop[(unsigned char)'\n'] = 1;
+
+  /* failure and dictionary links (breadth first) */
+  head = tail = 0;
+  for (k=s->start[0]; k<s->start[1]; k++) {
+    s->fail[s->to[k]] = 0;
+    s->dict[s->to[k]] = 0;
+    queue[tail++] = s->to[k];
+  }
+  while (head < tail) {
+    v = queue[head++];
+    for (k=s->start[v]; k<s->start[v+1]; k++) {
+      c = s->label[k];
+      r = s->to[k];
+      queue[tail++] = r;
+      for (f=s->fail[v]; f > 0 && step(s, f, (unsigned char)c) < 0; f=s->fail[f]) ;
+      f = step(s, f, (unsigned char)c);
+      s->fail[r] = (f < 0 || f == r) ? 0 : f;
+      s->dict[r] = s->term[s->fail[r]] >= 0 ? s->fail[r] : s->dict[s->fail[r]];
+    }
+  }
+  free(t);
+  free(queue);
+  free(count);
+  return s;
+
+nomem:
+  free(t);
+  free(queue);
+  free(count);
+  cext_scanner_free(s);
+  return NULL;
+}
+
+void cext_scanner_free(cext_scanner *s)
+{
+  if (s == NULL) return;
+  free(s->start); free(s->label); free(s->to); free(s->fail);
+  free(s->term); free(s->dict); free(s->same); free(s);
+}
+
+typedef struct { long *v; long n, cap; } long_array;
+
+static int push_long(long_array *a, long x)
+{
+  long *tmp;
+  if (a->n == a->cap) {
+    a->cap = a->cap ? 2*a->cap : 16;
+    if ((tmp = (long *)realloc(a->v, a->cap*sizeof(long))) == NULL) return -1;
+    a->v = tmp;
+  }
+  a->v[a->n++] = x;
+  return 0;
+}
+
+static int record(const cext_scanner *s, long_array *occ, int state, long line)
+{
+  int t, k;
+  for (t = s->term[state] >= 0 ? state : s->dict[state]; t > 0; t = s->dict[t]) {
+    for (k=s->term[t]; k >= 0; k=s->same[k])
+      if ((occ[k].n == 0 || occ[k].v[occ[k].n-1] != line) && push_long(&occ[k], line))
+        return -1;
+  }
+  return 0;
+}
+
+int cext_scan(const cext_scanner *s, const char *text, size_t length,
+  long **lines, long *nlines, size_t **linestart, long *nline)
+{
+  long_array *occ;
+  size_t *ls = NULL, *tmp, cap = 1024, i = 0;
+  long line = 0;
+  int state = 0, next, k;
+  const unsigned char *u = (const unsigned char *)text;
+
+  occ = (long_array *)calloc(s->npatterns > 0 ? s->npatterns : 1, sizeof(long_array));
+  ls = (size_t *)malloc(cap*sizeof(size_t));
+  if (occ == NULL || ls == NULL) goto nomem;
+  ls[0] = 0;
+
+  while (i < length) {
+    if (state == 0) {
+      /* skip the bytes that do not start a pattern */
+      while (i < length && !s->stop[u[i]]) i++;
+      if (i >= length) break;
+    }
+    if (u[i] == '\n') {
+      line++;
+      if ((size_t)line >= cap) {
+        cap *= 2;
+        if ((tmp = (size_t *)realloc(ls, cap*sizeof(size_t))) == NULL) goto nomem;
+        ls = tmp;
+      }
+      ls[line] = i + 1;
+      state = 0;
+      i++;
+      continue;
+    }
+    while (state > 0 && (next = step(s, state, u[i])) < 0) state = s->fail[state];
+    if (state == 0) state = s->root[u[i]];
+    else state = next;
+    if (state > 0 && (s->term[state] >= 0 || s->dict[state] > 0) &&
+        record(s, occ, state, line))
+      goto nomem;
+    i++;
+  }
+
+  /* the last line is counted only if it is not empty (as fgetl) */
+  *nline = (length > 0 && text[length-1] != '\n') ? line + 1 : line;
+  *linestart = ls;
+  for (k=0; k<s->npatterns; k++) {
+    lines[k] = occ[k].v;
+    nlines[k] = occ[k].n;
+  }
+  free(occ);
+  return 0;
+
+nomem:
+  if (occ != NULL)
+    for (k=0; k<s->npatterns; k++) free(occ[k].v);
+  free(occ);
+  free(ls);
+  return -1;
+}
+
+/*******************************************************************************
+ * Formats (subset of sscanf)
+ ******************************************************************************/
+
+enum { F_END, F_SPACE, F_CHAR, F_SKIP, F_FLOAT, F_INT };
+
+typedef struct { int type, width, discard; char c; } directive;
+
+/* returns the number of directives or -1 if the format is not supported */
+static int compile_format(const char *format, directive *d, int nmax)
+{
+  const char *p = format;
+  int n = 0;
+
+  while (*p && n < nmax-1) {
+    memset(&d[n], 0, sizeof(directive));
+    if (isspace((unsigned char)*p)) {
+      while (isspace((unsigned char)*p)) p++;
+      d[n++].type = F_SPACE;
+      continue;
+    }
+    if (*p != '%') {
+      d[n].type = F_CHAR;
+      d[n++].c = *p++;
+      continue;
+    }
+    p++;
+    if (*p == '%') { d[n].type = F_CHAR; d[n++].c = '%'; p++; continue; }
+    if (*p == '*') { d[n].discard = 1; p++; }
+    while (isdigit((unsigned char)*p)) d[n].width = 10*d[n].width + (*p++ - '0');
+    if (*p == '\0') { d[n++].type = F_END; return n; } /* trailing %* */
+    if (*p == 'l' || *p == 'h') p++;
+    switch (*p) {
+    case 'e': case 'E': case 'f': case 'g': case 'G':
+      d[n].type = F_FLOAT; break;
+    case 'd': case 'i': case 'u':
+      d[n].type = F_INT; break;
+    case 'c':
+      if (!d[n].discard) return -1;
+      d[n].type = F_SKIP;
+      if (d[n].width == 0) d[n].width = 1;
+      break;
+    default:
+      return -1;
+    }
+    p++;
+    n++;
+  }
+  /* without the terminating %* matlab cycles the format on the line */
+  return -1;
+}
+
+/*
+ * Apply the format to the line [p,e). Returns the number of values or -1
+ * when the conversion of matlab is ambiguous (integer conversion of a real
+ * number).
+ */
+static int scan_line(const directive *d, const char *p, const char *e,
+  double *values, int nmax)
+{
+  const char *q, *end;
+  int n = 0, k;
+  double v;
+
+  for (k=0; d[k].type != F_END; k++) {
+    switch (d[k].type) {
+    case F_SPACE:
+      while (p < e && isspace((unsigned char)*p)) p++;
+      break;
+    case F_CHAR:
+      if (p >= e || *p != d[k].c) return n;
+      p++;
+      break;
+    case F_SKIP:
+      if (e - p < d[k].width) return n;
+      p += d[k].width;
+      break;
+    default:
+      while (p < e && isspace((unsigned char)*p)) p++;
+      if (p >= e) return n;
+      end = d[k].width > 0 && p + d[k].width < e ? p + d[k].width : e;
+      if (d[k].type == F_FLOAT) {
+        v = cext_strtod(p, end, &q);
+        if (q == p) return n;
+      } else {
+        q = p;
+        if (q < end && (*q == '+' || *q == '-')) q++;
+        if (q >= end || !isdigit((unsigned char)*q)) return n;
+        while (q < end && isdigit((unsigned char)*q)) q++;
+        if (q < end && (*q == '.' || *q == 'e' || *q == 'E')) return -1;
+        v = cext_strtod(p, q, &q);
+      }
+      p = q;
+      if (!d[k].discard) {
+        if (n >= nmax) return -1;
+        values[n++] = v;
+      }
+    }
+  }
+  return n;
+}
+
+/*******************************************************************************
+ * Extraction
+ ******************************************************************************/
+
+#define NDIRECTIVES 64
+#define NVALUES 256
+
+/* history of the positions (TfileInfo.Vpos) as runs of consecutive lines */
+typedef struct {
+  long *first, *last;
+  long n, cap, max;
+} positions;
+
+static int push_position(positions *v, long pos)
+{
+  long *a, *b;
+  if (v->n > 0 && v->last[v->n-1] + 1 == pos) {
+    v->last[v->n-1] = pos;
+  } else {
+    if (v->n == v->cap) {
+      v->cap = v->cap ? 2*v->cap : 64;
+      a = (long *)realloc(v->first, v->cap*sizeof(long));
+      if (a == NULL) return -1;
+      v->first = a;
+      b = (long *)realloc(v->last, v->cap*sizeof(long));
+      if (b == NULL) return -1;
+      v->last = b;
+    }
+    v->first[v->n] = v->last[v->n] = pos;
+    v->n++;
+  }
+  if (pos > v->max) v->max = pos;
+  return 0;
+}
+
+/* Vpos(end-back), -1 if out of range */
+static long position_from_end(const positions *v, long back)
+{
+  long k, len;
+  for (k=v->n-1; k >= 0; k--) {
+    len = v->last[k] - v->first[k] + 1;
+    if (back < len) return v->last[k] - back;
+    back -= len;
+  }
+  return -1;
+}
+
+/* matrix with the same semantic of the matlab assignments */
+typedef struct { double *data; long nrows, ncols, cap; } matrix;
+
+static int matrix_reserve(matrix *m, long n)
+{
+  double *tmp;
+  if (n <= m->cap) return 0;
+  while (m->cap < n) m->cap = m->cap ? 2*m->cap : 64;
+  if ((tmp = (double *)realloc(m->data, m->cap*sizeof(double))) == NULL) return -1;
+  m->data = tmp;
+  return 0;
+}
+
+/* M(irow,:) = values (irow = nrows+1); a scalar NaN fills the row */
+static int matrix_add_row(matrix *m, const double *values, int n, int *unsupported)
+{
+  long i, j, nc;
+  double *tmp;
+  nc = m->nrows == 0 && m->ncols == 0 ? (long)n : m->ncols;
+  if (n != nc && n != 1) { *unsupported = 1; return 0; }
+  if (matrix_reserve(m, (m->nrows+1)*nc)) return -1;
+  /* column-wise storage: move the columns */
+  if (m->nrows > 0 && nc > 1) {
+    tmp = m->data;
+    for (j=nc-1; j >= 1; j--)
+      for (i=m->nrows-1; i >= 0; i--)
+        tmp[j*(m->nrows+1)+i] = tmp[j*m->nrows+i];
+  }
+  for (j=0; j<nc; j++)
+    m->data[j*(m->nrows+1)+m->nrows] = n == 1 ? values[0] : values[j];
+  m->nrows++;
+  m->ncols = nc;
+  return 0;
+}
+
+/* A = [A; B] (vertical) or [A, B] (horizontal) */
+static int matrix_concat(matrix *a, const matrix *b, int horizontal, int *unsupported)
+{
+  long i, j, nr;
+  double *tmp;
+  if (b->nrows == 0 || b->ncols == 0) return 0;
+  if (a->nrows == 0 || a->ncols == 0) {
+    if (matrix_reserve(a, b->nrows*b->ncols)) return -1;
+    memcpy(a->data, b->data, b->nrows*b->ncols*sizeof(double));
+    a->nrows = b->nrows;
+    a->ncols = b->ncols;
+    return 0;
+  }
+  if (horizontal) {
+    if (a->nrows != b->nrows) { *unsupported = 1; return 0; }
+    if (matrix_reserve(a, a->nrows*(a->ncols+b->ncols))) return -1;
+    memcpy(a->data + a->nrows*a->ncols, b->data, b->nrows*b->ncols*sizeof(double));
+    a->ncols += b->ncols;
+  } else {
+    if (a->ncols != b->ncols) { *unsupported = 1; return 0; }
+    nr = a->nrows + b->nrows;
+    if (matrix_reserve(a, nr*a->ncols)) return -1;
+    tmp = a->data;
+    for (j=a->ncols-1; j >= 0; j--) {
+      for (i=a->nrows-1; i >= 0; i--) tmp[j*nr+i] = tmp[j*a->nrows+i];
+      for (i=0; i<b->nrows; i++) tmp[j*nr+a->nrows+i] = b->data[j*b->nrows+i];
+    }
+    a->nrows = nr;
+  }
+  return 0;
+}
+
+typedef struct {
+  const char *text;
+  size_t length;
+  const size_t *linestart;
+  long nline;
+  long pos;                 /* current line (nline at the end of file) */
+  positions vpos;
+  int completed;            /* TfileInfo.status == 'completed' */
+  double *out;              /* TfileInfo.out (NaN allowed) */
+  char *outset;             /* the field of TfileInfo.out exists */
+} extract_state;
+
+/* fgetl: returns the line (or -1 at the end of file) and pushes ftell */
+static long next_line(extract_state *s)
+{
+  long l = -1;
+  if (s->pos < s->nline) l = s->pos++;
+  return push_position(&s->vpos, s->pos) ? -2 : l;
+}
+
+static void line_bounds(const extract_state *s, long l, const char **b, const char **e)
+{
+  *b = s->text + s->linestart[l];
+  *e = (l+1 < s->nline || (s->length > 0 && s->text[s->length-1] == '\n')) ?
+    s->text + s->linestart[l+1] - 1 : s->text + s->length;
+}
+
+/* first occurrence of the pattern at a line >= pos (binary search) */
+static long find_from(const long *lines, long n, long pos)
+{
+  long lo = 0, hi = n;
+  while (lo < hi) {
+    long mid = (lo + hi)/2;
+    if (lines[mid] < pos) lo = mid + 1; else hi = mid;
+  }
+  return lo < n ? lines[lo] : -1;
+}
+
+#define ERR_NOMEM -2
+#define ERR_UNSUPPORTED -3
+
+/*
+ * Response.findRelativePosition. Returns 0, 1 (the response is NaN or the
+ * end of file has been reached), ERR_NOMEM or ERR_UNSUPPORTED
+ */
+static int find_position(extract_state *s, const cext_response *r, int slot,
+  int varslot, const long *const *occ, const long *nocc, const int *look,
+  int *status)
+{
+  long l, k;
+  int ilook, lreset = 0;
+
+  if (r->nlookoutfor > 0) {
+    if (r->nrepeatanchor > 1 && s->vpos.n > 0) {
+      s->pos = s->vpos.max;
+      if (push_position(&s->vpos, s->pos)) return ERR_NOMEM;
+    }
+    for (ilook=0; ilook<r->nlookoutfor; ilook++) {
+      for (;;) {
+        l = look[ilook] >= 0 ? find_from(occ[look[ilook]], nocc[look[ilook]], s->pos) : -1;
+        if (l >= 0) {
+          /* fgetl up to the line of the anchor */
+          for (k=s->pos+1; k<=l+1; k++)
+            if (push_position(&s->vpos, k)) return ERR_NOMEM;
+          s->pos = l + 1;
+          break;
+        }
+        /* end of file */
+        for (k=s->pos+1; k<=s->nline; k++)
+          if (push_position(&s->vpos, k)) return ERR_NOMEM;
+        s->pos = s->nline;
+        if (push_position(&s->vpos, s->pos)) return ERR_NOMEM;
+        if (isinf(r->nrepeatanchor)) {
+          s->completed = 1;
+          return 1;
+        }
+        if (lreset) {
+          s->completed = 0;
+          s->out[slot] = NAN;
+          s->outset[slot] = 1;
+          *status |= CEXT_WARN_ANCHOR;
+          return 1;
+        }
+        s->pos = 0;
+        if (push_position(&s->vpos, 0)) return ERR_NOMEM;
+        s->completed = 0;
+        lreset = 1;
+      }
+    }
+    s->out[slot] = (double)s->pos;
+    s->outset[slot] = 1;
+  } else if (r->varname != NULL && r->varname[0] != '\0') {
+    if (varslot < 0 || !s->outset[varslot] || isnan(s->out[varslot])) {
+      s->out[slot] = NAN;
+      s->outset[slot] = 1;
+      *status |= CEXT_WARN_POSITION;
+      return 1;
+    }
+    s->pos = (long)s->out[varslot];
+  } else {
+    s->pos = 0;
+    if (push_position(&s->vpos, 0)) return ERR_NOMEM;
+  }
+
+  if (r->nrownum <= 0) {
+    /* matlab raises an error when the index is out of Vpos */
+    if ((l = position_from_end(&s->vpos, 1 - r->nrownum)) < 0) return ERR_UNSUPPORTED;
+    s->pos = l;
+    if (push_position(&s->vpos, l)) return ERR_NOMEM;
+  } else {
+    for (k=1; k<r->nrownum; k++) {
+      if ((l = next_line(s)) == -2) return ERR_NOMEM;
+      if (l < 0) {
+        s->out[slot] = NAN;
+        s->outset[slot] = 1;
+        *status |= CEXT_WARN_READ;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+/* Response.readResponse */
+static int read_response(extract_state *s, const cext_response *r,
+  const directive *d, matrix *m, int *status, int *unsupported)
+{
+  const char *b, *e;
+  double values[NVALUES], nan = NAN;
+  long l;
+  double irow;
+  int n;
+
+  m->nrows = m->ncols = 0;
+  for (irow=1; irow <= r->nrepeat; irow++) {
+    if ((l = next_line(s)) == -2) return ERR_NOMEM;
+    if (l >= 0) line_bounds(s, l, &b, &e);
+    if (l < 0 || b == e) {
+      if (!isinf(r->nrepeat)) {
+        *status |= CEXT_WARN_READ;
+        if (matrix_add_row(m, &nan, 1, unsupported)) return ERR_NOMEM;
+      }
+      break;
+    }
+    n = scan_line(d, b, e, values, NVALUES);
+    if (n < 0) { *unsupported = 1; return 0; }
+    if (n == 0) {
+      *status |= CEXT_WARN_READ;
+      if (matrix_add_row(m, &nan, 1, unsupported)) return ERR_NOMEM;
+    } else if (matrix_add_row(m, values, n, unsupported)) {
+      return ERR_NOMEM;
+    }
+    if (*unsupported) return 0;
+  }
+  return 0;
+}
+
+static int is_literal(const char *p)
+{
+  for (; *p; p++)
+    if (strchr(".^$*+?()[]{}|\\\n", *p) != NULL) return 0;
+  return 1;
+}
+
+/* file in memory (mapped when possible) */
+typedef struct { char *text; size_t length; int mapped; } file_map;
+
+static int map_file(const char *Sfile, file_map *f)
+{
+#if !defined(_WIN32)
+  struct stat st;
+  int fd;
+  f->mapped = 0;
+  if ((fd = open(Sfile, O_RDONLY)) < 0) return -1;
+  if (fstat(fd, &st) != 0) { close(fd); return -1; }
+  f->length = (size_t)st.st_size;
+  if (f->length == 0) {
+    f->text = NULL;
+  } else {
+    f->text = (char *)mmap(NULL, f->length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (f->text == MAP_FAILED) { close(fd); return -1; }
+    madvise(f->text, f->length, MADV_SEQUENTIAL);
+    f->mapped = 1;
+  }
+  close(fd);
+  return 0;
+#else
+  FILE *fp;
+  long n;
+  f->mapped = 0;
+  if ((fp = fopen(Sfile, "rb")) == NULL) return -1;
+  fseek(fp, 0, SEEK_END);
+  n = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  f->length = n > 0 ? (size_t)n : 0;
+  f->text = (char *)malloc(f->length + 1);
+  if (f->text == NULL || fread(f->text, 1, f->length, fp) != f->length) {
+    free(f->text);
+    fclose(fp);
+    return -1;
+  }
+  fclose(fp);
+  return 0;
+#endif
+}
+
+static void unmap_file(file_map *f)
+{
+#if !defined(_WIN32)
+  if (f->mapped) munmap(f->text, f->length);
+#else
+  free(f->text);
+#endif
+}
+
+int cext_extract(const char *Sfile, int nresponses,
+  const cext_response *responses, cext_output *out, char *message,
+  size_t lmessage)
+{
+  const cext_response *r;
+  const char **patterns = NULL;
+  cext_scanner *scanner = NULL;
+  directive *d = NULL;
+  int *look = NULL, *lookstart = NULL, *slot = NULL, *varslot = NULL;
+  long **occ = NULL, *nocc = NULL;
+  extract_state s;
+  file_map f;
+  matrix m, mr;
+  int npatterns = 0, nlook = 0, i, j, k, rc = CEXT_SUCCESS, unsupported = 0, stop;
+  double nrep;
+
+  memset(&s, 0, sizeof(s));
+  memset(&m, 0, sizeof(m));
+  memset(&mr, 0, sizeof(mr));
+  memset(out, 0, nresponses*sizeof(cext_output));
+
+  /* compile the formats and the anchors */
+  for (i=0; i<nresponses; i++) nlook += responses[i].nlookoutfor;
+  d = (directive *)malloc((nresponses > 0 ? nresponses : 1)*NDIRECTIVES*sizeof(directive));
+  patterns = (const char **)malloc((nlook > 0 ? nlook : 1)*sizeof(char *));
+  look = (int *)malloc((nlook > 0 ? nlook : 1)*sizeof(int));
+  lookstart = (int *)malloc((nresponses+1)*sizeof(int));
+  slot = (int *)malloc((nresponses > 0 ? nresponses : 1)*sizeof(int));
+  varslot = (int *)malloc((nresponses > 0 ? nresponses : 1)*sizeof(int));
+  if (!d || !patterns || !look || !lookstart || !slot || !varslot) goto nomem;
+
+  for (i=0, k=0; i<nresponses; i++) {
+    r = &responses[i];
+    if (compile_format(r->format, d + i*NDIRECTIVES, NDIRECTIVES) < 0) {
+      snprintf(message, lmessage, "Format %s of the response %s not supported",
+        r->format, r->name);
+      rc = CEXT_UNSUPPORTED;
+      goto cleanup;
+    }
+    lookstart[i] = k;
+    for (j=0; j<r->nlookoutfor; j++, k++) {
+      if (!is_literal(r->lookoutfor[j])) {
+        snprintf(message, lmessage, "Regular expression %s of the response %s "
+          "not supported", r->lookoutfor[j], r->name);
+        rc = CEXT_UNSUPPORTED;
+        goto cleanup;
+      }
+      /* identical anchors share the state of the automaton (see same) */
+      look[k] = k;
+      patterns[k] = r->lookoutfor[j];
+    }
+    /* TfileInfo.out is indexed by the names of the responses */
+    slot[i] = i;
+    for (j=0; j<i; j++)
+      if (strcmp(responses[j].name, r->name) == 0) { slot[i] = slot[j]; break; }
+  }
+  lookstart[nresponses] = k;
+  npatterns = k;
+  for (i=0; i<nresponses; i++) {
+    varslot[i] = -1;
+    if (responses[i].varname == NULL) continue;
+    for (j=0; j<nresponses; j++)
+      if (strcmp(responses[j].name, responses[i].varname) == 0) { varslot[i] = slot[j]; break; }
+  }
+
+  /* single pass on the file */
+  if (map_file(Sfile, &f)) {
+    snprintf(message, lmessage, "The results file %s cannot be read", Sfile);
+    rc = CEXT_NOFILE;
+    goto cleanup;
+  }
+  occ = (long **)calloc(npatterns > 0 ? npatterns : 1, sizeof(long *));
+  nocc = (long *)calloc(npatterns > 0 ? npatterns : 1, sizeof(long));
+  if (!occ || !nocc || (scanner = cext_scanner_compile(patterns, npatterns)) == NULL ||
+      cext_scan(scanner, f.text, f.length, occ, nocc, (size_t **)&s.linestart, &s.nline)) {
+    unmap_file(&f);
+    goto nomem;
+  }
+  s.text = f.text;
+  s.length = f.length;
+  s.out = (double *)calloc(nresponses > 0 ? nresponses : 1, sizeof(double));
+  s.outset = (char *)calloc(nresponses > 0 ? nresponses : 1, 1);
+  if (!s.out || !s.outset) { unmap_file(&f); goto nomem; }
+
+  /* Response.extract for each response */
+  for (i=0; i<nresponses && !unsupported; i++) {
+    r = &responses[i];
+    m.nrows = m.ncols = 0;
+    for (nrep=1; nrep <= r->nrepeatanchor; nrep++) {
+      stop = find_position(&s, r, slot[i], varslot[i], (const long *const *)occ,
+        nocc, look + lookstart[i], &out[i].status);
+      if (stop == ERR_NOMEM) { unmap_file(&f); goto nomem; }
+      if (stop == ERR_UNSUPPORTED) { unsupported = 1; break; }
+      if (s.completed) break;
+      if (s.outset[slot[i]] && isnan(s.out[slot[i]])) {
+        double nan = NAN;
+        mr.nrows = mr.ncols = 0;
+        if (matrix_add_row(&mr, &nan, 1, &unsupported)) { unmap_file(&f); goto nomem; }
+      } else if (read_response(&s, r, d + i*NDIRECTIVES, &mr, &out[i].status,
+          &unsupported)) {
+        unmap_file(&f);
+        goto nomem;
+      }
+      if (unsupported) break;
+      if (matrix_concat(&m, &mr, r->rowconcat, &unsupported)) { unmap_file(&f); goto nomem; }
+      if (unsupported) break;
+    }
+    if (unsupported) {
+      snprintf(message, lmessage, "The values of the response %s have "
+        "inconsistent sizes or types", r->name);
+      break;
+    }
+    s.out[slot[i]] = (double)s.pos;
+    s.outset[slot[i]] = 1;
+
+    out[i].nrows = m.nrows;
+    out[i].ncols = m.ncols;
+    if (m.nrows*m.ncols > 0) {
+      if ((out[i].data = (double *)malloc(m.nrows*m.ncols*sizeof(double))) == NULL) {
+        unmap_file(&f);
+        goto nomem;
+      }
+      memcpy(out[i].data, m.data, m.nrows*m.ncols*sizeof(double));
+    }
+  }
+  unmap_file(&f);
+  if (unsupported) {
+    cext_free_outputs(nresponses, out);
+    rc = CEXT_UNSUPPORTED;
+  }
+  goto cleanup;
+
+nomem:
+  snprintf(message, lmessage, "Out of memory");
+  cext_free_outputs(nresponses, out);
+  rc = CEXT_OUT_OF_MEMORY;
+
+cleanup:
+  if (occ != NULL)
+    for (k=0; k<npatterns; k++) free(occ[k]);
+  free(occ); free(nocc);
+  cext_scanner_free(scanner);
+  free((void *)s.linestart);
+  free(s.out); free(s.outset);
+  free(s.vpos.first); free(s.vpos.last);
+  free(m.data); free(mr.data);
+  free(d); free(patterns); free(look); free(lookstart); free(slot); free(varslot);
+  return rc;
+}
+
+void cext_free_outputs(int nresponses, cext_output *out)
+{
+  int i;
+  for (i=0; i<nresponses; i++) {
+    free(out[i].data);
+    out[i].data = NULL;
+    out[i].nrows = out[i].ncols = 0;
+  }
+}
@@ -0,0 +1,127 @@
+/*******************************************************************************
+ * cossan_extract.h: single pass extraction of the Responses of an Extractor
+ *
+ * The output file is mapped in memory and scanned once: the anchors
+ * (Clookoutfor) of all the responses are compiled in an Aho-Corasick
+ * automaton and the scan records the lines where each anchor occurs
+ * together with the index of the lines. The responses are then extracted
+ * following the same rules of Response.findRelativePosition and
+ * Response.readResponse, moving on the index of the lines instead of reading
+ * the file again for each response.
+ *
+ * Only literal anchors and the numeric formats of sscanf (%e %f %g %d %i,
+ * with width, %*Nc skip and literal characters) are supported. The other
+ * cases are reported as CEXT_UNSUPPORTED so that the caller can use the
+ * MATLAB implementation.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _COSSAN_EXTRACT_H
+#define _COSSAN_EXTRACT_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Possible return values of cext_extract
+ */
+typedef enum {
+  CEXT_UNSUPPORTED  = -3, /* the responses cannot be extracted natively */
+  CEXT_OUT_OF_MEMORY = -2, /* memory allocation failed */
+  CEXT_NOFILE       = -1, /* the output file cannot be read */
+  CEXT_SUCCESS      =  0
+} cext_result;
+
+/*
+ * Definition of a response (see the properties of Response)
+ */
+typedef struct {
+  const char *name;          /* Sname */
+  const char *const *lookoutfor; /* Clookoutfor */
+  int nlookoutfor;
+  const char *varname;       /* Svarname (NULL or "" if not used) */
+  long nrownum;              /* Nrownum */
+  double nrepeat;            /* Nrepeat (can be Inf) */
+  double nrepeatanchor;      /* NrepeatAnchor (can be Inf) */
+  int rowconcat;             /* the repetitions of the anchor are
+                                concatenated horizontally (VcoordRow) */
+  const char *format;        /* Sfieldformat */
+} cext_response;
+
+/*
+ * Extracted values of a response: nrows x ncols matrix (column-wise)
+ */
+typedef struct {
+  double *data;
+  long nrows, ncols;
+  int status;                /* 0 or one of the CEXT_WARN_* flags */
+} cext_output;
+
+#define CEXT_WARN_ANCHOR   1 /* anchor not found (NaN) */
+#define CEXT_WARN_POSITION 2 /* position of the response not available */
+#define CEXT_WARN_READ     4 /* end of file or values not found */
+
+/*
+ * Compiled multi-pattern scanner (Aho-Corasick)
+ */
+typedef struct cext_scanner cext_scanner;
+
+/* compile the literal patterns. Returns NULL if memory is exhausted */
+extern cext_scanner *cext_scanner_compile(const char *const *patterns,
+  int npatterns);
+extern void cext_scanner_free(cext_scanner *s);
+
+/*
+ * Scan the text. On output lines[k] (nlines[k] elements, allocated by the
+ * function) are the 0-based lines where the pattern k occurs and
+ * linestart the offsets of the beginning of the lines (nline elements, one
+ * more when the text ends with a newline).
+ * Returns 0 on success and -1 if memory is exhausted.
+ */
+extern int cext_scan(const cext_scanner *s, const char *text, size_t length,
+  long **lines, long *nlines, size_t **linestart, long *nline);
+
+/*
+ * Extract the responses from the file. out (nresponses) is allocated by the
+ * caller; the data must be released with cext_free_outputs.
+ */
+extern int cext_extract(const char *Sfile, int nresponses,
+  const cext_response *responses, cext_output *out, char *message,
+  size_t lmessage);
+
+extern void cext_free_outputs(int nresponses, cext_output *out);
+
+/* fast conversion of a decimal number (same result of strtod) */
+extern double cext_strtod(const char *s, const char *end, const char **next);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_EXTRACT_H */
@@ -0,0 +1,351 @@
+/*******************************************************************************
+ * cossan_result.c: binary result files of the connectors
+ *
+ * See cossan_result.h for the format of the file.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <stdarg.h>
+#include "cossan_result.h"
+
+#ifdef _WIN32
+#define fseeko _fseeki64
+#define ftello _ftelli64
+typedef long long off_t_;
+#else
+#include <sys/types.h>
+typedef off_t off_t_;
+#endif
+
+#define LFIXED     24 /* magic, version, number of responses, header size */
+#define LENTRY     32 /* fixed part of the description of a response */
+#define LCHUNK   4096 /* values converted at once on big-endian hosts */
+#define MAX_NAME 4096
+
+static void set_message(char *message, size_t lmessage, const char *fmt, ...)
+{
+  va_list ap;
+  if (message == NULL || lmessage == 0)
+    return;
+  va_start(ap, fmt);
+  vsnprintf(message, lmessage, fmt, ap);
+  va_end(ap);
+}
+
+static int little_endian(void)
+{
+  const uint16_t one = 1;
+  return *(const unsigned char *)&one == 1;
+}
+
+static void put_u32(unsigned char *b, uint32_t v)
+{
+  int i;
+  for (i=0; i<4; i++)
+    b[i] = (unsigned char)(v >> (8*i));
+}
+
+static void put_u64(unsigned char *b, uint64_t v)
+{
+  int i;
+  for (i=0; i<8; i++)
+    b[i] = (unsigned char)(v >> (8*i));
+}
+
+static uint32_t get_u32(const unsigned char *b)
+{
+  return (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 |
+    (uint32_t)b[3] << 24;
+}
+
+static uint64_t get_u64(const unsigned char *b)
+{
+  return (uint64_t)get_u32(b) | (uint64_t)get_u32(b+4) << 32;
+}
+
+static void swap_doubles(double *v, size_t n)
+{
+  size_t i;
+  unsigned char *b, t;
+  for (i=0; i<n; i++) {
+    b = (unsigned char *)(v+i);
+    t = b[0]; b[0] = b[7]; b[7] = t;
+    t = b[1]; b[1] = b[6]; b[6] = t;
+    t = b[2]; b[2] = b[5]; b[5] = t;
+    t = b[3]; b[3] = b[4]; b[4] = t;
+  }
+}
+
+static size_t pad8(size_t n)
+{
+  return (n + 7) & ~(size_t)7;
+}
+
+/*
+ * Write the values in little-endian order
+ */
+static int write_values(FILE *fp, const double *data, size_t n)
+{
+  double chunk[LCHUNK];
+  size_t m;
+
+  if (n == 0)
+    return 0;
+  if (little_endian())
+    return fwrite(data, sizeof(double), n, fp) == n ? 0 : -1;
+  while (n > 0) {
+    m = n < LCHUNK ? n : LCHUNK;
+    memcpy(chunk, data, m*sizeof(double));
+    swap_doubles(chunk, m);
+    if (fwrite(chunk, sizeof(double), m, fp) != m)
+      return -1;
+    data += m;
+    n -= m;
+  }
+  return 0;
+}
+
+int cres_write(const char *Sfile, int nresponses,
+  const cres_response *responses, char *message, size_t lmessage)
+{
+  char *Stmp;
+  unsigned char *header;
+  size_t lheader, offset, lname, pos;
+  FILE *fp;
+  int i, rc = CRES_FILE_ERROR;
+
+  if (nresponses < 0) {
+    set_message(message, lmessage, "Invalid number of responses");
+    return CRES_FORMAT_ERROR;
+  }
+  lheader = LFIXED;
+  for (i=0; i<nresponses; i++) {
+    lname = strlen(responses[i].name);
+    if (lname == 0 || lname > MAX_NAME) {
+      set_message(message, lmessage, "Invalid name of the response %d", i+1);
+      return CRES_FORMAT_ERROR;
+    }
+    lheader += LENTRY + pad8(lname);
+  }
+
+  header = (unsigned char *)calloc(lheader, 1);
+  Stmp = (char *)malloc(strlen(Sfile) + 6);
+  if (header == NULL || Stmp == NULL) {
+    free(header);
+    free(Stmp);
+    set_message(message, lmessage, "Out of memory");
+    return CRES_OUT_OF_MEMORY;
+  }
+  memcpy(header, CRES_MAGIC, 8);
+  put_u32(header+8, CRES_VERSION);
+  put_u32(header+12, (uint32_t)nresponses);
+  put_u64(header+16, (uint64_t)lheader);
+  pos = LFIXED;
+  offset = lheader;
+  for (i=0; i<nresponses; i++) {
+    lname = strlen(responses[i].name);
+    put_u32(header+pos, (uint32_t)lname);
+    put_u64(header+pos+8, (uint64_t)responses[i].nrows);
+    put_u64(header+pos+16, (uint64_t)responses[i].ncols);
+    put_u64(header+pos+24, (uint64_t)offset);
+    memcpy(header+pos+LENTRY, responses[i].name, lname);
+    pos += LENTRY + pad8(lname);
+    offset += responses[i].nrows*responses[i].ncols*sizeof(double);
+  }
+
+  /* the result appears under its name only when complete */
+  sprintf(Stmp, "%s.part", Sfile);
+  fp = fopen(Stmp, "wb");
+  if (fp == NULL) {
+    set_message(message, lmessage, "Cannot open the file %s: %s", Stmp, strerror(errno));
+    free(header);
+    free(Stmp);
+    return CRES_FILE_ERROR;
+  }
+  if (fwrite(header, 1, lheader, fp) == lheader) {
+    for (i=0; i<nresponses; i++)
+      if (write_values(fp, responses[i].data,
+          responses[i].nrows*responses[i].ncols) != 0)
+        break;
+    if (i == nresponses)
+      rc = CRES_SUCCESS;
+  }
+  if (fclose(fp) != 0)
+    rc = CRES_FILE_ERROR;
+  if (rc == CRES_SUCCESS && rename(Stmp, Sfile) != 0)
+    rc = CRES_FILE_ERROR;
+  if (rc != CRES_SUCCESS) {
+    set_message(message, lmessage, "Cannot write the file %s: %s", Sfile, strerror(errno));
+    remove(Stmp);
+  }
+  free(header);
+  free(Stmp);
+  return rc;
+}
+
+int cres_open(const char *Sfile, cres_file *f, char *message, size_t lmessage)
+{
+  unsigned char fixed[LFIXED], *header = NULL;
+  uint64_t lheader, nrows, ncols, offset, lfile;
+  off_t_ lend;
+  size_t pos, lname, lnames = 0;
+  int i, n;
+  char *name;
+
+  memset(f, 0, sizeof(*f));
+  f->fp = fopen(Sfile, "rb");
+  if (f->fp == NULL) {
+    set_message(message, lmessage, "Cannot open the file %s: %s", Sfile, strerror(errno));
+    return CRES_FILE_ERROR;
+  }
+  if (fseeko(f->fp, 0, SEEK_END) != 0 || (lend = ftello(f->fp)) < 0 ||
+      fseeko(f->fp, 0, SEEK_SET) != 0) {
+    set_message(message, lmessage, "Cannot read the file %s", Sfile);
+    cres_close(f);
+    return CRES_FILE_ERROR;
+  }
+  lfile = (uint64_t)lend;
+  if (fread(fixed, 1, LFIXED, f->fp) != LFIXED || memcmp(fixed, CRES_MAGIC, 8) != 0) {
+    set_message(message, lmessage, "The file %s is not a binary result file", Sfile);
+    cres_close(f);
+    return CRES_FORMAT_ERROR;
+  }
+  if (get_u32(fixed+8) != CRES_VERSION) {
+    set_message(message, lmessage, "Version %u of the file %s not supported",
+      (unsigned)get_u32(fixed+8), Sfile);
+    cres_close(f);
+    return CRES_FORMAT_ERROR;
+  }
+  n = (int)get_u32(fixed+12);
+  lheader = get_u64(fixed+16);
+  if (n < 0 || lheader < LFIXED + (uint64_t)n*LENTRY || lheader > lfile) {
+    set_message(message, lmessage, "Corrupted header of the file %s", Sfile);
+    cres_close(f);
+    return CRES_FORMAT_ERROR;
+  }
+
+  header = (unsigned char *)malloc((size_t)lheader - LFIXED + 1);
+  f->entries = (cres_entry *)calloc(n > 0 ? n : 1, sizeof(cres_entry));
+  if (header == NULL || f->entries == NULL) {
+    free(header);
+    set_message(message, lmessage, "Out of memory");
+    cres_close(f);
+    return CRES_OUT_OF_MEMORY;
+  }
+  if (fread(header, 1, (size_t)lheader - LFIXED, f->fp) != lheader - LFIXED) {
+    free(header);
+    set_message(message, lmessage, "Cannot read the file %s", Sfile);
+    cres_close(f);
+    return CRES_FILE_ERROR;
+  }
+
+  /* check the descriptions of the responses against the size of the file */
+  pos = 0;
+  for (i=0; i<n; i++) {
+    if (pos + LENTRY > lheader - LFIXED)
+      break;
+    lname = get_u32(header+pos);
+    nrows = get_u64(header+pos+8);
+    ncols = get_u64(header+pos+16);
+    offset = get_u64(header+pos+24);
+    if (lname == 0 || lname > MAX_NAME || pos + LENTRY + lname > lheader - LFIXED ||
+        offset % 8 != 0 || offset < lheader || offset > lfile ||
+        (ncols > 0 && nrows > (lfile - offset)/sizeof(double)/ncols))
+      break;
+    f->entries[i].nrows = (size_t)nrows;
+    f->entries[i].ncols = (size_t)ncols;
+    f->entries[i].offset = (long long)offset;
+    lnames += lname + 1;
+    pos += LENTRY + pad8(lname);
+  }
+  if (i < n) {
+    free(header);
+    set_message(message, lmessage, "Corrupted description of the response %d in %s",
+      i+1, Sfile);
+    cres_close(f);
+    return CRES_FORMAT_ERROR;
+  }
+
+  f->names = (char *)malloc(lnames > 0 ? lnames : 1);
+  if (f->names == NULL) {
+    free(header);
+    set_message(message, lmessage, "Out of memory");
+    cres_close(f);
+    return CRES_OUT_OF_MEMORY;
+  }
+  pos = 0;
+  name = f->names;
+  for (i=0; i<n; i++) {
+    lname = get_u32(header+pos);
+    memcpy(name, header+pos+LENTRY, lname);
+    name[lname] = '\0';
+    f->entries[i].name = name;
+    name += lname + 1;
+    pos += LENTRY + pad8(lname);
+  }
+  f->nresponses = n;
+  free(header);
+  return CRES_SUCCESS;
+}
+
+int cres_find(const cres_file *f, const char *name)
+{
+  int i;
+  for (i=0; i<f->nresponses; i++)
+    if (strcmp(f->entries[i].name, name) == 0)
+      return i;
+  return -1;
+}
+
+int cres_read(const cres_file *f, int k, double *data)
+{
+  size_t n;
+
+  if (k < 0 || k >= f->nresponses)
+    return CRES_FORMAT_ERROR;
+  n = f->entries[k].nrows*f->entries[k].ncols;
+  if (n == 0)
+    return CRES_SUCCESS;
+  if (fseeko(f->fp, (off_t_)f->entries[k].offset, SEEK_SET) != 0 ||
+      fread(data, sizeof(double), n, f->fp) != n)
+    return CRES_FILE_ERROR;
+  if (!little_endian())
+    swap_doubles(data, n);
+  return CRES_SUCCESS;
+}
+
+void cres_close(cres_file *f)
+{
+  if (f->fp != NULL)
+    fclose(f->fp);
+  free(f->entries);
+  free(f->names);
+  memset(f, 0, sizeof(*f));
+}
@@ -0,0 +1,115 @@
+/*******************************************************************************
+ * cossan_result.h: binary result files of the connectors
+ *
+ * A solver can write its responses in a binary result file instead of an
+ * ASCII output file; the file is read by the BinaryExtractor without any
+ * text conversion. The file is self-describing (all the integers and the
+ * values are little-endian):
+ *
+ *   header      "COSSANRB" (8 bytes), uint32 version (1), uint32 number
+ *               of responses, uint64 size of the header in bytes
+ *   responses   for each response: uint32 length of the name, uint32
+ *               reserved (0), uint64 rows, uint64 columns, uint64 offset of
+ *               the values from the beginning of the file, name (padded
+ *               with zeros to a multiple of 8 bytes)
+ *   values      rows x columns float64 of each response (column-wise),
+ *               starting at the offset of the response (multiple of 8)
+ *
+ * cres_write writes a temporary file that is renamed at the end, so that a
+ * partially written result is never read.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+#ifndef _COSSAN_RESULT_H
+#define _COSSAN_RESULT_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CRES_MAGIC   "COSSANRB"
+#define CRES_VERSION 1
+
+/*
+ * Possible return values of the functions
+ */
+typedef enum {
+  CRES_FORMAT_ERROR  = -3, /* the file is not a valid binary result */
+  CRES_OUT_OF_MEMORY = -2, /* memory allocation failed */
+  CRES_FILE_ERROR    = -1, /* the file cannot be read or written */
+  CRES_SUCCESS       =  0
+} cres_result;
+
+/*
+ * Response to be written: nrows x ncols values (column-wise)
+ */
+typedef struct {
+  const char *name;
+  size_t nrows, ncols;
+  const double *data;
+} cres_response;
+
+/*
+ * Response of an open result file
+ */
+typedef struct {
+  char *name;
+  size_t nrows, ncols;
+  long long offset;           /* offset of the values in the file */
+} cres_entry;
+
+typedef struct {
+  FILE *fp;
+  int nresponses;
+  cres_entry *entries;
+  char *names;                /* storage of the names */
+} cres_file;
+
+/* write the responses in the file Sfile (through Sfile.part) */
+extern int cres_write(const char *Sfile, int nresponses,
+  const cres_response *responses, char *message, size_t lmessage);
+
+/* open the file and read the description of the responses */
+extern int cres_open(const char *Sfile, cres_file *f, char *message,
+  size_t lmessage);
+
+/* index of the response with the given name or -1 */
+extern int cres_find(const cres_file *f, const char *name);
+
+/* read the values of the response k in data (nrows*ncols elements) */
+extern int cres_read(const cres_file *f, int k, double *data);
+
+extern void cres_close(cres_file *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_RESULT_H */
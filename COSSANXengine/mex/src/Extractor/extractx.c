@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * extractx: extraction of the responses from an ASCII file - matlab MEX
+ *
+ * Native implementation of Extractor.extract: the file is mapped in memory
+ * and scanned once for all the anchors of the responses (see
+ * cossan_extract.c). Only literal anchors and the numeric conversions of
+ * sscanf are supported; the other responses raise the error
+ * openCOSSAN:extractx:unsupported and are extracted by the MATLAB code.
+ *
+ * usage:
+ *   [Cvalues,Vstatus] = extractx(Sfile,Tresponses)
+ * where
+ *   Sfile      : full name of the output file
+ *   Tresponses : structure array with the fields Sname, Sfieldformat,
+ *                Clookoutfor, Svarname, Nrownum, Nrepeat, NrepeatAnchor
+ *                and LrowConcat (the properties of the Response objects)
+ *
+ *   Cvalues    : cell array with the values extracted for each response
+ *   Vstatus    : 0 or warning flags of each response (1 anchor not found,
+ *                2 position not available, 4 values not found)
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+#include "cossan_extract.h"
+
+#define LMESSAGE 512
+
+static char *get_string(const mxArray *T, mwIndex i, const char *Sfield)
+{
+    const mxArray *f = mxGetField(T, i, Sfield);
+    if (f == NULL || mxIsEmpty(f))
+        return NULL;
+    if (!mxIsChar(f))
+        mexErrMsgIdAndTxt("openCOSSAN:extractx", "The field %s must be a string", Sfield);
+    return mxArrayToString(f);
+}
+
+static double get_scalar(const mxArray *T, mwIndex i, const char *Sfield)
+{
+    const mxArray *f = mxGetField(T, i, Sfield);
+    if (f == NULL || mxIsEmpty(f) || !(mxIsNumeric(f) || mxIsLogical(f)))
+        mexErrMsgIdAndTxt("openCOSSAN:extractx", "The field %s must be a scalar", Sfield);
+    return mxGetScalar(f);
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    char *Sfile, message[LMESSAGE];
+    const mxArray *c;
+    cext_response *responses;
+    cext_output *out;
+    mwIndex i, j;
+    int n, rc;
+    double *Vstatus;
+
+    /* check input arguments */
+    if (nlhs > 2 || nrhs != 2 || !mxIsChar(prhs[0]) || !mxIsStruct(prhs[1]))
+        mexErrMsgTxt("usage: [Cvalues,Vstatus] = extractx(Sfile,Tresponses) ;");
+
+    n = (int)mxGetNumberOfElements(prhs[1]);
+    Sfile = mxArrayToString(prhs[0]);
+    responses = (cext_response *)mxCalloc(n > 0 ? n : 1, sizeof(cext_response));
+    out = (cext_output *)mxCalloc(n > 0 ? n : 1, sizeof(cext_output));
+
+    for (i=0; i<(mwIndex)n; i++) {
+        responses[i].name = get_string(prhs[1], i, "Sname");
+        responses[i].format = get_string(prhs[1], i, "Sfieldformat");
+        responses[i].varname = get_string(prhs[1], i, "Svarname");
+        if (responses[i].name == NULL || responses[i].format == NULL)
+            mexErrMsgIdAndTxt("openCOSSAN:extractx", "Sname and Sfieldformat are mandatory");
+        responses[i].nrownum = (long)get_scalar(prhs[1], i, "Nrownum");
+        responses[i].nrepeat = get_scalar(prhs[1], i, "Nrepeat");
+        responses[i].nrepeatanchor = get_scalar(prhs[1], i, "NrepeatAnchor");
+        responses[i].rowconcat = get_scalar(prhs[1], i, "LrowConcat") != 0;
+        c = mxGetField(prhs[1], i, "Clookoutfor");
+        if (c != NULL && !mxIsEmpty(c)) {
+            char **CSlook;
+            if (!mxIsCell(c))
+                mexErrMsgIdAndTxt("openCOSSAN:extractx:unsupported",
+                    "Clookoutfor of the response %s must be a cell array", responses[i].name);
+            responses[i].nlookoutfor = (int)mxGetNumberOfElements(c);
+            CSlook = (char **)mxCalloc(responses[i].nlookoutfor, sizeof(char *));
+            for (j=0; j<(mwIndex)responses[i].nlookoutfor; j++) {
+                if (mxGetCell(c, j) == NULL || !mxIsChar(mxGetCell(c, j)))
+                    mexErrMsgIdAndTxt("openCOSSAN:extractx:unsupported",
+                        "Clookoutfor of the response %s must contain strings",
+                        responses[i].name);
+                CSlook[j] = mxArrayToString(mxGetCell(c, j));
+            }
+            responses[i].lookoutfor = (const char *const *)CSlook;
+        }
+    }
+
+    rc = cext_extract(Sfile, n, responses, out, message, sizeof(message));
+    switch (rc) {
+    case CEXT_SUCCESS:
+        break;
+    case CEXT_UNSUPPORTED:
+        mexErrMsgIdAndTxt("openCOSSAN:extractx:unsupported", "%s", message);
+        break;
+    case CEXT_NOFILE:
+        mexErrMsgIdAndTxt("openCOSSAN:extractx:noFile", "%s", message);
+        break;
+    default:
+        mexErrMsgIdAndTxt("openCOSSAN:extractx", "%s", message);
+    }
+
+    plhs[0] = mxCreateCellMatrix(n, 1);
+    plhs[1] = mxCreateDoubleMatrix(n, 1, mxREAL);
+    Vstatus = mxGetPr(plhs[1]);
+    for (i=0; i<(mwIndex)n; i++) {
+        mxArray *M = mxCreateDoubleMatrix(out[i].nrows, out[i].ncols, mxREAL);
+        if (out[i].nrows*out[i].ncols > 0)
+            memcpy(mxGetPr(M), out[i].data, out[i].nrows*out[i].ncols*sizeof(double));
+        mxSetCell(plhs[0], i, M);
+        Vstatus[i] = (double)out[i].status;
+    }
+    cext_free_outputs(n, out);
+}
@@ -0,0 +1,31 @@
+% Script to generate the mex files used to extract the responses from the
+% ASCII output files in a single pass (see cossan_extract.c) and to read the
+% binary result files (see cossan_result.c).
+
+disp('Compiling the extractor mex files ..');
+
+assert(~isempty(OpenCossan.getCossanRoot),'openCOSSAN:makeExtractor','Please initialize OpenCossan')
+
+% mex for the extraction of the responses (Extractor.extract)
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" extractx.c cossan_extract.c
+
+% mex for the binary result files (BinaryExtractor.extract)
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" readresultx.c cossan_result.c
+
+% List of created mex files
+r=dir('*.mex*');
+
+Spath=fullfile(OpenCossan.getCossanRoot,'mex','bin');
+
+
+for n=1:length(r)
+    % Move the compiled file in the appropriate folder
+    [status,message,messageid]=movefile(r(n).name,Spath,'f');
+    
+    if status
+        disp(['MEX FILE ' r(n).name ' created and moved in ' Spath ]);
+    else
+        disp(message);
+        disp(messageid);
+    end
+end
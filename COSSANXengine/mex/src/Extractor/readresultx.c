@@ -0,0 +1,118 @@
+/*******************************************************************************
+ * readresultx: reading of a binary result file - matlab MEX
+ *
+ * Native reader of the binary result files written by the solvers (see
+ * cossan_result.h) used by BinaryExtractor. The values are read directly in
+ * the output matrices.
+ *
+ * usage:
+ *   [Cvalues,Vstatus,CSnames] = readresultx(Sfile)
+ *   [Cvalues,Vstatus] = readresultx(Sfile,CSnames)
+ * where
+ *   Sfile   : full name of the binary result file
+ *   CSnames : names of the responses to be read (default all the responses
+ *             of the file)
+ *
+ *   Cvalues : cell array with the values of each response
+ *   Vstatus : 0 or 1 if the response is not in the file (empty value)
+ *   CSnames : names of the responses of the file
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+#include "cossan_result.h"
+
+#define LMESSAGE 512
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    char *Sfile, *Sname, message[LMESSAGE];
+    cres_file f;
+    mwIndex i;
+    int n, k, rc;
+    double *Vstatus;
+    mxArray *M;
+
+    /* check input arguments */
+    if (nlhs > 3 || nrhs < 1 || nrhs > 2 || !mxIsChar(prhs[0]) ||
+            (nrhs == 2 && !mxIsCell(prhs[1])) || (nrhs == 2 && nlhs > 2))
+        mexErrMsgTxt("usage: [Cvalues,Vstatus,CSnames] = readresultx(Sfile[,CSnames]) ;");
+
+    Sfile = mxArrayToString(prhs[0]);
+    rc = cres_open(Sfile, &f, message, sizeof(message));
+    switch (rc) {
+    case CRES_SUCCESS:
+        break;
+    case CRES_FILE_ERROR:
+        mexErrMsgIdAndTxt("openCOSSAN:readresultx:noFile", "%s", message);
+        break;
+    default:
+        mexErrMsgIdAndTxt("openCOSSAN:readresultx", "%s", message);
+    }
+
+    n = nrhs == 2 ? (int)mxGetNumberOfElements(prhs[1]) : f.nresponses;
+    plhs[0] = mxCreateCellMatrix(n, 1);
+    if (nlhs > 1) {
+        plhs[1] = mxCreateDoubleMatrix(n, 1, mxREAL);
+        Vstatus = mxGetPr(plhs[1]);
+    } else
+        Vstatus = NULL;
+    if (nlhs > 2)
+        plhs[2] = mxCreateCellMatrix(n, 1);
+
+    for (i=0; i<(mwIndex)n; i++) {
+        if (nrhs == 2) {
+            if (mxGetCell(prhs[1], i) == NULL || !mxIsChar(mxGetCell(prhs[1], i))) {
+                cres_close(&f);
+                mexErrMsgIdAndTxt("openCOSSAN:readresultx", "CSnames must contain strings");
+            }
+            Sname = mxArrayToString(mxGetCell(prhs[1], i));
+            k = cres_find(&f, Sname);
+            mxFree(Sname);
+        } else
+            k = (int)i;
+        if (k < 0) {
+            mxSetCell(plhs[0], i, mxCreateDoubleMatrix(0, 0, mxREAL));
+            if (Vstatus != NULL)
+                Vstatus[i] = 1;
+            continue;
+        }
+        M = mxCreateDoubleMatrix((mwSize)f.entries[k].nrows, (mwSize)f.entries[k].ncols, mxREAL);
+        if (cres_read(&f, k, mxGetPr(M)) != CRES_SUCCESS) {
+            snprintf(message, sizeof(message), "Cannot read the response %s from the file %s",
+                f.entries[k].name, Sfile);
+            cres_close(&f);
+            mexErrMsgIdAndTxt("openCOSSAN:readresultx", "%s", message);
+        }
+        mxSetCell(plhs[0], i, M);
+        if (nlhs > 2)
+            mxSetCell(plhs[2], i, mxCreateString(f.entries[k].name));
+    }
+    cres_close(&f);
+}
@@ -0,0 +1,339 @@
+/*******************************************************************************
+ * cossan_ini.c: hashed INI parser for the input decks
+ *
+ * The keys are hashed with FNV-1a of the string section.name, computed on
+ * the section, the dot and the name without building the string. The perfect
+ * hash is built by hash and displace: the keys are grouped in buckets of
+ * about two keys and, from the largest bucket, each bucket gets the first
+ * displacement that puts all its keys in free slots of a table of at least
+ * twice the number of keys. A lookup costs one hash, two mixes and one
+ * comparison.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cossan_ini.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static unsigned int hash_bytes(unsigned int h, const char *s, size_t n)
+{
+  size_t i;
+  for (i=0; i<n; i++) {
+    h ^= (unsigned char)s[i];
+    h *= 16777619U;
+  }
+  return h;
+}
+
+/* FNV-1a of section.name */
+static unsigned int hash_key(unsigned int seed, const char *section,
+  size_t lsection, const char *name, size_t lname)
+{
+  unsigned int h = 2166136261U ^ (seed*2654435761U);
+  if (lsection > 0) {
+    h = hash_bytes(h, section, lsection);
+    h = hash_bytes(h, ".", 1);
+  }
+  return hash_bytes(h, name, lname);
+}
+
+static unsigned int mix(unsigned int h, unsigned int k)
+{
+  h ^= k;
+  h ^= h >> 16;
+  h *= 0x7feb352dU;
+  h ^= h >> 15;
+  h *= 0x846ca68bU;
+  h ^= h >> 16;
+  return h;
+}
+
+/* slot of the hash h with the displacement d of its bucket */
+static unsigned int slot_of(unsigned int h, unsigned int d, unsigned int mask)
+{
+  return (mix(h, 0x9e3779b9U) + d*(mix(h, 0x85ebca6bU) | 1U)) & mask;
+}
+
+static unsigned int bucket_of(unsigned int h, unsigned int bmask)
+{
+  return mix(h, 0xc2b2ae35U) & bmask;
+}
+
+/* section and name of a key: the section ends at the last dot */
+static void split_key(const char *key, const char **name, size_t *lsection)
+{
+  const char *dot = strrchr(key, '.');
+  *lsection = dot != NULL ? (size_t)(dot - key) : 0;
+  *name = dot != NULL ? dot + 1 : key;
+}
+
+/* hash and displace: the largest buckets are placed first */
+static int build(cini_schema *schema, unsigned int size, const unsigned int *h)
+{
+  int count[CINI_MAX_SLOTS/4], order[CINI_MAX_SLOTS/4], members[CINI_MAX_KEYS];
+  unsigned int nbuckets = size/4, b, d;
+  int nkeys = schema->nkeys, k, j, i, n, ok;
+
+  schema->mask = size-1;
+  schema->bmask = nbuckets-1;
+  for (b=0; b<nbuckets; b++) { count[b] = 0; order[b] = (int)b; schema->disp[b] = 0; }
+  for (k=0; k<(int)size; k++) schema->slot[k] = -1;
+  for (k=0; k<nkeys; k++) count[bucket_of(h[k], schema->bmask)]++;
+  /* insertion sort of the buckets by decreasing size */
+  for (i=1; i<(int)nbuckets; i++) {
+    int o = order[i];
+    for (j=i; j>0 && count[order[j-1]] < count[o]; j--) order[j] = order[j-1];
+    order[j] = o;
+  }
+  for (i=0; i<(int)nbuckets && count[order[i]] > 0; i++) {
+    b = (unsigned int)order[i];
+    for (k=0, n=0; k<nkeys; k++)
+      if (bucket_of(h[k], schema->bmask) == b) members[n++] = k;
+    for (d=0; d<65536U; d++) {
+      for (j=0, ok=1; j<n && ok; j++) {
+        unsigned int s = slot_of(h[members[j]], d, schema->mask);
+        if (schema->slot[s] >= 0) {
+          ok = 0;
+        } else {
+          schema->slot[s] = (short)members[j];
+        }
+      }
+      if (ok) break;
+      /* undo the keys of the bucket placed with d */
+      while (--j >= 0) {
+        unsigned int s = slot_of(h[members[j]], d, schema->mask);
+        if (schema->slot[s] == (short)members[j]) schema->slot[s] = -1;
+      }
+    }
+    if (d == 65536U) return -1;
+    schema->disp[b] = (unsigned short)d;
+  }
+  return 0;
+}
+
+int cini_schema_init(cini_schema *schema, const char *const *keys, int nkeys)
+{
+  unsigned int h[CINI_MAX_KEYS], size, seed;
+  const char *name;
+  size_t lsection;
+  int k, j;
+
+  if (nkeys < 0 || nkeys > CINI_MAX_KEYS) return CINI_TOO_MANY;
+  schema->keys = keys;
+  schema->nkeys = nkeys;
+  for (k=0; k<nkeys; k++)
+    for (j=0; j<k; j++)
+      if (strcmp(keys[k], keys[j]) == 0) return CINI_HASH_ERROR;
+
+  for (seed=0; seed<16; seed++) {
+    for (k=0; k<nkeys; k++) {
+      split_key(keys[k], &name, &lsection);
+      h[k] = hash_key(seed, keys[k], lsection, name, strlen(name));
+    }
+    for (size=8; size < 2*(unsigned int)nkeys; size *= 2) ;
+    for (; size <= CINI_MAX_SLOTS; size *= 2) {
+      schema->seed = seed;
+      if (build(schema, size, h) == 0) return CINI_SUCCESS;
+    }
+  }
+  return CINI_HASH_ERROR;
+}
+
+int cini_lookup(const cini_schema *schema, const char *section,
+  size_t lsection, const char *name, size_t lname)
+{
+  const char *key;
+  unsigned int h;
+  int k;
+  if (schema->nkeys == 0) return -1;
+  h = hash_key(schema->seed, section, lsection, name, lname);
+  k = schema->slot[slot_of(h, schema->disp[bucket_of(h, schema->bmask)],
+    schema->mask)];
+  if (k < 0) return -1;
+  /* the slot can hold another key: compare with section.name */
+  key = schema->keys[k];
+  if (lsection > 0) {
+    if (strncmp(key, section, lsection) != 0 || key[lsection] != '.') return -1;
+    key += lsection + 1;
+  }
+  return strncmp(key, name, lname) == 0 && key[lname] == '\0' ? k : -1;
+}
+
+static int is_space(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+int cini_parse(const cini_schema *schema, const char *text, size_t length,
+  cini_value *values, int *errline)
+{
+  const char *p = text, *end = text + length, *eol, *s, *e, *sep, *section = text;
+  size_t lsection = 0;
+  int k, line, rc = CINI_SUCCESS;
+
+  if (errline != NULL) *errline = 0;
+  for (k=0; k<schema->nkeys; k++) {
+    values[k].offset = -1;
+    values[k].length = 0;
+    values[k].line = 0;
+  }
+  if (length >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0) p += 3;
+
+  for (line=1; p < end; p = eol + 1, line++) {
+    if ((eol = (const char *)memchr(p, '\n', end-p)) == NULL) eol = end;
+    for (s=p; s < eol && is_space(*s); s++) ;
+    for (e=eol; e > s && is_space(e[-1]); e--) ;
+    if (s == e || *s == ';' || *s == '#') continue;
+
+    if (*s == '[') {
+      /* [section] */
+      const char *close = (const char *)memchr(s, ']', e-s);
+      if (close == NULL) goto syntax;
+      for (section=s+1; section < close && is_space(*section); section++) ;
+      for (sep=close; sep > section && is_space(sep[-1]); sep--) ;
+      lsection = sep - section;
+      continue;
+    }
+
+    /* name = value */
+    for (sep=s; sep < e && *sep != '=' && *sep != ':'; sep++) ;
+    if (sep == e) goto syntax;
+    {
+      const char *ename = sep, *v = sep + 1, *c;
+      while (ename > s && is_space(ename[-1])) ename--;
+      while (v < e && is_space(*v)) v++;
+      /* inline comment: ';' preceded by whitespace */
+      for (c=v; c < e; c++)
+        if (*c == ';' && c > v && is_space(c[-1])) break;
+      while (c > v && is_space(c[-1])) c--;
+      k = cini_lookup(schema, section, lsection, s, ename - s);
+      if (k >= 0) {
+        values[k].offset = (long)(v - text);
+        values[k].length = (long)(c - v);
+        values[k].line = line;
+      }
+    }
+    continue;
+
+syntax:
+    if (rc == CINI_SUCCESS && errline != NULL) *errline = line;
+    rc = CINI_SYNTAX_ERROR;
+  }
+  return rc;
+}
+
+int cini_map(const char *Sfile, cini_file *file)
+{
+#if !defined(_WIN32)
+  struct stat st;
+  int fd;
+  file->mapped = 0;
+  file->text = NULL;
+  if ((fd = open(Sfile, O_RDONLY)) < 0) return CINI_FILE_ERROR;
+  if (fstat(fd, &st) != 0) { close(fd); return CINI_FILE_ERROR; }
+  file->length = (size_t)st.st_size;
+  if (file->length > 0) {
+    file->text = (char *)mmap(NULL, file->length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (file->text == MAP_FAILED) {
+      file->text = NULL;
+      close(fd);
+      return CINI_FILE_ERROR;
+    }
+    file->mapped = 1;
+  }
+  close(fd);
+  return CINI_SUCCESS;
+#else
+  FILE *fp;
+  long n;
+  file->mapped = 0;
+  if ((fp = fopen(Sfile, "rb")) == NULL) return CINI_FILE_ERROR;
+  fseek(fp, 0, SEEK_END);
+  n = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  file->length = n > 0 ? (size_t)n : 0;
+  file->text = (char *)malloc(file->length + 1);
+  if (file->text == NULL || fread(file->text, 1, file->length, fp) != file->length) {
+    free(file->text);
+    file->text = NULL;
+    fclose(fp);
+    return CINI_FILE_ERROR;
+  }
+  fclose(fp);
+  return CINI_SUCCESS;
+#endif
+}
+
+void cini_unmap(cini_file *file)
+{
+#if !defined(_WIN32)
+  if (file->mapped) munmap(file->text, file->length);
+#else
+  free(file->text);
+#endif
+  file->text = NULL;
+  file->length = 0;
+  file->mapped = 0;
+}
+
+int cini_parse_file(const cini_schema *schema, const char *Sfile,
+  cini_file *file, cini_value *values, int *errline)
+{
+  if (cini_map(Sfile, file) != CINI_SUCCESS) return CINI_FILE_ERROR;
+  return cini_parse(schema, file->text, file->length, values, errline);
+}
+
+int cini_double(const char *text, const cini_value *value, double *x)
+{
+  char buffer[64], *end;
+  /* copied: the mapped value is not terminated */
+  if (value->offset < 0 || value->length == 0 ||
+      value->length >= (long)sizeof(buffer))
+    return -1;
+  memcpy(buffer, text + value->offset, value->length);
+  buffer[value->length] = '\0';
+  *x = strtod(buffer, &end);
+  return (*end != '\0' || end == buffer) ? -1 : 0;
+}
+
+size_t cini_string(const char *text, const cini_value *value, char *buffer,
+  size_t lbuffer)
+{
+  size_t n = value->offset < 0 ? 0 : (size_t)value->length;
+  if (lbuffer == 0) return n;
+  memcpy(buffer, text + (value->offset < 0 ? 0 : value->offset),
+    n < lbuffer ? n : lbuffer-1);
+  buffer[n < lbuffer ? n : lbuffer-1] = '\0';
+  return n;
+}
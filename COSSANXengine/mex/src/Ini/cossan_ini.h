@@ -0,0 +1,128 @@
+/*******************************************************************************
+ * cossan_ini.h: hashed INI parser for the input decks
+ *
+ * The file is memory mapped and parsed in a single pass without copies, line
+ * length limits or allocations. The keys expected by the reader are given as
+ * "section.name" strings (or "name" outside of any section); a perfect hash
+ * of the keys is computed once by cini_schema_init, and each name=value pair
+ * of the file is resolved with one hash and one comparison into the entry of
+ * the key in an array of offsets. Unknown keys are ignored.
+ *
+ * Syntax (the subset of inih used by the decks): [section] headers,
+ * name=value or name:value pairs (whitespace stripped), comments starting
+ * with ';' or '#' at the beginning of a line and with " ;" after a value, an
+ * optional UTF-8 BOM. The keys are case sensitive and the last occurrence of
+ * a key wins.
+ *
+ * cini_map/cini_unmap are also used to read the templates of the Injector
+ * (see ../Injector/cossan_template.c).
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _COSSAN_INI_H
+#define _COSSAN_INI_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Possible return values of the functions
+ */
+typedef enum {
+  CINI_SYNTAX_ERROR = -4, /* line that is not a section, pair or comment */
+  CINI_HASH_ERROR   = -3, /* duplicated keys or no perfect hash found */
+  CINI_TOO_MANY     = -2, /* more than CINI_MAX_KEYS keys */
+  CINI_FILE_ERROR   = -1, /* the file cannot be read */
+  CINI_SUCCESS      =  0
+} cini_result;
+
+#define CINI_MAX_KEYS  512
+#define CINI_MAX_SLOTS (4*CINI_MAX_KEYS) /* power of two */
+
+/* expected keys and their perfect hash */
+typedef struct {
+  const char *const *keys; /* "section.name" (the strings are not copied) */
+  int nkeys;
+  unsigned int seed;       /* seed of the hash */
+  unsigned int mask;       /* number of slots - 1 */
+  unsigned int bmask;      /* number of buckets - 1 */
+  unsigned short disp[CINI_MAX_SLOTS/4]; /* displacement of each bucket */
+  short slot[CINI_MAX_SLOTS];            /* key of each slot (-1 empty) */
+} cini_schema;
+
+/* value of a key: text[offset .. offset+length-1] */
+typedef struct {
+  long offset;  /* -1 if the key is not in the file */
+  long length;
+  int line;     /* line of the file (starting from 1) */
+} cini_value;
+
+/* file in memory (mapped when possible) */
+typedef struct {
+  char *text;
+  size_t length;
+  int mapped;
+} cini_file;
+
+extern int cini_schema_init(cini_schema *schema, const char *const *keys,
+  int nkeys);
+
+/* index of the key section.name (-1 if not expected) */
+extern int cini_lookup(const cini_schema *schema, const char *section,
+  size_t lsection, const char *name, size_t lname);
+
+/*
+ * Parse text (length bytes). values has schema->nkeys entries. Returns
+ * CINI_SUCCESS or CINI_SYNTAX_ERROR (errline is the first wrong line, the
+ * rest of the file is parsed anyway).
+ */
+extern int cini_parse(const cini_schema *schema, const char *text,
+  size_t length, cini_value *values, int *errline);
+
+extern int cini_map(const char *Sfile, cini_file *file);
+extern void cini_unmap(cini_file *file);
+
+/* map and parse a file. The values refer to file->text (cini_unmap after use) */
+extern int cini_parse_file(const cini_schema *schema, const char *Sfile,
+  cini_file *file, cini_value *values, int *errline);
+
+/*
+ * Conversion of the values. cini_double returns 0 and the value in x, or -1
+ * if the value is missing or is not a number. cini_string copies the value
+ * (truncated to lbuffer-1 characters) and returns its length.
+ */
+extern int cini_double(const char *text, const cini_value *value, double *x);
+extern size_t cini_string(const char *text, const cini_value *value,
+  char *buffer, size_t lbuffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_INI_H */
@@ -0,0 +1,392 @@
+/*******************************************************************************
+ * cossan_template.c: compiled templates of the input files of the Injector
+ *
+ * The identifiers are located with the same rules as Injector.scanFile (the
+ * regular expression <cossan\s.+?/> within a line, attributes name, index,
+ * format and original). Formats with more than one conversion are truncated
+ * at the second '%' as done by Injector.replaceIdentifiers.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include "cossan_template.h"
+#include "cossan_ini.h"
+
+#define CTPL_DEFAULT_FORMAT "%10.4e"
+
+static char *strndup_(const char *s, size_t n)
+{
+  char *d = (char *)malloc(n+1);
+  if (d == NULL) return NULL;
+  memcpy(d, s, n);
+  d[n] = '\0';
+  return d;
+}
+
+/* value of the attribute attr="..." in [s,e), NULL if missing */
+static char *attribute(const char *s, const char *e, const char *attr)
+{
+  size_t la = strlen(attr);
+  const char *p, *q;
+  for (p=s; p+la+2 <= e; p++) {
+    if (memcmp(p, attr, la) == 0 && p[la] == '=' && p[la+1] == '"' &&
+        (p == s || isspace((unsigned char)p[-1]))) {
+      p += la+2;
+      /* .+? : at least one character */
+      for (q=p+1; q<e && *q != '"'; q++) ;
+      if (q >= e) return NULL;
+      return strndup_(p, q-p);
+    }
+  }
+  return NULL;
+}
+
+/*
+ * check the printf format: a single conversion, returns the type or -1 and
+ * the position of the conversion character in *conversion
+ */
+static int check_format(char *format, size_t *conversion)
+{
+  char *p = format, *conv = NULL;
+  int type = -1;
+
+  while ((p = strchr(p, '%')) != NULL) {
+    if (p[1] == '%') { p += 2; continue; }
+    if (conv != NULL) { *p = '\0'; break; } /* multiple fields: truncate */
+    conv = p++;
+    while (*p && strchr("-+ #0", *p)) p++;
+    while (isdigit((unsigned char)*p)) p++;
+    if (*p == '.') { p++; while (isdigit((unsigned char)*p)) p++; }
+    if (*p && strchr("eEfFgG", *p)) type = CTPL_PRINTF;
+    else if (*p && strchr("di", *p)) type = CTPL_PRINTF_INT;
+    else return -1;
+    *conversion = (size_t)(p - format);
+    p++;
+  }
+  return conv == NULL ? -1 : type;
+}
+
+/* case insensitive comparison (lower(Sfieldformat) in Identifier) */
+static int same_format(const char *a, const char *b)
+{
+  for (; *a && *b; a++, b++)
+    if (tolower((unsigned char)*a) != tolower((unsigned char)*b)) return 0;
+  return *a == *b;
+}
+
+static int add_name(ctpl_template *t, const char *name)
+{
+  char **tmp;
+  int k;
+  for (k=0; k<t->nnames; k++)
+    if (strcmp(t->names[k], name) == 0) return k;
+  if ((t->nnames & 15) == 0) {
+    tmp = (char **)realloc(t->names, (t->nnames+16)*sizeof(char *));
+    if (tmp == NULL) return -1;
+    t->names = tmp;
+  }
+  if ((t->names[t->nnames] = strndup_(name, strlen(name))) == NULL) return -1;
+  return t->nnames++;
+}
+
+ctpl_template *ctpl_compile(const char *text, size_t length, char *message,
+  size_t lmessage)
+{
+  ctpl_template *t;
+  ctpl_field *f, *tmp;
+  const char *p, *s, *e, *eol, *end = text + length;
+  char *name, *sindex, *format, *original;
+  int nalloc = 0, line = 1;
+
+  if ((t = (ctpl_template *)calloc(1, sizeof(ctpl_template))) == NULL ||
+      (t->text = strndup_(text, length)) == NULL) {
+    snprintf(message, lmessage, "Out of memory");
+    free(t);
+    return NULL;
+  }
+  t->length = length;
+
+  for (p=text; p<end; p=eol+1, line++) {
+    if ((eol = memchr(p, '\n', end-p)) == NULL) eol = end;
+    for (s=p; s+8 <= eol; s++) {
+      if (memcmp(s, "<cossan", 7) != 0 || !isspace((unsigned char)s[7]))
+        continue;
+      /* <cossan\s.+?/> : the shortest match on the line */
+      for (e=s+9; e+1 < eol && !(e[0] == '/' && e[1] == '>'); e++) ;
+      if (e+1 >= eol) break;
+      e += 2;
+
+      if (t->nfields == nalloc) {
+        nalloc = nalloc ? 2*nalloc : 64;
+        tmp = (ctpl_field *)realloc(t->fields, nalloc*sizeof(ctpl_field));
+        if (tmp == NULL) goto nomem;
+        t->fields = tmp;
+      }
+      f = &t->fields[t->nfields];
+      memset(f, 0, sizeof(ctpl_field));
+      f->offset = s - text;
+      f->length = e - s;
+
+      name = attribute(s, e, "name");
+      sindex = attribute(s, e, "index");
+      format = attribute(s, e, "format");
+      original = attribute(s, e, "original");
+      if (name == NULL) {
+        snprintf(message, lmessage, "Identifier without name at line %d", line);
+        free(sindex); free(format); free(original);
+        ctpl_free(t);
+        return NULL;
+      }
+      f->variable = add_name(t, name);
+      free(name);
+      f->index = sindex != NULL ? strtol(sindex, NULL, 10) : 1;
+      free(sindex);
+      f->original = original != NULL ? original : strndup_("0", 1);
+      f->format = format != NULL ? format : strndup_(CTPL_DEFAULT_FORMAT,
+        strlen(CTPL_DEFAULT_FORMAT));
+      t->nfields++;
+      if (f->variable < 0 || f->original == NULL || f->format == NULL)
+        goto nomem;
+      f->noriginal = strtod(f->original, NULL);
+
+      if (same_format(f->format, "nastran8")) {
+        f->type = CTPL_NASTRAN8;
+      } else if (same_format(f->format, "nastran16")) {
+        f->type = CTPL_NASTRAN16;
+      } else if ((f->type = check_format(f->format, &f->conversion)) < 0) {
+        snprintf(message, lmessage, "Format %s at line %d is not supported "
+          "by the native injector", f->format, line);
+        ctpl_free(t);
+        return NULL;
+      }
+      if (f->index < 1) {
+        snprintf(message, lmessage, "Invalid index of %s at line %d",
+          t->names[f->variable], line);
+        ctpl_free(t);
+        return NULL;
+      }
+      s = e-1;
+    }
+  }
+  return t;
+
+nomem:
+  snprintf(message, lmessage, "Out of memory");
+  ctpl_free(t);
+  return NULL;
+}
+
+ctpl_template *ctpl_compile_file(const char *Sfile, char *message,
+  size_t lmessage)
+{
+  cini_file file;
+  ctpl_template *t;
+
+  /* the file is mapped (see cossan_ini.h) */
+  if (cini_map(Sfile, &file) != CINI_SUCCESS) {
+    snprintf(message, lmessage, "Cannot read the file %s", Sfile);
+    return NULL;
+  }
+  t = ctpl_compile(file.text != NULL ? file.text : "", file.length, message,
+    lmessage);
+  cini_unmap(&file);
+  return t;
+}
+
+void ctpl_free(ctpl_template *t)
+{
+  int k;
+  if (t == NULL) return;
+  for (k=0; k<t->nfields; k++) {
+    free(t->fields[k].format);
+    free(t->fields[k].original);
+  }
+  for (k=0; k<t->nnames; k++) free(t->names[k]);
+  free(t->fields); free(t->names); free(t->text); free(t);
+}
+
+/*
+ * NASTRAN fields: transcription of Identifier.num2nastran8/16. The mantissa
+ * of sprintf('%0.14e') is truncated and the 'e' of the exponent removed.
+ */
+void ctpl_nastran8(double x, char *out)
+{
+  char aux[32], v[17];
+  int k = 0, neg = x < 0.0;
+  double a = fabs(x);
+
+  if (x == 0.0) {
+    strcpy(v, "0.");
+  } else {
+    snprintf(aux, sizeof(aux), "%.14e", a);
+    /* aux: d.dddddddddddddde+XX, aux[17] sign, aux[18..19] exponent */
+    if (neg) v[k++] = '-';
+    if (a < 1e-9 || a >= 1e10) {
+      memcpy(v+k, aux, 5-neg); k += 5-neg;
+      memcpy(v+k, aux+17, 3); k += 3;
+    } else if (a >= 1.0 && a < 10.0) {
+      memcpy(v+k, aux, 8-neg); k += 8-neg;
+    } else {
+      memcpy(v+k, aux, 6-neg); k += 6-neg;
+      v[k++] = aux[17];
+      v[k++] = aux[19];
+    }
+    v[k] = '\0';
+  }
+  snprintf(out, 32, "%8s", v);
+}
+
+void ctpl_nastran16(double x, char *out)
+{
+  char v[32];
+  if (x == 0.0)
+    strcpy(v, "0.");
+  else
+    snprintf(v, sizeof(v), x > 0.0 ? "%0.10e" : "%0.9e", x);
+  snprintf(out, 32, "%16s", v);
+}
+
+static int reserve(ctpl_buffer *buf, size_t n)
+{
+  char *p;
+  size_t size;
+  if (buf->length + n <= buf->size) return 0;
+  size = buf->size ? buf->size : 4096;
+  while (size < buf->length + n) size *= 2;
+  if ((p = (char *)realloc(buf->data, size)) == NULL) return -1;
+  buf->data = p;
+  buf->size = size;
+  return 0;
+}
+
+static int append(ctpl_buffer *buf, const char *s, size_t n)
+{
+  if (n == 0) return 0;
+  if (reserve(buf, n)) return -1;
+  memcpy(buf->data + buf->length, s, n);
+  buf->length += n;
+  return 0;
+}
+
+int ctpl_render(const ctpl_template *t, const double *const *values,
+  const long *nvalues, ctpl_buffer *buf, char *message, size_t lmessage)
+{
+  const ctpl_field *f;
+  size_t pos = 0;
+  double v;
+  int k, n;
+
+  for (k=0; k<t->nfields; k++) {
+    f = &t->fields[k];
+    if (append(buf, t->text + pos, f->offset - pos)) goto nomem;
+    pos = f->offset + f->length;
+
+    if (values == NULL) {
+      v = f->noriginal;
+    } else {
+      if (values[f->variable] == NULL || f->index > nvalues[f->variable]) {
+        snprintf(message, lmessage, "Index %ld of the variable %s out of range",
+          f->index, t->names[f->variable]);
+        return -1;
+      }
+      v = values[f->variable][f->index-1];
+    }
+
+    if (reserve(buf, 64)) goto nomem;
+    switch (f->type) {
+    case CTPL_NASTRAN8:
+      ctpl_nastran8(v, buf->data + buf->length);
+      n = (int)strlen(buf->data + buf->length);
+      break;
+    case CTPL_NASTRAN16:
+      ctpl_nastran16(v, buf->data + buf->length);
+      n = (int)strlen(buf->data + buf->length);
+      break;
+    case CTPL_PRINTF_INT:
+      /* as fprintf of matlab: non integer values are printed with %e */
+      if (v == floor(v) && fabs(v) < 9.2e18) {
+        /* add the length modifier: %...d -> %...lld */
+        char *fmt = (char *)malloc(strlen(f->format) + 3);
+        if (fmt == NULL) goto nomem;
+        memcpy(fmt, f->format, f->conversion);
+        strcpy(fmt + f->conversion, "ll");
+        strcpy(fmt + f->conversion + 2, f->format + f->conversion);
+        n = snprintf(NULL, 0, fmt, (long long)v);
+        if (reserve(buf, n+1)) { free(fmt); goto nomem; }
+        snprintf(buf->data + buf->length, n+1, fmt, (long long)v);
+        free(fmt);
+      } else {
+        n = snprintf(NULL, 0, "%e", v);
+        if (reserve(buf, n+1)) goto nomem;
+        snprintf(buf->data + buf->length, n+1, "%e", v);
+      }
+      break;
+    default:
+      n = snprintf(NULL, 0, f->format, v);
+      if (reserve(buf, n+1)) goto nomem;
+      snprintf(buf->data + buf->length, n+1, f->format, v);
+    }
+    buf->length += n;
+  }
+  if (append(buf, t->text + pos, t->length - pos)) goto nomem;
+  return 0;
+
+nomem:
+  snprintf(message, lmessage, "Out of memory");
+  return -1;
+}
+
+int ctpl_write(const ctpl_template *t, const double *const *values,
+  const long *nvalues, const char *Sfile, ctpl_buffer *buf, char *message,
+  size_t lmessage)
+{
+  FILE *fp;
+  size_t nw;
+
+  buf->length = 0;
+  if (ctpl_render(t, values, nvalues, buf, message, lmessage)) return -1;
+  if ((fp = fopen(Sfile, "wb")) == NULL) {
+    snprintf(message, lmessage, "Cannot write the file %s", Sfile);
+    return -1;
+  }
+  nw = fwrite(buf->data, 1, buf->length, fp);
+  if (fclose(fp) != 0 || nw != buf->length) {
+    snprintf(message, lmessage, "Error writing the file %s", Sfile);
+    return -1;
+  }
+  return 0;
+}
+
+void ctpl_buffer_free(ctpl_buffer *buf)
+{
+  free(buf->data);
+  buf->data = NULL;
+  buf->length = buf->size = 0;
+}
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * cossan_template.h: compiled templates of the input files of the Injector
+ *
+ * An input file with the identifiers
+ *
+ *   <cossan name="Xrv1" index="1" format="%12.4e" original="0.000" />
+ *
+ * is parsed once into a list of literal segments and fields. Each input
+ * deck is then rendered into a single buffer (the literal text with the
+ * fields formatted with the values of a realization) and written at once.
+ * The formats are printf-like formats with a single conversion, 'nastran8'
+ * and 'nastran16' (same output as Identifier.num2nastran8/16).
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _COSSAN_TEMPLATE_H
+#define _COSSAN_TEMPLATE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum ctpl_format_type {
+  CTPL_PRINTF = 0,     /* printf-like format (floating point conversion) */
+  CTPL_PRINTF_INT = 1, /* printf-like format with an integer conversion */
+  CTPL_NASTRAN8 = 2,   /* 8 characters NASTRAN field */
+  CTPL_NASTRAN16 = 3   /* 16 characters NASTRAN field */
+};
+
+typedef struct {
+  size_t offset;       /* position of the identifier in the scanned text */
+  size_t length;       /* length of the identifier */
+  int variable;        /* index of the variable in ctpl_template.names */
+  long index;          /* 1-based index of the value in the variable */
+  int type;            /* see ctpl_format_type */
+  char *format;        /* format (CTPL_PRINTF*) */
+  size_t conversion;   /* position of the conversion character in format */
+  char *original;      /* original value (text) */
+  double noriginal;    /* original value */
+} ctpl_field;
+
+typedef struct {
+  char *text;          /* scanned text */
+  size_t length;       /* length of the scanned text */
+  ctpl_field *fields;  /* identifiers, in order of appearance */
+  int nfields;
+  char **names;        /* names of the variables (unique) */
+  int nnames;
+} ctpl_template;
+
+/* growing output buffer */
+typedef struct {
+  char *data;
+  size_t length, size;
+} ctpl_buffer;
+
+/*
+ * Compile the template from the scanned text. Returns NULL on error and a
+ * description in message. Formats not supported by the native engine (e.g.
+ * the tables of the stochastic processes) are reported as errors.
+ */
+extern ctpl_template *ctpl_compile(const char *text, size_t length,
+  char *message, size_t lmessage);
+extern ctpl_template *ctpl_compile_file(const char *Sfile, char *message,
+  size_t lmessage);
+extern void ctpl_free(ctpl_template *t);
+
+/*
+ * Render the template in buf (appended). values[k] points to the nvalues[k]
+ * values of the variable names[k]; values == NULL renders the original
+ * values. Returns 0 on success and -1 if an index is out of range or memory
+ * is exhausted (description in message).
+ */
+extern int ctpl_render(const ctpl_template *t, const double *const *values,
+  const long *nvalues, ctpl_buffer *buf, char *message, size_t lmessage);
+
+/* render and write the file (single write). Returns 0 on success */
+extern int ctpl_write(const ctpl_template *t, const double *const *values,
+  const long *nvalues, const char *Sfile, ctpl_buffer *buf, char *message,
+  size_t lmessage);
+
+/* NASTRAN formats (out must hold at least 32 characters) */
+extern void ctpl_nastran8(double x, char *out);
+extern void ctpl_nastran16(double x, char *out);
+
+extern void ctpl_buffer_free(ctpl_buffer *buf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_TEMPLATE_H */
@@ -0,0 +1,287 @@
+/*******************************************************************************
+ * injectx: native engine of the Injector - matlab MEX
+ *
+ * The file with the identifiers is compiled once (see cossan_template.c) and
+ * cached; each input deck is rendered in memory and written with a single
+ * write instead of the fseek/fprintf of Identifier.replaceValues.
+ *
+ * usage:
+ *   injectx(Sscanfile,Soutfile,Tinput)
+ *   injectx(Sscanfile,CSoutfiles,Tinput)
+ *   Tidentifiers = injectx(Sscanfile)
+ *   injectx('clear')
+ * where
+ *   Sscanfile    : file with the identifiers (Injector.Sscanfilename)
+ *   Soutfile     : input file to be written
+ *   CSoutfiles   : cell array of input files (one per element of Tinput or
+ *                  the same Tinput for all the files if Tinput is 1x1)
+ *   Tinput       : structure of the values. The fields must be double,
+ *                  single or logical arrays. If Tinput is empty the
+ *                  original values are written.
+ *   Tidentifiers : structure array of the identifiers (Sname, Nindex,
+ *                  Sfieldformat, Soriginal)
+ *
+ * The compiled templates are cached by name, size and modification time of
+ * the file. 'clear' empties the cache.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "mex.h"
+#include "cossan_template.h"
+
+#define NCACHE 16
+#define LMESSAGE 512
+
+typedef struct {
+    char *Sfile;
+    long size;
+    time_t mtime;
+    ctpl_template *t;
+} cache_entry;
+
+static cache_entry cache[NCACHE];
+static int ncache = 0, lastcache = 0;
+static ctpl_buffer buffer = {NULL, 0, 0};
+
+static void clear_cache(void)
+{
+    int k;
+    for (k=0; k<ncache; k++) {
+        free(cache[k].Sfile);
+        ctpl_free(cache[k].t);
+    }
+    ncache = 0;
+    lastcache = 0;
+    ctpl_buffer_free(&buffer);
+}
+
+/* compiled template of the file (from the cache if not modified) */
+static const ctpl_template *get_template(const char *Sfile)
+{
+    struct stat st;
+    char message[LMESSAGE];
+    ctpl_template *t;
+    int k;
+
+    if (stat(Sfile, &st) != 0)
+        mexErrMsgIdAndTxt("openCOSSAN:injectx:noscanfile",
+            "The file to be scanned does not exist \n Filename: %s", Sfile);
+
+    for (k=0; k<ncache; k++) {
+        if (strcmp(cache[k].Sfile, Sfile) == 0) {
+            if (cache[k].t != NULL && cache[k].size == (long)st.st_size &&
+                cache[k].mtime == st.st_mtime)
+                return cache[k].t;
+            ctpl_free(cache[k].t);
+            cache[k].t = NULL;
+            break;
+        }
+    }
+
+    if ((t = ctpl_compile_file(Sfile, message, LMESSAGE)) == NULL)
+        mexErrMsgIdAndTxt("openCOSSAN:injectx:unsupportedFormat", "%s", message);
+
+    if (k == ncache) {
+        if (ncache < NCACHE) {
+            ncache++;
+        } else {
+            /* replace the entries in turn */
+            k = lastcache;
+            lastcache = (lastcache + 1) % NCACHE;
+            free(cache[k].Sfile);
+            ctpl_free(cache[k].t);
+        }
+        cache[k].Sfile = (char *)malloc(strlen(Sfile)+1);
+        if (cache[k].Sfile == NULL) {
+            ctpl_free(t);
+            ncache--;
+            mexErrMsgIdAndTxt("openCOSSAN:injectx", "Out of memory");
+        }
+        strcpy(cache[k].Sfile, Sfile);
+    }
+    cache[k].size = (long)st.st_size;
+    cache[k].mtime = st.st_mtime;
+    cache[k].t = t;
+    return t;
+}
+
+/* values of the variables of the template from the element i of Tinput */
+static void get_values(const ctpl_template *t, const mxArray *Tinput,
+    mwIndex i, const double **values, long *nvalues, int *lcopy)
+{
+    const mxArray *field;
+    double *v;
+    mwSize n, j;
+    int k;
+
+    for (k=0; k<t->nnames; k++) {
+        field = mxGetField(Tinput, i, t->names[k]);
+        if (field == NULL)
+            mexErrMsgIdAndTxt("openCOSSAN:injectx:missingField",
+                "The variables %s present in the Injector \n"
+                "is not present in the input object", t->names[k]);
+        n = mxGetNumberOfElements(field);
+        nvalues[k] = (long)n;
+        lcopy[k] = 1;
+        if (mxIsDouble(field) && !mxIsComplex(field)) {
+            values[k] = mxGetPr(field);
+            lcopy[k] = 0;
+        } else if (mxIsSingle(field) && !mxIsComplex(field)) {
+            const float *s = (const float *)mxGetData(field);
+            v = (double *)mxMalloc((n > 0 ? n : 1)*sizeof(double));
+            for (j=0; j<n; j++) v[j] = (double)s[j];
+            values[k] = v;
+        } else if (mxIsLogical(field)) {
+            const mxLogical *l = mxGetLogicals(field);
+            v = (double *)mxMalloc((n > 0 ? n : 1)*sizeof(double));
+            for (j=0; j<n; j++) v[j] = l[j] ? 1.0 : 0.0;
+            values[k] = v;
+        } else {
+            mexErrMsgIdAndTxt("openCOSSAN:injectx:unsupportedClass",
+                "The class %s of the variable %s is not supported by injectx",
+                mxGetClassName(field), t->names[k]);
+        }
+    }
+}
+
+/* release the values converted to double */
+static void free_values(const ctpl_template *t, const double **values,
+    int *lcopy)
+{
+    int k;
+    for (k=0; k<t->nnames; k++) {
+        if (lcopy[k])
+            mxFree((void *)values[k]);
+        lcopy[k] = 0;
+    }
+}
+
+static void write_file(const ctpl_template *t, const double *const *values,
+    const long *nvalues, const mxArray *Soutfile)
+{
+    char message[LMESSAGE], *Sfile;
+
+    if (!mxIsChar(Soutfile))
+        mexErrMsgIdAndTxt("openCOSSAN:injectx", "The name of the input file must be a string");
+    Sfile = mxArrayToString(Soutfile);
+    if (ctpl_write(t, values, nvalues, Sfile, &buffer, message, LMESSAGE)) {
+        mxFree(Sfile);
+        mexErrMsgIdAndTxt("openCOSSAN:injectx", "%s", message);
+    }
+    mxFree(Sfile);
+}
+
+static mxArray *identifiers(const ctpl_template *t)
+{
+    const char *Cfields[] = {"Sname", "Nindex", "Sfieldformat", "Soriginal"};
+    mxArray *T;
+    int k;
+
+    T = mxCreateStructMatrix(t->nfields, 1, 4, Cfields);
+    for (k=0; k<t->nfields; k++) {
+        mxSetField(T, k, "Sname", mxCreateString(t->names[t->fields[k].variable]));
+        mxSetField(T, k, "Nindex", mxCreateDoubleScalar((double)t->fields[k].index));
+        mxSetField(T, k, "Sfieldformat", mxCreateString(t->fields[k].format));
+        mxSetField(T, k, "Soriginal", mxCreateString(t->fields[k].original));
+    }
+    return T;
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    const ctpl_template *t;
+    const mxArray *Tinput;
+    const double **values;
+    long *nvalues;
+    int *lcopy;
+    char *Sscanfile;
+    mwSize nfiles, ninput, i;
+
+    mexAtExit(clear_cache);
+
+    /* check input arguments */
+    if (nrhs < 1 || nrhs > 3 || nrhs == 2 || !mxIsChar(prhs[0]))
+        mexErrMsgTxt("usage: injectx(Sscanfile,Soutfile,Tinput) ;");
+
+    Sscanfile = mxArrayToString(prhs[0]);
+    if (nrhs == 1 && strcmp(Sscanfile, "clear") == 0) {
+        mxFree(Sscanfile);
+        clear_cache();
+        return;
+    }
+    t = get_template(Sscanfile);
+    mxFree(Sscanfile);
+
+    if (nrhs == 1) {
+        plhs[0] = identifiers(t);
+        return;
+    }
+    if (nlhs > 0)
+        mexErrMsgTxt("usage: injectx(Sscanfile,Soutfile,Tinput) ;");
+
+    Tinput = prhs[2];
+    if (!mxIsEmpty(Tinput) && !mxIsStruct(Tinput))
+        mexErrMsgIdAndTxt("openCOSSAN:injectx",
+            "At least the input values must be passed as a structure");
+    ninput = mxIsEmpty(Tinput) ? 0 : mxGetNumberOfElements(Tinput);
+    nfiles = mxIsCell(prhs[1]) ? mxGetNumberOfElements(prhs[1]) : 1;
+    if (!mxIsCell(prhs[1]) && ninput > 1)
+        mexErrMsgIdAndTxt("openCOSSAN:injectx",
+            "Only one realization of the input parameters is allowed");
+    if (ninput > 1 && ninput != nfiles)
+        mexErrMsgIdAndTxt("openCOSSAN:injectx",
+            "The number of input files (%d) and realizations (%d) must agree",
+            (int)nfiles, (int)ninput);
+
+    values  = (const double **)mxCalloc(t->nnames > 0 ? t->nnames : 1, sizeof(double *));
+    nvalues = (long *)mxCalloc(t->nnames > 0 ? t->nnames : 1, sizeof(long));
+    lcopy   = (int *)mxCalloc(t->nnames > 0 ? t->nnames : 1, sizeof(int));
+
+    for (i=0; i<nfiles; i++) {
+        const mxArray *Soutfile = mxIsCell(prhs[1]) ? mxGetCell(prhs[1], i) : prhs[1];
+        if (Soutfile == NULL)
+            mexErrMsgIdAndTxt("openCOSSAN:injectx", "The name of the input file must be a string");
+        if (ninput == 0) {
+            write_file(t, NULL, NULL, Soutfile);
+        } else {
+            /* Tinput(1) is reused for all the files if 1x1 */
+            mwIndex j = ninput > 1 ? i : 0;
+            if (i == 0 || ninput > 1)
+                get_values(t, Tinput, j, values, nvalues, lcopy);
+            write_file(t, values, nvalues, Soutfile);
+            if (ninput > 1 || i == nfiles-1)
+                free_values(t, values, lcopy);
+        }
+    }
+
+    mxFree(values);
+    mxFree(nvalues);
+    mxFree(lcopy);
+}
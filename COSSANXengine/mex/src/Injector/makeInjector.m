@@ -0,0 +1,28 @@
+% Script to generate the mex file of the native engine of the Injector.
+% The file with the identifiers is compiled once and the input files are
+% rendered in memory (see cossan_template.c)
+
+disp('Compiling the Injector mex files ..');
+
+assert(~isempty(OpenCossan.getCossanRoot),'openCOSSAN:makeInjector','Please initialize OpenCossan')
+
+% mex for the injection of the input values (Injector.inject)
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" -I../Ini injectx.c cossan_template.c ../Ini/cossan_ini.c
+
+% List of created mex files
+r=dir('*.mex*');
+
+Spath=fullfile(OpenCossan.getCossanRoot,'mex','bin');
+
+
+for n=1:length(r)
+    % Move the compiled file in the appropriate folder
+    [status,message,messageid]=movefile(r(n).name,Spath,'f');
+    
+    if status
+        disp(['MEX FILE ' r(n).name ' created and moved in ' Spath ]);
+    else
+        disp(message);
+        disp(messageid);
+    end
+end
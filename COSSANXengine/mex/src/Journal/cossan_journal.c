@@ -0,0 +1,517 @@
+/*******************************************************************************
+ * cossan_journal.c: result journal of the Evaluator (see cossan_journal.h)
+ *
+ * The outputs of the records are kept in memory with an open addressing
+ * hash table on the hash of the inputs (linear probing).
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cossan_journal.h"
+
+#if !defined(_WIN32)
+#include <sys/types.h>
+#include <unistd.h>
+#else
+#include <io.h>
+#include <fcntl.h>
+#define fseeko _fseeki64
+#define ftello _ftelli64
+#endif
+
+#define RECORD_MARKER 0x4c524a43u /* "CJRL" */
+#define LRECORD_FIXED 24          /* marker, number of outputs, index, hash */
+#define LHEADER_FIXED 32          /* magic, version, numbers of variables, model */
+#define MAX_NAMES     (1 << 24)   /* maximum length of the names */
+#define EMPTY         (-1)        /* free slot of the hash table */
+
+struct cjournal {
+  FILE *fp;
+  int sync;
+  int noutputs;
+  long long discarded;
+  size_t nentries, capacity;
+  uint64_t *hashes;              /* hash of the inputs of each entry */
+  double *values;                /* noutputs values of each entry */
+  long *table;                   /* entries by hash */
+  size_t size;                   /* slots of the table (power of 2) */
+  unsigned char *record;         /* buffer of a record */
+};
+
+static void put_u32(unsigned char *b, uint32_t v)
+{
+  int i;
+  for (i=0; i<4; i++)
+    b[i] = (unsigned char)(v >> (8*i));
+}
+
+static void put_u64(unsigned char *b, uint64_t v)
+{
+  int i;
+  for (i=0; i<8; i++)
+    b[i] = (unsigned char)(v >> (8*i));
+}
+
+static uint32_t get_u32(const unsigned char *b)
+{
+  return (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 |
+    (uint32_t)b[3] << 24;
+}
+
+static uint64_t get_u64(const unsigned char *b)
+{
+  return (uint64_t)get_u32(b) | (uint64_t)get_u32(b+4) << 32;
+}
+
+static void put_double(unsigned char *b, double x)
+{
+  uint64_t u;
+  memcpy(&u, &x, sizeof(u));
+  put_u64(b, u);
+}
+
+static double get_double(const unsigned char *b)
+{
+  uint64_t u = get_u64(b);
+  double x;
+  memcpy(&x, &u, sizeof(x));
+  return x;
+}
+
+static uint32_t crc32(const unsigned char *b, size_t n)
+{
+  static uint32_t table[256];
+  static int init = 0;
+  uint32_t c;
+  size_t i;
+  int k;
+
+  if (!init) {
+    for (i=0; i<256; i++) {
+      c = (uint32_t)i;
+      for (k=0; k<8; k++)
+        c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      table[i] = c;
+    }
+    init = 1;
+  }
+  c = 0xffffffffu;
+  for (i=0; i<n; i++)
+    c = table[(c ^ b[i]) & 0xff] ^ (c >> 8);
+  return c ^ 0xffffffffu;
+}
+
+static void set_message(char *message, size_t lmessage, const char *text,
+                        const char *file)
+{
+  if (message != NULL && lmessage > 0)
+    snprintf(message, lmessage, text, file);
+}
+
+uint64_t cjournal_hash(const double *x, size_t n, size_t stride)
+{
+  uint64_t h = 14695981039346656037ull, u;
+  double v;
+  size_t i;
+  int k;
+
+  for (i=0; i<n; i++) {
+    v = x[i*stride];
+    if (v == 0)
+      u = 0;
+    else if (v != v)
+      u = 0x7ff8000000000000ull;
+    else
+      memcpy(&u, &v, sizeof(u));
+    for (k=0; k<8; k++) {
+      h ^= (u >> (8*k)) & 0xff;
+      h *= 1099511628211ull;
+    }
+  }
+  return h;
+}
+
+/* FNV-1a hash of the definition of the model */
+static uint64_t model_hash(const unsigned char *model, size_t lmodel)
+{
+  uint64_t h = 14695981039346656037ull;
+  size_t i;
+
+  for (i=0; i<lmodel; i++) {
+    h ^= model[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+/* header of the journal (length in *lheader) */
+static unsigned char *build_header(int ninputs, const char *const *inputs,
+                                   int noutputs, const char *const *outputs,
+                                   uint64_t model, size_t *lheader)
+{
+  unsigned char *header, *p;
+  size_t lnames = 0;
+  int i;
+
+  for (i=0; i<ninputs; i++)
+    lnames += strlen(inputs[i]) + 1;
+  for (i=0; i<noutputs; i++)
+    lnames += strlen(outputs[i]) + 1;
+  if (lnames > MAX_NAMES)
+    return NULL;
+  *lheader = LHEADER_FIXED + lnames + 4;
+  if ((header = malloc(*lheader)) == NULL)
+    return NULL;
+  memcpy(header, CJOURNAL_MAGIC, 8);
+  put_u32(header+8, CJOURNAL_VERSION);
+  put_u32(header+12, (uint32_t)ninputs);
+  put_u32(header+16, (uint32_t)noutputs);
+  put_u32(header+20, (uint32_t)lnames);
+  put_u64(header+24, model);
+  p = header + LHEADER_FIXED;
+  for (i=0; i<ninputs; i++) {
+    memcpy(p, inputs[i], strlen(inputs[i]) + 1);
+    p += strlen(inputs[i]) + 1;
+  }
+  for (i=0; i<noutputs; i++) {
+    memcpy(p, outputs[i], strlen(outputs[i]) + 1);
+    p += strlen(outputs[i]) + 1;
+  }
+  put_u32(p, crc32(header+8, (size_t)(p - header) - 8));
+  return header;
+}
+
+static int sync_file(FILE *fp)
+{
+#if !defined(_WIN32)
+  return fsync(fileno(fp));
+#else
+  return _commit(_fileno(fp));
+#endif
+}
+
+/* create the journal with its header (written to file.part and renamed) */
+static int create_journal(const char *file, const unsigned char *header,
+                          size_t lheader)
+{
+  char *part;
+  FILE *fp;
+  int rc = CJOURNAL_SUCCESS;
+
+  if ((part = malloc(strlen(file) + 6)) == NULL)
+    return CJOURNAL_OUT_OF_MEMORY;
+  sprintf(part, "%s.part", file);
+  if ((fp = fopen(part, "wb")) == NULL) {
+    free(part);
+    return CJOURNAL_FILE_ERROR;
+  }
+  if (fwrite(header, 1, lheader, fp) != lheader || fflush(fp) != 0 ||
+      sync_file(fp) != 0)
+    rc = CJOURNAL_FILE_ERROR;
+  if (fclose(fp) != 0)
+    rc = CJOURNAL_FILE_ERROR;
+#if defined(_WIN32)
+  remove(file);
+#endif
+  if (rc == CJOURNAL_SUCCESS && rename(part, file) != 0)
+    rc = CJOURNAL_FILE_ERROR;
+  if (rc != CJOURNAL_SUCCESS)
+    remove(part);
+  free(part);
+  return rc;
+}
+
+static int truncate_file(const char *file, long long length)
+{
+#if !defined(_WIN32)
+  return truncate(file, (off_t)length);
+#else
+  int fd, rc;
+  if ((fd = _open(file, _O_RDWR | _O_BINARY)) < 0)
+    return -1;
+  rc = _chsize_s(fd, length);
+  _close(fd);
+  return rc;
+#endif
+}
+
+/*
+ * Slot of the entry with the hash or of the free slot where it is
+ * inserted
+ */
+static size_t find_slot(const cjournal *journal, uint64_t hash)
+{
+  size_t mask = journal->size - 1, i = (size_t)(hash ^ (hash >> 32)) & mask;
+
+  while (journal->table[i] != EMPTY && journal->hashes[journal->table[i]] != hash)
+    i = (i + 1) & mask;
+  return i;
+}
+
+static int grow(cjournal *journal)
+{
+  size_t capacity, size, k;
+  uint64_t *hashes;
+  double *values;
+  long *table;
+
+  if (journal->nentries == journal->capacity) {
+    capacity = journal->capacity ? 2*journal->capacity : 1024;
+    if ((hashes = realloc(journal->hashes, capacity*sizeof(uint64_t))) == NULL)
+      return CJOURNAL_OUT_OF_MEMORY;
+    journal->hashes = hashes;
+    values = realloc(journal->values,
+                     capacity*(size_t)(journal->noutputs ? journal->noutputs : 1)*sizeof(double));
+    if (values == NULL)
+      return CJOURNAL_OUT_OF_MEMORY;
+    journal->values = values;
+    journal->capacity = capacity;
+  }
+  if (2*(journal->nentries + 1) > journal->size) {
+    size = journal->size ? 2*journal->size : 2048;
+    if ((table = malloc(size*sizeof(long))) == NULL)
+      return CJOURNAL_OUT_OF_MEMORY;
+    free(journal->table);
+    journal->table = table;
+    journal->size = size;
+    for (k=0; k<size; k++)
+      table[k] = EMPTY;
+    for (k=0; k<journal->nentries; k++)
+      table[find_slot(journal, journal->hashes[k])] = (long)k;
+  }
+  return CJOURNAL_SUCCESS;
+}
+
+/* store the outputs of the sample with the hash (replacing the previous) */
+static int insert(cjournal *journal, uint64_t hash, const double *values,
+                  size_t stride)
+{
+  size_t slot;
+  double *v;
+  long k;
+  int i, rc;
+
+  if ((rc = grow(journal)) != CJOURNAL_SUCCESS)
+    return rc;
+  slot = find_slot(journal, hash);
+  if ((k = journal->table[slot]) == EMPTY) {
+    k = (long)journal->nentries++;
+    journal->hashes[k] = hash;
+    journal->table[slot] = k;
+  }
+  v = journal->values + (size_t)k*(size_t)journal->noutputs;
+  for (i=0; i<journal->noutputs; i++)
+    v[i] = values[(size_t)i*stride];
+  return CJOURNAL_SUCCESS;
+}
+
+/*
+ * Read the records of the journal fp after the header. Returns the number
+ * of records or a negative cjournal_result; *valid receives the end of
+ * the last valid record.
+ */
+static int load_records(cjournal *journal, FILE *fp, long long *valid)
+{
+  size_t lrecord = LRECORD_FIXED + 8*(size_t)journal->noutputs + 4;
+  unsigned char *b = journal->record;
+  double *values;
+  int i, n = 0, rc;
+
+  if ((values = malloc(((size_t)journal->noutputs + 1)*sizeof(double))) == NULL)
+    return CJOURNAL_OUT_OF_MEMORY;
+  while (fread(b, 1, lrecord, fp) == lrecord) {
+    if (get_u32(b) != RECORD_MARKER ||
+        get_u32(b+4) != (uint32_t)journal->noutputs ||
+        get_u32(b+lrecord-4) != crc32(b+4, lrecord-8))
+      break;
+    for (i=0; i<journal->noutputs; i++)
+      values[i] = get_double(b + LRECORD_FIXED + 8*i);
+    if ((rc = insert(journal, get_u64(b+16), values, 1)) != CJOURNAL_SUCCESS) {
+      free(values);
+      return rc;
+    }
+    *valid += (long long)lrecord;
+    n++;
+  }
+  free(values);
+  return n;
+}
+
+int cjournal_open(const char *file, int ninputs, const char *const *inputs,
+                  int noutputs, const char *const *outputs,
+                  const unsigned char *model, size_t lmodel, int sync,
+                  cjournal **journal, char *message, size_t lmessage)
+{
+  cjournal *j;
+  unsigned char *header, *b;
+  size_t lheader;
+  long long size = 0, valid;
+  FILE *fp;
+  int rc, nrecords = 0;
+
+  *journal = NULL;
+  if (ninputs < 0 || noutputs < 0)
+    return CJOURNAL_FORMAT_ERROR;
+  if ((header = build_header(ninputs, inputs, noutputs, outputs,
+                             model_hash(model, lmodel), &lheader)) == NULL)
+    return CJOURNAL_OUT_OF_MEMORY;
+  if ((j = calloc(1, sizeof(cjournal))) == NULL ||
+      (j->record = malloc(LRECORD_FIXED + 8*(size_t)noutputs + 4)) == NULL ||
+      (b = malloc(lheader)) == NULL) {
+    if (j != NULL)
+      free(j->record);
+    free(j);
+    free(header);
+    return CJOURNAL_OUT_OF_MEMORY;
+  }
+  j->noutputs = noutputs;
+  j->sync = sync;
+  memset(b, 0, lheader);
+
+  if ((fp = fopen(file, "rb")) != NULL) {
+    fseeko(fp, 0, SEEK_END);
+    size = (long long)ftello(fp);
+    rewind(fp);
+  }
+  if (size <= 0) {
+    /* new journal */
+    if (fp != NULL)
+      fclose(fp);
+    rc = create_journal(file, header, lheader);
+    if (rc != CJOURNAL_SUCCESS)
+      set_message(message, lmessage, "Cannot create the journal %s", file);
+  } else if (fread(b, 1, lheader, fp) != lheader || memcmp(b, header, lheader) != 0) {
+    fclose(fp);
+    if (memcmp(b, CJOURNAL_MAGIC, 8) != 0)
+      set_message(message, lmessage, "The file %s is not a journal", file);
+    else if (get_u32(b+8) != CJOURNAL_VERSION)
+      set_message(message, lmessage,
+                  "The journal %s was written by another version of openCOSSAN", file);
+    else if (memcmp(b+12, header+12, 12) == 0 &&
+             memcmp(b+LHEADER_FIXED, header+LHEADER_FIXED, lheader-LHEADER_FIXED-4) == 0)
+      set_message(message, lmessage,
+                  "The journal %s was written by another model (remove it to evaluate "
+                  "the samples again)", file);
+    else
+      set_message(message, lmessage,
+                  "The journal %s was written for other inputs or outputs", file);
+    rc = CJOURNAL_FORMAT_ERROR;
+  } else {
+    /* records of the previous runs, the incomplete tail is removed */
+    valid = (long long)lheader;
+    rc = nrecords = load_records(j, fp, &valid);
+    fclose(fp);
+    if (rc >= 0 && valid < size) {
+      j->discarded = size - valid;
+      if (truncate_file(file, valid) != 0) {
+        set_message(message, lmessage, "Cannot repair the journal %s", file);
+        rc = CJOURNAL_FILE_ERROR;
+      }
+    }
+  }
+  free(b);
+  free(header);
+
+  if (rc >= 0 && (j->fp = fopen(file, "ab")) == NULL) {
+    set_message(message, lmessage, "Cannot open the journal %s", file);
+    rc = CJOURNAL_FILE_ERROR;
+  }
+  if (rc < 0) {
+    cjournal_close(j);
+    return rc;
+  }
+  *journal = j;
+  return nrecords;
+}
+
+void cjournal_close(cjournal *journal)
+{
+  if (journal == NULL)
+    return;
+  if (journal->fp != NULL) {
+    cjournal_flush(journal);
+    fclose(journal->fp);
+  }
+  free(journal->hashes);
+  free(journal->values);
+  free(journal->table);
+  free(journal->record);
+  free(journal);
+}
+
+long long cjournal_discarded(const cjournal *journal)
+{
+  return journal->discarded;
+}
+
+int cjournal_noutputs(const cjournal *journal)
+{
+  return journal->noutputs;
+}
+
+const double *cjournal_lookup(const cjournal *journal, uint64_t hash)
+{
+  long k;
+
+  if (journal->size == 0)
+    return NULL;
+  k = journal->table[find_slot(journal, hash)];
+  return k == EMPTY ? NULL : journal->values + (size_t)k*(size_t)journal->noutputs;
+}
+
+int cjournal_append(cjournal *journal, uint64_t index, uint64_t hash,
+                    const double *values, size_t stride)
+{
+  size_t lrecord = LRECORD_FIXED + 8*(size_t)journal->noutputs + 4;
+  unsigned char *b = journal->record;
+  int i, rc;
+
+  put_u32(b, RECORD_MARKER);
+  put_u32(b+4, (uint32_t)journal->noutputs);
+  put_u64(b+8, index);
+  put_u64(b+16, hash);
+  for (i=0; i<journal->noutputs; i++)
+    put_double(b + LRECORD_FIXED + 8*i, values[(size_t)i*stride]);
+  put_u32(b+lrecord-4, crc32(b+4, lrecord-8));
+  if (fwrite(b, 1, lrecord, journal->fp) != lrecord)
+    return CJOURNAL_FILE_ERROR;
+  if ((rc = insert(journal, hash, values, stride)) != CJOURNAL_SUCCESS)
+    return rc;
+  return CJOURNAL_SUCCESS;
+}
+
+int cjournal_flush(cjournal *journal)
+{
+  if (fflush(journal->fp) != 0)
+    return CJOURNAL_FILE_ERROR;
+  if (journal->sync && sync_file(journal->fp) != 0)
+    return CJOURNAL_FILE_ERROR;
+  return CJOURNAL_SUCCESS;
+}
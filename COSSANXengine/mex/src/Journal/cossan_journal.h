@@ -0,0 +1,124 @@
+/*******************************************************************************
+ * cossan_journal.h: result journal of the Evaluator
+ *
+ * Append-only binary file with one record per sample evaluated
+ * successfully, used to resume an analysis after an interruption without
+ * evaluating again the samples already in the journal. A sample is
+ * identified by the hash of the values of its inputs. All the integers
+ * and the values are little-endian:
+ *
+ *   header   "COSSANJL" (8 bytes), uint32 version (2), uint32 number of
+ *            inputs, uint32 number of outputs, uint32 length of the names,
+ *            uint64 hash of the definition of the model, names of the
+ *            inputs and of the outputs (each terminated by a zero), uint32
+ *            CRC-32 of the header after the magic
+ *   records  uint32 marker, uint32 number of outputs, uint64 index of the
+ *            sample, uint64 hash of the inputs, float64 values of the
+ *            outputs, uint32 CRC-32 of the record after the marker
+ *
+ * The header of a new journal is written to a temporary file that is
+ * renamed. When the journal is opened the records are verified and an
+ * incomplete or damaged tail (interruption during a write) is removed, so
+ * that the journal can be appended again. The records are written to the
+ * file by cjournal_flush and, with the sync option, to the disk.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+
+#ifndef _COSSAN_JOURNAL_H
+#define _COSSAN_JOURNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CJOURNAL_MAGIC   "COSSANJL"
+#define CJOURNAL_VERSION 2
+
+/*
+ * Possible return values of the functions
+ */
+typedef enum {
+  CJOURNAL_FORMAT_ERROR  = -3, /* not a journal or written for another model */
+  CJOURNAL_OUT_OF_MEMORY = -2, /* memory allocation failed */
+  CJOURNAL_FILE_ERROR    = -1, /* the file cannot be read or written */
+  CJOURNAL_SUCCESS       =  0
+} cjournal_result;
+
+typedef struct cjournal cjournal;
+
+/*
+ * Open the journal file (created if it does not exist) for the variables
+ * inputs and outputs of the model identified by the lmodel bytes of its
+ * definition, and load its records. A journal written for other variables
+ * or for another model is not opened. Returns the number of records loaded
+ * or a negative cjournal_result (with a description in message).
+ */
+int cjournal_open(const char *file, int ninputs, const char *const *inputs,
+                  int noutputs, const char *const *outputs,
+                  const unsigned char *model, size_t lmodel, int sync,
+                  cjournal **journal, char *message, size_t lmessage);
+
+/* Flush the pending records and close the journal */
+void cjournal_close(cjournal *journal);
+
+/* Bytes of incomplete records removed by cjournal_open */
+long long cjournal_discarded(const cjournal *journal);
+
+/* Number of outputs of the records */
+int cjournal_noutputs(const cjournal *journal);
+
+/*
+ * Hash of the n inputs of a sample (x[0], x[stride], ...). -0 and 0, and
+ * all the NaN, have the same hash.
+ */
+uint64_t cjournal_hash(const double *x, size_t n, size_t stride);
+
+/*
+ * Outputs of the sample with the hash (the last record of the sample) or
+ * NULL if the sample is not in the journal.
+ */
+const double *cjournal_lookup(const cjournal *journal, uint64_t hash);
+
+/*
+ * Append the record of a sample with the outputs values[0],
+ * values[stride], ...
+ */
+int cjournal_append(cjournal *journal, uint64_t index, uint64_t hash,
+                    const double *values, size_t stride);
+
+/* Write the records to the file (and to the disk with the sync option) */
+int cjournal_flush(cjournal *journal);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_JOURNAL_H */
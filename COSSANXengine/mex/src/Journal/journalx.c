@@ -0,0 +1,207 @@
+/*******************************************************************************
+ * journalx: result journal of the Evaluator - matlab MEX
+ *
+ * Append-only journal of the outputs of the samples evaluated successfully
+ * (see cossan_journal.h). One journal is open at a time; it is closed by
+ * 'close', by the next 'open' or when the mex file is cleared.
+ *
+ * usage:
+ *   [Nrecords,Ndiscarded] = journalx('open',Sfile,CSinputNames,CSoutputNames,Lsync,Vmodel)
+ *   [Lfound,Moutputs] = journalx('lookup',Minputs)
+ *   journalx('append',Vindex,Minputs,Moutputs)
+ *   journalx('close')
+ * where
+ *   Sfile      : journal file (created if it does not exist)
+ *   Nrecords   : number of records of the journal
+ *   Ndiscarded : bytes of incomplete records removed from the journal
+ *   Lsync      : flush the records to the disk at each 'append'
+ *   Vmodel     : definition of the model (uint8, see modelDefinition of
+ *                the Evaluator); the journal of another model is not opened
+ *   Minputs    : values of the inputs, one row per sample
+ *   Lfound     : true for the samples in the journal
+ *   Moutputs   : values of the outputs, one row per sample (NaN for the
+ *                samples not found)
+ *   Vindex     : index of the samples in the analysis
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+#include "cossan_journal.h"
+
+static cjournal *journal = NULL;
+
+static void close_journal(void)
+{
+    cjournal_close(journal);
+    journal = NULL;
+}
+
+static void check_rc(int rc)
+{
+    switch (rc) {
+    case CJOURNAL_FILE_ERROR:
+        mexErrMsgIdAndTxt("openCOSSAN:journalx:fileError", "Cannot write the journal");
+        break;
+    case CJOURNAL_OUT_OF_MEMORY:
+        mexErrMsgIdAndTxt("openCOSSAN:journalx", "Out of memory");
+        break;
+    }
+}
+
+static const double *get_matrix(const mxArray *M, int k)
+{
+    if (!mxIsDouble(M) || mxIsComplex(M) || mxIsSparse(M))
+        mexErrMsgIdAndTxt("openCOSSAN:journalx", "Argument %d must be a real matrix", k+1);
+    return mxGetPr(M);
+}
+
+/* strings of a cell array (freed with free_names) */
+static char **get_names(const mxArray *CS, int k, int *n)
+{
+    char **names;
+    const mxArray *S;
+    int i;
+
+    if (!mxIsCell(CS))
+        mexErrMsgIdAndTxt("openCOSSAN:journalx", "Argument %d must be a cell array of strings", k+1);
+    *n = (int)mxGetNumberOfElements(CS);
+    names = mxCalloc(*n > 0 ? *n : 1, sizeof(char *));
+    for (i=0; i<*n; i++) {
+        S = mxGetCell(CS, i);
+        if (S == NULL || !mxIsChar(S))
+            mexErrMsgIdAndTxt("openCOSSAN:journalx", "Argument %d must be a cell array of strings", k+1);
+        names[i] = mxArrayToString(S);
+    }
+    return names;
+}
+
+static void free_names(char **names, int n)
+{
+    int i;
+    for (i=0; i<n; i++)
+        mxFree(names[i]);
+    mxFree(names);
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    char Saction[16], message[512];
+    char *Sfile, **CSinputs, **CSoutputs;
+    const double *Minputs, *Moutputs, *Vindex, *values;
+    double *Mfound;
+    mxLogical *Lfound;
+    mwSize nsamples, ninputs, k;
+    int nin, nout, i, rc;
+
+    mexAtExit(close_journal);
+
+    if (nrhs < 1 || !mxIsChar(prhs[0]) || mxGetString(prhs[0], Saction, sizeof(Saction)) != 0)
+        mexErrMsgTxt("usage: journalx(Saction,...) ; (open, lookup, append or close)");
+
+    if (strcmp(Saction, "close") == 0) {
+        close_journal();
+        return;
+    }
+
+    if (strcmp(Saction, "open") == 0) {
+        if (nrhs < 4 || nrhs > 6 || nlhs > 2 || !mxIsChar(prhs[1]) ||
+            (nrhs > 5 && !mxIsUint8(prhs[5])))
+            mexErrMsgTxt("usage: [Nrecords,Ndiscarded] = journalx('open',Sfile,CSinputNames,CSoutputNames,Lsync,Vmodel) ;");
+        close_journal();
+        CSinputs = get_names(prhs[2], 2, &nin);
+        CSoutputs = get_names(prhs[3], 3, &nout);
+        Sfile = mxArrayToString(prhs[1]);
+        message[0] = '\0';
+        rc = cjournal_open(Sfile, nin, (const char *const *)CSinputs, nout,
+                           (const char *const *)CSoutputs,
+                           nrhs > 5 ? (const unsigned char *)mxGetData(prhs[5]) : NULL,
+                           nrhs > 5 ? mxGetNumberOfElements(prhs[5]) : 0,
+                           nrhs > 4 && mxIsLogicalScalarTrue(prhs[4]), &journal,
+                           message, sizeof(message));
+        free_names(CSinputs, nin);
+        free_names(CSoutputs, nout);
+        mxFree(Sfile);
+        if (rc < 0) {
+            if (message[0] == '\0')
+                check_rc(rc == CJOURNAL_FORMAT_ERROR ? CJOURNAL_FILE_ERROR : rc);
+            mexErrMsgIdAndTxt(rc == CJOURNAL_FORMAT_ERROR ? "openCOSSAN:journalx:formatError" :
+                              "openCOSSAN:journalx:fileError", "%s", message);
+        }
+        plhs[0] = mxCreateDoubleScalar(rc);
+        if (nlhs > 1)
+            plhs[1] = mxCreateDoubleScalar((double)cjournal_discarded(journal));
+        return;
+    }
+
+    if (journal == NULL)
+        mexErrMsgIdAndTxt("openCOSSAN:journalx", "The journal is not open");
+    nout = cjournal_noutputs(journal);
+
+    if (strcmp(Saction, "lookup") == 0) {
+        if (nrhs != 2 || nlhs > 2)
+            mexErrMsgTxt("usage: [Lfound,Moutputs] = journalx('lookup',Minputs) ;");
+        Minputs = get_matrix(prhs[1], 1);
+        nsamples = mxGetM(prhs[1]);
+        ninputs = mxGetN(prhs[1]);
+        plhs[0] = mxCreateLogicalMatrix(nsamples, 1);
+        Lfound = mxGetLogicals(plhs[0]);
+        Mfound = NULL;
+        if (nlhs > 1) {
+            plhs[1] = mxCreateDoubleMatrix(nsamples, nout, mxREAL);
+            Mfound = mxGetPr(plhs[1]);
+        }
+        for (k=0; k<nsamples; k++) {
+            values = cjournal_lookup(journal, cjournal_hash(Minputs+k, ninputs, nsamples));
+            Lfound[k] = values != NULL;
+            for (i=0; Mfound != NULL && i<nout; i++)
+                Mfound[k + (mwSize)i*nsamples] = values != NULL ? values[i] : mxGetNaN();
+        }
+
+    } else if (strcmp(Saction, "append") == 0) {
+        if (nrhs != 4 || nlhs > 0)
+            mexErrMsgTxt("usage: journalx('append',Vindex,Minputs,Moutputs) ;");
+        Vindex = get_matrix(prhs[1], 1);
+        Minputs = get_matrix(prhs[2], 2);
+        Moutputs = get_matrix(prhs[3], 3);
+        nsamples = mxGetM(prhs[2]);
+        ninputs = mxGetN(prhs[2]);
+        if (mxGetNumberOfElements(prhs[1]) != nsamples || mxGetM(prhs[3]) != nsamples ||
+            mxGetN(prhs[3]) != (mwSize)nout)
+            mexErrMsgIdAndTxt("openCOSSAN:journalx",
+                "Vindex, Minputs and Moutputs must have one row per sample and Moutputs %d columns", nout);
+        for (k=0; k<nsamples; k++)
+            check_rc(cjournal_append(journal, (uint64_t)Vindex[k],
+                                     cjournal_hash(Minputs+k, ninputs, nsamples),
+                                     Moutputs+k, nsamples));
+        check_rc(cjournal_flush(journal));
+
+    } else
+        mexErrMsgIdAndTxt("openCOSSAN:journalx", "Unknown action %s", Saction);
+}
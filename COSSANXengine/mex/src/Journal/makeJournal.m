@@ -0,0 +1,26 @@
+% Script to generate the mex file of the result journal of the Evaluator
+% (see cossan_journal.h)
+
+disp('Compiling the journal mex files ..');
+
+assert(~isempty(OpenCossan.getCossanRoot),'openCOSSAN:makeJournal','Please initialize OpenCossan')
+
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" journalx.c cossan_journal.c
+
+% List of created mex files
+r=dir('*.mex*');
+
+Spath=fullfile(OpenCossan.getCossanRoot,'mex','bin');
+
+
+for n=1:length(r)
+    % Move the compiled file in the appropriate folder
+    [status,message,messageid]=movefile(r(n).name,Spath,'f');
+    
+    if status
+        disp(['MEX FILE ' r(n).name ' created and moved in ' Spath ]);
+    else
+        disp(message);
+        disp(messageid);
+    end
+end
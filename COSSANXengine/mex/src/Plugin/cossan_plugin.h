@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * cossan_plugin.h: C interface of the in-process model plugins
+ *
+ * A plugin is a shared library (.so, .dylib or .dll) that evaluates a model
+ * on a batch of samples without files and without external processes. The
+ * library exports the function cossan_plugin_entry returning the
+ * description of the model (see cossan_plugin). Only this header is needed
+ * to build a plugin, e.g.
+ *
+ *   gcc -shared -fPIC -O2 -I<COSSAN>/mex/src/Plugin model.c -lm -o libmodel.so
+ *
+ * The plugins are loaded by the mex file pluginx and used by the Connector
+ * when the property SpluginLibrary is defined.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _COSSAN_PLUGIN_H
+#define _COSSAN_PLUGIN_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define COSSAN_PLUGIN_ABI_VERSION 1
+
+/* name of the function exported by the plugin */
+#define COSSAN_PLUGIN_ENTRY "cossan_plugin_entry"
+
+/* flags of the plugin */
+#define COSSAN_PLUGIN_THREAD_SAFE 1 /* evaluate_batch can be called
+                                       concurrently on disjoint batches */
+
+#if defined(_WIN32)
+#define COSSAN_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define COSSAN_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+/*
+ * Description of the model
+ *
+ * init           : create the state of the model. options is the string
+ *                  SpluginOptions of the Connector (can be empty). Return 0
+ *                  on success. Can be NULL.
+ * evaluate_batch : evaluate the model on n samples. x[j*ld+i] is the input
+ *                  j of the sample i and y[k*ld+i] the output k. Return 0 on
+ *                  success and a non-zero value to abort the analysis; the
+ *                  outputs of the failed samples can be set to NaN instead.
+ * finalize       : release the state. Can be NULL.
+ */
+typedef struct {
+  int abi_version;                /* COSSAN_PLUGIN_ABI_VERSION */
+  const char *name;               /* name of the model */
+  int flags;                      /* COSSAN_PLUGIN_* flags */
+  int ninputs;
+  const char *const *inputs;      /* names of the inputs */
+  int noutputs;
+  const char *const *outputs;     /* names of the outputs */
+  int (*init)(const char *options, void **state);
+  int (*evaluate_batch)(void *state, long n, long ld, const double *x,
+    double *y);
+  void (*finalize)(void *state);
+} cossan_plugin;
+
+typedef const cossan_plugin *cossan_plugin_entry_function(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_PLUGIN_H */
@@ -0,0 +1,209 @@
+/*******************************************************************************
+ * cossan_plugin_host.c: loading and evaluation of the model plugins
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cossan_plugin_host.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <pthread.h>
+#define CPLG_THREADS
+#endif
+
+static void *load_library(const char *library, char *message, size_t lmessage)
+{
+#if defined(_WIN32)
+  HMODULE h = LoadLibraryA(library);
+  if (h == NULL)
+    snprintf(message, lmessage, "Cannot load %s (error %lu)", library,
+      (unsigned long)GetLastError());
+  return (void *)h;
+#else
+  void *h = dlopen(library, RTLD_NOW | RTLD_LOCAL);
+  if (h == NULL)
+    snprintf(message, lmessage, "Cannot load %s: %s", library, dlerror());
+  return h;
+#endif
+}
+
+static void *find_symbol(void *library, const char *name)
+{
+#if defined(_WIN32)
+  return (void *)GetProcAddress((HMODULE)library, name);
+#else
+  return dlsym(library, name);
+#endif
+}
+
+static void unload_library(void *library)
+{
+#if defined(_WIN32)
+  FreeLibrary((HMODULE)library);
+#else
+  dlclose(library);
+#endif
+}
+
+static int check_names(int n, const char *const *names)
+{
+  int i;
+  if (n < 0 || (n > 0 && names == NULL)) return -1;
+  for (i=0; i<n; i++)
+    if (names[i] == NULL || names[i][0] == '\0') return -1;
+  return 0;
+}
+
+int cplg_open(const char *library, const char *options, cplg_handle *h,
+  char *message, size_t lmessage)
+{
+  cossan_plugin_entry_function *entry;
+  const cossan_plugin *p;
+
+  memset(h, 0, sizeof(cplg_handle));
+  if ((h->library = load_library(library, message, lmessage)) == NULL)
+    return CPLG_LOAD_ERROR;
+
+  /* cast through an integer type: ISO C does not convert void* to functions */
+  entry = (cossan_plugin_entry_function *)(size_t)find_symbol(h->library,
+    COSSAN_PLUGIN_ENTRY);
+  if (entry == NULL || (p = entry()) == NULL) {
+    snprintf(message, lmessage, "%s does not export %s", library,
+      COSSAN_PLUGIN_ENTRY);
+    goto invalid;
+  }
+  if (p->abi_version != COSSAN_PLUGIN_ABI_VERSION) {
+    snprintf(message, lmessage, "%s implements the version %d of the plugin "
+      "interface (expected %d)", library, p->abi_version,
+      COSSAN_PLUGIN_ABI_VERSION);
+    goto invalid;
+  }
+  if (p->evaluate_batch == NULL || check_names(p->ninputs, p->inputs) ||
+      p->noutputs <= 0 || check_names(p->noutputs, p->outputs)) {
+    snprintf(message, lmessage, "%s: invalid description of the model", library);
+    goto invalid;
+  }
+  h->plugin = p;
+  if (p->init != NULL && p->init(options != NULL ? options : "", &h->state) != 0) {
+    snprintf(message, lmessage, "Initialization of the model %s failed",
+      p->name != NULL ? p->name : library);
+    unload_library(h->library);
+    memset(h, 0, sizeof(cplg_handle));
+    return CPLG_INIT_ERROR;
+  }
+  return CPLG_SUCCESS;
+
+invalid:
+  unload_library(h->library);
+  memset(h, 0, sizeof(cplg_handle));
+  return CPLG_INVALID_PLUGIN;
+}
+
+typedef struct {
+  const cplg_handle *h;
+  long i0, n, ld;
+  const double *x;
+  double *y;
+  int rc;
+} cplg_batch;
+
+#ifdef CPLG_THREADS
+static void *evaluate_batch(void *arg)
+{
+  cplg_batch *b = (cplg_batch *)arg;
+  b->rc = b->h->plugin->evaluate_batch(b->h->state, b->n, b->ld, b->x + b->i0,
+    b->y + b->i0);
+  return NULL;
+}
+#endif
+
+int cplg_evaluate(const cplg_handle *h, long n, const double *x, double *y,
+  int nthreads)
+{
+  const cossan_plugin *p = h->plugin;
+#ifdef CPLG_THREADS
+  cplg_batch *batch;
+  pthread_t *tid;
+  long chunk, i0;
+  int t, rc = 0;
+#endif
+
+  if (n <= 0) return CPLG_SUCCESS;
+  if (!(p->flags & COSSAN_PLUGIN_THREAD_SAFE)) nthreads = 1;
+  if (nthreads > n) nthreads = (int)n;
+  if (nthreads <= 1)
+    return p->evaluate_batch(h->state, n, n, x, y) ? CPLG_EVALUATION_ERROR :
+      CPLG_SUCCESS;
+
+#ifdef CPLG_THREADS
+  batch = (cplg_batch *)malloc(nthreads*sizeof(cplg_batch));
+  tid = (pthread_t *)malloc(nthreads*sizeof(pthread_t));
+  if (batch == NULL || tid == NULL) {
+    free(batch); free(tid);
+    return CPLG_OUT_OF_MEMORY;
+  }
+  chunk = (n + nthreads - 1)/nthreads;
+  for (t=0, i0=0; t<nthreads; t++, i0+=chunk) {
+    batch[t].h = h;
+    batch[t].i0 = i0;
+    batch[t].n = (i0+chunk <= n) ? chunk : n-i0;
+    batch[t].ld = n;
+    batch[t].x = x;
+    batch[t].y = y;
+    batch[t].rc = 0;
+    if (batch[t].n <= 0) { nthreads = t; break; }
+    if (pthread_create(&tid[t], NULL, evaluate_batch, &batch[t]) != 0) {
+      /* evaluate this batch in the calling thread */
+      evaluate_batch(&batch[t]);
+      tid[t] = pthread_self();
+    }
+  }
+  for (t=0; t<nthreads; t++) {
+    if (!pthread_equal(tid[t], pthread_self()))
+      pthread_join(tid[t], NULL);
+    if (batch[t].rc) rc = CPLG_EVALUATION_ERROR;
+  }
+  free(batch); free(tid);
+  return rc;
+#else
+  return p->evaluate_batch(h->state, n, n, x, y) ? CPLG_EVALUATION_ERROR :
+    CPLG_SUCCESS;
+#endif
+}
+
+void cplg_close(cplg_handle *h)
+{
+  if (h->library == NULL) return;
+  if (h->plugin != NULL && h->plugin->finalize != NULL)
+    h->plugin->finalize(h->state);
+  unload_library(h->library);
+  memset(h, 0, sizeof(cplg_handle));
+}
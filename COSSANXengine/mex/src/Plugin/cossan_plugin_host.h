@@ -0,0 +1,83 @@
+/*******************************************************************************
+ * cossan_plugin_host.h: loading and evaluation of the model plugins
+ *
+ * The library is opened with dlopen (LoadLibrary on Windows), the
+ * description returned by cossan_plugin_entry is validated and the model is
+ * initialized. The batches are split among threads when the plugin is
+ * thread-safe. See cossan_plugin.h for the interface of the plugins.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _COSSAN_PLUGIN_HOST_H
+#define _COSSAN_PLUGIN_HOST_H
+
+#include <stddef.h>
+#include "cossan_plugin.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Possible return values of the functions
+ */
+typedef enum {
+  CPLG_EVALUATION_ERROR = -5, /* evaluate_batch returned an error */
+  CPLG_INIT_ERROR       = -4, /* init returned an error */
+  CPLG_INVALID_PLUGIN   = -3, /* entry point missing or wrong description */
+  CPLG_LOAD_ERROR       = -2, /* the library cannot be loaded */
+  CPLG_OUT_OF_MEMORY    = -1, /* memory allocation failed */
+  CPLG_SUCCESS          =  0
+} cplg_result;
+
+typedef struct {
+  void *library;                  /* handle of the shared library */
+  const cossan_plugin *plugin;    /* description of the model */
+  void *state;                    /* state returned by init */
+} cplg_handle;
+
+/*
+ * Load the library and initialize the model. On error message contains
+ * the reason and the handle is not valid.
+ */
+extern int cplg_open(const char *library, const char *options,
+  cplg_handle *h, char *message, size_t lmessage);
+
+/*
+ * Evaluate n samples: x (n x ninputs) and y (n x noutputs) are stored
+ * column-wise. nthreads>1 is used only by thread-safe plugins.
+ */
+extern int cplg_evaluate(const cplg_handle *h, long n, const double *x,
+  double *y, int nthreads);
+
+/* finalize the model and unload the library */
+extern void cplg_close(cplg_handle *h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_PLUGIN_HOST_H */
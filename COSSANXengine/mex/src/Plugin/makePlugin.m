@@ -0,0 +1,31 @@
+% Script to generate the mex file used to evaluate the model plugins in
+% the MATLAB process (see cossan_plugin.h).
+
+disp('Compiling the plugin mex files ..');
+
+assert(~isempty(OpenCossan.getCossanRoot),'openCOSSAN:makePlugin','Please initialize OpenCossan')
+
+% mex for the evaluation of the plugins (Connector.run)
+if isunix
+    mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" pluginx.c cossan_plugin_host.c -ldl
+else
+    mex pluginx.c cossan_plugin_host.c
+end
+
+% List of created mex files
+r=dir('*.mex*');
+
+Spath=fullfile(OpenCossan.getCossanRoot,'mex','bin');
+
+
+for n=1:length(r)
+    % Move the compiled file in the appropriate folder
+    [status,message,messageid]=movefile(r(n).name,Spath,'f');
+    
+    if status
+        disp(['MEX FILE ' r(n).name ' created and moved in ' Spath ]);
+    else
+        disp(message);
+        disp(messageid);
+    end
+end
@@ -0,0 +1,193 @@
+/*******************************************************************************
+ * pluginx: in-process evaluation of the model plugins - matlab MEX
+ *
+ * The plugins (see cossan_plugin.h) are loaded once and kept in a cache
+ * until pluginx('clear') is called or the mex file is cleared.
+ *
+ * usage:
+ *   [CSinputs,CSoutputs,Sname] = pluginx('info',Slibrary,Soptions)
+ *   Moutput = pluginx(Slibrary,Minput,Nthreads,Soptions)
+ *   pluginx('clear')
+ * where
+ *   Slibrary  : full name of the shared library
+ *   Soptions  : string passed to the function init of the plugin (optional)
+ *   Minput    : inputs of the model (Nsamples x Ninputs, in the order of
+ *               CSinputs)
+ *   Nthreads  : number of threads (used only by thread-safe plugins)
+ *
+ *   CSinputs  : names of the inputs of the model
+ *   CSoutputs : names of the outputs of the model
+ *   Moutput   : outputs of the model (Nsamples x Noutputs)
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+#include "cossan_plugin_host.h"
+
+#define NCACHE 16
+#define LMESSAGE 512
+
+typedef struct {
+    char *Slibrary, *Soptions;
+    cplg_handle h;
+} cache_entry;
+
+static cache_entry cache[NCACHE];
+static int ncache = 0;
+
+static void clear_cache(void)
+{
+    int k;
+    for (k=0; k<ncache; k++) {
+        cplg_close(&cache[k].h);
+        free(cache[k].Slibrary);
+        free(cache[k].Soptions);
+    }
+    ncache = 0;
+}
+
+static char *duplicate(const char *s)
+{
+    char *d = (char *)malloc(strlen(s)+1);
+    if (d != NULL) strcpy(d, s);
+    return d;
+}
+
+/* plugin loaded with the options (from the cache if already loaded) */
+static const cplg_handle *get_plugin(const char *Slibrary, const char *Soptions)
+{
+    char message[LMESSAGE];
+    cplg_handle h;
+    int k;
+
+    for (k=0; k<ncache; k++)
+        if (strcmp(cache[k].Slibrary, Slibrary) == 0 &&
+            strcmp(cache[k].Soptions, Soptions) == 0)
+            return &cache[k].h;
+
+    if (ncache == NCACHE)
+        mexErrMsgIdAndTxt("openCOSSAN:pluginx",
+            "Too many plugins loaded (%d). Use pluginx('clear')", NCACHE);
+    switch (cplg_open(Slibrary, Soptions, &h, message, LMESSAGE)) {
+    case CPLG_SUCCESS:
+        break;
+    case CPLG_LOAD_ERROR:
+        mexErrMsgIdAndTxt("openCOSSAN:pluginx:loadError", "%s", message);
+        break;
+    default:
+        mexErrMsgIdAndTxt("openCOSSAN:pluginx:invalidPlugin", "%s", message);
+    }
+    cache[ncache].Slibrary = duplicate(Slibrary);
+    cache[ncache].Soptions = duplicate(Soptions);
+    if (cache[ncache].Slibrary == NULL || cache[ncache].Soptions == NULL) {
+        free(cache[ncache].Slibrary);
+        free(cache[ncache].Soptions);
+        cplg_close(&h);
+        mexErrMsgIdAndTxt("openCOSSAN:pluginx", "Out of memory");
+    }
+    cache[ncache].h = h;
+    return &cache[ncache++].h;
+}
+
+static mxArray *names(int n, const char *const *Cnames)
+{
+    mxArray *C = mxCreateCellMatrix(1, n);
+    int k;
+    for (k=0; k<n; k++)
+        mxSetCell(C, k, mxCreateString(Cnames[k]));
+    return C;
+}
+
+static char *get_options(int nrhs, const mxArray *prhs[], int k)
+{
+    static char Snone[] = "";
+    if (nrhs <= k || mxIsEmpty(prhs[k]))
+        return Snone;
+    if (!mxIsChar(prhs[k]))
+        mexErrMsgIdAndTxt("openCOSSAN:pluginx", "Soptions must be a string");
+    return mxArrayToString(prhs[k]);
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    const cplg_handle *h;
+    char *Scommand, *Soptions;
+    mwSize n;
+    int nthreads = 1, rc;
+
+    mexAtExit(clear_cache);
+
+    /* check input arguments */
+    if (nrhs < 1 || nrhs > 4 || !mxIsChar(prhs[0]))
+        mexErrMsgTxt("usage: Moutput = pluginx(Slibrary,Minput,Nthreads,Soptions) ;");
+
+    Scommand = mxArrayToString(prhs[0]);
+    if (nrhs == 1 && strcmp(Scommand, "clear") == 0) {
+        mxFree(Scommand);
+        clear_cache();
+        return;
+    }
+
+    if (strcmp(Scommand, "info") == 0) {
+        char *Slibrary;
+        if (nrhs < 2 || !mxIsChar(prhs[1]) || nlhs > 3)
+            mexErrMsgTxt("usage: [CSinputs,CSoutputs,Sname] = pluginx('info',Slibrary,Soptions) ;");
+        Slibrary = mxArrayToString(prhs[1]);
+        Soptions = get_options(nrhs, prhs, 2);
+        h = get_plugin(Slibrary, Soptions);
+        plhs[0] = names(h->plugin->ninputs, h->plugin->inputs);
+        if (nlhs > 1)
+            plhs[1] = names(h->plugin->noutputs, h->plugin->outputs);
+        if (nlhs > 2)
+            plhs[2] = mxCreateString(h->plugin->name != NULL ? h->plugin->name : "");
+        return;
+    }
+
+    if (nrhs < 2 || nlhs > 1 || !mxIsDouble(prhs[1]) || mxIsComplex(prhs[1]))
+        mexErrMsgTxt("usage: Moutput = pluginx(Slibrary,Minput,Nthreads,Soptions) ;");
+    if (nrhs > 2 && !mxIsEmpty(prhs[2]))
+        nthreads = (int)mxGetScalar(prhs[2]);
+    Soptions = get_options(nrhs, prhs, 3);
+    h = get_plugin(Scommand, Soptions);
+
+    n = mxGetM(prhs[1]);
+    if (mxGetN(prhs[1]) != (mwSize)h->plugin->ninputs && n > 0)
+        mexErrMsgIdAndTxt("openCOSSAN:pluginx",
+            "The model %s requires %d inputs (Minput has %d columns)",
+            h->plugin->name != NULL ? h->plugin->name : Scommand,
+            h->plugin->ninputs, (int)mxGetN(prhs[1]));
+
+    plhs[0] = mxCreateDoubleMatrix(n, h->plugin->noutputs, mxREAL);
+    rc = cplg_evaluate(h, (long)n, mxGetPr(prhs[1]), mxGetPr(plhs[0]), nthreads);
+    if (rc == CPLG_OUT_OF_MEMORY)
+        mexErrMsgIdAndTxt("openCOSSAN:pluginx", "Out of memory");
+    else if (rc != CPLG_SUCCESS)
+        mexErrMsgIdAndTxt("openCOSSAN:pluginx:evaluationError",
+            "The evaluation of the model %s failed",
+            h->plugin->name != NULL ? h->plugin->name : Scommand);
+}
@@ -0,0 +1,391 @@
+/*******************************************************************************
+ * cossan_pool.c: pool of solver processes for the Connector
+ *
+ * The processes are created with posix_spawn (the MATLAB process is large
+ * and multithreaded, fork would copy its page tables for each job) and the
+ * shell changes directory before executing the command. The pool does not
+ * install a SIGCHLD handler: the jobs are polled with wait4(WNOHANG) on
+ * their own pids only, so that the children of the host application are
+ * not reaped, and wait4 returns the resources used by the job and by the
+ * descendants it has waited for. On Linux the I/O volume is read from
+ * /proc/<pid>/io between the termination and the reaping of the job.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "cossan_pool.h"
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+extern char **environ;
+
+#define POOL_POLL_MIN 0.0005  /* polling interval [s] */
+#define POOL_POLL_MAX 0.02
+
+typedef struct {
+  pid_t pid;           /* pid of the shell (0 if the slot is free) */
+  int job;             /* index of the job */
+  double start;        /* start time */
+  double deadline;     /* timeout (0: none) */
+  double killtime;     /* time of the SIGKILL after the SIGTERM (0: not sent) */
+  int timedout;
+} pool_slot;
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9*(double)ts.tv_nsec;
+}
+
+static void sleep_for(double t)
+{
+  struct timespec ts;
+  ts.tv_sec = (time_t)t;
+  ts.tv_nsec = (long)((t - (double)ts.tv_sec)*1e9);
+  while (nanosleep(&ts, &ts) == -1 && errno == EINTR) ;
+}
+
+/*
+ * The child inherits the affinity of the calling thread: to bind it to cpu
+ * (if cpu >= 0) the thread is bound to cpu for the time of the spawn.
+ */
+static pid_t spawn(const char *folder, const char *command,
+  const pool_options *options, int cpu)
+{
+  posix_spawn_file_actions_t actions;
+  posix_spawnattr_t attr;
+  sigset_t sigdefault;
+  char *script, *log = NULL;
+  char *argv[4];
+  pid_t pid;
+  int rc;
+#if defined(__linux__)
+  cpu_set_t saved, set;
+  int bound = 0;
+#endif
+
+  if ((script = cossan_pool_shell_command(folder, command)) == NULL) return -1;
+  if (options->logfile != NULL) {
+    size_t n = (folder ? strlen(folder) : 0) + strlen(options->logfile) + 2;
+    if ((log = (char *)malloc(n)) == NULL) { free(script); return -1; }
+    if (folder != NULL && *folder && options->logfile[0] != '/')
+      snprintf(log, n, "%s/%s", folder, options->logfile);
+    else
+      snprintf(log, n, "%s", options->logfile);
+  }
+
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+  posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO,
+    log != NULL ? log : "/dev/null", O_WRONLY|O_CREAT|O_TRUNC, 0644);
+  posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+
+  /* new process group (killed as a whole) and default signal handlers */
+  posix_spawnattr_init(&attr);
+  sigfillset(&sigdefault);
+  sigdelset(&sigdefault, SIGKILL);
+  sigdelset(&sigdefault, SIGSTOP);
+  posix_spawnattr_setsigdefault(&attr, &sigdefault);
+  posix_spawnattr_setpgroup(&attr, 0);
+  posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGDEF);
+
+  argv[0] = (char *)options->shell;
+  argv[1] = (char *)"-c";
+  argv[2] = script;
+  argv[3] = NULL;
+#if defined(__linux__)
+  if (cpu >= 0 && cpu < CPU_SETSIZE &&
+      pthread_getaffinity_np(pthread_self(), sizeof(saved), &saved) == 0) {
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    bound = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+  }
+#else
+  (void)cpu;
+#endif
+  rc = posix_spawn(&pid, options->shell, &actions, &attr, argv, environ);
+#if defined(__linux__)
+  if (bound) pthread_setaffinity_np(pthread_self(), sizeof(saved), &saved);
+#endif
+
+  posix_spawn_file_actions_destroy(&actions);
+  posix_spawnattr_destroy(&attr);
+  free(script);
+  free(log);
+  return rc == 0 ? pid : -1;
+}
+
+#if defined(__linux__)
+/* I/O counters of the process and of its reaped children */
+static int read_io(pid_t pid, pool_job *result)
+{
+  char file[64], line[128];
+  double rchar = -1, wchar = -1, value;
+  FILE *f;
+
+  snprintf(file, sizeof(file), "/proc/%ld/io", (long)pid);
+  if ((f = fopen(file, "r")) == NULL) return -1;
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (sscanf(line, "rchar: %lf", &value) == 1) rchar = value;
+    else if (sscanf(line, "wchar: %lf", &value) == 1) wchar = value;
+  }
+  fclose(f);
+  if (rchar < 0 || wchar < 0) return -1;
+  result->rbytes = rchar;
+  result->wbytes = wchar;
+  return 0;
+}
+#endif
+
+/*
+ * Reap the job pid if it has terminated (returns 0 if it is running) and
+ * store the resources it used. On Linux the I/O counters are read from /proc
+ * before the process is reaped (waitid with WNOWAIT).
+ */
+static pid_t reap(pid_t pid, int *wstatus, pool_job *result)
+{
+  struct rusage ru;
+  pid_t w;
+  int io = -1;
+#if defined(__linux__)
+  siginfo_t info;
+
+  info.si_pid = 0;
+  if (waitid(P_PID, pid, &info, WEXITED | WNOHANG | WNOWAIT) == -1) return -1;
+  if (info.si_pid == 0) return 0;
+  io = read_io(pid, result);
+#endif
+  memset(&ru, 0, sizeof(ru));
+  w = wait4(pid, wstatus, WNOHANG, &ru);
+  if (w <= 0) return w;
+  result->utime = (double)ru.ru_utime.tv_sec + 1e-6*(double)ru.ru_utime.tv_usec;
+  result->stime = (double)ru.ru_stime.tv_sec + 1e-6*(double)ru.ru_stime.tv_usec;
+#if defined(__APPLE__)
+  result->maxrss = (double)ru.ru_maxrss/1024.0; /* bytes */
+#else
+  result->maxrss = (double)ru.ru_maxrss;
+#endif
+  if (io != 0) {
+    result->rbytes = 512.0*(double)ru.ru_inblock;
+    result->wbytes = 512.0*(double)ru.ru_oublock;
+  }
+  return w;
+}
+
+static int job_status(int wstatus)
+{
+  if (WIFEXITED(wstatus)) return WEXITSTATUS(wstatus);
+  if (WIFSIGNALED(wstatus)) return 128 + WTERMSIG(wstatus);
+  return 255;
+}
+
+/* kill the process groups of all the running jobs and reap them */
+static void kill_all(pool_slot *slots, int nslots, pool_job *results)
+{
+  int k, wstatus;
+  for (k=0; k<nslots; k++)
+    if (slots[k].pid > 0) kill(-slots[k].pid, SIGKILL);
+  for (k=0; k<nslots; k++) {
+    if (slots[k].pid <= 0) continue;
+    while (waitpid(slots[k].pid, &wstatus, 0) == -1 && errno == EINTR) ;
+    results[slots[k].job].status = POOL_JOB_ABORTED;
+    results[slots[k].job].time = now() - slots[k].start;
+    slots[k].pid = 0;
+  }
+}
+
+int cossan_pool_run(int njobs, const char *const *commands,
+  const char *const *folders, const pool_options *options, pool_job *results,
+  pool_callback *callback, void *state)
+{
+  pool_slot *slots;
+  double t, poll = POOL_POLL_MIN;
+  int nslots, next = 0, running = 0, k, wstatus, rc = POOL_SUCCESS;
+  pid_t w;
+
+  if (njobs < 0 || options == NULL || options->nworkers < 1 ||
+      (njobs > 0 && (commands == NULL || results == NULL)))
+    return POOL_INVALID_ARGS;
+
+  nslots = options->nworkers < njobs ? options->nworkers : njobs;
+  if (nslots == 0) return POOL_SUCCESS;
+  if ((slots = (pool_slot *)calloc(nslots, sizeof(pool_slot))) == NULL)
+    return POOL_OUT_OF_MEMORY;
+
+  for (k=0; k<njobs; k++) {
+    memset(&results[k], 0, sizeof(pool_job));
+    results[k].status = POOL_JOB_NOSTART;
+  }
+
+  while (next < njobs || running > 0) {
+    /* fill the free slots */
+    for (k=0; k<nslots && next < njobs; k++) {
+      if (slots[k].pid != 0) continue;
+      t = now();
+      slots[k].job = next;
+      slots[k].start = t;
+      slots[k].deadline = options->timeout > 0 ? t + options->timeout : 0.0;
+      slots[k].killtime = 0.0;
+      slots[k].timedout = 0;
+      slots[k].pid = spawn(folders ? folders[next] : NULL, commands[next], options,
+        options->cpus != NULL && options->ncpus > 0 ? options->cpus[k % options->ncpus] : -1);
+      next++;
+      if (slots[k].pid > 0) {
+        running++;
+        poll = POOL_POLL_MIN;
+      } else {
+        slots[k].pid = 0;
+        results[slots[k].job].status = POOL_JOB_NOSTART;
+        if (callback != NULL && callback(slots[k].job, &results[slots[k].job], state)) {
+          rc = POOL_CALLBACK_STOP;
+          goto stop;
+        }
+        k--; /* reuse the slot */
+      }
+    }
+
+    /* collect the finished jobs and enforce the timeouts */
+    for (k=0; k<nslots; k++) {
+      if (slots[k].pid <= 0) continue;
+      w = reap(slots[k].pid, &wstatus, &results[slots[k].job]);
+      t = now();
+      if (w == 0) {
+        if (slots[k].deadline > 0 && t > slots[k].deadline && !slots[k].timedout) {
+          kill(-slots[k].pid, SIGTERM);
+          slots[k].timedout = 1;
+          slots[k].killtime = t + options->killgrace;
+        } else if (slots[k].timedout && t > slots[k].killtime) {
+          kill(-slots[k].pid, SIGKILL);
+        }
+        continue;
+      }
+      if (w == -1 && errno == EINTR) continue;
+      /* the process has terminated (or it has been reaped by somebody else) */
+      results[slots[k].job].status = slots[k].timedout ? POOL_JOB_TIMEOUT :
+        (w == -1 ? 255 : job_status(wstatus));
+      results[slots[k].job].time = t - slots[k].start;
+      /* remove the processes left behind by the shell */
+      if (slots[k].timedout) kill(-slots[k].pid, SIGKILL);
+      slots[k].pid = 0;
+      running--;
+      poll = POOL_POLL_MIN;
+      if (callback != NULL && callback(slots[k].job, &results[slots[k].job], state)) {
+        rc = POOL_CALLBACK_STOP;
+        goto stop;
+      }
+    }
+
+    if (running > 0 && (next >= njobs || running == nslots)) {
+      sleep_for(poll);
+      poll = poll*2 < POOL_POLL_MAX ? poll*2 : POOL_POLL_MAX;
+    }
+  }
+
+stop:
+  if (rc != POOL_SUCCESS) kill_all(slots, nslots, results);
+  for (k=next; k<njobs; k++) results[k].status = POOL_JOB_ABORTED;
+  free(slots);
+  return rc;
+}
+
+#else /* _WIN32 */
+
+int cossan_pool_run(int njobs, const char *const *commands,
+  const char *const *folders, const pool_options *options, pool_job *results,
+  pool_callback *callback, void *state)
+{
+  (void)njobs; (void)commands; (void)folders; (void)options;
+  (void)results; (void)callback; (void)state;
+  return POOL_INVALID_ARGS;
+}
+
+#endif
+
+/* "cd 'folder' && { command }" with the folder quoted for the shell */
+char *cossan_pool_shell_command(const char *folder, const char *command)
+{
+  size_t n = strlen(command) + 16, k = 0;
+  const char *p;
+  char *s;
+
+  if (folder != NULL)
+    for (p=folder; *p; p++) n += *p == '\'' ? 4 : 1;
+  if ((s = (char *)malloc(n)) == NULL) return NULL;
+  if (folder != NULL && *folder) {
+    memcpy(s, "cd '", 4); k = 4;
+    for (p=folder; *p; p++) {
+      if (*p == '\'') { memcpy(s+k, "'\\''", 4); k += 4; }
+      else s[k++] = *p;
+    }
+    /* the command is grouped: none of its parts runs if cd fails. The
+       group is closed on a new line, valid also after & or a comment */
+    memcpy(s+k, "' && { ", 7); k += 7;
+    strcpy(s+k, command);
+    strcat(s+k, "\n}");
+  } else {
+    strcpy(s+k, command);
+  }
+  return s;
+}
+
+void cossan_pool_default_options(pool_options *options)
+{
+  memset(options, 0, sizeof(pool_options));
+  options->nworkers = 1;
+  options->timeout = 0.0;
+  options->killgrace = 5.0;
+  options->logfile = NULL;
+  options->shell = "/bin/sh";
+  options->cpus = NULL;
+  options->ncpus = 0;
+}
+
+const char *cossan_pool_rc_string(int rc)
+{
+  switch (rc) {
+  case POOL_CALLBACK_STOP: return "Execution stopped by the callback";
+  case POOL_OUT_OF_MEMORY: return "Out of memory";
+  case POOL_INVALID_ARGS:  return "Invalid arguments (the process pool is available on POSIX systems only)";
+  case POOL_SUCCESS:       return "All the jobs have been executed";
+  default:                 return "Unknown return code";
+  }
+}
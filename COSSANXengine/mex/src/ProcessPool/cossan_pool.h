@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * cossan_pool.h: pool of solver processes for the Connector
+ *
+ * The pool executes a list of shell commands, each in its own working
+ * directory, keeping at most nworkers processes running at the same time.
+ * Every process is started in a new process group so that the whole tree
+ * of the solver can be terminated when the timeout expires. The completion
+ * of each job is reported through a callback in the order in which the jobs
+ * finish, with the resources used by the job (cpu time, peak memory and I/O
+ * volume of the process and of its descendants).
+ *
+ * The pool is available on POSIX systems only.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _COSSAN_POOL_H
+#define _COSSAN_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Possible return values of cossan_pool_run
+ */
+typedef enum {
+  POOL_CALLBACK_STOP = -3, /* the callback requested the end of the pool */
+  POOL_OUT_OF_MEMORY = -2, /* memory allocation failed */
+  POOL_INVALID_ARGS  = -1, /* inconsistent options or unsupported system */
+  POOL_SUCCESS       =  0  /* all the jobs have been executed */
+} pool_result;
+
+/*
+ * Status of a job
+ */
+#define POOL_JOB_TIMEOUT  -1  /* killed after the timeout */
+#define POOL_JOB_NOSTART  -2  /* the process could not be started */
+#define POOL_JOB_ABORTED  -3  /* killed because the pool was stopped */
+
+typedef struct {
+  int status;          /* exit code of the shell (128+signal if killed by a
+                          signal) or one of the POOL_JOB_* codes */
+  double time;         /* wall clock time of the job [s] */
+  double utime;        /* user and system cpu time of the job, including */
+  double stime;        /* its terminated descendants [s] */
+  double maxrss;       /* peak resident set size of its largest process [kB] */
+  double rbytes;       /* bytes read and written: read and write system */
+  double wbytes;       /* calls on Linux, blocks of the file system elsewhere */
+} pool_job;
+
+/*
+ * Called each time a job finishes. job is the (0-based) index of the job.
+ * Return non-zero to stop the pool (the running jobs are killed).
+ */
+typedef int pool_callback(int job, const pool_job *result, void *state);
+
+typedef struct {
+  int nworkers;        /* maximum number of concurrent processes */
+  double timeout;      /* timeout of each job [s] (<=0: no timeout) */
+  double killgrace;    /* time between SIGTERM and SIGKILL [s] */
+  const char *logfile; /* stdout and stderr of each job are written in this
+                          file of the working directory (NULL: /dev/null) */
+  const char *shell;   /* shell used to execute the commands (/bin/sh) */
+  const int *cpus;     /* the processes of the k-th worker are bound to the
+                          cpu cpus[k % ncpus] (Linux only; NULL: not bound) */
+  int ncpus;
+} pool_options;
+
+extern void cossan_pool_default_options(pool_options *options);
+
+/*
+ * Execute the commands. commands[i] is executed by the shell in the folder
+ * folders[i]. results (njobs) contains the status of each job on return;
+ * callback can be NULL.
+ */
+extern int cossan_pool_run(int njobs, const char *const *commands,
+  const char *const *folders, const pool_options *options, pool_job *results,
+  pool_callback *callback, void *state);
+
+extern const char *cossan_pool_rc_string(int rc);
+
+/*
+ * "cd 'folder' && { command }" with the folder quoted for the shell (folder
+ * can be NULL): the command is not executed if the folder is not
+ * available. The string is allocated with malloc.
+ */
+extern char *cossan_pool_shell_command(const char *folder, const char *command);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_POOL_H */
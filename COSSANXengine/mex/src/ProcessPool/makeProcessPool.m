@@ -0,0 +1,28 @@
+% Script to generate the mex file of the process pool of the Connector.
+% The solver processes are created with posix_spawn and polled (see
+% cossan_pool.c). Available on POSIX systems only.
+
+disp('Compiling the process pool mex files ..');
+
+assert(~isempty(OpenCossan.getCossanRoot),'openCOSSAN:makeProcessPool','Please initialize OpenCossan')
+
+% mex for the concurrent execution of the solvers (Connector.run)
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" runpoolx.c cossan_pool.c
+
+% List of created mex files
+r=dir('*.mex*');
+
+Spath=fullfile(OpenCossan.getCossanRoot,'mex','bin');
+
+
+for n=1:length(r)
+    % Move the compiled file in the appropriate folder
+    [status,message,messageid]=movefile(r(n).name,Spath,'f');
+    
+    if status
+        disp(['MEX FILE ' r(n).name ' created and moved in ' Spath ]);
+    else
+        disp(message);
+        disp(messageid);
+    end
+end
@@ -0,0 +1,208 @@
+/*******************************************************************************
+ * runpoolx: pool of solver processes - matlab MEX
+ *
+ * Execute the shell commands, each in its own folder, keeping at most
+ * Nworkers processes running (see cossan_pool.c).
+ *
+ * usage:
+ *   [Vstatus,Vtime,Musage] = runpoolx(CScommands,CSfolders,Nworkers)
+ *   [Vstatus,Vtime,Musage] = runpoolx(CScommands,CSfolders,Nworkers,Ntimeout,Hcallback,Slogfile,Vcpus)
+ * where
+ *   CScommands : cell array of shell commands
+ *   CSfolders  : cell array of working directories (same size of CScommands)
+ *   Nworkers   : maximum number of concurrent processes
+ *   Ntimeout   : timeout of each command [s] (Inf or empty: no timeout)
+ *   Hcallback  : function handle called when a command terminates as
+ *                Hcallback(irun,Nstatus,Ntime), in order of completion. An
+ *                error in the callback kills the running processes and is
+ *                rethrown.
+ *   Slogfile   : name of the file of each folder where stdout and stderr of
+ *                the command are written (default: discarded)
+ *   Vcpus      : cpus (numbered from 0) to which the processes are bound;
+ *                the k-th worker runs its commands on Vcpus(mod(k-1,end)+1)
+ *                (Linux only, default: not bound)
+ *
+ *   Vstatus    : exit status of the commands. -1 timeout, -2 the process
+ *                could not be started, -3 killed after an error
+ *   Vtime      : wall clock time of the commands [s]
+ *   Musage     : resources used by each command and by its descendants, one
+ *                row per command: user cpu time [s], system cpu time [s],
+ *                peak resident memory [kB], bytes read, bytes written (the
+ *                read/write system calls on Linux, the blocks of the file
+ *                system elsewhere). Zero for the killed commands.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <string.h>
+#include <math.h>
+#include "mex.h"
+#include "cossan_pool.h"
+
+typedef struct {
+    const mxArray *handle;  /* callback */
+    mxArray *error;         /* exception of the callback */
+} pool_state;
+
+static int call_matlab(int job, const pool_job *result, void *state)
+{
+    pool_state *s = (pool_state *)state;
+    mxArray *rhs[4];
+    int k;
+
+    rhs[0] = (mxArray *)s->handle;
+    rhs[1] = mxCreateDoubleScalar((double)(job+1));
+    rhs[2] = mxCreateDoubleScalar((double)result->status);
+    rhs[3] = mxCreateDoubleScalar(result->time);
+    s->error = mexCallMATLABWithTrap(0, NULL, 4, rhs, "feval");
+    for (k=1; k<4; k++) mxDestroyArray(rhs[k]);
+    return s->error != NULL;
+}
+
+static char **get_strings(const mxArray *C, const char *Sname, mwSize n)
+{
+    char **S;
+    mwSize i;
+    const mxArray *c;
+
+    if (!mxIsCell(C) || mxGetNumberOfElements(C) != n)
+        mexErrMsgIdAndTxt("openCOSSAN:runpoolx",
+            "%s must be a cell array of %d strings", Sname, (int)n);
+    S = (char **)mxCalloc(n > 0 ? n : 1, sizeof(char *));
+    for (i=0; i<n; i++) {
+        c = mxGetCell(C, i);
+        if (c == NULL || !mxIsChar(c))
+            mexErrMsgIdAndTxt("openCOSSAN:runpoolx",
+                "%s must be a cell array of %d strings", Sname, (int)n);
+        S[i] = mxArrayToString(c);
+    }
+    return S;
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    pool_options options;
+    pool_state state;
+    pool_job *results;
+    char **commands, **folders, *Slogfile = NULL;
+    double *Vstatus, *Vtime, *Musage;
+    mwSize n, i;
+    int *cpus = NULL;
+    int rc;
+
+    /* check input arguments */
+    if (nlhs > 3 || nrhs < 3 || nrhs > 7)
+        mexErrMsgTxt("usage: [Vstatus,Vtime,Musage] = runpoolx(CScommands,CSfolders,Nworkers,Ntimeout,Hcallback,Slogfile,Vcpus) ;");
+
+    n = mxGetNumberOfElements(prhs[0]);
+    commands = get_strings(prhs[0], "CScommands", n);
+    folders  = get_strings(prhs[1], "CSfolders", n);
+
+    cossan_pool_default_options(&options);
+    options.nworkers = (int)mxGetScalar(prhs[2]);
+    if (options.nworkers < 1)
+        mexErrMsgIdAndTxt("openCOSSAN:runpoolx", "Nworkers must be a positive integer");
+    if (nrhs > 3 && !mxIsEmpty(prhs[3])) {
+        options.timeout = mxGetScalar(prhs[3]);
+        if (mxIsInf(options.timeout) || mxIsNaN(options.timeout))
+            options.timeout = 0.0;
+    }
+    state.handle = NULL;
+    state.error = NULL;
+    if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+        if (mxGetClassID(prhs[4]) != mxFUNCTION_CLASS)
+            mexErrMsgIdAndTxt("openCOSSAN:runpoolx", "Hcallback must be a function handle");
+        state.handle = prhs[4];
+    }
+    if (nrhs > 5 && !mxIsEmpty(prhs[5])) {
+        if (!mxIsChar(prhs[5]))
+            mexErrMsgIdAndTxt("openCOSSAN:runpoolx", "Slogfile must be a string");
+        Slogfile = mxArrayToString(prhs[5]);
+        options.logfile = Slogfile;
+    }
+    if (nrhs > 6 && !mxIsEmpty(prhs[6])) {
+        if (!mxIsDouble(prhs[6]) || mxIsComplex(prhs[6]))
+            mexErrMsgIdAndTxt("openCOSSAN:runpoolx", "Vcpus must be a vector of cpu numbers");
+        options.ncpus = (int)mxGetNumberOfElements(prhs[6]);
+        cpus = (int *)mxCalloc(options.ncpus, sizeof(int));
+        for (i=0; i<(mwSize)options.ncpus; i++) {
+            cpus[i] = (int)mxGetPr(prhs[6])[i];
+            if (cpus[i] < 0)
+                mexErrMsgIdAndTxt("openCOSSAN:runpoolx", "Vcpus must be a vector of cpu numbers");
+        }
+        options.cpus = cpus;
+    }
+
+    results = (pool_job *)mxCalloc(n > 0 ? n : 1, sizeof(pool_job));
+
+    rc = cossan_pool_run((int)n, (const char *const *)commands,
+        (const char *const *)folders, &options, results,
+        state.handle != NULL ? call_matlab : NULL, &state);
+
+    for (i=0; i<n; i++) {
+        mxFree(commands[i]);
+        mxFree(folders[i]);
+    }
+    mxFree(commands);
+    mxFree(folders);
+    if (Slogfile != NULL) mxFree(Slogfile);
+    if (cpus != NULL) mxFree(cpus);
+
+    if (state.error != NULL) {
+        mxFree(results);
+        mexCallMATLAB(0, NULL, 1, &state.error, "rethrow");
+    }
+    if (rc != POOL_SUCCESS) {
+        mxFree(results);
+        mexErrMsgIdAndTxt("openCOSSAN:runpoolx", "%s", cossan_pool_rc_string(rc));
+    }
+
+    plhs[0] = mxCreateDoubleMatrix(n, 1, mxREAL);
+    Vstatus = mxGetPr(plhs[0]);
+    if (nlhs > 1) {
+        plhs[1] = mxCreateDoubleMatrix(n, 1, mxREAL);
+        Vtime = mxGetPr(plhs[1]);
+    } else {
+        Vtime = NULL;
+    }
+    if (nlhs > 2) {
+        plhs[2] = mxCreateDoubleMatrix(n, 5, mxREAL);
+        Musage = mxGetPr(plhs[2]);
+    } else {
+        Musage = NULL;
+    }
+    for (i=0; i<n; i++) {
+        Vstatus[i] = (double)results[i].status;
+        if (Vtime != NULL) Vtime[i] = results[i].time;
+        if (Musage != NULL) {
+            Musage[i] = results[i].utime;
+            Musage[i+n] = results[i].stime;
+            Musage[i+2*n] = results[i].maxrss;
+            Musage[i+3*n] = results[i].rbytes;
+            Musage[i+4*n] = results[i].wbytes;
+        }
+    }
+    mxFree(results);
+}
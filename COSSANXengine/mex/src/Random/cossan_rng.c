@@ -0,0 +1,267 @@
+/*******************************************************************************
+ * cossan_rng.c: counter-based random number generator for the mex files
+ *
+ * Philox4x32-10: each block of 4 32-bit words is obtained by 10 rounds of the
+ * Philox bijection applied to the 128-bit counter (position, stream) with the
+ * 64-bit key. Blocks are generated COSSAN_RNG_LANES counters at a time in
+ * structure-of-arrays form so that the rounds are vectorized (32x32->64
+ * multiplications) by the compiler.
+ *
+ * Uniform deviates use 53 bits of two words. Normal deviates are obtained by
+ * the Box-Muller transform, two per block.
+ *
+ * The blocks are checked against the known answers of the reference
+ * implementation by cossan_rng_kat.c (make check).
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <string.h>
+#include <math.h>
+#include "cossan_rng.h"
+
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+
+#define COSSAN_RNG_LANES 8
+#define COSSAN_RNG_MAGIC 0x50484C58U /* "PHLX" */
+
+#define TWO_PI 6.283185307179586476925286766559
+#define TWO_M53 (1.0/9007199254740992.0)
+
+/*
+ * Generate nb (<=COSSAN_RNG_LANES) consecutive blocks starting at position
+ */
+static void philox_lanes(const uint32_t key[2], uint64_t position,
+  uint64_t stream, uint32_t *out, int nb)
+{
+  uint32_t c0[COSSAN_RNG_LANES], c1[COSSAN_RNG_LANES];
+  uint32_t c2[COSSAN_RNG_LANES], c3[COSSAN_RNG_LANES];
+  uint32_t k0 = key[0], k1 = key[1];
+  uint64_t p0, p1;
+  int l, r;
+
+  for (l=0; l<COSSAN_RNG_LANES; l++) {
+    c0[l] = (uint32_t)(position + l);
+    c1[l] = (uint32_t)((position + l) >> 32);
+    c2[l] = (uint32_t)stream;
+    c3[l] = (uint32_t)(stream >> 32);
+  }
+  for (r=0; r<10; r++) {
+    for (l=0; l<COSSAN_RNG_LANES; l++) {
+      p0 = (uint64_t)PHILOX_M0*c0[l];
+      p1 = (uint64_t)PHILOX_M1*c2[l];
+      c0[l] = (uint32_t)(p1 >> 32) ^ c1[l] ^ k0;
+      c2[l] = (uint32_t)(p0 >> 32) ^ c3[l] ^ k1;
+      c1[l] = (uint32_t)p1;
+      c3[l] = (uint32_t)p0;
+    }
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+  for (l=0; l<nb; l++) {
+    out[4*l]   = c0[l];
+    out[4*l+1] = c1[l];
+    out[4*l+2] = c2[l];
+    out[4*l+3] = c3[l];
+  }
+}
+
+/* fill nblocks blocks (4*nblocks words) and advance the position */
+static void philox_blocks(cossan_rng *rng, uint32_t *out, long nblocks)
+{
+  int nb;
+  while (nblocks > 0) {
+    nb = nblocks < COSSAN_RNG_LANES ? (int)nblocks : COSSAN_RNG_LANES;
+    philox_lanes(rng->key, rng->position, rng->stream, out, nb);
+    rng->position += nb;
+    out += 4*nb;
+    nblocks -= nb;
+  }
+  rng->ibuf = 4;
+}
+
+static double to_uniform(uint32_t a, uint32_t b)
+{
+  return (double)((((uint64_t)a << 32) | b) >> 11)*TWO_M53;
+}
+
+void cossan_rng_init(cossan_rng *rng, uint64_t seed)
+{
+  rng->key[0] = (uint32_t)seed;
+  rng->key[1] = (uint32_t)(seed >> 32);
+  rng->position = 0;
+  rng->stream = 0;
+  rng->ibuf = 4;
+}
+
+void cossan_rng_substream(const cossan_rng *parent, uint64_t id,
+  cossan_rng *child)
+{
+  uint32_t key[2], block[4];
+
+  /* the identifier of the substream is a Philox hash of (id, stream) */
+  key[0] = parent->key[0] ^ 0x3C6EF372U;
+  key[1] = parent->key[1] ^ 0xA54FF53AU;
+  philox_lanes(key, id, parent->stream, block, 1);
+  child->key[0] = parent->key[0];
+  child->key[1] = parent->key[1];
+  child->stream = ((uint64_t)block[1] << 32) | block[0];
+  child->position = 0;
+  child->ibuf = 4;
+}
+
+void cossan_rng_skip(cossan_rng *rng, uint64_t nblocks)
+{
+  rng->position += nblocks;
+  rng->ibuf = 4;
+}
+
+uint32_t cossan_rng_uint32(cossan_rng *rng)
+{
+  if (rng->ibuf >= 4) {
+    philox_lanes(rng->key, rng->position, rng->stream, rng->buf, 1);
+    rng->position++;
+    rng->ibuf = 0;
+  }
+  return rng->buf[rng->ibuf++];
+}
+
+double cossan_rng_uniform(cossan_rng *rng)
+{
+  uint32_t a = cossan_rng_uint32(rng);
+  uint32_t b = cossan_rng_uint32(rng);
+  return to_uniform(a, b);
+}
+
+double cossan_rng_normal(cossan_rng *rng)
+{
+  double u1, u2;
+  u1 = 1.0 - cossan_rng_uniform(rng); /* (0,1] */
+  u2 = cossan_rng_uniform(rng);
+  return sqrt(-2.0*log(u1))*cos(TWO_PI*u2);
+}
+
+void cossan_rng_fill_uint32(cossan_rng *rng, uint32_t *u, long n)
+{
+  uint32_t tail[4];
+  long nfull = n/4;
+  int i;
+
+  philox_blocks(rng, u, nfull);
+  if (n > 4*nfull) {
+    philox_blocks(rng, tail, 1);
+    for (i=0; i<n-4*nfull; i++) u[4*nfull+i] = tail[i];
+  }
+}
+
+void cossan_rng_fill_uniform(cossan_rng *rng, double *u, long n)
+{
+  uint32_t w[4*COSSAN_RNG_LANES];
+  long i = 0;
+  int j, nw;
+
+  while (i < n) {
+    /* 2 uniforms per block */
+    nw = (n - i + 1)/2 < COSSAN_RNG_LANES ? (int)((n - i + 1)/2) : COSSAN_RNG_LANES;
+    philox_blocks(rng, w, nw);
+    for (j=0; j<2*nw && i<n; j++, i++)
+      u[i] = to_uniform(w[2*j], w[2*j+1]);
+  }
+}
+
+void cossan_rng_fill_normal(cossan_rng *rng, double *z, long n)
+{
+  uint32_t w[4*COSSAN_RNG_LANES];
+  double r, t;
+  long i = 0;
+  int j, nw;
+
+  while (i < n) {
+    /* 2 normals per block (Box-Muller) */
+    nw = (n - i + 1)/2 < COSSAN_RNG_LANES ? (int)((n - i + 1)/2) : COSSAN_RNG_LANES;
+    philox_blocks(rng, w, nw);
+    for (j=0; j<nw && i<n; j++) {
+      r = sqrt(-2.0*log(1.0 - to_uniform(w[4*j], w[4*j+1])));
+      t = TWO_PI*to_uniform(w[4*j+2], w[4*j+3]);
+      z[i++] = r*cos(t);
+      if (i < n) z[i++] = r*sin(t);
+    }
+  }
+}
+
+void cossan_rng_fill_index(cossan_rng *rng, int *k, long n, int range)
+{
+  uint32_t w[4*COSSAN_RNG_LANES];
+  long i = 0;
+  int j, nw;
+
+  while (i < n) {
+    /* 4 indices per block (multiply-shift) */
+    nw = (n - i + 3)/4 < COSSAN_RNG_LANES ? (int)((n - i + 3)/4) : COSSAN_RNG_LANES;
+    philox_blocks(rng, w, nw);
+    for (j=0; j<4*nw && i<n; j++, i++)
+      k[i] = (int)(((uint64_t)w[j]*(uint32_t)range) >> 32);
+  }
+}
+
+void cossan_rng_uniforms(void *rng, double *u, int n)
+{
+  cossan_rng_fill_uniform((cossan_rng *)rng, u, n);
+}
+
+void cossan_rng_export(const cossan_rng *rng,
+  uint32_t state[COSSAN_RNG_STATE_SIZE])
+{
+  state[0] = rng->key[0];
+  state[1] = rng->key[1];
+  state[2] = (uint32_t)rng->position;
+  state[3] = (uint32_t)(rng->position >> 32);
+  state[4] = (uint32_t)rng->stream;
+  state[5] = (uint32_t)(rng->stream >> 32);
+  state[6] = (uint32_t)rng->ibuf;
+  state[7] = COSSAN_RNG_MAGIC;
+}
+
+int cossan_rng_import(cossan_rng *rng,
+  const uint32_t state[COSSAN_RNG_STATE_SIZE])
+{
+  if (state[7] != COSSAN_RNG_MAGIC || state[6] > 4)
+    return -1;
+  rng->key[0] = state[0];
+  rng->key[1] = state[1];
+  rng->position = ((uint64_t)state[3] << 32) | state[2];
+  rng->stream = ((uint64_t)state[5] << 32) | state[4];
+  rng->ibuf = (int)state[6];
+  if (rng->ibuf < 4) {
+    /* regenerate the partially used block */
+    if (rng->position == 0)
+      return -1;
+    philox_lanes(rng->key, rng->position-1, rng->stream, rng->buf, 1);
+  }
+  return 0;
+}
@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * cossan_rng.h: counter-based random number generator for the mex files
+ *
+ * Philox4x32-10 generator (J.K. Salmon, M.A. Moraes, R.O. Dror and D.E. Shaw,
+ * "Parallel random numbers: as easy as 1, 2, 3", SC'11, 2011) shared by all
+ * the mex sources of OpenCossan. The generator is stateless apart from a
+ * 64-bit key, a 64-bit position and a 64-bit stream identifier:
+ *
+ *  - the sequence is reproducible and independent of the number of threads;
+ *  - cossan_rng_substream derives independent generators (e.g. one per
+ *    thread or one per column) from a parent generator;
+ *  - blocks of uniform and normal deviates are produced several counters at
+ *    a time so that the compiler can vectorize the rounds;
+ *  - the state can be exported to and imported from a uint32 vector, which
+ *    is used to seed the generator from the OpenCossan random stream (see
+ *    OpenCossan.getNativeRandomState and cossan_rng_mex.h).
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _COSSAN_RNG_H
+#define _COSSAN_RNG_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* number of uint32 words of the exported state */
+#define COSSAN_RNG_STATE_SIZE 8
+
+typedef struct {
+  uint32_t key[2];     /* key of the generator (seed) */
+  uint64_t position;   /* index of the next block of the stream */
+  uint64_t stream;     /* identifier of the substream */
+  uint32_t buf[4];     /* last block generated */
+  int ibuf;            /* next unused word of buf (4 if empty) */
+} cossan_rng;
+
+/* initialize the generator from a 64-bit seed (stream 0) */
+extern void cossan_rng_init(cossan_rng *rng, uint64_t seed);
+
+/* derive the independent generator number id from the parent generator */
+extern void cossan_rng_substream(const cossan_rng *parent, uint64_t id,
+  cossan_rng *child);
+
+/* skip nblocks blocks of 4 words */
+extern void cossan_rng_skip(cossan_rng *rng, uint64_t nblocks);
+
+/* single deviates */
+extern uint32_t cossan_rng_uint32(cossan_rng *rng);
+extern double cossan_rng_uniform(cossan_rng *rng);   /* [0,1) */
+extern double cossan_rng_normal(cossan_rng *rng);    /* N(0,1) */
+
+/* blocks of deviates. The words left in the buffer by the single deviates
+   are discarded, so that the blocks always start at a block boundary. */
+extern void cossan_rng_fill_uint32(cossan_rng *rng, uint32_t *u, long n);
+extern void cossan_rng_fill_uniform(cossan_rng *rng, double *u, long n);
+extern void cossan_rng_fill_normal(cossan_rng *rng, double *z, long n);
+/* integers uniformly distributed in [0,range) */
+extern void cossan_rng_fill_index(cossan_rng *rng, int *k, long n, int range);
+
+/* export/import of the state. cossan_rng_import returns 0 on success and -1
+   if the vector is not a valid state. */
+extern void cossan_rng_export(const cossan_rng *rng,
+  uint32_t state[COSSAN_RNG_STATE_SIZE]);
+extern int cossan_rng_import(cossan_rng *rng,
+  const uint32_t state[COSSAN_RNG_STATE_SIZE]);
+
+/* uniform block source compatible with srank_uniforms (SRES/srank.h) */
+extern void cossan_rng_uniforms(void *rng, double *u, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_RNG_H */
@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * cossan_rng_mex.h: initialization of cossan_rng from the mex arguments
+ *
+ * The argument used to initialize the generator can be
+ *   - empty or missing: the state is obtained from the random stream of
+ *     OpenCossan (OpenCossan.getNativeRandomState) or, if OpenCossan has not
+ *     been initialized, from the global stream of matlab;
+ *   - a numeric scalar: seed of the generator;
+ *   - a uint32 vector of COSSAN_RNG_STATE_SIZE elements: state exported by a
+ *     previous call (cossan_rng_to_mxarray) or by
+ *     OpenCossan.getNativeRandomState.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _COSSAN_RNG_MEX_H
+#define _COSSAN_RNG_MEX_H
+
+#include "mex.h"
+#include "cossan_rng.h"
+
+/* initialize rng from the mex argument a (NULL if missing) */
+static void cossan_rng_from_mxarray(cossan_rng *rng, const mxArray *a,
+  const char *Sid)
+{
+  mxArray *lhs[1], *rhs[1], *err;
+  double *u;
+  uint64_t seed;
+
+  if (a != NULL && !mxIsEmpty(a)) {
+    if (mxGetClassID(a) == mxUINT32_CLASS &&
+        mxGetNumberOfElements(a) == COSSAN_RNG_STATE_SIZE) {
+      if (cossan_rng_import(rng, (const uint32_t *)mxGetData(a)))
+        mexErrMsgIdAndTxt(Sid, "Invalid state of the random number generator");
+      return;
+    }
+    if (!mxIsNumeric(a) || mxGetNumberOfElements(a) != 1)
+      mexErrMsgIdAndTxt(Sid, "The seed must be a scalar or a uint32 state "
+        "vector of %d elements", COSSAN_RNG_STATE_SIZE);
+    cossan_rng_init(rng, (uint64_t)mxGetScalar(a));
+    return;
+  }
+
+  /* state from the random stream of OpenCossan */
+  rhs[0] = mxCreateString("OpenCossan.getNativeRandomState");
+  err = mexCallMATLABWithTrap(1, lhs, 1, rhs, "feval");
+  mxDestroyArray(rhs[0]);
+  if (err == NULL) {
+    if (mxGetClassID(lhs[0]) == mxUINT32_CLASS &&
+        mxGetNumberOfElements(lhs[0]) == COSSAN_RNG_STATE_SIZE &&
+        cossan_rng_import(rng, (const uint32_t *)mxGetData(lhs[0])) == 0) {
+      mxDestroyArray(lhs[0]);
+      return;
+    }
+    mxDestroyArray(lhs[0]);
+  } else {
+    mxDestroyArray(err);
+  }
+
+  /* OpenCossan not initialized: seed from the global stream of matlab */
+  rhs[0] = mxCreateDoubleMatrix(1, 2, mxREAL);
+  u = mxGetPr(rhs[0]);
+  u[0] = 1.0; u[1] = 2.0;
+  mexCallMATLAB(1, lhs, 1, rhs, "rand");
+  u = mxGetPr(lhs[0]);
+  seed = ((uint64_t)(u[0]*4294967296.0) << 32) | (uint64_t)(u[1]*4294967296.0);
+  mxDestroyArray(lhs[0]);
+  mxDestroyArray(rhs[0]);
+  cossan_rng_init(rng, seed);
+}
+
+/* export the state of rng (1 x COSSAN_RNG_STATE_SIZE uint32) */
+static mxArray *cossan_rng_to_mxarray(const cossan_rng *rng)
+{
+  mxArray *a = mxCreateNumericMatrix(1, COSSAN_RNG_STATE_SIZE, mxUINT32_CLASS,
+    mxREAL);
+  cossan_rng_export(rng, (uint32_t *)mxGetData(a));
+  return a;
+}
+
+#endif /* _COSSAN_RNG_MEX_H */
@@ -13,33 +13,20 @@
  * GNU General Public License for more details.
  */
 
-#include <math.h>
-#include "mex.h"
-
-#ifdef __STDC__
-void Randomize (double *D, int N)
-#else
-void Randomize (D, N)
-double *D ;
-int N ;
-#endif
-{
-  mxArray *nRand, *Rand[1] ;
-  double  *nRandPtr, *RandPtr ;
-  int i ;
-
-  nRand = mxCreateDoubleMatrix(1,2,mxREAL) ;
-  nRandPtr = mxGetPr(nRand) ;
-  nRandPtr[0] = 1 ;
-  nRandPtr[1] = (double)N ;
-  mexCallMATLAB(1,Rand,1,&nRand,"rand") ;
-  RandPtr = mxGetPr(Rand[0]) ;
-  for (i=0;i<N;i++)
-    D[i] = RandPtr[i] ;
-  mxDestroyArray(nRand) ;
-  mxDestroyArray(Rand[0]) ;
-}
+/*
+ * Modified by the Cossan Working Group: the random numbers are generated in
+ * process by cossan_rng (mex/src/Random) instead of calling rand of matlab and
+ * the recombination is performed column-wise, multithreaded, by recomb.c.
+ *
+ * usage: eta = arithx(eta)
+ *        [eta,state] = arithx(eta,state)
+ * where state initializes the random number generator (see cossan_rng_mex.h)
+ * and the output state can be used to continue the sequence.
+ */
 
+#include "mex.h"
+#include "cossan_rng_mex.h"
+#include "recomb.h"
 
 #ifdef __STDC__
 void mexFunction(int nlhs,mxArray *plhs[],int nrhs, const mxArray *prhs[])
@@ -50,29 +37,25 @@ mxArray *plhs[] ;
 const mxArray *prhs[] ;
 #endif
 {
-  int i, j, k, N, n ;
-  double *eta_, *eta, *R ;
-  double a, b ;
+  int N, n, rc ;
+  double *eta_, *eta ;
+  cossan_rng rng ;
 
-  if (nrhs<1)
-    mexErrMsgTxt("usage: eta = arithx(eta);") ;
+  if (nrhs<1 || nrhs>2 || nlhs>2)
+    mexErrMsgTxt("usage: [eta,state] = arithx(eta,state);") ;
 
   N =  mxGetM(prhs[0]) ;
   n =  mxGetN(prhs[0]) ;
   eta_ = mxGetPr(prhs[0]) ;
+  cossan_rng_from_mxarray(&rng, nrhs>1 ? prhs[1] : NULL, "openCOSSAN:arithx") ;
   plhs[0] = mxCreateDoubleMatrix(N,n,mxREAL) ;
   eta = mxGetPr(plhs[0]) ;
 
-  /* allocate random vector */
-  if ((R = (double *) mxCalloc(n*N,sizeof(double))) == NULL)
-    mexErrMsgTxt("fault: memory allocation error in mxCalloc") ;
-
-  Randomize(R,n*N) ;
-  for (i=0;i<N;i++) {
-    for (j=0;j<n;j++) {
-      k = (int)(floor(((double)N)*R[j*N+i])) ;
-      eta[j*N+i] = (eta_[j*N+i] + eta_[j*N+k])/2.0 ;
-    }
+  if (N>0) {
+    rc = recomb(RECOMB_GLOBAL,N,N,n,eta_,eta,0,NULL,NULL,&rng,0) ;
+    if (rc)
+      mexErrMsgTxt("fault: memory allocation error in recomb") ;
   }
-  mxFree(R) ;
+  if (nlhs>1)
+    plhs[1] = cossan_rng_to_mxarray(&rng) ;
 }
@@ -6,9 +6,16 @@ disp('Compiling the Stochastic Ranking ED auxiliary mex files ..');
 assert(~isempty(OpenCossan.getCossanRoot),'openCOSSAN:makeSRES','Please initialize OpenCossan')
 
 % mex for global intermediate recombination (can be ignored...)
-mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" arithx.c
+% The random numbers of all the mex files are generated by ../Random/cossan_rng.c
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" -I../Random arithx.c recomb.c ../Random/cossan_rng.c
+% mex for the recombination operators shared with EvolutionStrategy (see recomb.c)
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" -I../Random recombx.c recomb.c ../Random/cossan_rng.c
 % mex for stochasti ranking sorting
-mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" srsort.c
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" -I../Random srsort.c ../Random/cossan_rng.c
+% mex for stochastic ranking with in-process random numbers (see srank.c)
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" -I../Random srsortx.c srank.c ../Random/cossan_rng.c
+% mex for the native SRES engine (generation loop of sres.m)
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" -I../Random sres_matlab.c sres.c srank.c recomb.c ../Random/cossan_rng.c
 
 % List of created mex files
 r=dir('*.mex*');
@@ -0,0 +1,227 @@
+/*******************************************************************************
+ * recomb.c: recombination operators of the evolution strategies
+ *
+ * The loops of arithx.c visit the step sizes row by row and read a random row
+ * of the whole matrix for each element. Here each column of the parents is
+ * processed contiguously (the random reads stay in a single column, which
+ * fits in the cache for populations of 10^5 individuals) and the random
+ * indices of a block of rows are drawn in bulk. Blocks of RECOMB_BLOCK rows
+ * are the units of work distributed to the threads.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "recomb.h"
+
+#if !defined(_MSC_VER)
+#include <pthread.h>
+#include <unistd.h>
+#define RECOMB_THREADS 1
+#endif
+
+#define RECOMB_BLOCK 4096        /* rows per unit of work */
+#define RECOMB_MIN_WORK 65536    /* elements per thread */
+
+typedef struct {
+  int method, nparents, noffspring, rho;
+  const double *P;
+  double *O;
+  const int *partners;
+  const double *w;
+  cossan_rng base;               /* parent of the substreams of the blocks */
+  int nblocks;                   /* blocks per column */
+  long u0, u1;                   /* units of work [u0,u1) of the thread */
+  int rc;
+} recomb_task;
+
+static void recomb_unit(recomb_task *t, long u, int *k)
+{
+  const double *p;
+  double *o, wr;
+  int j = (int)(u/t->nblocks), i0, i1, i, r, np = t->nparents;
+  int no = t->noffspring;
+  cossan_rng rng;
+
+  i0 = (int)(u%t->nblocks)*RECOMB_BLOCK;
+  i1 = i0+RECOMB_BLOCK < no ? i0+RECOMB_BLOCK : no;
+  p = t->P + (size_t)j*np;
+  o = t->O + (size_t)j*no;
+
+  switch (t->method) {
+  case RECOMB_GLOBAL:
+    cossan_rng_substream(&t->base, (uint64_t)u, &rng);
+    cossan_rng_fill_index(&rng, k, i1-i0, np);
+    for (i=i0; i<i1; i++)
+      o[i] = 0.5*(p[i%np] + p[k[i-i0]]);
+    break;
+  case RECOMB_DISCRETE:
+    cossan_rng_substream(&t->base, (uint64_t)u, &rng);
+    cossan_rng_fill_index(&rng, k, i1-i0, t->rho);
+    for (i=i0; i<i1; i++)
+      o[i] = p[t->partners[(size_t)k[i-i0]*no+i]];
+    break;
+  case RECOMB_INTERMEDIATE:
+    for (i=i0; i<i1; i++) o[i] = 0.0;
+    for (r=0; r<t->rho; r++) {
+      wr = t->w[r];
+      for (i=i0; i<i1; i++)
+        o[i] += wr*p[t->partners[(size_t)r*no+i]];
+    }
+    break;
+  }
+}
+
+static void *recomb_worker(void *arg)
+{
+  recomb_task *t = (recomb_task *)arg;
+  long u;
+  int *k = (int *)malloc(RECOMB_BLOCK*sizeof(int));
+
+  if (k == NULL) { t->rc = -2; return NULL; }
+  for (u=t->u0; u<t->u1; u++)
+    recomb_unit(t, u, k);
+  free(k);
+  t->rc = 0;
+  return NULL;
+}
+
+static int number_of_processors(void)
+{
+#ifdef RECOMB_THREADS
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (int)n : 1;
+#else
+  return 1;
+#endif
+}
+
+int recomb_partners(int nparents, int noffspring, int rho, int *partners,
+  cossan_rng *rng)
+{
+  int i, q, r, s, t, lfound;
+
+  if (rho < 1 || rho > nparents) return -1;
+  for (i=0; i<noffspring; i++) {
+    /* Floyd's algorithm: rho distinct integers with O(rho^2) operations */
+    for (r=0, s=nparents-rho; r<rho; r++, s++) {
+      t = (int)(((uint64_t)cossan_rng_uint32(rng)*(uint32_t)(s+1)) >> 32);
+      lfound = 0;
+      for (q=0; q<r; q++)
+        if (partners[(size_t)q*noffspring+i] == t) { lfound = 1; break; }
+      partners[(size_t)r*noffspring+i] = lfound ? s : t;
+    }
+  }
+  return 0;
+}
+
+int recomb(int method, int nparents, int noffspring, int n,
+  const double *P, double *O, int rho, const int *partners, const double *w,
+  cossan_rng *rng, int nthreads)
+{
+  recomb_task task, *tasks;
+  double *wn = NULL, wsum;
+  long nunits, chunk;
+  int t, r, rc = 0;
+#ifdef RECOMB_THREADS
+  pthread_t *tid;
+#endif
+
+  if (nparents < 1 || noffspring < 0 || n < 0 || P == NULL || O == NULL ||
+      method < RECOMB_GLOBAL || method > RECOMB_INTERMEDIATE)
+    return -1;
+  if (method != RECOMB_GLOBAL && (partners == NULL || rho < 1))
+    return -1;
+  if (noffspring == 0 || n == 0) return 0;
+
+  task.method = method; task.nparents = nparents;
+  task.noffspring = noffspring; task.rho = rho;
+  task.P = P; task.O = O; task.partners = partners; task.w = NULL;
+  if (method == RECOMB_INTERMEDIATE) {
+    if ((wn = (double *)malloc(rho*sizeof(double))) == NULL) return -2;
+    wsum = 0.0;
+    for (r=0; r<rho; r++) wsum += w != NULL ? w[r] : 1.0;
+    if (!(wsum > 0.0)) { free(wn); return -1; }
+    for (r=0; r<rho; r++) wn[r] = (w != NULL ? w[r] : 1.0)/wsum;
+    task.w = wn;
+  }
+
+  /* the substreams of this call are derived from one block of rng */
+  task.base = *rng;
+  task.base.stream = (uint64_t)cossan_rng_uint32(rng) << 32;
+  task.base.stream |= cossan_rng_uint32(rng);
+  cossan_rng_skip(rng, 0); /* discard the rest of the block */
+
+  task.nblocks = (noffspring + RECOMB_BLOCK - 1)/RECOMB_BLOCK;
+  nunits = (long)task.nblocks*n;
+
+  if (nthreads <= 0) nthreads = number_of_processors();
+  if ((long)nthreads > (long)noffspring*n/RECOMB_MIN_WORK)
+    nthreads = (int)((long)noffspring*n/RECOMB_MIN_WORK);
+  if (nthreads > nunits) nthreads = (int)nunits;
+  if (nthreads < 1) nthreads = 1;
+
+  tasks = (recomb_task *)malloc(nthreads*sizeof(recomb_task));
+#ifdef RECOMB_THREADS
+  tid = (pthread_t *)malloc(nthreads*sizeof(pthread_t));
+  if (tasks == NULL || tid == NULL) {
+    free(tasks); free(tid); free(wn);
+    return -2;
+  }
+#else
+  if (tasks == NULL) { free(wn); return -2; }
+  nthreads = 1;
+#endif
+
+  /* contiguous ranges of units: each thread works on whole columns */
+  chunk = (nunits + nthreads - 1)/nthreads;
+  for (t=0; t<nthreads; t++) {
+    tasks[t] = task;
+    tasks[t].u0 = t*chunk < nunits ? t*chunk : nunits;
+    tasks[t].u1 = (t+1)*chunk < nunits ? (t+1)*chunk : nunits;
+    tasks[t].rc = 0;
+  }
+#ifdef RECOMB_THREADS
+  for (t=1; t<nthreads; t++)
+    if (pthread_create(&tid[t], NULL, recomb_worker, &tasks[t]) != 0) {
+      /* run this range in the calling thread */
+      recomb_worker(&tasks[t]);
+      tid[t] = pthread_self();
+    }
+  recomb_worker(&tasks[0]);
+  for (t=1; t<nthreads; t++)
+    if (!pthread_equal(tid[t], pthread_self()))
+      pthread_join(tid[t], NULL);
+  free(tid);
+#else
+  recomb_worker(&tasks[0]);
+#endif
+  for (t=0; t<nthreads; t++)
+    if (tasks[t].rc) rc = tasks[t].rc;
+
+  free(tasks); free(wn);
+  return rc;
+}
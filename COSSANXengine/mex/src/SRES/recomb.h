@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * recomb.h: recombination operators of the evolution strategies
+ *
+ * Kernel shared by the native SRES engine (sres.c) and by the mex files arithx
+ * and recombx (used by StochasticRanking and EvolutionStrategy).
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _RECOMB_H
+#define _RECOMB_H
+
+#include "cossan_rng.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Available recombination operators
+ *
+ * RECOMB_GLOBAL       global intermediate recombination (arithx): the
+ *                     variable j of the offspring i is the mean of the
+ *                     variable j of the parent i%nparents and of a parent
+ *                     drawn at random for each variable
+ * RECOMB_DISCRETE     the variable j of the offspring i is copied from one
+ *                     of its rho partners, drawn at random for each variable
+ * RECOMB_INTERMEDIATE weighted mean of the rho partners of the offspring
+ */
+enum recomb_method {
+  RECOMB_GLOBAL = 0,
+  RECOMB_DISCRETE = 1,
+  RECOMB_INTERMEDIATE = 2
+};
+
+/*
+ * Draw rho distinct parents in [0,nparents) for each offspring.
+ * partners[r*noffspring+i] is the partner r of the offspring i.
+ * Returns 0 on success and -1 if rho is not in [1,nparents].
+ */
+extern int recomb_partners(int nparents, int noffspring, int rho,
+  int *partners, cossan_rng *rng);
+
+/*
+ * Recombination of the parents P (nparents x n, column-wise) into the
+ * offspring O (noffspring x n, column-wise).
+ *
+ * rho, partners : partners of each offspring (see recomb_partners), used by
+ *                 RECOMB_DISCRETE and RECOMB_INTERMEDIATE
+ * w             : weights of the rho partners for RECOMB_INTERMEDIATE
+ *                 (normalized to unit sum; NULL for equal weights)
+ * rng           : random number generator, advanced by one block per call
+ * nthreads      : number of threads (<=0: number of processors)
+ *
+ * The matrices are processed one column at a time and the columns are split
+ * in blocks of rows with their own substream of rng, so that the result does
+ * not depend on the number of threads.
+ * Returns 0 on success, -1 for invalid arguments and -2 if out of memory.
+ */
+extern int recomb(int method, int nparents, int noffspring, int n,
+  const double *P, double *O, int rho, const int *partners, const double *w,
+  cossan_rng *rng, int nthreads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RECOMB_H */
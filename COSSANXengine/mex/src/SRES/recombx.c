@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * recombx: recombination operators of the evolution strategies - matlab MEX
+ *
+ * Interface to recomb.c, shared by StochasticRanking (global intermediate
+ * recombination, see also arithx) and EvolutionStrategy (discrete and
+ * weighted intermediate recombination).
+ *
+ * usage:
+ *   [Moffspring,state,Mpartners] = recombx(Mparents,Noffspring,Smethod)
+ *   [...] = recombx(Mparents,Noffspring,Smethod,Nrho,Vweights,state,Nthreads,Mpartners)
+ * where
+ *   Mparents   : parents (Nparents x n)
+ *   Noffspring : number of offspring
+ *   Smethod    : 'global' (global intermediate), 'discrete' or
+ *                'intermediate' (weighted mean of the partners)
+ *   Nrho       : number of partners of each offspring (default 2)
+ *   Vweights   : weights of the Nrho partners for 'intermediate' (default
+ *                equal weights)
+ *   state      : seed or state of the random number generator (see
+ *                cossan_rng_mex.h). By default it is drawn from the random
+ *                stream of OpenCossan.
+ *   Nthreads   : number of threads (default: number of processors)
+ *   Mpartners  : partners of each offspring (Noffspring x Nrho, 1-based
+ *                indices of the parents). By default they are drawn at random
+ *                (Nrho distinct parents per offspring).
+ *
+ *   Moffspring : offspring (Noffspring x n)
+ *   state      : state of the random number generator after the call
+ *   Mpartners  : partners used (pass them to a second call to recombine
+ *                other variables of the same offspring)
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <string.h>
+#include "mex.h"
+#include "cossan_rng_mex.h"
+#include "recomb.h"
+
+#define ID "openCOSSAN:recombx"
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    int nparents, noffspring, n, rho = 2, nthreads = 0, method, i, rc;
+    int *partners = NULL;
+    double *P, *w = NULL, *Mp;
+    char Smethod[16];
+    cossan_rng rng;
+
+    if (nrhs < 3 || nrhs > 8 || nlhs > 3)
+        mexErrMsgTxt("usage: [Moffspring,state,Mpartners] = recombx(Mparents,"
+            "Noffspring,Smethod,Nrho,Vweights,state,Nthreads,Mpartners)");
+
+    if (!mxIsDouble(prhs[0]) || mxIsComplex(prhs[0]))
+        mexErrMsgIdAndTxt(ID, "Mparents must be a real double matrix");
+    nparents   = (int)mxGetM(prhs[0]);
+    n          = (int)mxGetN(prhs[0]);
+    P          = mxGetPr(prhs[0]);
+    noffspring = (int)mxGetScalar(prhs[1]);
+    if (nparents < 1 || noffspring < 0)
+        mexErrMsgIdAndTxt(ID, "At least one parent and a non-negative number "
+            "of offspring are required");
+
+    if (!mxIsChar(prhs[2]) || mxGetString(prhs[2], Smethod, sizeof(Smethod)))
+        mexErrMsgIdAndTxt(ID, "Smethod must be 'global', 'discrete' or 'intermediate'");
+    if (strcmp(Smethod, "global") == 0)
+        method = RECOMB_GLOBAL;
+    else if (strcmp(Smethod, "discrete") == 0)
+        method = RECOMB_DISCRETE;
+    else if (strcmp(Smethod, "intermediate") == 0)
+        method = RECOMB_INTERMEDIATE;
+    else
+        mexErrMsgIdAndTxt(ID, "Unknown recombination %s. Use 'global', "
+            "'discrete' or 'intermediate'", Smethod);
+
+    if (nrhs > 3 && !mxIsEmpty(prhs[3]))
+        rho = (int)mxGetScalar(prhs[3]);
+    if (nrhs > 7 && !mxIsEmpty(prhs[7]))
+        rho = (int)mxGetN(prhs[7]);
+    if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+        if ((int)mxGetNumberOfElements(prhs[4]) != rho || !mxIsDouble(prhs[4]))
+            mexErrMsgIdAndTxt(ID, "Vweights must contain Nrho (%d) values", rho);
+        w = mxGetPr(prhs[4]);
+    }
+    cossan_rng_from_mxarray(&rng, nrhs > 5 ? prhs[5] : NULL, ID);
+    if (nrhs > 6 && !mxIsEmpty(prhs[6]))
+        nthreads = (int)mxGetScalar(prhs[6]);
+
+    /* partners of each offspring */
+    if (method != RECOMB_GLOBAL || nlhs > 2) {
+        if (rho < 1 || rho > nparents)
+            mexErrMsgIdAndTxt(ID, "Nrho (%d) must be between 1 and the number "
+                "of parents (%d)", rho, nparents);
+        partners = (int *)mxCalloc(noffspring > 0 ? (size_t)noffspring*rho : 1,
+            sizeof(int));
+        if (nrhs > 7 && !mxIsEmpty(prhs[7])) {
+            if ((int)mxGetM(prhs[7]) != noffspring || !mxIsDouble(prhs[7]))
+                mexErrMsgIdAndTxt(ID, "Mpartners must be a Noffspring x Nrho matrix");
+            Mp = mxGetPr(prhs[7]);
+            for (i=0; i<noffspring*rho; i++) {
+                partners[i] = (int)Mp[i] - 1;
+                if (partners[i] < 0 || partners[i] >= nparents)
+                    mexErrMsgIdAndTxt(ID, "Mpartners must contain indices "
+                        "of the parents (1 to %d)", nparents);
+            }
+        } else {
+            recomb_partners(nparents, noffspring, rho, partners, &rng);
+        }
+    }
+
+    plhs[0] = mxCreateDoubleMatrix(noffspring, n, mxREAL);
+    rc = recomb(method, nparents, noffspring, n, P, mxGetPr(plhs[0]), rho,
+        partners, w, &rng, nthreads);
+    if (rc == -2)
+        mexErrMsgIdAndTxt(ID, "Out of memory");
+    else if (rc)
+        mexErrMsgIdAndTxt(ID, "Invalid arguments (check Vweights)");
+
+    if (nlhs > 1)
+        plhs[1] = cossan_rng_to_mxarray(&rng);
+    if (nlhs > 2) {
+        plhs[2] = mxCreateDoubleMatrix(noffspring, rho, mxREAL);
+        Mp = mxGetPr(plhs[2]);
+        for (i=0; i<noffspring*rho; i++)
+            Mp[i] = (double)(partners[i]+1);
+    }
+    if (partners != NULL)
+        mxFree(partners);
+}
@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * srank.c: Stochastic Ranking procedure
+ *
+ * srank is the stochastic bubble sort of T.P. Runarsson (srsort.c):
+ * up to lambda sweeps of adjacent comparisons, stopping at the first sweep
+ * without swaps. Given the same stream of uniform numbers it returns the same
+ * ranking as srsort.c, but the indices are kept as integers and the lambda-1
+ * random numbers of a sweep are drawn in one block (no call to matlab), so
+ * that the decision "compare by objective function" is computed in a
+ * separate, vectorizable pass before the swap pass. srank_validate checks
+ * the equivalence with srsort.c.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include "srank.h"
+
+static int rank_bubble(int lambda, const double *f, const double *phi,
+  double pf, int *I, double *u, int *byf, srank_uniforms *uniform, void *rng)
+{
+  int i, j, a, b, lswap;
+
+  for (i=0; i<lambda; i++) I[i] = i;
+  for (i=0; i<lambda; i++) {
+    /* draw the random numbers of the sweep and decide in one pass which
+       comparisons are made by objective function */
+    uniform(rng, u, lambda-1);
+    for (j=0; j<lambda-1; j++)
+      byf[j] = u[j] < pf;
+
+    lswap = 0;
+    for (j=0; j<lambda-1; j++) {
+      a = I[j]; b = I[j+1];
+      if (byf[j] || (phi[a] == 0.0 && phi[b] == 0.0)) {
+        if (f[a] > f[b]) { I[j] = b; I[j+1] = a; lswap = 1; }
+      } else {
+        if (phi[a] > phi[b]) { I[j] = b; I[j+1] = a; lswap = 1; }
+      }
+    }
+    if (!lswap) return i+1;
+  }
+  return lambda;
+}
+
+int srank(int lambda, const double *f, const double *phi,
+  double pf, int *I, void *work, srank_uniforms *uniform, void *rng)
+{
+  double *u = (double *)work;
+  int *iw = (int *)(u + lambda);
+
+  if (lambda < 2) {
+    if (lambda == 1) I[0] = 0;
+    return 0;
+  }
+  return rank_bubble(lambda, f, phi, pf, I, u, iw, uniform, rng);
+}
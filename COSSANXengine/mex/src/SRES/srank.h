@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * srank.h: Stochastic Ranking procedure
+ *
+ * Declaration of the native stochastic ranking procedure used by the SRES
+ * engine (sres.c) and by the mex srsortx. See srank.c for the details.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _SRANK_H
+#define _SRANK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Source of uniform random numbers: fill u[0..n-1] with deviates in [0,1)
+ */
+typedef void srank_uniforms(void *rng, double *u, int n);
+
+/*
+ * srank : rank a population by stochastic ranking (stochastic bubble sort,
+ *         same ranking as srsort.c)
+ *
+ * lambda  : size of the population
+ * f       : objective function (lambda)
+ * phi     : penalty, zero for the feasible individuals (lambda)
+ * pf      : probability of comparing two individuals by objective function
+ * I       : on output, ranked indices (0-based, lambda)
+ * work    : workspace of lambda doubles and lambda ints (see SRANK_WORK)
+ * uniform : random number generator and its state
+ *
+ * Two adjacent individuals are compared by objective function when both are
+ * feasible or with probability pf, and by penalty otherwise.
+ * The function returns the number of sweeps performed.
+ */
+extern int srank(int lambda, const double *f, const double *phi,
+  double pf, int *I, void *work, srank_uniforms *uniform, void *rng);
+
+/* size in bytes of the workspace required by srank */
+#define SRANK_WORK(lambda) ((size_t)(lambda)*(sizeof(double)+sizeof(int)))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SRANK_H */
@@ -0,0 +1,128 @@
+/*******************************************************************************
+ * srank_validate: validation of the stochastic ranking procedure
+ *
+ * Standalone program (no matlab required) that checks that srank.c returns
+ * exactly the ranking of the reference stochastic bubble sort of srsort.c
+ * when both consume the same stream of uniform numbers, over ntrials random
+ * populations with a fraction pfeasible of feasible individuals.
+ *
+ * The program prints a summary and returns a non-zero exit status when the
+ * check fails.
+ *
+ * Compile with:
+ *
+ *   gcc -O2 -I../Random srank_validate.c srank.c ../Random/cossan_rng.c -lm \
+ *     -o srank_validate
+ *
+ * usage: srank_validate [lambda pf pfeasible ntrials]
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "srank.h"
+#include "cossan_rng.h"
+
+/* transcription of the sorting loop of srsort.c (indices stored as double) */
+static void srsort_reference(int n, const double *f, const double *phi,
+  double pf, double *I, double *G, cossan_rng *rng)
+{
+  int i, j;
+  double Is;
+
+  for (i=1; i<=n; i++) I[i-1] = (double)i;
+  for (i=0; i<n; i++) {
+    Is = 0;
+    cossan_rng_uniforms(rng, G, n-1);
+    for (j=0; j<(n-1); j++) {
+      if (((phi[(int)I[j]-1]==phi[(int)I[j+1]-1]) && (phi[(int)I[j]-1]==0)) || (G[j]<pf)) {
+        if (f[(int)I[j]-1]>f[(int)I[j+1]-1]) {
+          Is = I[j]; I[j] = I[j+1]; I[j+1] = Is;
+        }
+      } else {
+        if (phi[(int)I[j]-1]>phi[(int)I[j+1]-1]) {
+          Is = I[j]; I[j] = I[j+1]; I[j+1] = Is;
+        }
+      }
+    }
+    if (Is == 0) break;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  int lambda = 100, ntrials = 2000;
+  double pf = 0.45, pfeas = 0.3;
+  int t, i, nmismatch = 0, *I;
+  double *f, *phi, *Iref, *G;
+  void *work;
+  cossan_rng rng, rng_ref, rng_pop;
+
+  if (argc > 1) lambda = atoi(argv[1]);
+  if (argc > 2) pf = atof(argv[2]);
+  if (argc > 3) pfeas = atof(argv[3]);
+  if (argc > 4) ntrials = atoi(argv[4]);
+  if (lambda < 2 || ntrials < 1) {
+    fprintf(stderr, "usage: %s [lambda pf pfeasible ntrials]\n", argv[0]);
+    return 2;
+  }
+
+  f = (double *)malloc(lambda*sizeof(double));
+  phi = (double *)malloc(lambda*sizeof(double));
+  Iref = (double *)malloc(lambda*sizeof(double));
+  G = (double *)malloc(lambda*sizeof(double));
+  I = (int *)malloc(lambda*sizeof(int));
+  work = malloc(SRANK_WORK(lambda));
+
+  cossan_rng_init(&rng_pop, 1);
+  for (t=0; t<ntrials; t++) {
+    /* random population */
+    for (i=0; i<lambda; i++) {
+      f[i] = cossan_rng_normal(&rng_pop);
+      phi[i] = cossan_rng_uniform(&rng_pop) < pfeas ? 0.0 : cossan_rng_uniform(&rng_pop);
+    }
+
+    /* same ranking as srsort.c */
+    cossan_rng_init(&rng, 1000+t);
+    rng_ref = rng;
+    srank(lambda, f, phi, pf, I, work, cossan_rng_uniforms, &rng);
+    srsort_reference(lambda, f, phi, pf, Iref, G, &rng_ref);
+    for (i=0; i<lambda; i++)
+      if (I[i]+1 != (int)Iref[i]) { nmismatch++; break; }
+  }
+
+  printf("lambda=%d pf=%g pfeasible=%g trials=%d\n", lambda, pf, pfeas, ntrials);
+  printf("srank vs srsort.c: %d mismatching rankings\n", nmismatch);
+
+  free(f); free(phi); free(Iref); free(G); free(I); free(work);
+
+  if (nmismatch > 0) {
+    printf("FAILED: srank does not reproduce srsort.c\n");
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
@@ -0,0 +1,379 @@
+/*******************************************************************************
+ * sres.c: Stochastic Ranking Evolution Strategy - native engine
+ *
+ * Native implementation of the generation loop of sres.m (T.P. Runarsson and
+ * X. Yao, "Stochastic Ranking for Constrained Evolutionary Optimization", IEEE
+ * Transactions on Evolutionary Computation, 4(3):284-294, 2000).
+ *
+ * Each generation:
+ *   1. the fitness of the whole population is requested with one call of the
+ *      batch fitness function (split in nthreads concurrent batches when
+ *      nthreads>1);
+ *   2. the population is ranked by stochastic ranking (see srank.c) using
+ *      the quadratic loss of the constraint violations as penalty;
+ *   3. the mu best individuals are selected as parents of lambda offspring;
+ *   4. the step sizes are recombined by global intermediate recombination
+ *      (see arithx.c) and self-adapted with a lognormal update;
+ *   5. the offspring are mutated and the variables out of bounds are resampled
+ *      up to nretry times (the parent value is kept if they still fail).
+ *
+ * The population is stored column-wise (lambda x n) as in MATLAB so that the
+ * matrices can be shared with the mex interface without transposition.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "sres.h"
+#include "srank.h"
+#include "recomb.h"
+#include "cossan_rng.h"
+
+#if !defined(_MSC_VER)
+#include <pthread.h>
+#define SRES_THREADS 1
+#endif
+
+#ifndef NAN
+#define NAN (0.0/0.0)
+#endif
+
+#define SRES_NBATCH 100 /* growth of the statistics arrays */
+
+/*
+ * Fitness evaluation of the population
+ */
+typedef struct {
+  sres_fitness *fitness;
+  void *state;
+  int i0, nrows, ld, n, m;
+  const double *x;
+  double *f, *phi;
+  int rc;
+} sres_batch;
+
+#ifdef SRES_THREADS
+static void *evaluate_batch(void *arg)
+{
+  sres_batch *b = (sres_batch *)arg;
+  b->rc = b->fitness(b->nrows, b->ld, b->n, b->m, b->x + b->i0,
+    b->f + b->i0, b->phi + b->i0, b->state);
+  return NULL;
+}
+#endif
+
+static int evaluate_population(const sres_options *o, sres_fitness *fitness,
+  void *state, const double *x, double *f, double *phi)
+{
+  int nthreads = o->nthreads;
+#ifdef SRES_THREADS
+  sres_batch *batch;
+  pthread_t *tid;
+  int t, i0, rc = 0, chunk;
+#endif
+
+  if (nthreads > o->lambda) nthreads = o->lambda;
+  if (nthreads <= 1)
+    return fitness(o->lambda, o->lambda, o->n, o->m, x, f, phi, state);
+
+#ifdef SRES_THREADS
+  batch = (sres_batch *)malloc(nthreads*sizeof(sres_batch));
+  tid = (pthread_t *)malloc(nthreads*sizeof(pthread_t));
+  if (batch == NULL || tid == NULL) {
+    free(batch); free(tid);
+    return fitness(o->lambda, o->lambda, o->n, o->m, x, f, phi, state);
+  }
+  chunk = (o->lambda + nthreads - 1)/nthreads;
+  for (t=0, i0=0; t<nthreads; t++, i0+=chunk) {
+    batch[t].fitness = fitness; batch[t].state = state;
+    batch[t].i0 = i0;
+    batch[t].nrows = (i0+chunk <= o->lambda) ? chunk : o->lambda-i0;
+    batch[t].ld = o->lambda; batch[t].n = o->n; batch[t].m = o->m;
+    batch[t].x = x; batch[t].f = f; batch[t].phi = phi;
+    batch[t].rc = 0;
+    if (batch[t].nrows <= 0) { nthreads = t; break; }
+    if (pthread_create(&tid[t], NULL, evaluate_batch, &batch[t]) != 0) {
+      /* evaluate this batch in the calling thread */
+      evaluate_batch(&batch[t]);
+      tid[t] = pthread_self();
+    }
+  }
+  for (t=0; t<nthreads; t++) {
+    if (!pthread_equal(tid[t], pthread_self()))
+      pthread_join(tid[t], NULL);
+    if (batch[t].rc) rc = batch[t].rc;
+  }
+  free(batch); free(tid);
+  return rc;
+#else
+  return fitness(o->lambda, o->lambda, o->n, o->m, x, f, phi, state);
+#endif
+}
+
+static int grow_statistics(sres_results *r, int size)
+{
+  double *p;
+  if ((p = (double *)realloc(r->vmin, size*sizeof(double))) == NULL) return -1;
+  r->vmin = p;
+  if ((p = (double *)realloc(r->vmean, size*sizeof(double))) == NULL) return -1;
+  r->vmean = p;
+  if ((p = (double *)realloc(r->vfeasible, size*sizeof(double))) == NULL) return -1;
+  r->vfeasible = p;
+  return 0;
+}
+
+void sres_default_options(sres_options *o, int n, int m)
+{
+  o->n = n;
+  o->m = m;
+  o->lambda = 100;
+  o->mu = 10;
+  o->maxgen = 2000;
+  o->nretry = 10;
+  o->nthreads = 1;
+  o->pf = 0.45;
+  o->varphi = 1.0;
+  o->lb = NULL;
+  o->ub = NULL;
+  o->seed = 0;
+  o->rngstate = NULL;
+}
+
+void sres_free_results(sres_results *r)
+{
+  free(r->xb); r->xb = NULL;
+  free(r->vmin); r->vmin = NULL;
+  free(r->vmean); r->vmean = NULL;
+  free(r->vfeasible); r->vfeasible = NULL;
+}
+
+const char *sres_rc_string(int rc)
+{
+  switch (rc) {
+    case SRES_FITNESS_ERROR:  return "Fitness function returned an error";
+    case SRES_OUT_OF_MEMORY:  return "Memory allocation failed";
+    case SRES_INVALID_ARGS:   return "Invalid arguments";
+    case SRES_MAXGEN_REACHED: return "Maximum number of generations reached";
+    case SRES_USER_STOP:      return "Termination requested by the monitor";
+    default:                  return "Unknown return code";
+  }
+}
+
+int sres(const sres_options *o, sres_fitness *fitness, sres_monitor *monitor,
+  void *state, sres_results *r)
+{
+  int n, m, lambda, mu;
+  int i, j, k, p, g, retry, nfeas, ibest, ipen, lfeas, nstat, rc;
+  double *x, *xnew, *f, *phi, *pen, *eta, *etasel, *etau, *xb, *tmp;
+  double *xpen;
+  void *work;
+  int *I;
+  double tau, tau_, fmin, fsum, pmin, ptot, meanold, xij, lo, hi, dv, gl;
+  cossan_rng rng;
+  sres_status st;
+
+  memset(r, 0, sizeof(sres_results));
+  if (o == NULL || fitness == NULL || o->n < 1 || o->m < 0 || o->lambda < 2 ||
+      o->mu < 1 || o->mu > o->lambda || o->maxgen < 1 || o->lb == NULL ||
+      o->ub == NULL || o->pf < 0.0 || o->pf > 1.0)
+    return SRES_INVALID_ARGS;
+  if (o->rngstate != NULL && cossan_rng_import(&rng, o->rngstate))
+    return SRES_INVALID_ARGS;
+  for (j=0; j<o->n; j++)
+    if (!(o->lb[j] <= o->ub[j])) return SRES_INVALID_ARGS;
+
+  n = o->n; m = o->m; lambda = o->lambda; mu = o->mu;
+
+  x      = (double *)malloc(lambda*n*sizeof(double));
+  xnew   = (double *)malloc(lambda*n*sizeof(double));
+  eta    = (double *)malloc(lambda*n*sizeof(double));
+  etasel = (double *)malloc(lambda*n*sizeof(double));
+  f      = (double *)malloc(lambda*sizeof(double));
+  phi    = (double *)malloc((m > 0 ? lambda*m : 1)*sizeof(double));
+  pen    = (double *)malloc(lambda*sizeof(double));
+  etau   = (double *)malloc(n*sizeof(double));
+  xb     = (double *)malloc(n*sizeof(double));
+  xpen   = (double *)malloc(n*sizeof(double));
+  I      = (int *)malloc(lambda*sizeof(int));
+  work   = malloc(SRANK_WORK(lambda));
+  nstat  = SRES_NBATCH;
+  if (x == NULL || xnew == NULL || eta == NULL || etasel == NULL ||
+      f == NULL || phi == NULL || pen == NULL || etau == NULL || xb == NULL ||
+      xpen == NULL || I == NULL || work == NULL || grow_statistics(r, nstat)) {
+    rc = SRES_OUT_OF_MEMORY;
+    goto cleanup;
+  }
+
+  if (o->rngstate == NULL)
+    cossan_rng_init(&rng, (uint64_t)o->seed);
+
+  /* Initialize population and step sizes */
+  for (j=0; j<n; j++) {
+    etau[j] = (o->ub[j] - o->lb[j])/sqrt((double)n);
+    for (i=0; i<lambda; i++) {
+      x[j*lambda+i] = o->lb[j] + cossan_rng_uniform(&rng)*(o->ub[j] - o->lb[j]);
+      eta[j*lambda+i] = etau[j];
+    }
+  }
+  tau  = o->varphi/sqrt(2.0*sqrt((double)n));
+  tau_ = o->varphi/sqrt(2.0*n);
+
+  r->fb = HUGE_VAL;
+  r->gm = 0;
+  meanold = NAN;
+  lfeas = 0;
+  rc = SRES_MAXGEN_REACHED;
+
+  /* Generation loop */
+  for (g=0; g<o->maxgen; g++) {
+    if (g >= nstat) {
+      nstat += SRES_NBATCH;
+      if (grow_statistics(r, nstat)) { rc = SRES_OUT_OF_MEMORY; break; }
+    }
+
+    /* fitness evaluation */
+    if (evaluate_population(o, fitness, state, x, f, phi)) {
+      rc = SRES_FITNESS_ERROR;
+      break;
+    }
+    r->nevals += lambda;
+
+    /* statistics and quadratic loss penalty */
+    nfeas = 0; fsum = 0.0; fmin = HUGE_VAL; ibest = -1;
+    pmin = HUGE_VAL; ipen = 0;
+    for (i=0; i<lambda; i++) {
+      ptot = 0.0;
+      for (k=0; k<m; k++)
+        if (phi[k*lambda+i] > 0.0) ptot += phi[k*lambda+i]*phi[k*lambda+i];
+      pen[i] = ptot;
+      if (ptot == 0.0) {
+        nfeas++;
+        fsum += f[i];
+        if (f[i] < fmin) { fmin = f[i]; ibest = i; }
+      }
+      if (ptot < pmin) { pmin = ptot; ipen = i; }
+    }
+    r->vfeasible[g] = (double)nfeas;
+    if (nfeas > 0) {
+      r->vmin[g] = fmin;
+      r->vmean[g] = fsum/nfeas;
+    } else {
+      r->vmin[g] = NAN;
+      r->vmean[g] = NAN;
+    }
+
+    /* keep best individual found */
+    if (ibest >= 0 && fmin < r->fb) {
+      for (j=0; j<n; j++) xb[j] = x[j*lambda+ibest];
+      r->fb = fmin;
+      r->gm = g+1;
+      lfeas = 1;
+    }
+    if (!lfeas)
+      for (j=0; j<n; j++) xpen[j] = x[j*lambda+ipen];
+
+    /* selection using stochastic ranking */
+    srank(lambda, f, pen, o->pf, I, work, cossan_rng_uniforms, &rng);
+    for (j=0; j<n; j++)
+      for (i=0; i<lambda; i++)
+        etasel[j*lambda+i] = eta[j*lambda+I[i%mu]];
+
+    /* global intermediate recombination and lognormal update of eta */
+    if (recomb(RECOMB_GLOBAL, lambda, lambda, n, etasel, eta, 0, NULL, NULL,
+               &rng, o->nthreads)) {
+      rc = SRES_OUT_OF_MEMORY;
+      break;
+    }
+    for (i=0; i<lambda; i++) {
+      gl = tau_*cossan_rng_normal(&rng);
+      for (j=0; j<n; j++) {
+        eta[j*lambda+i] *= exp(gl + tau*cossan_rng_normal(&rng));
+        if (eta[j*lambda+i] > etau[j]) eta[j*lambda+i] = etau[j];
+      }
+    }
+
+    /* mutation with retry for the variables out of bounds */
+    dv = 0.0;
+    for (j=0; j<n; j++) {
+      lo = o->lb[j]; hi = o->ub[j];
+      for (i=0; i<lambda; i++) {
+        p = I[i%mu];
+        xij = x[j*lambda+p];
+        for (retry=0; retry<=o->nretry; retry++) {
+          xnew[j*lambda+i] = xij + eta[j*lambda+i]*cossan_rng_normal(&rng);
+          if (xnew[j*lambda+i] >= lo && xnew[j*lambda+i] <= hi) break;
+        }
+        if (retry > o->nretry) xnew[j*lambda+i] = xij; /* ignore failures */
+        dv += fabs(xnew[j*lambda+i] - xij);
+      }
+    }
+
+    /* report the generation to the monitor */
+    if (monitor != NULL) {
+      st.generation = g;
+      st.nevals = r->nevals;
+      st.lambda = lambda; st.n = n; st.m = m;
+      st.x = x; st.f = f; st.phi = phi;
+      st.nfeasible = nfeas;
+      st.fmin = r->vmin[g];
+      st.fmean = r->vmean[g];
+      st.deltaDV = dv;
+      st.deltaObjFun = (g > 0) ? fabs(r->vmean[g] - meanold) : 0.0;
+      st.xbest = lfeas ? xb : NULL;
+      st.fbest = r->fb;
+      st.gbest = r->gm;
+      if (monitor(&st, state)) {
+        r->ngen = g+1;
+        rc = SRES_USER_STOP;
+        break;
+      }
+    }
+    meanold = r->vmean[g];
+
+    tmp = x; x = xnew; xnew = tmp;
+    r->ngen = g+1;
+  }
+
+  if (rc >= 0) {
+    if (lfeas) {
+      r->xb = xb; xb = NULL;
+      r->lfeasible = 1;
+    } else {
+      /* no feasible solution: return the least infeasible individual */
+      r->xb = xpen; xpen = NULL;
+      r->fb = NAN;
+      r->gm = r->ngen;
+      r->lfeasible = 0;
+    }
+  }
+
+cleanup:
+  free(x); free(xnew); free(eta); free(etasel); free(f); free(phi);
+  free(pen); free(etau); free(xb); free(xpen); free(I); free(work);
+  if (rc < 0) sres_free_results(r);
+  return rc;
+}
@@ -0,0 +1,162 @@
+/*******************************************************************************
+ * sres.h: Stochastic Ranking Evolution Strategy - native engine
+ *
+ * Declarations of the native SRES engine. The engine implements the complete
+ * generation loop of sres.m (stochastic ranking, global intermediate
+ * recombination of the step sizes, lognormal self-adaptation, mutation with
+ * bound retry) and does not depend on MATLAB. The fitness of the population
+ * is requested through a batch callback. See sres.c for the details.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _SRES_H
+#define _SRES_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Possible return values of sres
+ */
+typedef enum {
+  SRES_FITNESS_ERROR  = -3, /* the fitness callback returned an error */
+  SRES_OUT_OF_MEMORY  = -2, /* memory allocation failed */
+  SRES_INVALID_ARGS   = -1, /* inconsistent options */
+  SRES_MAXGEN_REACHED =  0, /* maximum number of generations reached */
+  SRES_USER_STOP      =  1  /* the monitor requested the end of the search */
+} sres_result;
+
+/*
+ * Batch fitness function
+ *
+ * nrows : number of individuals to be evaluated
+ * ld    : leading dimension of x and phi (the population size lambda)
+ * n     : number of design variables
+ * m     : number of inequality constraints
+ * x     : individuals, x[j*ld+i] is the variable j of the individual i
+ * f     : on output, f[i] objective function of the individual i
+ * phi   : on output, phi[k*ld+i] constraint k of the individual i (<=0 is
+ *         feasible)
+ * state : user data passed to sres
+ *
+ * The population is stored column-wise (as a MATLAB matrix) and x, f and phi
+ * point to the first individual of the batch. The function must return 0 on
+ * success and a non-zero value to abort the optimization. When nthreads>1 the
+ * function is called concurrently on disjoint batches and must be
+ * thread-safe.
+ */
+typedef int sres_fitness(int nrows, int ld, int n, int m, const double *x,
+  double *f, double *phi, void *state);
+
+/*
+ * Status of the current generation passed to the monitor
+ */
+typedef struct {
+  int generation;        /* generation number (starting from 0) */
+  int nevals;            /* number of individuals evaluated so far */
+  int lambda, n, m;      /* size of the population */
+  const double *x;       /* evaluated population (lambda x n, column-wise) */
+  const double *f;       /* objective function (lambda) */
+  const double *phi;     /* constraints (lambda x m, column-wise) */
+  int nfeasible;         /* number of feasible individuals */
+  double fmin;           /* best feasible objective function (NaN if none) */
+  double fmean;          /* mean feasible objective function (NaN if none) */
+  double deltaDV;        /* sum of the absolute changes of the mutation */
+  double deltaObjFun;    /* change of the mean feasible objective function */
+  const double *xbest;   /* best feasible individual found (NULL if none) */
+  double fbest;          /* objective function of xbest */
+  int gbest;             /* generation where xbest has been found */
+} sres_status;
+
+/*
+ * Monitor called at the end of each generation. Return non-zero to stop.
+ */
+typedef int sres_monitor(const sres_status *status, void *state);
+
+/*
+ * Options of the engine. Use sres_default_options to initialize.
+ */
+typedef struct {
+  int n;               /* number of design variables */
+  int m;               /* number of inequality constraints */
+  int lambda;          /* number of offspring */
+  int mu;              /* number of parents */
+  int maxgen;          /* maximum number of generations */
+  int nretry;          /* number of retries for mutations out of bounds */
+  int nthreads;        /* number of threads used to evaluate the fitness */
+  double pf;           /* probability of comparing by fitness */
+  double varphi;       /* expected rate of convergence */
+  const double *lb;    /* lower bounds (n) */
+  const double *ub;    /* upper bounds (n) */
+  unsigned long seed;  /* seed of the random number generator */
+  const uint32_t *rngstate; /* state of the generator (COSSAN_RNG_STATE_SIZE
+                               words, see cossan_rng.h). Overrides seed */
+} sres_options;
+
+/*
+ * Results of the engine. The statistics are allocated by sres and must be
+ * released with sres_free_results.
+ */
+typedef struct {
+  double *xb;          /* best feasible individual (n) */
+  double fb;           /* objective function of xb */
+  int gm;              /* generation where xb has been found (starting from 1) */
+  int lfeasible;       /* 1 if xb is feasible */
+  int ngen;            /* number of generations performed */
+  int nevals;          /* number of individuals evaluated */
+  double *vmin;        /* best feasible objective function per generation */
+  double *vmean;       /* mean feasible objective function per generation */
+  double *vfeasible;   /* number of feasible individuals per generation */
+} sres_results;
+
+extern void sres_default_options(sres_options *options, int n, int m);
+
+/*
+ * sres : minimize the objective function subject to phi<=0 and lb<=x<=ub
+ *
+ * options  : settings of the engine (see sres_options)
+ * fitness  : batch fitness function (see sres_fitness)
+ * monitor  : monitor called at each generation (can be NULL)
+ * state    : user data passed to fitness and monitor
+ * results  : on output, best individual and statistics
+ *
+ * The function returns a code defined in the sres_result enum.
+ */
+extern int sres(const sres_options *options, sres_fitness *fitness,
+  sres_monitor *monitor, void *state, sres_results *results);
+
+extern void sres_free_results(sres_results *results);
+
+extern const char *sres_rc_string(int rc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SRES_H */
@@ -0,0 +1,277 @@
+/*******************************************************************************
+ * sres_matlab: Stochastic Ranking Evolution Strategy - matlab MEX
+ *
+ * This is the source code of the MEX used to call the native SRES engine
+ * (sres.c) from matlab. It is used by the class StochasticRanking of
+ * OpenCossan in place of the interpreted generation loop of sres.m.
+ *
+ * usage:
+ *   [xb,Stats,Gm,Tstatus] = sres_matlab(objfun,cons,lu,m,lambda,G,mu,pf,varphi)
+ *   [xb,Stats,Gm,Tstatus] = sres_matlab(...,outfun)
+ *   [xb,Stats,Gm,Tstatus] = sres_matlab(...,outfun,seed)
+ * where
+ *   objfun  : handle of the objective function, f = objfun(x) with x a
+ *             lambda x n matrix and f a lambda x 1 vector
+ *   cons    : handle of the constraints, phi = cons(x) with phi a lambda x m
+ *             matrix (phi<=0 feasible)
+ *   lu      : lower and upper bounds (2 x n)
+ *   m       : number of constraints
+ *   lambda  : population size (number of offspring)
+ *   G       : maximum number of generations
+ *   mu      : number of parents
+ *   pf      : pressure on fitness in [0 0.5]
+ *   varphi  : expected rate of convergence
+ *   outfun  : (optional) handle called at each generation as
+ *             Lstop = outfun(Tstatus). Pass [] to skip.
+ *   seed    : (optional) seed or uint32 state of the random number generator
+ *             (see cossan_rng_mex.h). By default the state is drawn from the
+ *             random stream of OpenCossan.
+ *
+ *   xb      : best feasible individual found
+ *   Stats   : [min(f(x)) mean(f(x)) number_feasible(x)] per generation
+ *   Gm      : generation number when xb was found
+ *   Tstatus : structure with the statistics of each generation
+ *
+ * The whole population is passed to objfun and cons at once, so that the
+ * Evaluator can distribute the evaluation of the individuals.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "mex.h"
+#include "sres.h"
+#include "cossan_rng_mex.h"
+
+typedef struct
+{
+    const mxArray *objfun;  /* handle of the objective function */
+    const mxArray *cons;    /* handle of the constraints */
+    const mxArray *outfun;  /* handle of the output function (or NULL) */
+    mxArray *xpop;          /* population passed to the handles */
+    mxArray *error;         /* MException caught in the callbacks */
+    char message[128];      /* wrong size of the values returned */
+} sres_state;
+
+static const char *Cstatus[] = {"Mx", "MobjFun", "Mconstraints", "Vfeasible",
+    "iteration", "deltaDV", "deltaObjFun", "Nevaluations"};
+
+/* 3. Batch evaluation of Objective Function and Constraints */
+static int calcfc(int nrows, int ld, int n, int m, const double *x,
+    double *f, double *phi, void *data)
+{
+    sres_state *state = (sres_state *)data;
+    mxArray *rhs[2], *lhs[1];
+    double *pr;
+    int i, k;
+
+    memcpy(mxGetPr(state->xpop), x, (size_t)ld*n*sizeof(double));
+
+    /* Objective Function Evaluation */
+    rhs[0] = (mxArray *)state->objfun;
+    rhs[1] = state->xpop;
+    state->error = mexCallMATLABWithTrap(1, lhs, 2, rhs, "feval");
+    if (state->error != NULL)
+        return 1;
+    if (mxGetNumberOfElements(lhs[0]) != (size_t)nrows || !mxIsDouble(lhs[0])) {
+        mxDestroyArray(lhs[0]);
+        snprintf(state->message, sizeof(state->message),
+            "The objective function must return a vector of %d doubles", nrows);
+        return 1;
+    }
+    memcpy(f, mxGetPr(lhs[0]), nrows*sizeof(double));
+    mxDestroyArray(lhs[0]);
+
+    /* Constraints Evaluation */
+    if (m > 0) {
+        rhs[0] = (mxArray *)state->cons;
+        state->error = mexCallMATLABWithTrap(1, lhs, 2, rhs, "feval");
+        if (state->error != NULL)
+            return 1;
+        if (mxGetM(lhs[0]) != (size_t)nrows || mxGetN(lhs[0]) != (size_t)m ||
+                !mxIsDouble(lhs[0])) {
+            mxDestroyArray(lhs[0]);
+            snprintf(state->message, sizeof(state->message),
+                "The constraints must return a %d x %d matrix", nrows, m);
+            return 1;
+        }
+        pr = mxGetPr(lhs[0]);
+        for (k=0; k<m; k++)
+            for (i=0; i<nrows; i++)
+                phi[k*ld+i] = pr[k*nrows+i];
+        mxDestroyArray(lhs[0]);
+    }
+    return 0;
+} /* calcfc */
+
+static mxArray *copy_matrix(const double *p, int nrows, int ncols)
+{
+    mxArray *out = mxCreateDoubleMatrix(nrows, ncols, mxREAL);
+    if (nrows*ncols > 0)
+        memcpy(mxGetPr(out), p, (size_t)nrows*ncols*sizeof(double));
+    return out;
+}
+
+/* 4. Export the status of the generation and check the termination */
+static int monitor(const sres_status *st, void *data)
+{
+    sres_state *state = (sres_state *)data;
+    mxArray *rhs[2], *lhs[1], *Tstatus;
+    int lstop;
+
+    if (state->outfun == NULL)
+        return 0;
+
+    Tstatus = mxCreateStructMatrix(1, 1, 8, Cstatus);
+    mxSetField(Tstatus, 0, "Mx", copy_matrix(st->x, st->lambda, st->n));
+    mxSetField(Tstatus, 0, "MobjFun", copy_matrix(st->f, st->lambda, 1));
+    mxSetField(Tstatus, 0, "Mconstraints", copy_matrix(st->phi, st->lambda, st->m));
+    mxSetField(Tstatus, 0, "Vfeasible", mxCreateDoubleScalar((double)st->nfeasible));
+    mxSetField(Tstatus, 0, "iteration", mxCreateDoubleScalar((double)st->generation));
+    mxSetField(Tstatus, 0, "deltaDV", mxCreateDoubleScalar(st->deltaDV));
+    mxSetField(Tstatus, 0, "deltaObjFun", mxCreateDoubleScalar(st->deltaObjFun));
+    mxSetField(Tstatus, 0, "Nevaluations", mxCreateDoubleScalar((double)st->nevals));
+
+    rhs[0] = (mxArray *)state->outfun;
+    rhs[1] = Tstatus;
+    state->error = mexCallMATLABWithTrap(1, lhs, 2, rhs, "feval");
+    mxDestroyArray(Tstatus);
+    if (state->error != NULL)
+        return 1;
+    lstop = mxGetScalar(lhs[0]) != 0.0;
+    mxDestroyArray(lhs[0]);
+    return lstop;
+}
+
+/* 1. Gateway Routine */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    static const char *Cresults[] = {"VminObjFun", "VmeanObjFun", "Vfeasible",
+        "Niterations", "Nevaluations", "Lfeasible", "Sexitflag"};
+    sres_options options;
+    sres_results results;
+    sres_state state;
+    cossan_rng rng;
+    uint32_t rngstate[COSSAN_RNG_STATE_SIZE];
+    double *lu, *lb, *ub, *stats;
+    int n, m, j, g, rc;
+
+    if (nrhs < 9 || nrhs > 11)
+        mexErrMsgTxt("usage: [xb,Stats,Gm,Tstatus] = sres_matlab(objfun,cons,lu,m,lambda,G,mu,pf,varphi,outfun,seed)");
+
+    if (mxGetM(prhs[2]) != 2 || !mxIsDouble(prhs[2]))
+        mexErrMsgIdAndTxt("openCOSSAN:StochasticRanking:sres_matlab",
+            "The bounds must be a 2 x n matrix");
+
+    /* Get the input data */
+    n   = (int)mxGetN(prhs[2]);
+    m   = (int)mxGetScalar(prhs[3]);
+    lu  = mxGetPr(prhs[2]);
+    lb  = (double *)mxCalloc(n, sizeof(double));
+    ub  = (double *)mxCalloc(n, sizeof(double));
+    for (j=0; j<n; j++) {
+        lb[j] = lu[2*j];
+        ub[j] = lu[2*j+1];
+    }
+
+    sres_default_options(&options, n, m);
+    options.lambda = (int)mxGetScalar(prhs[4]);
+    options.maxgen = (int)mxGetScalar(prhs[5]);
+    options.mu     = (int)mxGetScalar(prhs[6]);
+    options.pf     = mxGetScalar(prhs[7]);
+    options.varphi = mxGetScalar(prhs[8]);
+    options.lb     = lb;
+    options.ub     = ub;
+    /* the callbacks into matlab are not thread-safe: the whole population is
+       passed to the Evaluator in one batch */
+    options.nthreads = 1;
+
+    state.objfun = prhs[0];
+    state.cons   = prhs[1];
+    state.outfun = (nrhs > 9 && !mxIsEmpty(prhs[9])) ? prhs[9] : NULL;
+    state.error  = NULL;
+    state.message[0] = '\0';
+
+    /* Seed of the random number generator */
+    cossan_rng_from_mxarray(&rng, nrhs > 10 ? prhs[10] : NULL,
+        "openCOSSAN:StochasticRanking:sres_matlab");
+    cossan_rng_export(&rng, rngstate);
+    options.rngstate = rngstate;
+
+    if (options.lambda < 2 || options.mu < 1 || options.mu > options.lambda)
+        mexErrMsgIdAndTxt("openCOSSAN:StochasticRanking:sres_matlab",
+            "Invalid population size (lambda=%d, mu=%d)", options.lambda, options.mu);
+
+    state.xpop = mxCreateDoubleMatrix(options.lambda, n, mxREAL);
+
+    /* Call SRES */
+    rc = sres(&options, calcfc, monitor, &state, &results);
+
+    mxDestroyArray(state.xpop);
+    mxFree(lb);
+    mxFree(ub);
+
+    if (state.error != NULL) {
+        sres_free_results(&results);
+        mexCallMATLAB(0, NULL, 1, &state.error, "rethrow");
+    }
+    if (state.message[0] != '\0')
+        mexErrMsgIdAndTxt("openCOSSAN:StochasticRanking:sres_matlab",
+            "%s", state.message);
+    if (rc < 0)
+        mexErrMsgIdAndTxt("openCOSSAN:StochasticRanking:sres_matlab",
+            "SRES failed: %s", sres_rc_string(rc));
+
+    if (!results.lfeasible)
+        mexWarnMsgIdAndTxt("openCOSSAN:StochasticRanking:sres_matlab",
+            "solution is infeasible");
+
+    /* Set the output */
+    plhs[0] = copy_matrix(results.xb, 1, n);
+    if (nlhs > 1) {
+        plhs[1] = mxCreateDoubleMatrix(results.ngen, 3, mxREAL);
+        stats = mxGetPr(plhs[1]);
+        for (g=0; g<results.ngen; g++) {
+            stats[g] = results.vmin[g];
+            stats[results.ngen+g] = results.vmean[g];
+            stats[2*results.ngen+g] = results.vfeasible[g];
+        }
+    }
+    if (nlhs > 2)
+        plhs[2] = mxCreateDoubleScalar((double)results.gm);
+    if (nlhs > 3) {
+        plhs[3] = mxCreateStructMatrix(1, 1, 7, Cresults);
+        mxSetField(plhs[3], 0, "VminObjFun", copy_matrix(results.vmin, results.ngen, 1));
+        mxSetField(plhs[3], 0, "VmeanObjFun", copy_matrix(results.vmean, results.ngen, 1));
+        mxSetField(plhs[3], 0, "Vfeasible", copy_matrix(results.vfeasible, results.ngen, 1));
+        mxSetField(plhs[3], 0, "Niterations", mxCreateDoubleScalar((double)results.ngen));
+        mxSetField(plhs[3], 0, "Nevaluations", mxCreateDoubleScalar((double)results.nevals));
+        mxSetField(plhs[3], 0, "Lfeasible", mxCreateLogicalScalar(results.lfeasible != 0));
+        mxSetField(plhs[3], 0, "Sexitflag", mxCreateString(sres_rc_string(rc)));
+    }
+    sres_free_results(&results);
+}
@@ -13,33 +13,20 @@
  * GNU General Public License for more details.
  */
 
+/*
+ * Modified by the Cossan Working Group: the random numbers are generated in
+ * process by cossan_rng (mex/src/Random) instead of calling rand of matlab.
+ *
+ * usage: I = srsort(f,phi,pf)
+ *        [I,state] = srsort(f,phi,pf,state)
+ * where state initializes the random number generator (see cossan_rng_mex.h)
+ * and the output state can be used to continue the sequence.
+ */
+
 #include "mex.h"
+#include "cossan_rng_mex.h"
 #define MAX(A,B) ((A) > (B) ? (A):(B))
 
-#ifdef __STDC__
-void Randomize (double *D, int N)
-#else
-void Randomize (D, N)
-double *D ;
-int N ;
-#endif
-{
-  mxArray *nRand, *Rand[1] ;
-  double  *nRandPtr, *RandPtr ;
-  int i ;
-
-  nRand = mxCreateDoubleMatrix(1,2,mxREAL) ;
-  nRandPtr = mxGetPr(nRand) ;
-  nRandPtr[0] = 1 ;
-  nRandPtr[1] = (double)N ;
-  mexCallMATLAB(1,Rand,1,&nRand,"rand") ;
-  RandPtr = mxGetPr(Rand[0]) ;
-  for (i=0;i<N;i++)
-    D[i] = RandPtr[i] ;
-  mxDestroyArray(nRand) ;
-  mxDestroyArray(Rand[0]) ;
-}
-
 #ifdef __STDC__
 void mexFunction(int nlhs, mxArray *plhs[],int nrhs, const mxArray *prhs[])
 #else
@@ -53,10 +40,11 @@ const mxArray *prhs[] ;
   double *P, *f, *phi ;  
   int i, j ;
   double pf, *I, Is, *G ;
+  cossan_rng rng ;
 
   /* check input arguments */
-  if (nrhs != 3)
-    mexErrMsgTxt("usage: I = srsort(f,phi,pf) ;") ;
+  if (nrhs < 3 || nrhs > 4 || nlhs > 2)
+    mexErrMsgTxt("usage: [I,state] = srsort(f,phi,pf,state) ;") ;
 
   /* get pointers to input */
   n = mxGetM(prhs[0]) ;
@@ -64,6 +52,7 @@ const mxArray *prhs[] ;
   phi = mxGetPr(prhs[1]) ;
   P = mxGetPr(prhs[2]) ;
   pf = P[0] ;
+  cossan_rng_from_mxarray(&rng, nrhs>3 ? prhs[3] : NULL, "openCOSSAN:srsort") ;
 
   /* initialize index */
   plhs[0] = mxCreateDoubleMatrix(n,1,mxREAL) ;
@@ -72,13 +61,13 @@ const mxArray *prhs[] ;
     I[i-1] =(double)i ;
 
   /* allocate random vector */
-  if ((G = (double *) mxCalloc(n-1,sizeof(double))) == NULL)
+  if ((G = (double *) mxCalloc(n > 1 ? n-1 : 1,sizeof(double))) == NULL)
     mexErrMsgTxt("fault: memory allocation error in mxCalloc") ;
 
   /* perform stochastic bubble sort */
   for (i=0;i<n;i++) {
     Is = 0 ;
-    Randomize(G,n-1) ;
+    cossan_rng_fill_uniform(&rng,G,n-1) ;
     for (j=0;j<(n-1);j++) {
       if (((phi[(int)I[j]-1]==phi[(int)I[j+1]-1]) && (phi[(int)I[j]-1]==0)) || (G[j]<pf) ) {
         if (f[(int)I[j]-1]>f[(int)I[j+1]-1]) {
@@ -99,4 +88,6 @@ const mxArray *prhs[] ;
       break ;
   }
   mxFree(G) ;
+  if (nlhs > 1)
+    plhs[1] = cossan_rng_to_mxarray(&rng) ;
 }
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * srsortx: Stochastic Ranking Procedure - matlab MEX
+ *
+ * Drop-in replacement of srsort. The random numbers are generated in process
+ * (see cossan_rng.h) and the ranking is performed by srank.c.
+ *
+ * usage:
+ *   I = srsortx(f,phi,pf)
+ *   I = srsortx(f,phi,pf,seed)
+ * where
+ *   f       : objective function (lambda x 1)
+ *   phi     : penalty (lambda x 1), zero for feasible individuals
+ *   pf      : probability of comparing by objective function
+ *   seed    : seed or uint32 state of the random number generator (see
+ *             cossan_rng_mex.h). By default the state is drawn from the
+ *             random stream of OpenCossan.
+ *
+ *   I       : ranked indices (1-based, lambda x 1)
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include "mex.h"
+#include "srank.h"
+#include "cossan_rng_mex.h"
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    int n, i;
+    int *I;
+    double *f, *phi, *Iout, pf;
+    void *work;
+    cossan_rng rng;
+
+    /* check input arguments */
+    if (nlhs > 1 || nrhs < 3 || nrhs > 4)
+        mexErrMsgTxt("usage: I = srsortx(f,phi,pf,seed) ;");
+
+    n   = (int)mxGetNumberOfElements(prhs[0]);
+    f   = mxGetPr(prhs[0]);
+    phi = mxGetPr(prhs[1]);
+    pf  = mxGetScalar(prhs[2]);
+    if ((int)mxGetNumberOfElements(prhs[1]) != n)
+        mexErrMsgIdAndTxt("openCOSSAN:srsortx",
+            "f and phi must have the same number of elements");
+
+    cossan_rng_from_mxarray(&rng, nrhs > 3 ? prhs[3] : NULL, "openCOSSAN:srsortx");
+
+    I    = (int *)mxCalloc(n > 0 ? n : 1, sizeof(int));
+    work = mxCalloc(1, SRANK_WORK(n > 0 ? n : 1));
+
+    /* perform stochastic ranking */
+    srank(n, f, phi, pf, I, work, cossan_rng_uniforms, &rng);
+
+    plhs[0] = mxCreateDoubleMatrix(n, 1, mxREAL);
+    Iout = mxGetPr(plhs[0]);
+    for (i=0; i<n; i++)
+        Iout[i] = (double)(I[i]+1);
+
+    mxFree(I);
+    mxFree(work);
+}
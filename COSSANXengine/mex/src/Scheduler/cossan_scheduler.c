@@ -0,0 +1,717 @@
+/*******************************************************************************
+ * cossan_scheduler.c: local job scheduler of the JobManager
+ *
+ * See cossan_scheduler.h. The queues are protected by their own mutex;
+ * the resources, the table of the jobs and the states are protected by the
+ * mutex of the scheduler, always acquired after the mutex of a queue. The
+ * executors sleep on a condition variable and are woken up by a counter
+ * that changes at each submission and at each end of a job.
+ *
+ * The processes are created with posix_spawn and polled with
+ * waitpid(WNOHANG) on their own pids, as in cossan_pool.c.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include "cossan_scheduler.h"
+#include "cossan_pool.h"
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+extern char **environ;
+
+#define CSCH_POLL_MIN 0.0005  /* polling interval of the running job [s] */
+#define CSCH_POLL_MAX 0.02
+#define CSCH_MAX_SKIP 8       /* times a job can be overtaken by smaller ones */
+
+typedef struct {
+  long id;
+  char *command, *folder, *logfile;
+  int cores;
+  double memory, timeout;
+  int state, status;
+  int deleted;         /* csch_delete called while running */
+  int skipped;         /* times the job has been overtaken */
+  pid_t pid;
+  int executor;
+  double submitted, start, end;
+} csch_job;
+
+/* queue of an executor (circular buffer) */
+typedef struct {
+  pthread_mutex_t lock;
+  csch_job **jobs;
+  int head, count, capacity;
+} csch_queue;
+
+struct csch_scheduler {
+  csch_options options;
+  char *shell;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  unsigned long generation;
+  int stopping;
+  int freecores, npending, nrunning;
+  double freememory;
+  csch_job **table;    /* the job with identifier id is table[id-1] */
+  long njobs, capacity;
+  csch_job *blocked;   /* starved job that must start before the others */
+  int nexecutors, nstarted, next;
+  pthread_t *threads;
+  csch_queue *queues;
+};
+
+typedef struct {
+  csch_scheduler *s;
+  int executor;
+} csch_executor_args;
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9*(double)ts.tv_nsec;
+}
+
+static void sleep_for(double t)
+{
+  struct timespec ts;
+  ts.tv_sec = (time_t)t;
+  ts.tv_nsec = (long)((t - (double)ts.tv_sec)*1e9);
+  while (nanosleep(&ts, &ts) == -1 && errno == EINTR) ;
+}
+
+static void set_message(char *message, size_t lmessage, const char *fmt, ...)
+{
+  va_list ap;
+  if (message == NULL || lmessage == 0) return;
+  va_start(ap, fmt);
+  vsnprintf(message, lmessage, fmt, ap);
+  va_end(ap);
+}
+
+static char *copy_string(const char *s)
+{
+  char *c;
+  if (s == NULL) return NULL;
+  if ((c = (char *)malloc(strlen(s) + 1)) != NULL) strcpy(c, s);
+  return c;
+}
+
+static void free_job(csch_job *job)
+{
+  if (job == NULL) return;
+  free(job->command);
+  free(job->folder);
+  free(job->logfile);
+  free(job);
+}
+
+void csch_default_options(csch_options *options)
+{
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  long pages = sysconf(_SC_PHYS_PAGES), pagesize = sysconf(_SC_PAGESIZE);
+  options->ncores = n > 0 ? (int)n : 1;
+  options->memory = pages > 0 && pagesize > 0 ?
+    (double)pages*(double)pagesize/1048576.0 : 0;
+  options->killgrace = 5;
+  options->shell = "/bin/sh";
+}
+
+/*
+ * Queues
+ */
+static int queue_push(csch_queue *q, csch_job *job)
+{
+  pthread_mutex_lock(&q->lock);
+  if (q->count == q->capacity) {
+    int k, capacity = q->capacity ? 2*q->capacity : 16;
+    csch_job **jobs = (csch_job **)malloc(capacity*sizeof(csch_job *));
+    if (jobs == NULL) {
+      pthread_mutex_unlock(&q->lock);
+      return -1;
+    }
+    for (k=0; k<q->count; k++)
+      jobs[k] = q->jobs[(q->head + k) % q->capacity];
+    free(q->jobs);
+    q->jobs = jobs;
+    q->head = 0;
+    q->capacity = capacity;
+  }
+  q->jobs[(q->head + q->count) % q->capacity] = job;
+  q->count++;
+  pthread_mutex_unlock(&q->lock);
+  return 0;
+}
+
+/* remove the k-th job of the queue (0: oldest) */
+static void queue_remove(csch_queue *q, int k)
+{
+  int i;
+  if (k == 0) {
+    q->head = (q->head + 1) % q->capacity;
+  } else {
+    for (i=k; i<q->count-1; i++)
+      q->jobs[(q->head + i) % q->capacity] = q->jobs[(q->head + i + 1) % q->capacity];
+  }
+  q->count--;
+}
+
+/* reserve the resources and mark the job as running (scheduler locked) */
+static void start_job(csch_scheduler *s, csch_job *job, int executor)
+{
+  job->state = CSCH_RUNNING;
+  job->executor = executor;
+  job->start = now();
+  s->freecores -= job->cores;
+  s->freememory -= job->memory;
+  s->npending--;
+  s->nrunning++;
+  if (s->blocked == job) s->blocked = NULL;
+}
+
+static int fits(const csch_scheduler *s, const csch_job *job)
+{
+  return job->cores <= s->freecores &&
+    (job->memory <= 0 || job->memory <= s->freememory);
+}
+
+/*
+ * Take a job from the queue q. The owner scans from the oldest job, a
+ * thief from the newest. The jobs deleted while pending are dropped.
+ */
+static csch_job *queue_take(csch_scheduler *s, csch_queue *q, int executor,
+  int steal)
+{
+  csch_job *job, *taken = NULL;
+  int i, k;
+
+  pthread_mutex_lock(&q->lock);
+  pthread_mutex_lock(&s->lock);
+  for (i=0; i<q->count && taken == NULL; ) {
+    k = steal ? q->count - 1 - i : i;
+    job = q->jobs[(q->head + k) % q->capacity];
+    if (job->state != CSCH_PENDING) {
+      /* deleted: the job is owned by the table */
+      queue_remove(q, k);
+      continue;
+    }
+    if ((s->blocked == NULL || s->blocked == job) && fits(s, job)) {
+      queue_remove(q, k);
+      start_job(s, job, executor);
+      taken = job;
+    } else
+      i++;
+  }
+  /* the jobs older than the one taken have been overtaken */
+  if (taken != NULL && !steal) {
+    for (k=0; k<i; k++) {
+      job = q->jobs[(q->head + k) % q->capacity];
+      if (++job->skipped > CSCH_MAX_SKIP && s->blocked == NULL)
+        s->blocked = job;
+    }
+  }
+  pthread_mutex_unlock(&s->lock);
+  pthread_mutex_unlock(&q->lock);
+  return taken;
+}
+
+static pid_t spawn(const csch_scheduler *s, const csch_job *job)
+{
+  posix_spawn_file_actions_t actions;
+  posix_spawnattr_t attr;
+  sigset_t sigdefault;
+  char *command, *script, *log = NULL;
+  char *argv[4];
+  size_t n;
+  pid_t pid;
+  int rc;
+
+  /* variables of the batch systems */
+  n = strlen(job->command) + 96;
+  if ((command = (char *)malloc(n)) == NULL) return -1;
+  snprintf(command, n, "JOB_ID=%ld NSLOTS=%d; export JOB_ID NSLOTS; %s",
+    job->id, job->cores, job->command);
+  script = cossan_pool_shell_command(job->folder, command);
+  free(command);
+  if (script == NULL) return -1;
+  if (job->logfile != NULL) {
+    n = (job->folder ? strlen(job->folder) : 0) + strlen(job->logfile) + 2;
+    if ((log = (char *)malloc(n)) == NULL) { free(script); return -1; }
+    if (job->folder != NULL && *job->folder && job->logfile[0] != '/')
+      snprintf(log, n, "%s/%s", job->folder, job->logfile);
+    else
+      snprintf(log, n, "%s", job->logfile);
+  }
+
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+  posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO,
+    log != NULL ? log : "/dev/null", O_WRONLY|O_CREAT|O_TRUNC, 0644);
+  posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+
+  /* new process group (killed as a whole) and default signal handlers */
+  posix_spawnattr_init(&attr);
+  sigfillset(&sigdefault);
+  sigdelset(&sigdefault, SIGKILL);
+  sigdelset(&sigdefault, SIGSTOP);
+  posix_spawnattr_setsigdefault(&attr, &sigdefault);
+  posix_spawnattr_setpgroup(&attr, 0);
+  posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGDEF);
+
+  argv[0] = s->shell;
+  argv[1] = (char *)"-c";
+  argv[2] = script;
+  argv[3] = NULL;
+  rc = posix_spawn(&pid, s->shell, &actions, &attr, argv, environ);
+
+  posix_spawn_file_actions_destroy(&actions);
+  posix_spawnattr_destroy(&attr);
+  free(script);
+  free(log);
+  return rc == 0 ? pid : -1;
+}
+
+static int job_status(int wstatus)
+{
+  if (WIFEXITED(wstatus)) return WEXITSTATUS(wstatus);
+  if (WIFSIGNALED(wstatus)) return 128 + WTERMSIG(wstatus);
+  return 255;
+}
+
+/* execute the job and wait for its end, killing it when requested */
+static void run_job(csch_scheduler *s, csch_job *job)
+{
+  double poll = CSCH_POLL_MIN, t, killtime = 0;
+  int wstatus = 0, timedout = 0, stop;
+  pid_t pid, rc;
+
+  pid = spawn(s, job);
+  pthread_mutex_lock(&s->lock);
+  if (pid > 0) {
+    job->pid = pid;
+    /* deleted between the start and the spawn */
+    if (job->deleted) kill(-pid, SIGTERM);
+  }
+  pthread_mutex_unlock(&s->lock);
+
+  while (pid > 0) {
+    rc = waitpid(pid, &wstatus, WNOHANG);
+    if (rc == pid || (rc < 0 && errno != EINTR)) break;
+    sleep_for(poll);
+    poll = poll*2 < CSCH_POLL_MAX ? poll*2 : CSCH_POLL_MAX;
+    t = now();
+    pthread_mutex_lock(&s->lock);
+    stop = job->deleted || s->stopping;
+    pthread_mutex_unlock(&s->lock);
+    if (!stop && job->timeout > 0 && t - job->start > job->timeout) {
+      timedout = 1;
+      stop = 1;
+    }
+    if (stop && killtime == 0) {
+      kill(-pid, SIGTERM);
+      killtime = t + s->options.killgrace;
+    } else if (stop && t >= killtime) {
+      kill(-pid, SIGKILL);
+    }
+  }
+  /* remaining processes of the group */
+  if (pid > 0 && killtime > 0) kill(-pid, SIGKILL);
+
+  pthread_mutex_lock(&s->lock);
+  job->end = now();
+  job->pid = 0;
+  if (pid <= 0) {
+    job->state = CSCH_NOSTART;
+    job->status = 127;
+  } else {
+    job->status = job_status(wstatus);
+    job->state = job->deleted || s->stopping ? CSCH_KILLED :
+      timedout ? CSCH_TIMEOUT : CSCH_COMPLETED;
+  }
+  s->freecores += job->cores;
+  s->freememory += job->memory;
+  s->nrunning--;
+  s->generation++;
+  pthread_cond_broadcast(&s->wake);
+  pthread_mutex_unlock(&s->lock);
+}
+
+static void *executor(void *args)
+{
+  csch_scheduler *s = ((csch_executor_args *)args)->s;
+  int e = ((csch_executor_args *)args)->executor, k;
+  unsigned long generation;
+  csch_job *job;
+
+  free(args);
+  for (;;) {
+    pthread_mutex_lock(&s->lock);
+    generation = s->generation;
+    if (s->stopping) {
+      pthread_mutex_unlock(&s->lock);
+      break;
+    }
+    pthread_mutex_unlock(&s->lock);
+
+    /* own queue first, then steal from the others */
+    job = queue_take(s, &s->queues[e], e, 0);
+    for (k=1; job == NULL && k<s->nexecutors; k++)
+      job = queue_take(s, &s->queues[(e + k) % s->nexecutors], e, 1);
+    if (job != NULL) {
+      run_job(s, job);
+      continue;
+    }
+
+    /* nothing to run: wait for a new job or for free resources */
+    pthread_mutex_lock(&s->lock);
+    while (generation == s->generation && !s->stopping)
+      pthread_cond_wait(&s->wake, &s->lock);
+    pthread_mutex_unlock(&s->lock);
+  }
+  return NULL;
+}
+
+csch_scheduler *csch_start(const csch_options *options, char *message,
+  size_t lmessage)
+{
+  csch_scheduler *s;
+  csch_executor_args *args;
+  int k;
+
+  if (options->ncores < 1 || options->killgrace < 0 || options->shell == NULL) {
+    set_message(message, lmessage, "Invalid options of the scheduler");
+    return NULL;
+  }
+  if ((s = (csch_scheduler *)calloc(1, sizeof(csch_scheduler))) == NULL) {
+    set_message(message, lmessage, "Out of memory");
+    return NULL;
+  }
+  s->options = *options;
+  s->shell = copy_string(options->shell);
+  s->options.shell = s->shell;
+  s->freecores = options->ncores;
+  s->freememory = options->memory;
+  s->nexecutors = options->ncores;
+  s->threads = (pthread_t *)calloc(s->nexecutors, sizeof(pthread_t));
+  s->queues = (csch_queue *)calloc(s->nexecutors, sizeof(csch_queue));
+  if (s->shell == NULL || s->threads == NULL || s->queues == NULL) {
+    free(s->shell);
+    free(s->threads);
+    free(s->queues);
+    free(s);
+    set_message(message, lmessage, "Out of memory");
+    return NULL;
+  }
+  pthread_mutex_init(&s->lock, NULL);
+  pthread_cond_init(&s->wake, NULL);
+  for (k=0; k<s->nexecutors; k++)
+    pthread_mutex_init(&s->queues[k].lock, NULL);
+
+  for (k=0; k<s->nexecutors; k++) {
+    if ((args = (csch_executor_args *)malloc(sizeof(csch_executor_args))) == NULL)
+      break;
+    args->s = s;
+    args->executor = k;
+    if (pthread_create(&s->threads[k], NULL, executor, args) != 0) {
+      free(args);
+      break;
+    }
+  }
+  s->nstarted = k;
+  if (k < s->nexecutors) {
+    set_message(message, lmessage, "Cannot start the executors of the scheduler");
+    csch_stop(s);
+    return NULL;
+  }
+  return s;
+}
+
+long csch_submit(csch_scheduler *s, const char *command,
+  const char *folder, const char *logfile, int cores, double memory,
+  double timeout)
+{
+  csch_job *job;
+  long id;
+  int q;
+
+  if (command == NULL || cores < 1) return CSCH_INVALID;
+  if (cores > s->options.ncores ||
+      (memory > 0 && s->options.memory > 0 && memory > s->options.memory))
+    return CSCH_NO_RESOURCES;
+  if ((job = (csch_job *)calloc(1, sizeof(csch_job))) == NULL)
+    return CSCH_OUT_OF_MEMORY;
+  job->command = copy_string(command);
+  job->folder = copy_string(folder);
+  job->logfile = copy_string(logfile);
+  if (job->command == NULL || (folder && !job->folder) || (logfile && !job->logfile)) {
+    free_job(job);
+    return CSCH_OUT_OF_MEMORY;
+  }
+  job->cores = cores;
+  /* the memory is not checked if the scheduler has no limit */
+  job->memory = memory > 0 && s->options.memory > 0 ? memory : 0;
+  job->timeout = timeout;
+  job->state = CSCH_PENDING;
+  job->executor = -1;
+  job->submitted = now();
+
+  pthread_mutex_lock(&s->lock);
+  if (s->njobs == s->capacity) {
+    long capacity = s->capacity ? 2*s->capacity : 64;
+    csch_job **table = (csch_job **)realloc(s->table, capacity*sizeof(csch_job *));
+    if (table == NULL) {
+      pthread_mutex_unlock(&s->lock);
+      free_job(job);
+      return CSCH_OUT_OF_MEMORY;
+    }
+    s->table = table;
+    s->capacity = capacity;
+  }
+  s->table[s->njobs++] = job;
+  id = job->id = s->njobs;
+  s->npending++;
+  q = s->next;
+  s->next = (s->next + 1) % s->nexecutors;
+  pthread_mutex_unlock(&s->lock);
+
+  /* the job enters the queue of the next executor */
+  if (queue_push(&s->queues[q], job) != 0) {
+    pthread_mutex_lock(&s->lock);
+    job->state = CSCH_NOSTART;
+    job->status = 127;
+    s->npending--;
+    pthread_mutex_unlock(&s->lock);
+    return CSCH_OUT_OF_MEMORY;
+  }
+
+  pthread_mutex_lock(&s->lock);
+  s->generation++;
+  pthread_cond_broadcast(&s->wake);
+  pthread_mutex_unlock(&s->lock);
+  return id;
+}
+
+int csch_status(csch_scheduler *s, long id, csch_job_info *info)
+{
+  csch_job *job;
+  double t = now();
+
+  pthread_mutex_lock(&s->lock);
+  if (id < 1 || id > s->njobs) {
+    pthread_mutex_unlock(&s->lock);
+    return CSCH_NO_JOB;
+  }
+  job = s->table[id-1];
+  info->state = job->state;
+  info->status = job->status;
+  info->cores = job->cores;
+  info->memory = job->memory;
+  info->executor = job->executor;
+  info->queued = (job->executor >= 0 ? job->start :
+    job->state == CSCH_PENDING ? t : job->end) - job->submitted;
+  info->elapsed = job->executor < 0 ? 0 :
+    (job->state == CSCH_RUNNING ? t : job->end) - job->start;
+  pthread_mutex_unlock(&s->lock);
+  return CSCH_SUCCESS;
+}
+
+int csch_delete(csch_scheduler *s, long id)
+{
+  csch_job *job;
+
+  pthread_mutex_lock(&s->lock);
+  if (id < 1 || id > s->njobs) {
+    pthread_mutex_unlock(&s->lock);
+    return CSCH_NO_JOB;
+  }
+  job = s->table[id-1];
+  if (job->state == CSCH_PENDING) {
+    /* removed from its queue by the next executor that scans it */
+    job->state = CSCH_KILLED;
+    job->end = now();
+    s->npending--;
+    if (s->blocked == job) {
+      s->blocked = NULL;
+      s->generation++;
+      pthread_cond_broadcast(&s->wake);
+    }
+  } else if (job->state == CSCH_RUNNING && !job->deleted) {
+    job->deleted = 1;
+    if (job->pid > 0) kill(-job->pid, SIGTERM);
+  }
+  pthread_mutex_unlock(&s->lock);
+  return CSCH_SUCCESS;
+}
+
+long csch_active_jobs(csch_scheduler *s, long **ids)
+{
+  long k, n = 0;
+
+  pthread_mutex_lock(&s->lock);
+  *ids = (long *)malloc((s->npending + s->nrunning + 1)*sizeof(long));
+  if (*ids == NULL) {
+    pthread_mutex_unlock(&s->lock);
+    return CSCH_OUT_OF_MEMORY;
+  }
+  for (k=0; k<s->njobs; k++)
+    if (s->table[k]->state == CSCH_PENDING || s->table[k]->state == CSCH_RUNNING)
+      (*ids)[n++] = s->table[k]->id;
+  pthread_mutex_unlock(&s->lock);
+  return n;
+}
+
+void csch_usage(csch_scheduler *s, int *freecores, double *freememory,
+  int *npending, int *nrunning)
+{
+  pthread_mutex_lock(&s->lock);
+  *freecores = s->freecores;
+  *freememory = s->freememory;
+  *npending = s->npending;
+  *nrunning = s->nrunning;
+  pthread_mutex_unlock(&s->lock);
+}
+
+void csch_stop(csch_scheduler *s)
+{
+  long k;
+
+  if (s == NULL) return;
+  pthread_mutex_lock(&s->lock);
+  s->stopping = 1;
+  for (k=0; k<s->njobs; k++)
+    if (s->table[k]->state == CSCH_PENDING) {
+      s->table[k]->state = CSCH_KILLED;
+      s->npending--;
+    }
+  pthread_cond_broadcast(&s->wake);
+  pthread_mutex_unlock(&s->lock);
+
+  /* the executors kill their running jobs */
+  for (k=0; k<s->nstarted; k++)
+    pthread_join(s->threads[k], NULL);
+
+  for (k=0; k<s->nexecutors; k++) {
+    free(s->queues[k].jobs);
+    pthread_mutex_destroy(&s->queues[k].lock);
+  }
+  for (k=0; k<s->njobs; k++)
+    free_job(s->table[k]);
+  pthread_cond_destroy(&s->wake);
+  pthread_mutex_destroy(&s->lock);
+  free(s->table);
+  free(s->queues);
+  free(s->threads);
+  free(s->shell);
+  free(s);
+}
+
+#else /* _WIN32 */
+
+void csch_default_options(csch_options *options)
+{
+  options->ncores = 1;
+  options->memory = 0;
+  options->killgrace = 5;
+  options->shell = NULL;
+}
+
+csch_scheduler *csch_start(const csch_options *options, char *message,
+  size_t lmessage)
+{
+  (void)options;
+  if (message != NULL && lmessage > 0)
+    snprintf(message, lmessage, "The local scheduler is not available on Windows");
+  return NULL;
+}
+
+long csch_submit(csch_scheduler *s, const char *command,
+  const char *folder, const char *logfile, int cores, double memory,
+  double timeout)
+{
+  (void)s; (void)command; (void)folder; (void)logfile; (void)cores;
+  (void)memory; (void)timeout;
+  return CSCH_INVALID;
+}
+
+int csch_status(csch_scheduler *s, long id, csch_job_info *info)
+{
+  (void)s; (void)id; (void)info;
+  return CSCH_INVALID;
+}
+
+int csch_delete(csch_scheduler *s, long id)
+{
+  (void)s; (void)id;
+  return CSCH_INVALID;
+}
+
+long csch_active_jobs(csch_scheduler *s, long **ids)
+{
+  (void)s;
+  *ids = NULL;
+  return CSCH_INVALID;
+}
+
+void csch_usage(csch_scheduler *s, int *freecores, double *freememory,
+  int *npending, int *nrunning)
+{
+  (void)s;
+  *freecores = *npending = *nrunning = 0;
+  *freememory = 0;
+}
+
+void csch_stop(csch_scheduler *s)
+{
+  (void)s;
+}
+
+#endif
+
+const char *csch_state_string(int state)
+{
+  switch (state) {
+  case CSCH_PENDING:   return "pending";
+  case CSCH_RUNNING:   return "running";
+  case CSCH_COMPLETED: return "completed";
+  case CSCH_KILLED:    return "killed";
+  case CSCH_TIMEOUT:   return "timeout";
+  case CSCH_NOSTART:   return "nostart";
+  default:             return "unknown";
+  }
+}
@@ -0,0 +1,139 @@
+/*******************************************************************************
+ * cossan_scheduler.h: local job scheduler of the JobManager
+ *
+ * Batch system for a single machine, used by the JobManagerInterface of
+ * type 'local' when no cluster is available. The jobs (the scripts of the
+ * JobManager, each evaluating one sample or a chunk of samples) are
+ * executed by one executor thread per core. Every executor owns a queue
+ * of jobs: the submitted jobs are distributed over the queues, an executor
+ * takes the oldest job of its own queue that fits the free resources and,
+ * when its queue has no suitable job, it steals the newest job of the
+ * other queues.
+ *
+ * A job requests a number of cores and an amount of memory and starts
+ * only when both are available. A job that has been overtaken too many
+ * times by smaller jobs blocks the start of the other jobs until it fits,
+ * so that large jobs are not starved.
+ *
+ * Like a batch system, the job is executed in a new process group with the
+ * variables JOB_ID and NSLOTS (number of cores) in its environment. The
+ * status of the jobs is kept in memory and queried with csch_status.
+ *
+ * The scheduler is available on POSIX systems only.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+#ifndef _COSSAN_SCHEDULER_H
+#define _COSSAN_SCHEDULER_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Possible return values of the functions
+ */
+typedef enum {
+  CSCH_NO_JOB        = -4, /* unknown job identifier */
+  CSCH_NO_RESOURCES  = -3, /* the job requests more than the machine */
+  CSCH_OUT_OF_MEMORY = -2, /* memory allocation failed */
+  CSCH_INVALID       = -1, /* inconsistent options or unsupported system */
+  CSCH_SUCCESS       =  0
+} csch_result;
+
+/*
+ * States of a job
+ */
+typedef enum {
+  CSCH_PENDING   = 0, /* waiting for the resources */
+  CSCH_RUNNING   = 1,
+  CSCH_COMPLETED = 2, /* terminated, see the exit status */
+  CSCH_KILLED    = 3, /* deleted by csch_delete or csch_stop */
+  CSCH_TIMEOUT   = 4, /* killed after its time limit */
+  CSCH_NOSTART   = 5  /* the process could not be started */
+} csch_state;
+
+typedef struct {
+  int state;           /* csch_state */
+  int status;          /* exit code of the shell (128+signal if killed by a
+                          signal) */
+  int cores;           /* requested resources */
+  double memory;
+  int executor;        /* executor that runs the job (-1: not started) */
+  double queued;       /* time spent in the queue [s] */
+  double elapsed;      /* wall clock time of the job [s] */
+} csch_job_info;
+
+typedef struct {
+  int ncores;          /* cores of the machine (executors) */
+  double memory;       /* memory available to the jobs [MB] */
+  double killgrace;    /* time between SIGTERM and SIGKILL [s] */
+  const char *shell;   /* shell used to execute the commands (/bin/sh) */
+} csch_options;
+
+typedef struct csch_scheduler csch_scheduler;
+
+/* number of online processors and physical memory of the machine */
+extern void csch_default_options(csch_options *options);
+
+/* start the executors. Returns NULL on error (message in message) */
+extern csch_scheduler *csch_start(const csch_options *options, char *message,
+  size_t lmessage);
+
+/*
+ * Queue the command, executed by the shell in folder (NULL: current
+ * folder) with stdout and stderr in logfile (relative to folder, NULL:
+ * /dev/null). memory [MB] and timeout [s] are not checked if <= 0.
+ * Returns the identifier of the job (>0) or one of the csch_result codes.
+ */
+extern long csch_submit(csch_scheduler *s, const char *command,
+  const char *folder, const char *logfile, int cores, double memory,
+  double timeout);
+
+extern int csch_status(csch_scheduler *s, long id, csch_job_info *info);
+
+/* remove a pending job or kill a running one */
+extern int csch_delete(csch_scheduler *s, long id);
+
+/* identifiers of the pending and running jobs (allocated with malloc) */
+extern long csch_active_jobs(csch_scheduler *s, long **ids);
+
+extern void csch_usage(csch_scheduler *s, int *freecores, double *freememory,
+  int *npending, int *nrunning);
+
+/* kill the running jobs, discard the pending ones and stop the executors */
+extern void csch_stop(csch_scheduler *s);
+
+extern const char *csch_state_string(int state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_SCHEDULER_H */
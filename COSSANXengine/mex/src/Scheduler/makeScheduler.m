@@ -0,0 +1,29 @@
+% Script to generate the mex file of the local job scheduler of the
+% JobManager (JobManagerInterface of type 'local').
+% The jobs are executed by one thread per core with work stealing (see
+% cossan_scheduler.c). Available on POSIX systems only.
+
+disp('Compiling the scheduler mex files ..');
+
+assert(~isempty(OpenCossan.getCossanRoot),'openCOSSAN:makeScheduler','Please initialize OpenCossan')
+
+% mex of the scheduler (JobManager.submitJob)
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" -I../ProcessPool schedulerx.c cossan_scheduler.c ../ProcessPool/cossan_pool.c
+
+% List of created mex files
+r=dir('*.mex*');
+
+Spath=fullfile(OpenCossan.getCossanRoot,'mex','bin');
+
+
+for n=1:length(r)
+    % Move the compiled file in the appropriate folder
+    [status,message,messageid]=movefile(r(n).name,Spath,'f');
+    
+    if status
+        disp(['MEX FILE ' r(n).name ' created and moved in ' Spath ]);
+    else
+        disp(message);
+        disp(messageid);
+    end
+end
@@ -0,0 +1,212 @@
+/*******************************************************************************
+ * schedulerx: local job scheduler of the JobManager - matlab MEX
+ *
+ * Batch system of the JobManagerInterface of type 'local' (see
+ * cossan_scheduler.h). The scheduler runs in the MATLAB process: it is
+ * started at the first submission with all the cores and the memory of the
+ * machine, or explicitly with 'start', and it is stopped (running jobs
+ * killed) by 'clear' or when the mex file is cleared.
+ *
+ * usage:
+ *   schedulerx('start',Ncores,Nmemory)
+ *   Nid = schedulerx('submit',Scommand,Sfolder,Slogfile,Ncores,Nmemory,Ntimeout)
+ *   [CSstate,Vstatus,Vid] = schedulerx('status',Vid)
+ *   schedulerx('delete',Vid)
+ *   [Ncores,Nmemory,NfreeCores,NfreeMemory,Npending,Nrunning] = schedulerx('info')
+ *   schedulerx('clear')
+ * where
+ *   Ncores   : cores of the machine or of the job
+ *   Nmemory  : memory of the machine or of the job [MB] (0: not checked)
+ *   Ntimeout : time limit of the job [s] (0: none)
+ *   Slogfile : file of the folder with stdout and stderr of the job
+ *   Vid      : identifiers of the jobs (default for 'status': the pending
+ *              and running jobs)
+ *   CSstate  : pending, running, completed, killed, timeout, nostart or
+ *              unknown
+ *   Vstatus  : exit status of the completed jobs
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+#include "cossan_scheduler.h"
+
+#define LMESSAGE 512
+
+static csch_scheduler *scheduler = NULL;
+static csch_options options;
+
+static void clear_scheduler(void)
+{
+    csch_stop(scheduler);
+    scheduler = NULL;
+}
+
+static void start_scheduler(const csch_options *opt)
+{
+    char message[LMESSAGE];
+    options = *opt;
+    if ((scheduler = csch_start(&options, message, LMESSAGE)) == NULL)
+        mexErrMsgIdAndTxt("openCOSSAN:schedulerx:startError", "%s", message);
+}
+
+static double get_scalar(int nrhs, const mxArray *prhs[], int k, double value)
+{
+    if (nrhs <= k || mxIsEmpty(prhs[k]))
+        return value;
+    if (!(mxIsNumeric(prhs[k]) || mxIsLogical(prhs[k])) || mxGetNumberOfElements(prhs[k]) != 1)
+        mexErrMsgIdAndTxt("openCOSSAN:schedulerx", "Argument %d must be a scalar", k+1);
+    return mxGetScalar(prhs[k]);
+}
+
+static char *get_string(int nrhs, const mxArray *prhs[], int k)
+{
+    if (nrhs <= k || mxIsEmpty(prhs[k]))
+        return NULL;
+    if (!mxIsChar(prhs[k]))
+        mexErrMsgIdAndTxt("openCOSSAN:schedulerx", "Argument %d must be a string", k+1);
+    return mxArrayToString(prhs[k]);
+}
+
+static void check_rc(int rc)
+{
+    switch (rc) {
+    case CSCH_NO_RESOURCES:
+        mexErrMsgIdAndTxt("openCOSSAN:schedulerx:noResources",
+            "The job requests more cores or memory than available (%d cores, %g MB)",
+            options.ncores, options.memory);
+        break;
+    case CSCH_OUT_OF_MEMORY:
+        mexErrMsgIdAndTxt("openCOSSAN:schedulerx", "Out of memory");
+        break;
+    case CSCH_INVALID:
+        mexErrMsgIdAndTxt("openCOSSAN:schedulerx", "Invalid arguments");
+        break;
+    }
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    char Saction[16];
+    csch_options opt;
+    csch_job_info info;
+    double *Vid;
+    long *ids = NULL, id, n;
+    int freecores, npending, nrunning, rc;
+    double freememory;
+    mwSize k;
+
+    mexAtExit(clear_scheduler);
+
+    if (nrhs < 1 || !mxIsChar(prhs[0]) || mxGetString(prhs[0], Saction, sizeof(Saction)) != 0)
+        mexErrMsgTxt("usage: schedulerx(Saction,...) ; (start, submit, status, delete, info or clear)");
+
+    if (strcmp(Saction, "clear") == 0) {
+        clear_scheduler();
+        return;
+    }
+
+    if (strcmp(Saction, "start") == 0) {
+        csch_default_options(&opt);
+        opt.ncores = (int)get_scalar(nrhs, prhs, 1, opt.ncores);
+        opt.memory = get_scalar(nrhs, prhs, 2, opt.memory);
+        if (scheduler != NULL) {
+            if (opt.ncores == options.ncores && opt.memory == options.memory)
+                return;
+            csch_usage(scheduler, &freecores, &freememory, &npending, &nrunning);
+            if (npending + nrunning > 0)
+                mexErrMsgIdAndTxt("openCOSSAN:schedulerx:busy",
+                    "The scheduler cannot be restarted with %d jobs pending or running",
+                    npending + nrunning);
+            clear_scheduler();
+        }
+        start_scheduler(&opt);
+        return;
+    }
+
+    if (scheduler == NULL) {
+        csch_default_options(&opt);
+        start_scheduler(&opt);
+    }
+
+    if (strcmp(Saction, "submit") == 0) {
+        char *Scommand = get_string(nrhs, prhs, 1);
+        if (Scommand == NULL || nrhs > 7 || nlhs > 1)
+            mexErrMsgTxt("usage: Nid = schedulerx('submit',Scommand,Sfolder,Slogfile,Ncores,Nmemory,Ntimeout) ;");
+        id = csch_submit(scheduler, Scommand, get_string(nrhs, prhs, 2),
+            get_string(nrhs, prhs, 3), (int)get_scalar(nrhs, prhs, 4, 1),
+            get_scalar(nrhs, prhs, 5, 0), get_scalar(nrhs, prhs, 6, 0));
+        if (id < 0)
+            check_rc((int)id);
+        plhs[0] = mxCreateDoubleScalar((double)id);
+
+    } else if (strcmp(Saction, "status") == 0) {
+        if (nrhs > 2 || nlhs > 3 || (nrhs == 2 && !mxIsDouble(prhs[1])))
+            mexErrMsgTxt("usage: [CSstate,Vstatus,Vid] = schedulerx('status',Vid) ;");
+        if (nrhs == 2) {
+            n = (long)mxGetNumberOfElements(prhs[1]);
+        } else {
+            n = csch_active_jobs(scheduler, &ids);
+            if (n < 0)
+                check_rc((int)n);
+        }
+        plhs[0] = mxCreateCellMatrix((mwSize)n, 1);
+        if (nlhs > 1)
+            plhs[1] = mxCreateDoubleMatrix((mwSize)n, 1, mxREAL);
+        if (nlhs > 2)
+            plhs[2] = mxCreateDoubleMatrix((mwSize)n, 1, mxREAL);
+        for (k=0; k<(mwSize)n; k++) {
+            id = ids != NULL ? ids[k] : (long)mxGetPr(prhs[1])[k];
+            rc = csch_status(scheduler, id, &info);
+            mxSetCell(plhs[0], k, mxCreateString(rc == CSCH_SUCCESS ?
+                csch_state_string(info.state) : "unknown"));
+            if (nlhs > 1)
+                mxGetPr(plhs[1])[k] = rc == CSCH_SUCCESS ? info.status : -1;
+            if (nlhs > 2)
+                mxGetPr(plhs[2])[k] = (double)id;
+        }
+        free(ids);
+
+    } else if (strcmp(Saction, "delete") == 0) {
+        if (nrhs != 2 || !mxIsDouble(prhs[1]) || nlhs > 0)
+            mexErrMsgTxt("usage: schedulerx('delete',Vid) ;");
+        Vid = mxGetPr(prhs[1]);
+        for (k=0; k<mxGetNumberOfElements(prhs[1]); k++)
+            csch_delete(scheduler, (long)Vid[k]);
+
+    } else if (strcmp(Saction, "info") == 0) {
+        csch_usage(scheduler, &freecores, &freememory, &npending, &nrunning);
+        plhs[0] = mxCreateDoubleScalar(options.ncores);
+        if (nlhs > 1) plhs[1] = mxCreateDoubleScalar(options.memory);
+        if (nlhs > 2) plhs[2] = mxCreateDoubleScalar(freecores);
+        if (nlhs > 3) plhs[3] = mxCreateDoubleScalar(freememory);
+        if (nlhs > 4) plhs[4] = mxCreateDoubleScalar(npending);
+        if (nlhs > 5) plhs[5] = mxCreateDoubleScalar(nrunning);
+
+    } else
+        mexErrMsgIdAndTxt("openCOSSAN:schedulerx", "Unknown action %s", Saction);
+}
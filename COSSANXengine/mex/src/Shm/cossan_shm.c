@@ -0,0 +1,559 @@
+/*******************************************************************************
+ * cossan_shm.c: shared memory transport of the sample matrices (see
+ * cossan_shm.h)
+ *
+ * Layout of the segment: a header of LHEADER bytes (with the two rings)
+ * followed by the nslots slots of ring 0 and the nslots slots of ring 1.
+ * A ring counts the blocks written (head) and read (tail); the slot of a
+ * block is its count modulo nslots. The writer fills a slot without
+ * holding the lock (the reader does not access it until head is
+ * incremented), so that the copies of the two processes overlap.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cossan_shm.h"
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define ENDIAN_CHECK 0x01020304u
+#define LHEADER      4096 /* size of the header (one page) */
+
+/* the timed waits use the monotonic clock where it can be selected */
+#if defined(__linux__)
+#define SHM_CLOCK CLOCK_MONOTONIC
+#else
+#define SHM_CLOCK CLOCK_REALTIME
+#endif
+
+typedef struct {
+  pthread_mutex_t mutex;
+  pthread_cond_t nonempty; /* signalled when a block is written */
+  pthread_cond_t nonfull;  /* signalled when a block is read */
+  uint64_t head;           /* blocks written */
+  uint64_t tail;           /* blocks read */
+} shm_ring;
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t endian;
+  uint32_t nslots;
+  uint32_t slot_doubles;
+  uint64_t size;
+  shm_ring ring[2];
+} shm_header;
+
+struct cshm {
+  int role;        /* CSHM_HOST or CSHM_WORKER */
+  size_t size;
+  size_t lslot;
+  unsigned char *map;
+  shm_header *header;
+  char *name;
+};
+
+static void set_message(char *message, size_t lmessage, const char *text,
+                        const char *name)
+{
+  if (message != NULL && lmessage > 0)
+    snprintf(message, lmessage, text, name);
+}
+
+static size_t slot_size(uint32_t slot_doubles)
+{
+  return sizeof(cshm_block) + (size_t)slot_doubles*sizeof(double);
+}
+
+/* size of the segment, 0 if it cannot be represented */
+static size_t segment_size(uint32_t nslots, uint32_t slot_doubles)
+{
+  uint64_t lslot = sizeof(cshm_block) + (uint64_t)slot_doubles*sizeof(double);
+  uint64_t size;
+  if ((UINT64_MAX - LHEADER)/2/nslots < lslot)
+    return 0;
+  size = LHEADER + 2*(uint64_t)nslots*lslot;
+  return (uint64_t)(size_t)size == size ? (size_t)size : 0;
+}
+
+static cshm_block *get_slot(const cshm *shm, int ring, uint64_t count)
+{
+  uint64_t islot = ring*(uint64_t)shm->header->nslots +
+                   count % shm->header->nslots;
+  return (cshm_block *)(shm->map + LHEADER + islot*shm->lslot);
+}
+
+static void get_deadline(double timeout, struct timespec *deadline)
+{
+  clock_gettime(SHM_CLOCK, deadline);
+  deadline->tv_sec += (time_t)timeout;
+  deadline->tv_nsec += (long)((timeout - (double)(time_t)timeout)*1e9);
+  if (deadline->tv_nsec >= 1000000000L) {
+    deadline->tv_sec++;
+    deadline->tv_nsec -= 1000000000L;
+  }
+}
+
+/* a lock left by a process that terminated is recovered */
+static int lock_ring(shm_ring *ring)
+{
+  int r = pthread_mutex_lock(&ring->mutex);
+#if defined(__linux__)
+  if (r == EOWNERDEAD)
+    r = pthread_mutex_consistent(&ring->mutex);
+#endif
+  return r == 0 ? CSHM_SUCCESS : CSHM_SYSTEM_ERROR;
+}
+
+static void unlock_ring(shm_ring *ring)
+{
+  pthread_mutex_unlock(&ring->mutex);
+}
+
+/* wait on cond with the lock of the ring held */
+static int wait_ring(shm_ring *ring, pthread_cond_t *cond, double timeout,
+                     const struct timespec *deadline)
+{
+  int r;
+  if (timeout < 0)
+    r = pthread_cond_wait(cond, &ring->mutex);
+  else if (timeout == 0)
+    r = ETIMEDOUT;
+  else
+    r = pthread_cond_timedwait(cond, &ring->mutex, deadline);
+#if defined(__linux__)
+  if (r == EOWNERDEAD)
+    r = pthread_mutex_consistent(&ring->mutex);
+#endif
+  if (r == ETIMEDOUT)
+    return CSHM_TIMEOUT;
+  return r == 0 ? CSHM_SUCCESS : CSHM_SYSTEM_ERROR;
+}
+
+static int init_ring(shm_ring *ring)
+{
+  pthread_mutexattr_t mattr;
+  pthread_condattr_t cattr;
+  int r = 0;
+
+  pthread_mutexattr_init(&mattr);
+  r |= pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED);
+#if defined(__linux__)
+  r |= pthread_mutexattr_setrobust(&mattr, PTHREAD_MUTEX_ROBUST);
+#endif
+  r |= pthread_mutex_init(&ring->mutex, &mattr);
+  pthread_mutexattr_destroy(&mattr);
+
+  pthread_condattr_init(&cattr);
+  r |= pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED);
+#if defined(__linux__)
+  r |= pthread_condattr_setclock(&cattr, SHM_CLOCK);
+#endif
+  r |= pthread_cond_init(&ring->nonempty, &cattr);
+  r |= pthread_cond_init(&ring->nonfull, &cattr);
+  pthread_condattr_destroy(&cattr);
+
+  ring->head = ring->tail = 0;
+  return r == 0 ? CSHM_SUCCESS : CSHM_SYSTEM_ERROR;
+}
+
+static cshm *new_shm(const char *name, int role)
+{
+  cshm *shm = calloc(1, sizeof(*shm));
+  if (shm == NULL)
+    return NULL;
+  shm->role = role;
+  shm->name = malloc(strlen(name) + 1);
+  if (shm->name == NULL) {
+    free(shm);
+    return NULL;
+  }
+  strcpy(shm->name, name);
+  return shm;
+}
+
+static void free_shm(cshm *shm)
+{
+  free(shm->name);
+  free(shm);
+}
+
+int cshm_create(const char *name, uint32_t nslots, uint32_t slot_doubles,
+                cshm **shm, char *message, size_t lmessage)
+{
+  cshm *s;
+  size_t size;
+  void *map;
+  int fd, r;
+
+  *shm = NULL;
+  if (name == NULL || nslots == 0 || slot_doubles == 0 ||
+      sizeof(shm_header) > LHEADER)
+    return CSHM_INVALID;
+  size = segment_size(nslots, slot_doubles);
+  if (size == 0 || (off_t)size < 0) {
+    set_message(message, lmessage, "The segment %s is too large", name);
+    return CSHM_INVALID;
+  }
+  s = new_shm(name, CSHM_HOST);
+  if (s == NULL)
+    return CSHM_OUT_OF_MEMORY;
+
+  fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0) {
+    set_message(message, lmessage,
+      "Cannot create the shared memory segment %s", name);
+    free_shm(s);
+    return CSHM_SYSTEM_ERROR;
+  }
+  if (ftruncate(fd, (off_t)size) != 0) {
+    set_message(message, lmessage,
+      "Cannot allocate the shared memory segment %s", name);
+    close(fd);
+    shm_unlink(name);
+    free_shm(s);
+    return CSHM_SYSTEM_ERROR;
+  }
+  map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    set_message(message, lmessage,
+      "Cannot map the shared memory segment %s", name);
+    shm_unlink(name);
+    free_shm(s);
+    return CSHM_SYSTEM_ERROR;
+  }
+
+  s->size = size;
+  s->lslot = slot_size(slot_doubles);
+  s->map = map;
+  s->header = map;
+  s->header->version = CSHM_VERSION;
+  s->header->endian = ENDIAN_CHECK;
+  s->header->nslots = nslots;
+  s->header->slot_doubles = slot_doubles;
+  s->header->size = size;
+  r = init_ring(&s->header->ring[0]);
+  if (r == CSHM_SUCCESS)
+    r = init_ring(&s->header->ring[1]);
+  if (r != CSHM_SUCCESS) {
+    set_message(message, lmessage,
+      "Cannot initialize the locks of the segment %s", name);
+    cshm_close(s);
+    return r;
+  }
+  /* the workers accept the segment once the magic is written */
+  __sync_synchronize();
+  memcpy(s->header->magic, CSHM_MAGIC, 8);
+
+  *shm = s;
+  return CSHM_SUCCESS;
+}
+
+int cshm_open(const char *name, cshm **shm, char *message, size_t lmessage)
+{
+  struct stat st;
+  shm_header *header;
+  cshm *s;
+  void *map;
+  int fd;
+
+  *shm = NULL;
+  if (name == NULL)
+    return CSHM_INVALID;
+  fd = shm_open(name, O_RDWR, 0);
+  if (fd < 0) {
+    set_message(message, lmessage,
+      "Cannot open the shared memory segment %s", name);
+    return CSHM_SYSTEM_ERROR;
+  }
+  if (fstat(fd, &st) != 0 || st.st_size < LHEADER) {
+    set_message(message, lmessage,
+      "%s is not a shared memory segment of COSSAN", name);
+    close(fd);
+    return CSHM_FORMAT_ERROR;
+  }
+  map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+             fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    set_message(message, lmessage,
+      "Cannot map the shared memory segment %s", name);
+    return CSHM_SYSTEM_ERROR;
+  }
+
+  header = map;
+  __sync_synchronize();
+  if (memcmp(header->magic, CSHM_MAGIC, 8) != 0 ||
+      header->version != CSHM_VERSION || header->endian != ENDIAN_CHECK ||
+      header->nslots == 0 || header->slot_doubles == 0 ||
+      header->size != (uint64_t)st.st_size ||
+      segment_size(header->nslots, header->slot_doubles) != header->size) {
+    set_message(message, lmessage,
+      "%s is not a shared memory segment of COSSAN", name);
+    munmap(map, (size_t)st.st_size);
+    return CSHM_FORMAT_ERROR;
+  }
+
+  s = new_shm(name, CSHM_WORKER);
+  if (s == NULL) {
+    munmap(map, (size_t)st.st_size);
+    return CSHM_OUT_OF_MEMORY;
+  }
+  s->size = (size_t)st.st_size;
+  s->lslot = slot_size(header->slot_doubles);
+  s->map = map;
+  s->header = header;
+  *shm = s;
+  return CSHM_SUCCESS;
+}
+
+void cshm_close(cshm *shm)
+{
+  if (shm == NULL)
+    return;
+  munmap(shm->map, shm->size);
+  if (shm->role == CSHM_HOST)
+    shm_unlink(shm->name);
+  free_shm(shm);
+}
+
+uint32_t cshm_nslots(const cshm *shm)
+{
+  return shm->header->nslots;
+}
+
+uint32_t cshm_slot_doubles(const cshm *shm)
+{
+  return shm->header->slot_doubles;
+}
+
+int cshm_send(cshm *shm, uint64_t id, int32_t status, const double *m,
+              uint64_t rows, uint32_t cols, double timeout)
+{
+  shm_ring *ring;
+  cshm_block *block;
+  struct timespec deadline;
+  uint64_t first = 0, brows, count;
+  uint32_t nslots, nrows, c;
+  double *values;
+  int r;
+
+  if (shm == NULL || (m == NULL && rows > 0 && cols > 0) ||
+      cols > shm->header->slot_doubles)
+    return CSHM_INVALID;
+  nslots = shm->header->nslots;
+  brows = cols == 0 ? rows : shm->header->slot_doubles/cols;
+  if (brows > UINT32_MAX)
+    brows = UINT32_MAX;
+  ring = &shm->header->ring[shm->role];
+  if (timeout > 0)
+    get_deadline(timeout, &deadline);
+
+  /* a matrix without rows is sent as an empty block */
+  do {
+    nrows = (uint32_t)(rows - first < brows ? rows - first : brows);
+
+    if ((r = lock_ring(ring)) != CSHM_SUCCESS)
+      return r;
+    while (ring->head - ring->tail >= nslots && r == CSHM_SUCCESS)
+      r = wait_ring(ring, &ring->nonfull, timeout, &deadline);
+    if (ring->head - ring->tail < nslots)
+      r = CSHM_SUCCESS;
+    count = ring->head;
+    unlock_ring(ring);
+    if (r != CSHM_SUCCESS)
+      return r;
+
+    block = get_slot(shm, shm->role, count);
+    block->id = id;
+    block->rows = rows;
+    block->first = first;
+    block->nrows = nrows;
+    block->cols = cols;
+    block->status = status;
+    block->reserved = 0;
+    values = (double *)(block + 1);
+    for (c=0; c<cols; c++)
+      memcpy(values + (size_t)c*nrows, m + (size_t)c*rows + first,
+             nrows*sizeof(double));
+
+    if ((r = lock_ring(ring)) != CSHM_SUCCESS)
+      return r;
+    ring->head++;
+    pthread_cond_signal(&ring->nonempty);
+    unlock_ring(ring);
+    first += nrows;
+  } while (first < rows);
+
+  return CSHM_SUCCESS;
+}
+
+/* wait for the next block of the ring read by the process */
+static int next_block(cshm *shm, double timeout,
+                      const struct timespec *deadline, cshm_block **block)
+{
+  shm_ring *ring = &shm->header->ring[1 - shm->role];
+  int r;
+
+  if ((r = lock_ring(ring)) != CSHM_SUCCESS)
+    return r;
+  while (ring->head == ring->tail && r == CSHM_SUCCESS)
+    r = wait_ring(ring, &ring->nonempty, timeout, deadline);
+  if (ring->head != ring->tail) {
+    r = CSHM_SUCCESS;
+    *block = get_slot(shm, 1 - shm->role, ring->tail);
+  }
+  unlock_ring(ring);
+  return r;
+}
+
+/* release the slot of the block read last */
+static int release_block(cshm *shm)
+{
+  shm_ring *ring = &shm->header->ring[1 - shm->role];
+  int r;
+
+  if ((r = lock_ring(ring)) != CSHM_SUCCESS)
+    return r;
+  ring->tail++;
+  pthread_cond_signal(&ring->nonfull);
+  unlock_ring(ring);
+  return CSHM_SUCCESS;
+}
+
+int cshm_wait(cshm *shm, cshm_block *block, double timeout)
+{
+  struct timespec deadline;
+  cshm_block *next;
+  int r;
+
+  if (shm == NULL)
+    return CSHM_INVALID;
+  if (timeout > 0)
+    get_deadline(timeout, &deadline);
+  r = next_block(shm, timeout, &deadline, &next);
+  if (r == CSHM_SUCCESS)
+    memcpy(block, next, sizeof(*block));
+  return r;
+}
+
+int cshm_receive(cshm *shm, double *m, double timeout)
+{
+  struct timespec deadline;
+  cshm_block *block, head;
+  uint64_t first = 0;
+  uint32_t c;
+  const double *values;
+  int r;
+
+  if (shm == NULL)
+    return CSHM_INVALID;
+  if (timeout > 0)
+    get_deadline(timeout, &deadline);
+
+  do {
+    if ((r = next_block(shm, timeout, &deadline, &block)) != CSHM_SUCCESS)
+      return r;
+    if (first == 0)
+      memcpy(&head, block, sizeof(head));
+    /* a block of another matrix (or a corrupted one) is discarded */
+    if (block->id != head.id || block->rows != head.rows ||
+        block->cols != head.cols || block->first != first ||
+        block->nrows > head.rows - first ||
+        (uint64_t)block->nrows*block->cols > shm->header->slot_doubles ||
+        (block->nrows == 0 && head.rows > 0)) {
+      release_block(shm);
+      return CSHM_FORMAT_ERROR;
+    }
+    if (m != NULL) {
+      values = (const double *)(block + 1);
+      for (c=0; c<head.cols; c++)
+        memcpy(m + (size_t)c*head.rows + first, values + (size_t)c*block->nrows,
+               block->nrows*sizeof(double));
+    }
+    first += block->nrows;
+    if ((r = release_block(shm)) != CSHM_SUCCESS)
+      return r;
+  } while (first < head.rows);
+
+  return CSHM_SUCCESS;
+}
+
+#else /* _WIN32 */
+
+int cshm_create(const char *name, uint32_t nslots, uint32_t slot_doubles,
+                cshm **shm, char *message, size_t lmessage)
+{
+  (void)name; (void)nslots; (void)slot_doubles;
+  *shm = NULL;
+  if (message != NULL && lmessage > 0)
+    snprintf(message, lmessage, "%s",
+      "The shared memory transport is not available on Windows");
+  return CSHM_INVALID;
+}
+
+int cshm_open(const char *name, cshm **shm, char *message, size_t lmessage)
+{
+  return cshm_create(name, 1, 1, shm, message, lmessage);
+}
+
+void cshm_close(cshm *shm) { (void)shm; }
+
+uint32_t cshm_nslots(const cshm *shm) { (void)shm; return 0; }
+
+uint32_t cshm_slot_doubles(const cshm *shm) { (void)shm; return 0; }
+
+int cshm_send(cshm *shm, uint64_t id, int32_t status, const double *m,
+              uint64_t rows, uint32_t cols, double timeout)
+{
+  (void)shm; (void)id; (void)status; (void)m; (void)rows; (void)cols;
+  (void)timeout;
+  return CSHM_INVALID;
+}
+
+int cshm_wait(cshm *shm, cshm_block *block, double timeout)
+{
+  (void)shm; (void)block; (void)timeout;
+  return CSHM_INVALID;
+}
+
+int cshm_receive(cshm *shm, double *m, double timeout)
+{
+  (void)shm; (void)m; (void)timeout;
+  return CSHM_INVALID;
+}
+
+#endif /* _WIN32 */
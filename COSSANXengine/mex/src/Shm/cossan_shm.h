@@ -0,0 +1,140 @@
+/*******************************************************************************
+ * cossan_shm.h: shared memory transport of the sample matrices
+ *
+ * A segment of POSIX shared memory (shm_open) connects a host (the MATLAB
+ * process that creates it) and a worker (a MATLAB or native process on the
+ * same machine that opens it by name, usually passed in the environment
+ * variable COSSAN_SHM). The segment holds two rings of nslots slots, one
+ * for each direction:
+ *
+ *   ring 0 : host -> worker (the samples)
+ *   ring 1 : worker -> host (the results)
+ *
+ * A matrix of doubles is sent as a sequence of blocks of consecutive rows,
+ * one block per slot. A slot starts with a cshm_block header (identifier,
+ * size of the matrix, first row and rows of the block, status) followed by
+ * the values of the block in column major order. Each ring has one writer
+ * and one reader; the access is synchronized with a process shared mutex
+ * and condition variables stored in the segment. The segment uses the byte
+ * order of the machine.
+ *
+ * The transport is available on POSIX systems only.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _COSSAN_SHM_H
+#define _COSSAN_SHM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CSHM_MAGIC   "COSSANSM"
+#define CSHM_VERSION 1
+
+/* environment variable with the name of the segment */
+#define CSHM_NAME_VARIABLE "COSSAN_SHM"
+
+/*
+ * Possible return values of the functions
+ */
+typedef enum {
+  CSHM_TIMEOUT       = -5, /* no slot or no message within the timeout */
+  CSHM_FORMAT_ERROR  = -4, /* not a segment, or inconsistent blocks */
+  CSHM_SYSTEM_ERROR  = -3, /* the segment cannot be created or mapped */
+  CSHM_OUT_OF_MEMORY = -2, /* memory allocation failed */
+  CSHM_INVALID       = -1, /* invalid argument or unsupported system */
+  CSHM_SUCCESS       =  0
+} cshm_result;
+
+/* roles of the processes connected by a segment */
+enum { CSHM_HOST = 0, CSHM_WORKER = 1 };
+
+/*
+ * Header of a slot
+ */
+typedef struct {
+  uint64_t id;      /* identifier of the matrix (chosen by the sender) */
+  uint64_t rows;    /* rows of the matrix */
+  uint64_t first;   /* first row of the block */
+  uint32_t nrows;   /* rows of the block */
+  uint32_t cols;    /* columns of the matrix */
+  int32_t status;   /* status of the matrix, passed to the receiver */
+  uint32_t reserved;
+} cshm_block;
+
+typedef struct cshm cshm;
+
+/*
+ * Create the segment name (as host) with nslots slots of slot_doubles
+ * values per direction. An existing segment with the same name is an
+ * error.
+ */
+int cshm_create(const char *name, uint32_t nslots, uint32_t slot_doubles,
+                cshm **shm, char *message, size_t lmessage);
+
+/* Open the segment name created by the host (as worker) */
+int cshm_open(const char *name, cshm **shm, char *message, size_t lmessage);
+
+/* Unmap the segment; the host also removes its name */
+void cshm_close(cshm *shm);
+
+/* Number of slots of a ring and values of a slot */
+uint32_t cshm_nslots(const cshm *shm);
+uint32_t cshm_slot_doubles(const cshm *shm);
+
+/*
+ * Send the rows x cols matrix m (column major) with the identifier id and
+ * the status. The call waits for free slots at most timeout seconds in
+ * total (for ever if timeout < 0). A matrix with more than
+ * cshm_slot_doubles values in a row cannot be sent. After a CSHM_TIMEOUT
+ * the receiver gets an incomplete matrix, and the segment should not be
+ * used any more.
+ */
+int cshm_send(cshm *shm, uint64_t id, int32_t status, const double *m,
+              uint64_t rows, uint32_t cols, double timeout);
+
+/*
+ * Wait at most timeout seconds for the next matrix and copy its header
+ * (the first block) in block, without removing it. The matrix is then
+ * read with cshm_receive.
+ */
+int cshm_wait(cshm *shm, cshm_block *block, double timeout);
+
+/*
+ * Remove the next matrix from the ring and copy it in m (block->rows x
+ * block->cols values, column major; discarded if m is NULL).
+ */
+int cshm_receive(cshm *shm, double *m, double timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_SHM_H */
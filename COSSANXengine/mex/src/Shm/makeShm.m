@@ -0,0 +1,31 @@
+% Script to generate the mex file of the shared memory transport of the
+% sample matrices (see cossan_shm.h). Available on POSIX systems only.
+
+disp('Compiling the shared memory mex files ..');
+
+assert(~isempty(OpenCossan.getCossanRoot),'openCOSSAN:makeShm','Please initialize OpenCossan')
+
+% shm_open is in librt on the older Linux systems
+if ismac
+    mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" shmx.c cossan_shm.c
+else
+    mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" shmx.c cossan_shm.c -lrt
+end
+
+% List of created mex files
+r=dir('*.mex*');
+
+Spath=fullfile(OpenCossan.getCossanRoot,'mex','bin');
+
+
+for n=1:length(r)
+    % Move the compiled file in the appropriate folder
+    [status,message,messageid]=movefile(r(n).name,Spath,'f');
+    
+    if status
+        disp(['MEX FILE ' r(n).name ' created and moved in ' Spath ]);
+    else
+        disp(message);
+        disp(messageid);
+    end
+end
@@ -0,0 +1,272 @@
+/*******************************************************************************
+ * shmx: shared memory transport of the sample matrices - matlab MEX
+ *
+ * Exchange matrices of doubles between MATLAB processes, or between MATLAB
+ * and native programs, running on the same machine through a segment of
+ * POSIX shared memory (see cossan_shm.h) instead of .mat files. The host
+ * creates the segment and the worker opens it by name; the host sends to
+ * the worker and receives from it, and vice versa.
+ *
+ * usage:
+ *   shmx('create',Sname,Nslots,NslotValues)
+ *   shmx('open',Sname)
+ *   shmx('send',Sname,Mvalues,Nid,Nstatus,Ntimeout)
+ *   [Mvalues,Nid,Nstatus] = shmx('receive',Sname,Ntimeout)
+ *   shmx('close',Sname)
+ *   shmx('clear')
+ * where
+ *   Sname       : name of the segment (a '/' is prepended if missing)
+ *   Nslots      : number of slots of each direction (default 16)
+ *   NslotValues : values of a slot (default 65536); a matrix is sent in
+ *                 blocks of rows of at most NslotValues values, so that a
+ *                 row must fit in a slot
+ *   Mvalues     : matrix of doubles
+ *   Nid         : identifier of the matrix (default 0)
+ *   Nstatus     : status of the matrix, e.g. an error code (default 0)
+ *   Ntimeout    : maximum waiting time in seconds (default Inf); 'send'
+ *                 waits for free slots and 'receive' for a matrix
+ *
+ * 'receive' returns empty Mvalues, Nid and Nstatus if no matrix arrives
+ * within Ntimeout. 'close' unmaps the segment (and the host removes it);
+ * 'clear' closes all the segments, as clearing the mex file does.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+#include "cossan_shm.h"
+
+/* open segments */
+typedef struct segment {
+    char *name;
+    cshm *shm;
+    struct segment *next;
+} segment;
+
+static segment *segments = NULL;
+
+static void close_segment(segment *s)
+{
+    segment **p;
+    for (p=&segments; *p!=NULL; p=&(*p)->next)
+        if (*p == s) {
+            *p = s->next;
+            break;
+        }
+    cshm_close(s->shm);
+    free(s->name);
+    free(s);
+}
+
+static void close_all(void)
+{
+    while (segments != NULL)
+        close_segment(segments);
+}
+
+/* name of the segment with the leading '/' (mxFree the result) */
+static char *get_name(int nrhs, const mxArray *prhs[])
+{
+    char *Sname, *name;
+    if (nrhs < 2 || !mxIsChar(prhs[1]))
+        mexErrMsgIdAndTxt("openCOSSAN:shmx", "The name of the segment must be a string");
+    Sname = mxArrayToString(prhs[1]);
+    if (Sname[0] == '/')
+        return Sname;
+    name = mxMalloc(strlen(Sname) + 2);
+    name[0] = '/';
+    strcpy(name + 1, Sname);
+    mxFree(Sname);
+    return name;
+}
+
+static segment *find_segment(const char *name)
+{
+    segment *s;
+    for (s=segments; s!=NULL; s=s->next)
+        if (strcmp(s->name, name) == 0)
+            return s;
+    return NULL;
+}
+
+static double get_scalar(int nrhs, const mxArray *prhs[], int k, double value)
+{
+    if (nrhs <= k || mxIsEmpty(prhs[k]))
+        return value;
+    if (!mxIsNumeric(prhs[k]) || mxGetNumberOfElements(prhs[k]) != 1)
+        mexErrMsgIdAndTxt("openCOSSAN:shmx", "Argument %d must be a scalar", k+1);
+    return mxGetScalar(prhs[k]);
+}
+
+/* timeout in seconds, negative to wait for ever */
+static double get_timeout(int nrhs, const mxArray *prhs[], int k)
+{
+    double timeout = get_scalar(nrhs, prhs, k, mxGetInf());
+    if (mxIsInf(timeout))
+        return -1;
+    if (mxIsNaN(timeout) || timeout < 0)
+        mexErrMsgIdAndTxt("openCOSSAN:shmx", "The timeout must be a non negative number");
+    return timeout;
+}
+
+static void check_rc(int rc)
+{
+    switch (rc) {
+    case CSHM_TIMEOUT:
+        mexErrMsgIdAndTxt("openCOSSAN:shmx:timeout", "Timeout of the shared memory transport");
+        break;
+    case CSHM_FORMAT_ERROR:
+        mexErrMsgIdAndTxt("openCOSSAN:shmx:formatError", "Inconsistent blocks in the segment");
+        break;
+    case CSHM_SYSTEM_ERROR:
+        mexErrMsgIdAndTxt("openCOSSAN:shmx:systemError", "Error of the locks of the segment");
+        break;
+    case CSHM_OUT_OF_MEMORY:
+        mexErrMsgIdAndTxt("openCOSSAN:shmx", "Out of memory");
+        break;
+    case CSHM_INVALID:
+        mexErrMsgIdAndTxt("openCOSSAN:shmx", "Invalid arguments or unsupported system");
+        break;
+    }
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    char Saction[16], message[512];
+    char *name;
+    segment *s;
+    cshm *shm;
+    cshm_block block;
+    double Nslots, NslotValues, timeout;
+    int rc;
+
+    mexAtExit(close_all);
+
+    if (nrhs < 1 || !mxIsChar(prhs[0]) || mxGetString(prhs[0], Saction, sizeof(Saction)) != 0)
+        mexErrMsgTxt("usage: shmx(Saction,...) ; (create, open, send, receive, close or clear)");
+
+    if (strcmp(Saction, "clear") == 0) {
+        close_all();
+        return;
+    }
+
+    name = get_name(nrhs, prhs);
+    s = find_segment(name);
+
+    if (strcmp(Saction, "create") == 0 || strcmp(Saction, "open") == 0) {
+        if (s != NULL) {
+            mxFree(name);
+            mexErrMsgIdAndTxt("openCOSSAN:shmx", "The segment is already open");
+        }
+        message[0] = '\0';
+        if (Saction[0] == 'c') {
+            if (nrhs > 4 || nlhs > 0)
+                mexErrMsgTxt("usage: shmx('create',Sname,Nslots,NslotValues) ;");
+            Nslots = get_scalar(nrhs, prhs, 2, 16);
+            NslotValues = get_scalar(nrhs, prhs, 3, 65536);
+            if (!(Nslots >= 1 && Nslots <= 4294967295.0 &&
+                  NslotValues >= 1 && NslotValues <= 4294967295.0))
+                mexErrMsgIdAndTxt("openCOSSAN:shmx", "Nslots and NslotValues must be positive integers");
+            rc = cshm_create(name, (uint32_t)Nslots, (uint32_t)NslotValues, &shm,
+                             message, sizeof(message));
+        } else {
+            if (nrhs != 2 || nlhs > 0)
+                mexErrMsgTxt("usage: shmx('open',Sname) ;");
+            rc = cshm_open(name, &shm, message, sizeof(message));
+        }
+        if (rc == CSHM_SUCCESS) {
+            s = malloc(sizeof(*s));
+            if (s != NULL && (s->name = malloc(strlen(name) + 1)) != NULL) {
+                strcpy(s->name, name);
+                s->shm = shm;
+                s->next = segments;
+                segments = s;
+            } else {
+                free(s);
+                cshm_close(shm);
+                rc = CSHM_OUT_OF_MEMORY;
+            }
+        }
+        mxFree(name);
+        if (rc != CSHM_SUCCESS && message[0] != '\0')
+            mexErrMsgIdAndTxt(rc == CSHM_FORMAT_ERROR ? "openCOSSAN:shmx:formatError" :
+                              "openCOSSAN:shmx:systemError", "%s", message);
+        check_rc(rc);
+        return;
+    }
+    mxFree(name);
+
+    if (strcmp(Saction, "close") == 0) {
+        if (s != NULL)
+            close_segment(s);
+        return;
+    }
+
+    if (s == NULL)
+        mexErrMsgIdAndTxt("openCOSSAN:shmx", "The segment is not open");
+
+    if (strcmp(Saction, "send") == 0) {
+        if (nrhs < 3 || nrhs > 6 || nlhs > 0)
+            mexErrMsgTxt("usage: shmx('send',Sname,Mvalues,Nid,Nstatus,Ntimeout) ;");
+        if (!mxIsDouble(prhs[2]) || mxIsComplex(prhs[2]) || mxIsSparse(prhs[2]) ||
+            mxGetNumberOfDimensions(prhs[2]) > 2)
+            mexErrMsgIdAndTxt("openCOSSAN:shmx", "Mvalues must be a real matrix");
+        if (mxGetN(prhs[2]) > cshm_slot_doubles(s->shm))
+            mexErrMsgIdAndTxt("openCOSSAN:shmx",
+                "A row of Mvalues does not fit in a slot (%u values)", cshm_slot_doubles(s->shm));
+        rc = cshm_send(s->shm, (uint64_t)get_scalar(nrhs, prhs, 3, 0),
+                       (int32_t)get_scalar(nrhs, prhs, 4, 0), mxGetPr(prhs[2]),
+                       mxGetM(prhs[2]), (uint32_t)mxGetN(prhs[2]), get_timeout(nrhs, prhs, 5));
+        check_rc(rc);
+
+    } else if (strcmp(Saction, "receive") == 0) {
+        if (nrhs > 3 || nlhs > 3)
+            mexErrMsgTxt("usage: [Mvalues,Nid,Nstatus] = shmx('receive',Sname,Ntimeout) ;");
+        timeout = get_timeout(nrhs, prhs, 2);
+        rc = cshm_wait(s->shm, &block, timeout);
+        if (rc == CSHM_TIMEOUT) {
+            plhs[0] = mxCreateDoubleMatrix(0, 0, mxREAL);
+            if (nlhs > 1)
+                plhs[1] = mxCreateDoubleMatrix(0, 0, mxREAL);
+            if (nlhs > 2)
+                plhs[2] = mxCreateDoubleMatrix(0, 0, mxREAL);
+            return;
+        }
+        check_rc(rc);
+        plhs[0] = mxCreateDoubleMatrix((mwSize)block.rows, block.cols, mxREAL);
+        /* the rest of the matrix follows the first block */
+        check_rc(cshm_receive(s->shm, mxGetPr(plhs[0]), timeout));
+        if (nlhs > 1)
+            plhs[1] = mxCreateDoubleScalar((double)block.id);
+        if (nlhs > 2)
+            plhs[2] = mxCreateDoubleScalar(block.status);
+
+    } else
+        mexErrMsgIdAndTxt("openCOSSAN:shmx", "Unknown action %s", Saction);
+}
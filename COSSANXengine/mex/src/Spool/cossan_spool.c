@@ -0,0 +1,608 @@
+/*******************************************************************************
+ * cossan_spool.c: completion spool of the JobManager (see cossan_spool.h)
+ *
+ * The registered jobs are stored in an array and indexed by two open
+ * addressing hash tables (FNV-1a, linear probing), one on the job
+ * identifier and one on the marker token: the status of a job and the
+ * owner of a marker are found in constant time. The removed entries are
+ * reclaimed when the tables are rebuilt.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cossan_spool.h"
+
+#define LRECORD 128  /* maximum length of a marker */
+
+int cspool_parse_record(const char *text, cspool_record *record)
+{
+  int status;
+  double runtime, maxrss;
+
+  if (text == NULL || record == NULL ||
+      sscanf(text, "%d %lf %lf", &status, &runtime, &maxrss) != 3)
+    return CSPOOL_INVALID;
+  record->state = CSPOOL_DONE;
+  record->status = status;
+  record->runtime = runtime;
+  record->maxrss = maxrss;
+  return CSPOOL_SUCCESS;
+}
+
+static char *join_path(const char *dir, const char *prefix, const char *name,
+                       const char *suffix)
+{
+  size_t l = strlen(dir) + strlen(prefix) + strlen(name) + strlen(suffix) + 2;
+  char *path = malloc(l);
+
+  if (path != NULL)
+    snprintf(path, l, "%s/%s%s%s", dir, prefix, name, suffix);
+  return path;
+}
+
+static int valid_token(const char *token)
+{
+  return token != NULL && token[0] != '\0' && token[0] != '.' &&
+    strchr(token, '/') == NULL;
+}
+
+int cspool_write_record(const char *dir, const char *token, int status,
+                        double runtime, double maxrss, int publish)
+{
+  char *hidden, *marker = NULL;
+  FILE *fid;
+  int rc = CSPOOL_SUCCESS;
+
+  if (dir == NULL || !valid_token(token))
+    return CSPOOL_INVALID;
+  hidden = join_path(dir, ".", token, "");
+  if (publish)
+    marker = join_path(dir, "", token, CSPOOL_SUFFIX);
+  if (hidden == NULL || (publish && marker == NULL)) {
+    free(hidden);
+    free(marker);
+    return CSPOOL_OUT_OF_MEMORY;
+  }
+
+  fid = fopen(hidden, "w");
+  if (fid == NULL)
+    rc = CSPOOL_FILE_ERROR;
+  else {
+    if (fprintf(fid, "%d %.3f %.0f\n", status, runtime, maxrss) < 0)
+      rc = CSPOOL_FILE_ERROR;
+    if (fclose(fid) != 0)
+      rc = CSPOOL_FILE_ERROR;
+  }
+  if (rc == CSPOOL_SUCCESS && publish && rename(hidden, marker) != 0)
+    rc = CSPOOL_FILE_ERROR;
+  if (rc != CSPOOL_SUCCESS)
+    remove(hidden);
+
+  free(hidden);
+  free(marker);
+  return rc;
+}
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
+
+#define SCAN_MAX 1.0  /* scan interval without inotify [s] */
+#define EMPTY   (-1)  /* free slot of the hash tables */
+#define REMOVED (-2)  /* slot of a removed entry */
+
+typedef struct {
+  char *id;       /* NULL: removed */
+  char *token;
+  cspool_record record;
+  int reported;
+} spool_entry;
+
+struct cspool {
+  char *dir;
+  int fd;               /* inotify descriptor, -1 if not available */
+  double rescan;
+  double last_scan, last_check;
+  spool_entry *entries;
+  size_t nentries, nalloc, nlive;
+  long *by_id, *by_token;
+  size_t size;          /* slots of the hash tables (power of 2) */
+  size_t nused;         /* slots not EMPTY */
+  int nwaiting;         /* registered jobs without marker */
+  int unreported;       /* completed jobs not yet reported */
+};
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9*(double)ts.tv_nsec;
+}
+
+static size_t hash_string(const char *s)
+{
+  unsigned int h = 2166136261u;
+
+  for (; *s != '\0'; s++) {
+    h ^= (unsigned char)*s;
+    h *= 16777619u;
+  }
+  return (size_t)h;
+}
+
+static const char *key_of(const spool_entry *e, int by_token)
+{
+  return by_token ? e->token : e->id;
+}
+
+/*
+ * Index of the entry with the key (-1 if absent). slot receives the slot
+ * of the entry or the slot where the key is inserted.
+ */
+static long lookup(const cspool *spool, const char *key, int by_token,
+                   size_t *slot)
+{
+  const long *table = by_token ? spool->by_token : spool->by_id;
+  size_t mask = spool->size - 1, i = hash_string(key) & mask;
+  size_t first = spool->size;
+
+  for (;; i = (i + 1) & mask) {
+    if (table[i] == EMPTY) {
+      if (slot != NULL)
+        *slot = first < spool->size ? first : i;
+      return -1;
+    }
+    if (table[i] == REMOVED) {
+      if (first == spool->size)
+        first = i;
+    } else if (strcmp(key_of(&spool->entries[table[i]], by_token), key) == 0) {
+      if (slot != NULL)
+        *slot = i;
+      return table[i];
+    }
+  }
+}
+
+/* compact the entries and rebuild the tables with size slots */
+static int rebuild(cspool *spool, size_t size)
+{
+  long *by_id = malloc(size*sizeof(long)), *by_token = malloc(size*sizeof(long));
+  size_t i, n = 0, slot;
+
+  if (by_id == NULL || by_token == NULL) {
+    free(by_id);
+    free(by_token);
+    return CSPOOL_OUT_OF_MEMORY;
+  }
+  for (i=0; i<size; i++)
+    by_id[i] = by_token[i] = EMPTY;
+  free(spool->by_id);
+  free(spool->by_token);
+  spool->by_id = by_id;
+  spool->by_token = by_token;
+  spool->size = size;
+
+  for (i=0; i<spool->nentries; i++) {
+    if (spool->entries[i].id == NULL)
+      continue;
+    spool->entries[n] = spool->entries[i];
+    lookup(spool, spool->entries[n].id, 0, &slot);
+    by_id[slot] = (long)n;
+    lookup(spool, spool->entries[n].token, 1, &slot);
+    by_token[slot] = (long)n;
+    n++;
+  }
+  spool->nentries = spool->nused = n;
+  return CSPOOL_SUCCESS;
+}
+
+static void remove_entry(cspool *spool, long k)
+{
+  spool_entry *e = &spool->entries[k];
+  size_t slot;
+
+  lookup(spool, e->id, 0, &slot);
+  spool->by_id[slot] = REMOVED;
+  lookup(spool, e->token, 1, &slot);
+  spool->by_token[slot] = REMOVED;
+  if (e->record.state == CSPOOL_WAITING)
+    spool->nwaiting--;
+  else if (!e->reported)
+    spool->unreported--;
+  free(e->id);
+  free(e->token);
+  e->id = e->token = NULL;
+  spool->nlive--;
+}
+
+/* read the marker of the entry k: 1 if read, 0 if not (yet) available */
+static int load_marker(cspool *spool, long k)
+{
+  spool_entry *e = &spool->entries[k];
+  char text[LRECORD];
+  char *path = join_path(spool->dir, "", e->token, CSPOOL_SUFFIX);
+  ssize_t n;
+  int fd;
+
+  if (path == NULL)
+    return CSPOOL_OUT_OF_MEMORY;
+  fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    free(path);
+    return 0;
+  }
+  n = read(fd, text, sizeof(text) - 1);
+  close(fd);
+  if (n <= 0) {
+    free(path);
+    return 0;
+  }
+  text[n] = '\0';
+  if (cspool_parse_record(text, &e->record) != CSPOOL_SUCCESS) {
+    free(path);
+    return 0;
+  }
+  e->reported = 0;
+  spool->nwaiting--;
+  spool->unreported++;
+  unlink(path);
+  free(path);
+  return 1;
+}
+
+/* marker file name: read it if it belongs to a registered waiting job */
+static int process_name(cspool *spool, const char *name)
+{
+  size_t l = strlen(name), ls = strlen(CSPOOL_SUFFIX);
+  char token[256];
+  long k;
+
+  if (name[0] == '.' || l <= ls || l - ls >= sizeof(token) ||
+      strcmp(name + l - ls, CSPOOL_SUFFIX) != 0)
+    return 0;
+  memcpy(token, name, l - ls);
+  token[l - ls] = '\0';
+  k = lookup(spool, token, 1, NULL);
+  if (k < 0 || spool->entries[k].record.state == CSPOOL_DONE)
+    return 0;
+  return load_marker(spool, k) == 1;
+}
+
+static int scan(cspool *spool)
+{
+  DIR *d;
+  struct dirent *de;
+  int n = 0;
+
+  spool->last_scan = now();
+  if (spool->nwaiting == 0)
+    return 0; /* nothing to wait for */
+  d = opendir(spool->dir);
+  if (d == NULL)
+    return CSPOOL_FILE_ERROR;
+  while ((de = readdir(d)) != NULL)
+    n += process_name(spool, de->d_name);
+  closedir(d);
+  return n;
+}
+
+static double scan_interval(const cspool *spool)
+{
+  return spool->fd < 0 && spool->rescan > SCAN_MAX ? SCAN_MAX : spool->rescan;
+}
+
+int cspool_open(const char *dir, double rescan, cspool **spool)
+{
+  struct stat st;
+  cspool *s;
+
+  if (dir == NULL || spool == NULL)
+    return CSPOOL_INVALID;
+  *spool = NULL;
+  if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode))
+    return CSPOOL_FILE_ERROR;
+
+  s = calloc(1, sizeof(cspool));
+  if (s == NULL || (s->dir = strdup(dir)) == NULL) {
+    free(s);
+    return CSPOOL_OUT_OF_MEMORY;
+  }
+  s->rescan = rescan > 0 ? rescan : SCAN_MAX;
+  s->last_scan = s->last_check = now();
+  s->fd = -1;
+  if (rebuild(s, 64) != CSPOOL_SUCCESS) {
+    cspool_close(s);
+    return CSPOOL_OUT_OF_MEMORY;
+  }
+#if defined(__linux__)
+  s->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (s->fd >= 0 && inotify_add_watch(s->fd, dir, IN_MOVED_TO | IN_CLOSE_WRITE) < 0) {
+    close(s->fd);
+    s->fd = -1;
+  }
+#endif
+  *spool = s;
+  return CSPOOL_SUCCESS;
+}
+
+void cspool_close(cspool *spool)
+{
+  size_t i;
+
+  if (spool == NULL)
+    return;
+  if (spool->fd >= 0)
+    close(spool->fd);
+  for (i=0; i<spool->nentries; i++) {
+    free(spool->entries[i].id);
+    free(spool->entries[i].token);
+  }
+  free(spool->entries);
+  free(spool->by_id);
+  free(spool->by_token);
+  free(spool->dir);
+  free(spool);
+}
+
+const char *cspool_directory(const cspool *spool)
+{
+  return spool->dir;
+}
+
+int cspool_forget(cspool *spool, const char *id)
+{
+  long k;
+
+  if (spool == NULL || id == NULL)
+    return CSPOOL_INVALID;
+  k = lookup(spool, id, 0, NULL);
+  if (k >= 0)
+    remove_entry(spool, k);
+  return CSPOOL_SUCCESS;
+}
+
+int cspool_expect(cspool *spool, const char *id, const char *token)
+{
+  spool_entry *e;
+  size_t slot;
+  long k;
+  int rc, lempty;
+
+  if (spool == NULL || id == NULL || id[0] == '\0' || !valid_token(token) ||
+      strlen(token) + strlen(CSPOOL_SUFFIX) >= 256)
+    return CSPOOL_INVALID;
+  /* identifier reused by the batch system or job resubmitted */
+  if ((k = lookup(spool, id, 0, NULL)) >= 0)
+    remove_entry(spool, k);
+  if ((k = lookup(spool, token, 1, NULL)) >= 0)
+    remove_entry(spool, k);
+
+  if (2*(spool->nused + 1) > spool->size) {
+    size_t size = 64;
+    while (size < 4*(spool->nlive + 1))
+      size *= 2;
+    if ((rc = rebuild(spool, size)) != CSPOOL_SUCCESS)
+      return rc;
+  }
+  if (spool->nentries == spool->nalloc) {
+    size_t nalloc = spool->nalloc ? 2*spool->nalloc : 64;
+    spool_entry *entries = realloc(spool->entries, nalloc*sizeof(spool_entry));
+    if (entries == NULL)
+      return CSPOOL_OUT_OF_MEMORY;
+    spool->entries = entries;
+    spool->nalloc = nalloc;
+  }
+
+  e = &spool->entries[spool->nentries];
+  e->id = strdup(id);
+  e->token = strdup(token);
+  if (e->id == NULL || e->token == NULL) {
+    free(e->id);
+    free(e->token);
+    return CSPOOL_OUT_OF_MEMORY;
+  }
+  e->record.state = CSPOOL_WAITING;
+  e->record.status = 0;
+  e->record.runtime = 0;
+  e->record.maxrss = -1;
+  e->reported = 0;
+  k = (long)spool->nentries++;
+  spool->nlive++;
+  spool->nwaiting++;
+  /* nused bounds the occupied slots of both tables */
+  lookup(spool, id, 0, &slot);
+  lempty = spool->by_id[slot] == EMPTY;
+  spool->by_id[slot] = k;
+  lookup(spool, token, 1, &slot);
+  lempty = lempty || spool->by_token[slot] == EMPTY;
+  spool->by_token[slot] = k;
+  if (lempty)
+    spool->nused++;
+
+  /* the job can be faster than its registration */
+  rc = load_marker(spool, k);
+  return rc < 0 ? rc : CSPOOL_SUCCESS;
+}
+
+int cspool_drain(cspool *spool)
+{
+  int n = 0, overflow = 0, rc;
+
+  if (spool == NULL)
+    return CSPOOL_INVALID;
+#if defined(__linux__)
+  if (spool->fd >= 0) {
+    char buffer[16384] __attribute__((aligned(__alignof__(struct inotify_event))));
+    const struct inotify_event *ev;
+    ssize_t l;
+    char *p;
+
+    while ((l = read(spool->fd, buffer, sizeof(buffer))) > 0) {
+      for (p = buffer; p < buffer + l; p += sizeof(struct inotify_event) + ev->len) {
+        ev = (const struct inotify_event *)p;
+        if (ev->mask & IN_Q_OVERFLOW)
+          overflow = 1;
+        else if (ev->len > 0)
+          n += process_name(spool, ev->name);
+      }
+    }
+  }
+#endif
+  if (overflow || now() - spool->last_scan >= scan_interval(spool)) {
+    if ((rc = scan(spool)) < 0)
+      return rc;
+    n += rc;
+  }
+  return n;
+}
+
+int cspool_status(cspool *spool, const char *id, cspool_record *record)
+{
+  spool_entry *e;
+  long k;
+
+  if (spool == NULL || id == NULL || record == NULL)
+    return CSPOOL_INVALID;
+  k = lookup(spool, id, 0, NULL);
+  if (k < 0) {
+    record->state = CSPOOL_UNKNOWN;
+    record->status = 0;
+    record->runtime = 0;
+    record->maxrss = -1;
+    return CSPOOL_SUCCESS;
+  }
+  e = &spool->entries[k];
+  *record = e->record;
+  if (e->record.state == CSPOOL_DONE && !e->reported) {
+    e->reported = 1;
+    spool->unreported--;
+  }
+  return CSPOOL_SUCCESS;
+}
+
+int cspool_wait(cspool *spool, double timeout)
+{
+  double t, deadline = now() + timeout, step;
+  int rc;
+
+  if (spool == NULL)
+    return CSPOOL_INVALID;
+  for (;;) {
+    if ((rc = cspool_drain(spool)) < 0)
+      return rc;
+    if (spool->unreported > 0)
+      return spool->unreported;
+    t = now();
+    if (t >= deadline)
+      return 0;
+    step = spool->last_scan + scan_interval(spool) - t;
+    if (step > deadline - t)
+      step = deadline - t;
+    if (step < 0.001)
+      step = 0.001;
+    if (spool->fd >= 0) {
+      struct pollfd pfd;
+      pfd.fd = spool->fd;
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      poll(&pfd, 1, (int)(1e3*step) + 1);
+    } else {
+      struct timespec ts;
+      ts.tv_sec = (time_t)step;
+      ts.tv_nsec = (long)(1e9*(step - (double)ts.tv_sec));
+      nanosleep(&ts, NULL);
+    }
+  }
+}
+
+int cspool_check_due(cspool *spool, double interval)
+{
+  double t = now();
+
+  if (spool == NULL || t - spool->last_check < interval)
+    return 0;
+  spool->last_check = t;
+  return 1;
+}
+
+#else /* _WIN32 */
+
+int cspool_open(const char *dir, double rescan, cspool **spool)
+{
+  (void)dir; (void)rescan;
+  if (spool != NULL)
+    *spool = NULL;
+  return CSPOOL_INVALID;
+}
+
+void cspool_close(cspool *spool) { (void)spool; }
+
+const char *cspool_directory(const cspool *spool) { (void)spool; return ""; }
+
+int cspool_expect(cspool *spool, const char *id, const char *token)
+{
+  (void)spool; (void)id; (void)token;
+  return CSPOOL_INVALID;
+}
+
+int cspool_forget(cspool *spool, const char *id)
+{
+  (void)spool; (void)id;
+  return CSPOOL_INVALID;
+}
+
+int cspool_drain(cspool *spool) { (void)spool; return CSPOOL_INVALID; }
+
+int cspool_status(cspool *spool, const char *id, cspool_record *record)
+{
+  (void)spool; (void)id; (void)record;
+  return CSPOOL_INVALID;
+}
+
+int cspool_wait(cspool *spool, double timeout)
+{
+  (void)spool; (void)timeout;
+  return CSPOOL_INVALID;
+}
+
+int cspool_check_due(cspool *spool, double interval)
+{
+  (void)spool; (void)interval;
+  return 0;
+}
+
+#endif /* _WIN32 */
@@ -0,0 +1,158 @@
+/*******************************************************************************
+ * cossan_spool.h: completion spool of the JobManager
+ *
+ * Completion tracking of the jobs submitted to a batch system without
+ * polling the batch system. At the end of its script, every job publishes
+ * a small marker file TOKEN.done in a spool directory (written to .TOKEN
+ * and renamed, so that a marker is never read half written) with one
+ * line:
+ *
+ *   <exit status> <runtime [s]> <peak resident memory [kB], -1 if unknown>
+ *
+ * The submitter registers the TOKEN of every job with the identifier given
+ * by the batch system (cspool_expect). The spool directory is watched with
+ * inotify, so that the markers are read when they are renamed in the
+ * directory and the status of a job is a lookup in a hash table. Markers
+ * written by other machines on a network file system do not produce
+ * inotify events: the directory is also scanned every few seconds, and it
+ * is only scanned when inotify is not available. The markers of the
+ * registered jobs are removed once read, the others are left untouched.
+ *
+ * The program spoolrun (spoolrun.c) executes the solver of a job and
+ * writes the marker with its runtime and peak memory.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+
+#ifndef _COSSAN_SPOOL_H
+#define _COSSAN_SPOOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Possible return values of the functions
+ */
+typedef enum {
+  CSPOOL_FILE_ERROR    = -3, /* missing spool directory or unreadable marker */
+  CSPOOL_OUT_OF_MEMORY = -2, /* memory allocation failed */
+  CSPOOL_INVALID       = -1, /* invalid argument or unsupported system */
+  CSPOOL_SUCCESS       =  0
+} cspool_result;
+
+/*
+ * States of a job
+ */
+typedef enum {
+  CSPOOL_UNKNOWN  = -1, /* not registered with cspool_expect */
+  CSPOOL_WAITING  =  0, /* registered, no marker yet */
+  CSPOOL_DONE     =  1  /* marker read */
+} cspool_state;
+
+/*
+ * Content of the marker of a job
+ */
+typedef struct {
+  int state;      /* cspool_state */
+  int status;     /* exit status of the job */
+  double runtime; /* [s] */
+  double maxrss;  /* peak resident memory [kB], -1 if unknown */
+} cspool_record;
+
+/* suffix of the published markers */
+#define CSPOOL_SUFFIX ".done"
+
+typedef struct cspool cspool;
+
+/*
+ * Open the spool directory dir (it must exist). The directory is scanned
+ * every rescan seconds in addition to the inotify events.
+ */
+int cspool_open(const char *dir, double rescan, cspool **spool);
+
+/* Close the spool, the markers not yet read are left in the directory */
+void cspool_close(cspool *spool);
+
+/* Directory of the spool */
+const char *cspool_directory(const cspool *spool);
+
+/*
+ * Register the job id with the marker token. A previous registration of
+ * the same id (identifiers reused by the batch system) is replaced. The
+ * marker is read immediately if it is already in the directory.
+ */
+int cspool_expect(cspool *spool, const char *id, const char *token);
+
+/* Remove the registration of the job id */
+int cspool_forget(cspool *spool, const char *id);
+
+/*
+ * Read the markers published since the last call. Returns the number of
+ * markers read or a negative cspool_result.
+ */
+int cspool_drain(cspool *spool);
+
+/*
+ * Status of the job id (after cspool_drain). A completed job is counted
+ * as reported and no longer wakes up cspool_wait.
+ */
+int cspool_status(cspool *spool, const char *id, cspool_record *record);
+
+/*
+ * Wait at most timeout seconds for a completed job not yet reported by
+ * cspool_status. Returns the number of such jobs (0 after the timeout) or
+ * a negative cspool_result.
+ */
+int cspool_wait(cspool *spool, double timeout);
+
+/*
+ * Returns 1 (and restarts the clock) if interval seconds have passed since
+ * the previous time it returned 1 or since the opening of the spool: the
+ * caller then queries the batch system for the jobs without a marker (jobs
+ * killed before the end of their script).
+ */
+int cspool_check_due(cspool *spool, double interval);
+
+/*
+ * Write the marker TOKEN into the spool directory. With publish=0 the
+ * marker is written to the hidden file .TOKEN, to be renamed by the job at
+ * the end of its script.
+ */
+int cspool_write_record(const char *dir, const char *token, int status,
+                        double runtime, double maxrss, int publish);
+
+/*
+ * Parse the content of a marker
+ */
+int cspool_parse_record(const char *text, cspool_record *record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_SPOOL_H */
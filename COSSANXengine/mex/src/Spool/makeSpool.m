@@ -0,0 +1,39 @@
+% Script to generate the mex file of the completion spool of the JobManager
+% (see cossan_spool.h) and the program spoolrun, used in the job scripts to
+% write the completion markers with runtime and peak memory. Available on
+% POSIX systems only (inotify on Linux).
+
+disp('Compiling the spool mex files ..');
+
+assert(~isempty(OpenCossan.getCossanRoot),'openCOSSAN:makeSpool','Please initialize OpenCossan')
+
+% mex of the spool (JobManagerInterface.getJobStatus)
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" spoolx.c cossan_spool.c
+
+% List of created mex files
+r=dir('*.mex*');
+
+Spath=fullfile(OpenCossan.getCossanRoot,'mex','bin');
+
+
+for n=1:length(r)
+    % Move the compiled file in the appropriate folder
+    [status,message,messageid]=movefile(r(n).name,Spath,'f');
+    
+    if status
+        disp(['MEX FILE ' r(n).name ' created and moved in ' Spath ]);
+    else
+        disp(message);
+        disp(messageid);
+    end
+end
+
+% spoolrun is executed on the machines of the batch system: it must be
+% compiled for them (the mex/bin folder is shared by the cluster nodes)
+[status,message]=system(['gcc -std=c99 -D_GNU_SOURCE -O2 spoolrun.c cossan_spool.c -o ' ...
+    fullfile(Spath,'spoolrun')]);
+if status==0
+    disp(['PROGRAM spoolrun created in ' Spath ]);
+else
+    disp(message);
+end
@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * spoolrun: run the solver of a job and write its completion marker
+ *
+ * Program used in the job scripts of the JobManager when the completion
+ * spool is enabled (see cossan_spool.h):
+ *
+ *   spoolrun Sspooldir Stoken command [arguments]
+ *
+ * executes the command, writes its exit status, runtime and peak resident
+ * memory to the hidden marker Sspooldir/.Stoken and exits with the exit
+ * status of the command (128+signal if the command has been killed). The
+ * job script publishes the marker at its end with
+ *
+ *   mv Sspooldir/.Stoken Sspooldir/Stoken.done
+ *
+ * Compile (see makeSpool.m):
+ *   gcc -O2 spoolrun.c cossan_spool.c -o spoolrun
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "cossan_spool.h"
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9*(double)ts.tv_nsec;
+}
+
+int main(int argc, char *argv[])
+{
+  struct rusage usage;
+  double start, maxrss;
+  int wstatus, status;
+  pid_t pid;
+
+  if (argc < 4) {
+    fprintf(stderr, "usage: spoolrun spooldir token command [arguments]\n");
+    return 2;
+  }
+
+  start = now();
+  pid = fork();
+  if (pid < 0) {
+    perror("spoolrun: fork");
+    cspool_write_record(argv[1], argv[2], 127, 0, -1, 0);
+    return 127;
+  }
+  if (pid == 0) {
+    execvp(argv[3], argv + 3);
+    perror("spoolrun: exec");
+    _exit(127);
+  }
+
+  while (wait4(pid, &wstatus, 0, &usage) < 0) {
+    if (errno != EINTR) {
+      perror("spoolrun: wait");
+      return 127;
+    }
+  }
+  if (WIFEXITED(wstatus))
+    status = WEXITSTATUS(wstatus);
+  else if (WIFSIGNALED(wstatus))
+    status = 128 + WTERMSIG(wstatus);
+  else
+    status = 1;
+#if defined(__APPLE__)
+  maxrss = (double)usage.ru_maxrss/1024; /* bytes */
+#else
+  maxrss = (double)usage.ru_maxrss;      /* kB */
+#endif
+
+  if (cspool_write_record(argv[1], argv[2], status, now() - start, maxrss, 0) !=
+      CSPOOL_SUCCESS)
+    fprintf(stderr, "spoolrun: cannot write the marker %s/.%s\n", argv[1], argv[2]);
+  return status;
+}
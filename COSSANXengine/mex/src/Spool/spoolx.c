@@ -0,0 +1,253 @@
+/*******************************************************************************
+ * spoolx: completion spool of the JobManager - matlab MEX
+ *
+ * Completion markers of the jobs in a spool directory watched with inotify
+ * (see cossan_spool.h). A spool is opened at its first use (scanned every
+ * 5 s for the markers written by other machines), or explicitly with
+ * 'open', and it is closed by 'clear' or when the mex file is cleared.
+ *
+ * usage:
+ *   spoolx('open',Sdir,Nrescan)
+ *   spoolx('expect',Sdir,SjobID,Stoken)
+ *   spoolx('forget',Sdir,CSjobID)
+ *   [Vstate,Vstatus,Vruntime,Vmaxrss,Lcheck] = spoolx('status',Sdir,CSjobID,Ncheck)
+ *   Nready = spoolx('wait',Sdir,Ntimeout)
+ *   spoolx('clear')
+ * where
+ *   Sdir     : spool directory (it must exist)
+ *   Nrescan  : interval of the scans of the directory [s]
+ *   SjobID   : identifier of the job given by the batch system
+ *   Stoken   : name of the marker of the job (Stoken.done)
+ *   Vstate   : -1 job not registered, 0 no marker yet, 1 completed
+ *   Vstatus  : exit status of the completed jobs
+ *   Vruntime : runtime of the completed jobs [s]
+ *   Vmaxrss  : peak resident memory of the completed jobs [kB] (-1 unknown)
+ *   Lcheck   : true every Ncheck seconds (the batch system must be queried
+ *              for the jobs without marker)
+ *   Nready   : number of completed jobs not yet returned by 'status'
+ *              ('wait' returns as soon as it is positive)
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+#include "cossan_spool.h"
+
+#define NRESCAN 5.0 /* default scan interval [s] */
+
+typedef struct spool_node {
+    cspool *spool;
+    struct spool_node *next;
+} spool_node;
+
+static spool_node *spools = NULL;
+
+static void clear_spools(void)
+{
+    spool_node *node;
+
+    while (spools != NULL) {
+        node = spools;
+        spools = node->next;
+        cspool_close(node->spool);
+        free(node);
+    }
+}
+
+static void check_rc(int rc)
+{
+    switch (rc) {
+    case CSPOOL_FILE_ERROR:
+        mexErrMsgIdAndTxt("openCOSSAN:spoolx:fileError", "Cannot read the spool directory");
+        break;
+    case CSPOOL_OUT_OF_MEMORY:
+        mexErrMsgIdAndTxt("openCOSSAN:spoolx", "Out of memory");
+        break;
+    case CSPOOL_INVALID:
+        mexErrMsgIdAndTxt("openCOSSAN:spoolx", "Invalid arguments or unsupported system");
+        break;
+    }
+}
+
+static char *get_string(int nrhs, const mxArray *prhs[], int k)
+{
+    if (nrhs <= k || !mxIsChar(prhs[k]) || mxIsEmpty(prhs[k]))
+        mexErrMsgIdAndTxt("openCOSSAN:spoolx", "Argument %d must be a string", k+1);
+    return mxArrayToString(prhs[k]);
+}
+
+static double get_scalar(int nrhs, const mxArray *prhs[], int k, double value)
+{
+    if (nrhs <= k || mxIsEmpty(prhs[k]))
+        return value;
+    if (!mxIsNumeric(prhs[k]) || mxGetNumberOfElements(prhs[k]) != 1)
+        mexErrMsgIdAndTxt("openCOSSAN:spoolx", "Argument %d must be a scalar", k+1);
+    return mxGetScalar(prhs[k]);
+}
+
+/* spool of the directory, opened with rescan if necessary */
+static cspool *get_spool(const char *dir, double rescan, int create)
+{
+    spool_node *node;
+    int rc;
+
+    for (node = spools; node != NULL; node = node->next)
+        if (strcmp(cspool_directory(node->spool), dir) == 0)
+            return node->spool;
+    if (!create)
+        return NULL;
+
+    node = malloc(sizeof(spool_node));
+    if (node == NULL)
+        check_rc(CSPOOL_OUT_OF_MEMORY);
+    if ((rc = cspool_open(dir, rescan, &node->spool)) != CSPOOL_SUCCESS) {
+        free(node);
+        if (rc == CSPOOL_FILE_ERROR)
+            mexErrMsgIdAndTxt("openCOSSAN:spoolx:fileError",
+                "The spool directory %s does not exist", dir);
+        check_rc(rc);
+    }
+    node->next = spools;
+    spools = node;
+    return node->spool;
+}
+
+/* job identifiers: string or cell array of strings */
+static mwSize number_of_ids(const mxArray *CSid)
+{
+    if (mxIsChar(CSid))
+        return 1;
+    if (!mxIsCell(CSid))
+        mexErrMsgIdAndTxt("openCOSSAN:spoolx", "The job identifiers must be a cell array of strings");
+    return mxGetNumberOfElements(CSid);
+}
+
+static char *get_id(const mxArray *CSid, mwSize k)
+{
+    const mxArray *Sid = mxIsChar(CSid) ? CSid : mxGetCell(CSid, k);
+
+    if (Sid == NULL || !mxIsChar(Sid))
+        return NULL;
+    return mxArrayToString(Sid);
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    char Saction[16];
+    char *Sdir, *Sid, *Stoken;
+    cspool *spool;
+    cspool_record record;
+    double *Vout[4]; /* state, status, runtime and maxrss */
+    double Ncheck;
+    mwSize k, n;
+    int i, Lcheck;
+
+    mexAtExit(clear_spools);
+
+    if (nrhs < 1 || !mxIsChar(prhs[0]) || mxGetString(prhs[0], Saction, sizeof(Saction)) != 0)
+        mexErrMsgTxt("usage: spoolx(Saction,...) ; (open, expect, forget, status, wait or clear)");
+
+    if (strcmp(Saction, "clear") == 0) {
+        clear_spools();
+        return;
+    }
+
+    Sdir = get_string(nrhs, prhs, 1);
+
+    if (strcmp(Saction, "open") == 0) {
+        if (get_spool(Sdir, 0, 0) == NULL)
+            get_spool(Sdir, get_scalar(nrhs, prhs, 2, NRESCAN), 1);
+
+    } else if (strcmp(Saction, "expect") == 0) {
+        if (nrhs != 4 || nlhs > 0)
+            mexErrMsgTxt("usage: spoolx('expect',Sdir,SjobID,Stoken) ;");
+        spool = get_spool(Sdir, NRESCAN, 1);
+        Sid = get_string(nrhs, prhs, 2);
+        Stoken = get_string(nrhs, prhs, 3);
+        check_rc(cspool_expect(spool, Sid, Stoken));
+        mxFree(Sid);
+        mxFree(Stoken);
+
+    } else if (strcmp(Saction, "forget") == 0) {
+        if (nrhs != 3 || nlhs > 0)
+            mexErrMsgTxt("usage: spoolx('forget',Sdir,CSjobID) ;");
+        spool = get_spool(Sdir, NRESCAN, 0);
+        n = number_of_ids(prhs[2]);
+        for (k=0; spool != NULL && k<n; k++) {
+            if ((Sid = get_id(prhs[2], k)) != NULL) {
+                cspool_forget(spool, Sid);
+                mxFree(Sid);
+            }
+        }
+
+    } else if (strcmp(Saction, "status") == 0) {
+        if (nrhs < 3 || nrhs > 4 || nlhs > 5)
+            mexErrMsgTxt("usage: [Vstate,Vstatus,Vruntime,Vmaxrss,Lcheck] = spoolx('status',Sdir,CSjobID,Ncheck) ;");
+        spool = get_spool(Sdir, NRESCAN, 1);
+        Ncheck = get_scalar(nrhs, prhs, 3, mxGetInf());
+        n = number_of_ids(prhs[2]);
+        check_rc(cspool_drain(spool) < 0 ? CSPOOL_FILE_ERROR : CSPOOL_SUCCESS);
+        for (i=0; i<4; i++) {
+            Vout[i] = NULL;
+            if (i == 0 || i < nlhs) {
+                plhs[i] = mxCreateDoubleMatrix(n, 1, mxREAL);
+                Vout[i] = mxGetPr(plhs[i]);
+            }
+        }
+        for (k=0; k<n; k++) {
+            record.state = CSPOOL_UNKNOWN;
+            record.status = 0;
+            record.runtime = 0;
+            record.maxrss = -1;
+            if ((Sid = get_id(prhs[2], k)) != NULL) {
+                cspool_status(spool, Sid, &record);
+                mxFree(Sid);
+            }
+            Vout[0][k] = record.state;
+            if (Vout[1] != NULL) Vout[1][k] = record.status;
+            if (Vout[2] != NULL) Vout[2][k] = record.runtime;
+            if (Vout[3] != NULL) Vout[3][k] = record.maxrss;
+        }
+        Lcheck = cspool_check_due(spool, Ncheck);
+        if (nlhs > 4)
+            plhs[4] = mxCreateLogicalScalar(Lcheck);
+
+    } else if (strcmp(Saction, "wait") == 0) {
+        int rc;
+        if (nrhs != 3 || nlhs > 1)
+            mexErrMsgTxt("usage: Nready = spoolx('wait',Sdir,Ntimeout) ;");
+        spool = get_spool(Sdir, NRESCAN, 1);
+        rc = cspool_wait(spool, get_scalar(nrhs, prhs, 2, 0));
+        check_rc(rc);
+        plhs[0] = mxCreateDoubleScalar(rc < 0 ? 0 : rc);
+
+    } else
+        mexErrMsgIdAndTxt("openCOSSAN:spoolx", "Unknown action %s", Saction);
+
+    mxFree(Sdir);
+}
@@ -0,0 +1,243 @@
+/*******************************************************************************
+ * cossan_stage.c: staging of the files of the working directories
+ *
+ * The copy-on-write clones use the FICLONE ioctl on Linux and clonefile on
+ * macOS. The full copy uses copy_file_range when available (the data is
+ * not transferred through user space) and read/write otherwise.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "cossan_stage.h"
+
+#if !defined(_WIN32)
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#if defined(__linux__)
+#include <sys/ioctl.h>
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
+#if defined(__APPLE__)
+#include <sys/clonefile.h>
+#endif
+
+#define STAGE_BUFFER (1<<20)
+
+/* create the parent folders of path */
+static int make_parents(const char *path)
+{
+  char *p, *s;
+  size_t n = strlen(path);
+
+  if ((s = (char *)malloc(n+1)) == NULL) return -1;
+  memcpy(s, path, n+1);
+  for (p=s+1; *p; p++) {
+    if (*p != '/') continue;
+    *p = '\0';
+    if (mkdir(s, 0777) != 0 && errno != EEXIST) { free(s); return -1; }
+    *p = '/';
+  }
+  free(s);
+  return 0;
+}
+
+static int copy_data(int in, int out, off_t size)
+{
+  char *buf;
+  ssize_t nr, nw, k;
+
+#if defined(__linux__) && defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+  while (size > 0) {
+    nw = copy_file_range(in, NULL, out, NULL, (size_t)size, 0);
+    if (nw <= 0) break;
+    size -= nw;
+  }
+  if (size == 0) return 0;
+  /* not supported by the file system: continue with read/write */
+#else
+  (void)size;
+#endif
+  if ((buf = (char *)malloc(STAGE_BUFFER)) == NULL) return -1;
+  while ((nr = read(in, buf, STAGE_BUFFER)) != 0) {
+    if (nr < 0) {
+      if (errno == EINTR) continue;
+      free(buf);
+      return -1;
+    }
+    for (k=0; k<nr; k+=nw) {
+      if ((nw = write(out, buf+k, nr-k)) < 0) {
+        if (errno == EINTR) { nw = 0; continue; }
+        free(buf);
+        return -1;
+      }
+    }
+  }
+  free(buf);
+  return 0;
+}
+
+/* reflink (if allowed) or copy of a regular file */
+static int clone_or_copy(const char *src, const char *dst, int reflink)
+{
+  struct stat st;
+  int in, out, rc = -1, method = STAGE_COPY;
+
+#if defined(__APPLE__)
+  if (reflink && clonefile(src, dst, 0) == 0) return STAGE_REFLINK;
+#endif
+  if ((in = open(src, O_RDONLY)) < 0) return -1;
+  if (fstat(in, &st) != 0 ||
+      (out = open(dst, O_WRONLY|O_CREAT|O_TRUNC, st.st_mode & 07777)) < 0) {
+    close(in);
+    return -1;
+  }
+#if defined(__linux__)
+  if (reflink && ioctl(out, FICLONE, in) == 0) {
+    method = STAGE_REFLINK;
+    rc = 0;
+  }
+#endif
+  if (rc != 0) rc = copy_data(in, out, st.st_size);
+  close(in);
+  if (close(out) != 0) rc = -1;
+  return rc == 0 ? method : -1;
+}
+
+static int stage(const char *src, const char *dst, int mode);
+
+static int stage_file(const char *src, const char *dst, int mode)
+{
+  char *abs;
+  int rc;
+
+  switch (mode) {
+  case STAGE_SYMLINK:
+    /* absolute target: the working directory is elsewhere */
+    if ((abs = realpath(src, NULL)) == NULL) return -1;
+    rc = symlink(abs, dst);
+    free(abs);
+    if (rc == 0) return STAGE_SYMLINK;
+    return stage(src, dst, STAGE_REFLINK);
+  case STAGE_HARDLINK:
+    if (link(src, dst) == 0) return STAGE_HARDLINK;
+    /* e.g. EXDEV (different file systems), EPERM, EMLINK */
+    return clone_or_copy(src, dst, 1);
+  case STAGE_REFLINK:
+    return clone_or_copy(src, dst, 1);
+  default:
+    return clone_or_copy(src, dst, 0);
+  }
+}
+
+static char *join(const char *a, const char *b)
+{
+  size_t na = strlen(a), nb = strlen(b);
+  char *s = (char *)malloc(na+nb+2);
+  if (s == NULL) return NULL;
+  memcpy(s, a, na);
+  s[na] = '/';
+  memcpy(s+na+1, b, nb+1);
+  return s;
+}
+
+static int stage(const char *src, const char *dst, int mode)
+{
+  struct stat st, sd;
+  struct dirent *e;
+  DIR *d;
+  char *s, *t;
+  int rc = mode;
+
+  if (stat(src, &st) != 0) return -1;
+
+  if (S_ISDIR(st.st_mode) && mode != STAGE_SYMLINK) {
+    if (mkdir(dst, st.st_mode & 07777) != 0 && errno != EEXIST) return -1;
+    if ((d = opendir(src)) == NULL) return -1;
+    while ((e = readdir(d)) != NULL) {
+      if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0) continue;
+      s = join(src, e->d_name);
+      t = join(dst, e->d_name);
+      rc = (s && t) ? stage(s, t, mode) : -1;
+      free(s); free(t);
+      if (rc < 0) break;
+    }
+    closedir(d);
+    return rc;
+  }
+
+  /* replace the destination (never write through an existing link) */
+  if (lstat(dst, &sd) == 0) {
+    if (S_ISDIR(sd.st_mode)) { errno = EISDIR; return -1; }
+    if (unlink(dst) != 0) return -1;
+  }
+  return stage_file(src, dst, mode);
+}
+
+int cossan_stage(const char *src, const char *dst, int mode)
+{
+  if (src == NULL || dst == NULL || mode < STAGE_COPY || mode > STAGE_SYMLINK) {
+    errno = EINVAL;
+    return -1;
+  }
+  if (make_parents(dst) != 0) return -1;
+  return stage(src, dst, mode);
+}
+
+#else /* _WIN32 */
+
+int cossan_stage(const char *src, const char *dst, int mode)
+{
+  (void)src; (void)dst; (void)mode;
+  errno = ENOSYS;
+  return -1;
+}
+
+#endif
+
+static const char *stage_names[] = {"copy", "hardlink", "reflink", "symlink"};
+
+const char *cossan_stage_name(int mode)
+{
+  return mode >= STAGE_COPY && mode <= STAGE_SYMLINK ? stage_names[mode] : "unknown";
+}
+
+int cossan_stage_mode(const char *name)
+{
+  int k;
+  for (k=STAGE_COPY; k<=STAGE_SYMLINK; k++)
+    if (strcmp(name, stage_names[k]) == 0) return k;
+  return -1;
+}
@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * cossan_stage.h: staging of the files of the working directories
+ *
+ * The files of a simulation (main input file, additional files) are placed
+ * in the working directory with the cheapest method allowed:
+ *
+ *   STAGE_SYMLINK : symbolic link to the original file (read-only assets)
+ *   STAGE_HARDLINK: hard link (the file is shared, it must not be modified)
+ *   STAGE_REFLINK : copy-on-write clone (btrfs, XFS, APFS), safe to modify
+ *   STAGE_COPY    : full copy
+ *
+ * When a method is not available (e.g. hard links between different file
+ * systems) the next one in the list is used. Directories are staged
+ * recursively.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _COSSAN_STAGE_H
+#define _COSSAN_STAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum cossan_stage_mode {
+  STAGE_COPY = 0,
+  STAGE_HARDLINK = 1,
+  STAGE_REFLINK = 2,
+  STAGE_SYMLINK = 3
+};
+
+/*
+ * Stage the file (or directory) src in dst. The parent folders of dst are
+ * created and an existing dst is replaced. Returns the method used (for a
+ * directory the method of its last file) or -1 on error (errno is set).
+ */
+extern int cossan_stage(const char *src, const char *dst, int mode);
+
+/* name of the method ("copy", "hardlink", "reflink" or "symlink") */
+extern const char *cossan_stage_name(int mode);
+
+/* method from its name, -1 if unknown */
+extern int cossan_stage_mode(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_STAGE_H */
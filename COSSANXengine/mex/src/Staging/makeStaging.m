@@ -0,0 +1,27 @@
+% Script to generate the mex file used to stage the working directories.
+% The files are linked or cloned instead of copied (see cossan_stage.c).
+
+disp('Compiling the staging mex files ..');
+
+assert(~isempty(OpenCossan.getCossanRoot),'openCOSSAN:makeStaging','Please initialize OpenCossan')
+
+% mex for the staging of the files (Connector.copyFiles)
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" stagex.c cossan_stage.c
+
+% List of created mex files
+r=dir('*.mex*');
+
+Spath=fullfile(OpenCossan.getCossanRoot,'mex','bin');
+
+
+for n=1:length(r)
+    % Move the compiled file in the appropriate folder
+    [status,message,messageid]=movefile(r(n).name,Spath,'f');
+    
+    if status
+        disp(['MEX FILE ' r(n).name ' created and moved in ' Spath ]);
+    else
+        disp(message);
+        disp(messageid);
+    end
+end
@@ -0,0 +1,83 @@
+/*******************************************************************************
+ * stagex: staging of the files of the working directories - matlab MEX
+ *
+ * Place the files in the working directory with links or copy-on-write
+ * clones instead of full copies (see cossan_stage.c).
+ *
+ * usage:
+ *   CSmethods = stagex(CSsources,CSdestinations,Smode)
+ * where
+ *   CSsources      : cell array of files or folders to be staged
+ *   CSdestinations : cell array of destinations (full names)
+ *   Smode          : 'copy', 'reflink', 'hardlink' or 'symlink'
+ *
+ *   CSmethods      : method actually used for each file (the cheaper
+ *                    methods fall back to reflink and then to copy)
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <string.h>
+#include <errno.h>
+#include "mex.h"
+#include "cossan_stage.h"
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    char Smode[16], *src, *dst;
+    const mxArray *c;
+    mwSize n, i;
+    int mode, rc;
+
+    /* check input arguments */
+    if (nlhs > 1 || nrhs != 3 || !mxIsCell(prhs[0]) || !mxIsCell(prhs[1]) ||
+        !mxIsChar(prhs[2]))
+        mexErrMsgTxt("usage: CSmethods = stagex(CSsources,CSdestinations,Smode) ;");
+
+    n = mxGetNumberOfElements(prhs[0]);
+    if (mxGetNumberOfElements(prhs[1]) != n)
+        mexErrMsgIdAndTxt("openCOSSAN:stagex",
+            "CSsources and CSdestinations must have the same number of elements");
+    if (mxGetString(prhs[2], Smode, sizeof(Smode)) ||
+        (mode = cossan_stage_mode(Smode)) < 0)
+        mexErrMsgIdAndTxt("openCOSSAN:stagex",
+            "Smode must be 'copy', 'reflink', 'hardlink' or 'symlink'");
+
+    plhs[0] = mxCreateCellMatrix(n, 1);
+    for (i=0; i<n; i++) {
+        c = mxGetCell(prhs[0], i);
+        if (c == NULL || !mxIsChar(c) || mxGetCell(prhs[1], i) == NULL ||
+            !mxIsChar(mxGetCell(prhs[1], i)))
+            mexErrMsgIdAndTxt("openCOSSAN:stagex", "The file names must be strings");
+        src = mxArrayToString(c);
+        dst = mxArrayToString(mxGetCell(prhs[1], i));
+        if ((rc = cossan_stage(src, dst, mode)) < 0)
+            mexErrMsgIdAndTxt("openCOSSAN:stagex", "Cannot stage %s in %s: %s",
+                src, dst, strerror(errno));
+        mxSetCell(plhs[0], i, mxCreateString(cossan_stage_name(rc)));
+        mxFree(src);
+        mxFree(dst);
+    }
+}
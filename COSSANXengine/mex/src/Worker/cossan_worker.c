@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * cossan_worker.c: solver side of the persistent worker protocol
+ *
+ * Linked by the solver wrappers (no dependency on MATLAB). See
+ * cossan_worker.h for the protocol.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include "cossan_worker.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+int cwk_worker_fd(void)
+{
+  const char *s = getenv(CWK_FD_VARIABLE);
+  char *end;
+  long fd;
+  if (s == NULL || *s == '\0') return -1;
+  fd = strtol(s, &end, 10);
+  return (*end != '\0' || fd < 0) ? -1 : (int)fd;
+}
+
+int cwk_read(int fd, void *buffer, size_t n)
+{
+  char *p = (char *)buffer;
+  ssize_t r;
+  while (n > 0) {
+    r = read(fd, p, n);
+    if (r < 0 && errno == EINTR) continue;
+    if (r <= 0) return -1;
+    p += r;
+    n -= (size_t)r;
+  }
+  return 0;
+}
+
+int cwk_write(int fd, const void *buffer, size_t n)
+{
+  const char *p = (const char *)buffer;
+  ssize_t r;
+  while (n > 0) {
+    /* send does not raise SIGPIPE if the other end is closed */
+    r = send(fd, p, n, MSG_NOSIGNAL);
+    if (r < 0 && errno == ENOTSOCK) r = write(fd, p, n);
+    if (r < 0 && errno == EINTR) continue;
+    if (r <= 0) return -1;
+    p += r;
+    n -= (size_t)r;
+  }
+  return 0;
+}
+
+static int hello(int fd, int ninputs, const char *const *inputs,
+  int noutputs, const char *const *outputs)
+{
+  cwk_header h;
+  char *names, *p;
+  size_t n = 0;
+  int k, rc;
+
+  for (k=0; k<ninputs; k++) n += strlen(inputs[k]) + 1;
+  for (k=0; k<noutputs; k++) n += strlen(outputs[k]) + 1;
+  if ((names = (char *)malloc(n > 0 ? n : 1)) == NULL) return -1;
+  for (k=0, p=names; k<ninputs; k++) { strcpy(p, inputs[k]); p += strlen(p) + 1; }
+  for (k=0; k<noutputs; k++) { strcpy(p, outputs[k]); p += strlen(p) + 1; }
+
+  memset(&h, 0, sizeof(h));
+  h.type = CWK_HELLO;
+  h.status = CWK_VERSION;
+  h.id = CWK_MAGIC;
+  h.count = (uint32_t)n;
+  h.nvars = (uint32_t)ninputs*65536U + (uint32_t)noutputs;
+  rc = cwk_write(fd, &h, sizeof(h)) || cwk_write(fd, names, n) ? -1 : 0;
+  free(names);
+  return rc;
+}
+
+int cwk_serve(int fd, int ninputs, const char *const *inputs,
+  int noutputs, const char *const *outputs, cwk_model *model, void *user)
+{
+  cwk_header h;
+  double *x, *record;
+  uint32_t k;
+  int rc = 0;
+
+  if (fd < 0 || ninputs < 0 || ninputs > 65535 || noutputs <= 0 ||
+      noutputs > 65535)
+    return -1;
+  x = (double *)malloc((ninputs > 0 ? ninputs : 1)*sizeof(double));
+  /* header and outputs are sent with a single write */
+  record = (double *)malloc(sizeof(cwk_header) + noutputs*sizeof(double));
+  if (x == NULL || record == NULL || hello(fd, ninputs, inputs, noutputs, outputs)) {
+    free(x); free(record);
+    return -1;
+  }
+
+  for (;;) {
+    if (cwk_read(fd, &h, sizeof(h))) break; /* connection closed */
+    if (h.type == CWK_EXIT) break;
+    if (h.type != CWK_SAMPLE || h.count != (uint32_t)ninputs) { rc = -1; break; }
+    if (cwk_read(fd, x, ninputs*sizeof(double))) { rc = -1; break; }
+    {
+      cwk_header *r = (cwk_header *)record;
+      double *y = (double *)((char *)record + sizeof(cwk_header));
+      for (k=0; k<(uint32_t)noutputs; k++) y[k] = 0.0;
+      r->type = CWK_RESULT;
+      r->id = h.id;
+      r->count = (uint32_t)noutputs;
+      r->nvars = 0;
+      r->status = model(x, y, user);
+      if (cwk_write(fd, record, sizeof(cwk_header) + noutputs*sizeof(double))) {
+        rc = -1;
+        break;
+      }
+    }
+  }
+  free(x);
+  free(record);
+  return rc;
+}
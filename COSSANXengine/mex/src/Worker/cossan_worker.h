@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * cossan_worker.h: protocol of the persistent solver workers
+ *
+ * A worker is a solver wrapper that stays resident and evaluates the
+ * samples sent by the Connector on a Unix domain socket (the descriptor is
+ * passed in the environment variable COSSAN_WORKER_FD). The messages are
+ * binary records made of a cwk_header followed by count doubles (or by the
+ * names of the variables for CWK_HELLO), in the byte order of the machine:
+ *
+ *   worker -> host : CWK_HELLO   (once, ninputs/noutputs and the names)
+ *   host -> worker : CWK_SAMPLE  (id, ninputs values)
+ *   worker -> host : CWK_RESULT  (id, status, noutputs values)
+ *   host -> worker : CWK_EXIT    (the worker returns from cwk_serve)
+ *
+ * The results can be returned in any order. Solver wrappers include this
+ * header and link cossan_worker.c (see examples/Models/IshigamiFunction).
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _COSSAN_WORKER_H
+#define _COSSAN_WORKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CWK_MAGIC   0x4B575343U /* "CSWK" */
+#define CWK_VERSION 1
+
+/* environment variable with the descriptor of the socket */
+#define CWK_FD_VARIABLE "COSSAN_WORKER_FD"
+
+enum { CWK_HELLO = 1, CWK_SAMPLE = 2, CWK_RESULT = 3, CWK_EXIT = 4 };
+
+typedef struct {
+  uint32_t type;    /* CWK_* */
+  int32_t status;   /* CWK_RESULT: 0 or error code of the model;
+                       CWK_HELLO: CWK_VERSION */
+  uint64_t id;      /* identifier of the sample; CWK_HELLO: CWK_MAGIC */
+  uint32_t count;   /* number of doubles; CWK_HELLO: bytes of the names */
+  uint32_t nvars;   /* CWK_HELLO: ninputs*65536 + noutputs */
+} cwk_header;
+
+/*
+ * Model evaluated by the worker: x (ninputs) and y (noutputs). Return 0 on
+ * success; the error code is passed to the Connector and the outputs are
+ * ignored.
+ */
+typedef int cwk_model(const double *x, double *y, void *user);
+
+/* descriptor of the socket (-1 if the program is not run as a worker) */
+extern int cwk_worker_fd(void);
+
+/*
+ * Serve the requests of the Connector until CWK_EXIT or the end of the
+ * connection. Returns 0 or -1 on errors of the connection.
+ */
+extern int cwk_serve(int fd, int ninputs, const char *const *inputs,
+  int noutputs, const char *const *outputs, cwk_model *model, void *user);
+
+/* read/write exactly n bytes. Return 0, or -1 (error or end of file) */
+extern int cwk_read(int fd, void *buffer, size_t n);
+extern int cwk_write(int fd, const void *buffer, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_WORKER_H */
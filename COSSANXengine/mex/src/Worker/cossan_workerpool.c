@@ -0,0 +1,567 @@
+/*******************************************************************************
+ * cossan_workerpool.c: pool of persistent solver workers
+ *
+ * The workers are started with posix_spawn through the shell, in a new
+ * process group and with the socket on the descriptor 3. The samples are
+ * written as soon as a worker has room for them and the results are
+ * collected with poll, so that the workers are never idle while samples
+ * are left.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include "cossan_workerpool.h"
+#include "cossan_worker.h"
+#include "cossan_pool.h"
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+extern char **environ;
+
+#define CWKP_FD 3 /* descriptor of the socket in the worker */
+
+typedef struct {
+  pid_t pid;           /* 0 if the worker is not running */
+  int fd;
+  long *inflight;      /* samples in flight (-1 free) */
+  int ninflight;
+} cwkp_worker;
+
+struct cwkp_pool {
+  char *command;
+  cwkp_options options;
+  char *folder, *logfile, *shell;
+  cwkp_worker *workers;
+  int ninputs, noutputs;
+  char *names;                  /* names announced by the first worker */
+  const char **inputs, **outputs;
+};
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9*(double)ts.tv_nsec;
+}
+
+static char *duplicate(const char *s)
+{
+  char *d;
+  if (s == NULL) return NULL;
+  if ((d = (char *)malloc(strlen(s)+1)) != NULL) strcpy(d, s);
+  return d;
+}
+
+/* environment of the worker: environ with COSSAN_WORKER_FD=3 */
+static char **worker_environment(void)
+{
+  static char variable[] = CWK_FD_VARIABLE "=3";
+  size_t n = 0, k, m = 0, lv = strlen(CWK_FD_VARIABLE);
+  char **env;
+  while (environ[n] != NULL) n++;
+  if ((env = (char **)malloc((n+2)*sizeof(char *))) == NULL) return NULL;
+  for (k=0; k<n; k++)
+    if (strncmp(environ[k], CWK_FD_VARIABLE, lv) != 0 || environ[k][lv] != '=')
+      env[m++] = environ[k];
+  env[m++] = variable;
+  env[m] = NULL;
+  return env;
+}
+
+static void terminate(cwkp_worker *w)
+{
+  if (w->fd >= 0) close(w->fd);
+  if (w->pid > 0) {
+    kill(-w->pid, SIGKILL);
+    while (waitpid(w->pid, NULL, 0) < 0 && errno == EINTR) ;
+  }
+  w->fd = -1;
+  w->pid = 0;
+  w->ninflight = 0;
+}
+
+/* read the hello of a worker. Returns the names or NULL */
+static char *read_hello(cwkp_worker *w, double timeout, int *ninputs,
+  int *noutputs, size_t *lnames, char *message, size_t lmessage)
+{
+  struct pollfd p;
+  cwk_header h;
+  char *names;
+  int r;
+
+  p.fd = w->fd;
+  p.events = POLLIN;
+  do {
+    r = poll(&p, 1, timeout > 0 ? (int)(timeout*1000) : -1);
+  } while (r < 0 && errno == EINTR);
+  if (r == 0) {
+    snprintf(message, lmessage, "The worker did not start within %g s", timeout);
+    return NULL;
+  }
+  if (r < 0 || cwk_read(w->fd, &h, sizeof(h))) {
+    snprintf(message, lmessage, "The worker terminated before the handshake "
+      "(see the log file)");
+    return NULL;
+  }
+  if (h.type != CWK_HELLO || h.id != CWK_MAGIC || h.status != CWK_VERSION ||
+      h.count > 1048576) {
+    snprintf(message, lmessage, "The program is not a worker of version %d",
+      CWK_VERSION);
+    return NULL;
+  }
+  if ((names = (char *)malloc(h.count + 1)) == NULL ||
+      cwk_read(w->fd, names, h.count)) {
+    free(names);
+    snprintf(message, lmessage, "The worker terminated during the handshake");
+    return NULL;
+  }
+  names[h.count] = '\0';
+  *ninputs = (int)(h.nvars/65536U);
+  *noutputs = (int)(h.nvars%65536U);
+  *lnames = h.count;
+  return names;
+}
+
+static int spawn_worker(cwkp_pool *pool, cwkp_worker *w, char *message,
+  size_t lmessage)
+{
+  posix_spawn_file_actions_t actions;
+  posix_spawnattr_t attr;
+  sigset_t sigdefault;
+  char *script, **env, *argv[4], *names;
+  int sv[2], child, rc, ninputs, noutputs;
+  size_t lnames;
+  pid_t pid;
+
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+    snprintf(message, lmessage, "socketpair: %s", strerror(errno));
+    return CWKP_START_ERROR;
+  }
+  fcntl(sv[0], F_SETFD, FD_CLOEXEC);
+  /* the end of the worker must not collide with the descriptor 3 */
+  if ((child = fcntl(sv[1], F_DUPFD, 10)) < 0) child = sv[1];
+  else close(sv[1]);
+
+  script = (char *)malloc(strlen(pool->command) + 6);
+  if (script != NULL) {
+    strcpy(script, "exec ");
+    strcat(script, pool->command);
+  }
+  argv[0] = pool->shell;
+  argv[1] = (char *)"-c";
+  argv[2] = script != NULL ? cossan_pool_shell_command(pool->folder, script) : NULL;
+  argv[3] = NULL;
+  env = worker_environment();
+  if (script == NULL || argv[2] == NULL || env == NULL) {
+    free(script); free(argv[2]); free(env);
+    close(sv[0]); close(child);
+    snprintf(message, lmessage, "Out of memory");
+    return CWKP_OUT_OF_MEMORY;
+  }
+
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+  posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO,
+    pool->logfile != NULL ? pool->logfile : "/dev/null",
+    O_WRONLY|O_CREAT|O_APPEND, 0644);
+  posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, child, CWKP_FD);
+  posix_spawn_file_actions_addclose(&actions, child);
+
+  /* new process group (killed as a whole) and default signal handlers */
+  posix_spawnattr_init(&attr);
+  sigfillset(&sigdefault);
+  sigdelset(&sigdefault, SIGKILL);
+  sigdelset(&sigdefault, SIGSTOP);
+  posix_spawnattr_setsigdefault(&attr, &sigdefault);
+  posix_spawnattr_setpgroup(&attr, 0);
+  posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGDEF);
+
+  rc = posix_spawn(&pid, pool->shell, &actions, &attr, argv, env);
+
+  posix_spawn_file_actions_destroy(&actions);
+  posix_spawnattr_destroy(&attr);
+  free(script); free(argv[2]); free(env);
+  close(child);
+  if (rc != 0) {
+    close(sv[0]);
+    snprintf(message, lmessage, "Cannot start %s: %s", pool->command, strerror(rc));
+    return CWKP_START_ERROR;
+  }
+  w->pid = pid;
+  w->fd = sv[0];
+  w->ninflight = 0;
+
+  names = read_hello(w, pool->options.starttimeout, &ninputs, &noutputs,
+    &lnames, message, lmessage);
+  if (names == NULL) {
+    terminate(w);
+    return CWKP_START_ERROR;
+  }
+  if (pool->names == NULL) {
+    /* names announced by the first worker */
+    int k;
+    const char *p = names;
+    pool->ninputs = ninputs;
+    pool->noutputs = noutputs;
+    pool->inputs = (const char **)malloc((ninputs > 0 ? ninputs : 1)*sizeof(char *));
+    pool->outputs = (const char **)malloc((noutputs > 0 ? noutputs : 1)*sizeof(char *));
+    if (pool->inputs == NULL || pool->outputs == NULL) {
+      free(names);
+      terminate(w);
+      snprintf(message, lmessage, "Out of memory");
+      return CWKP_OUT_OF_MEMORY;
+    }
+    for (k=0; k<ninputs+noutputs; k++) {
+      if (p >= names + lnames) {
+        free(names);
+        terminate(w);
+        snprintf(message, lmessage, "Wrong names in the handshake of the worker");
+        return CWKP_PROTOCOL_ERROR;
+      }
+      if (k < ninputs) pool->inputs[k] = p; else pool->outputs[k-ninputs] = p;
+      p += strlen(p) + 1;
+    }
+    pool->names = names;
+  } else {
+    free(names);
+    if (ninputs != pool->ninputs || noutputs != pool->noutputs) {
+      terminate(w);
+      snprintf(message, lmessage, "The workers announced different variables");
+      return CWKP_PROTOCOL_ERROR;
+    }
+  }
+  return CWKP_SUCCESS;
+}
+
+void cwkp_default_options(cwkp_options *options)
+{
+  memset(options, 0, sizeof(cwkp_options));
+  options->nworkers = 1;
+  options->depth = 2;
+  options->maxrestarts = 3;
+  options->starttimeout = 60.0;
+  options->killgrace = 5.0;
+  options->folder = NULL;
+  options->logfile = NULL;
+  options->shell = "/bin/sh";
+}
+
+cwkp_pool *cwkp_start(const char *command, const cwkp_options *options,
+  int *rc, char *message, size_t lmessage)
+{
+  cwkp_pool *pool;
+  int k;
+
+  if (command == NULL || options->nworkers < 1 || options->depth < 1) {
+    snprintf(message, lmessage, "Invalid options of the workers");
+    *rc = CWKP_INVALID_ARGS;
+    return NULL;
+  }
+  if ((pool = (cwkp_pool *)calloc(1, sizeof(cwkp_pool))) == NULL) goto nomem;
+  pool->options = *options;
+  pool->command = duplicate(command);
+  pool->folder = duplicate(options->folder);
+  pool->logfile = duplicate(options->logfile);
+  pool->shell = duplicate(options->shell != NULL ? options->shell : "/bin/sh");
+  pool->workers = (cwkp_worker *)calloc(options->nworkers, sizeof(cwkp_worker));
+  if (pool->command == NULL || pool->shell == NULL || pool->workers == NULL ||
+      (options->folder != NULL && pool->folder == NULL) ||
+      (options->logfile != NULL && pool->logfile == NULL))
+    goto nomem;
+  for (k=0; k<options->nworkers; k++) {
+    pool->workers[k].fd = -1;
+    pool->workers[k].inflight = (long *)malloc(options->depth*sizeof(long));
+    if (pool->workers[k].inflight == NULL) goto nomem;
+  }
+  for (k=0; k<options->nworkers; k++) {
+    if ((*rc = spawn_worker(pool, &pool->workers[k], message, lmessage)) != CWKP_SUCCESS) {
+      cwkp_stop(pool);
+      return NULL;
+    }
+  }
+  *rc = CWKP_SUCCESS;
+  return pool;
+
+nomem:
+  cwkp_stop(pool);
+  snprintf(message, lmessage, "Out of memory");
+  *rc = CWKP_OUT_OF_MEMORY;
+  return NULL;
+}
+
+const char *const *cwkp_inputs(const cwkp_pool *pool, int *ninputs)
+{
+  *ninputs = pool->ninputs;
+  return pool->inputs;
+}
+
+const char *const *cwkp_outputs(const cwkp_pool *pool, int *noutputs)
+{
+  *noutputs = pool->noutputs;
+  return pool->outputs;
+}
+
+static void set_failed(const cwkp_pool *pool, long n, long i, double *y,
+  int *status, int code)
+{
+  int k;
+  for (k=0; k<pool->noutputs; k++) y[k*n+i] = NAN;
+  status[i] = code;
+}
+
+/* the samples in flight are lost; the worker is restarted if allowed */
+static void worker_lost(cwkp_pool *pool, cwkp_worker *w, long n, double *y,
+  int *status, long *ndone, int *nrestarts, int restart)
+{
+  char message[256];
+  int k;
+  for (k=0; k<pool->options.depth; k++) {
+    if (w->inflight[k] >= 0) {
+      set_failed(pool, n, w->inflight[k], y, status, CWKP_SAMPLE_LOST);
+      w->inflight[k] = -1;
+      (*ndone)++;
+    }
+  }
+  terminate(w);
+  if (restart && *nrestarts < pool->options.maxrestarts) {
+    (*nrestarts)++;
+    spawn_worker(pool, w, message, sizeof(message));
+  }
+}
+
+int cwkp_evaluate(cwkp_pool *pool, long n, const double *x, double *y,
+  int *status, char *message, size_t lmessage)
+{
+  const int depth = pool->options.depth, nworkers = pool->options.nworkers;
+  struct pollfd *fds;
+  int *index, nfds, k, j, r, nrestarts = 0, nalive;
+  long next = 0, ndone = 0, i;
+  size_t lrecord;
+  char *record;
+  cwk_header h, *hs;
+  double *v;
+
+  lrecord = sizeof(cwk_header) + (pool->ninputs > pool->noutputs ?
+    pool->ninputs : pool->noutputs)*sizeof(double);
+  record = (char *)malloc(lrecord);
+  fds = (struct pollfd *)malloc(nworkers*sizeof(struct pollfd));
+  index = (int *)malloc(nworkers*sizeof(int));
+  if (record == NULL || fds == NULL || index == NULL) {
+    free(record); free(fds); free(index);
+    snprintf(message, lmessage, "Out of memory");
+    return CWKP_OUT_OF_MEMORY;
+  }
+  hs = (cwk_header *)record;
+  v = (double *)(record + sizeof(cwk_header));
+  for (k=0; k<nworkers; k++) {
+    pool->workers[k].ninflight = 0;
+    for (j=0; j<depth; j++) pool->workers[k].inflight[j] = -1;
+  }
+
+  while (ndone < n) {
+    /* send the samples to the workers with room */
+    nalive = 0;
+    for (k=0; k<nworkers; k++) {
+      cwkp_worker *w = &pool->workers[k];
+      if (w->pid == 0 && next < n && nrestarts < pool->options.maxrestarts) {
+        nrestarts++;
+        spawn_worker(pool, w, message, lmessage);
+      }
+      if (w->pid == 0) continue;
+      nalive++;
+      while (w->ninflight < depth && next < n) {
+        memset(hs, 0, sizeof(cwk_header));
+        hs->type = CWK_SAMPLE;
+        hs->id = (uint64_t)next;
+        hs->count = (uint32_t)pool->ninputs;
+        for (j=0; j<pool->ninputs; j++) v[j] = x[j*n+next];
+        for (j=0; j<depth && w->inflight[j] >= 0; j++) ;
+        w->inflight[j] = next++;
+        w->ninflight++;
+        if (cwk_write(w->fd, record, sizeof(cwk_header) + pool->ninputs*sizeof(double))) {
+          worker_lost(pool, w, n, y, status, &ndone, &nrestarts, next < n);
+          break;
+        }
+      }
+    }
+    if (nalive == 0) {
+      /* no worker left: the remaining samples are lost */
+      for (i=next; i<n; i++) set_failed(pool, n, i, y, status, CWKP_SAMPLE_LOST);
+      free(record); free(fds); free(index);
+      snprintf(message, lmessage, "All the workers terminated (%d restarts)", nrestarts);
+      return CWKP_NO_WORKERS;
+    }
+    if (ndone >= n) break;
+
+    /* wait for the results */
+    for (k=0, nfds=0; k<nworkers; k++) {
+      if (pool->workers[k].pid > 0 && pool->workers[k].ninflight > 0) {
+        fds[nfds].fd = pool->workers[k].fd;
+        fds[nfds].events = POLLIN;
+        fds[nfds].revents = 0;
+        index[nfds++] = k;
+      }
+    }
+    if (nfds == 0) continue;
+    do {
+      r = poll(fds, nfds, -1);
+    } while (r < 0 && errno == EINTR);
+    if (r < 0) {
+      free(record); free(fds); free(index);
+      snprintf(message, lmessage, "poll: %s", strerror(errno));
+      return CWKP_PROTOCOL_ERROR;
+    }
+    for (j=0; j<nfds; j++) {
+      cwkp_worker *w = &pool->workers[index[j]];
+      if (fds[j].revents == 0) continue;
+      if (cwk_read(w->fd, &h, sizeof(h)) || h.type != CWK_RESULT ||
+          h.count != (uint32_t)pool->noutputs ||
+          cwk_read(w->fd, v, pool->noutputs*sizeof(double))) {
+        worker_lost(pool, w, n, y, status, &ndone, &nrestarts, next < n);
+        continue;
+      }
+      for (k=0; k<depth && w->inflight[k] != (long)h.id; k++) ;
+      if (k == depth) {
+        /* result of a sample not sent to this worker */
+        worker_lost(pool, w, n, y, status, &ndone, &nrestarts, next < n);
+        continue;
+      }
+      i = w->inflight[k];
+      w->inflight[k] = -1;
+      w->ninflight--;
+      ndone++;
+      if (h.status != 0) {
+        set_failed(pool, n, i, y, status, h.status);
+      } else {
+        for (k=0; k<pool->noutputs; k++) y[k*n+i] = v[k];
+        status[i] = 0;
+      }
+    }
+  }
+  free(record); free(fds); free(index);
+  return CWKP_SUCCESS;
+}
+
+void cwkp_stop(cwkp_pool *pool)
+{
+  cwk_header h;
+  double deadline;
+  int k, nrunning;
+
+  if (pool == NULL) return;
+  if (pool->workers != NULL) {
+    memset(&h, 0, sizeof(h));
+    h.type = CWK_EXIT;
+    for (k=0; k<pool->options.nworkers; k++) {
+      if (pool->workers[k].pid > 0) {
+        cwk_write(pool->workers[k].fd, &h, sizeof(h));
+        close(pool->workers[k].fd);
+        pool->workers[k].fd = -1;
+      }
+    }
+    /* wait for the workers to exit, then kill them */
+    deadline = now() + pool->options.killgrace;
+    do {
+      for (k=0, nrunning=0; k<pool->options.nworkers; k++) {
+        if (pool->workers[k].pid > 0) {
+          if (waitpid(pool->workers[k].pid, NULL, WNOHANG) == pool->workers[k].pid)
+            pool->workers[k].pid = 0;
+          else
+            nrunning++;
+        }
+      }
+      if (nrunning > 0) {
+        struct timespec ts = {0, 10000000};
+        nanosleep(&ts, NULL);
+      }
+    } while (nrunning > 0 && now() < deadline);
+    for (k=0; k<pool->options.nworkers; k++) {
+      terminate(&pool->workers[k]);
+      free(pool->workers[k].inflight);
+    }
+  }
+  free(pool->workers);
+  free(pool->command); free(pool->folder); free(pool->logfile); free(pool->shell);
+  free(pool->names); free(pool->inputs); free(pool->outputs);
+  free(pool);
+}
+
+#else /* _WIN32 */
+
+struct cwkp_pool { int unused; };
+
+void cwkp_default_options(cwkp_options *options)
+{
+  memset(options, 0, sizeof(cwkp_options));
+}
+
+cwkp_pool *cwkp_start(const char *command, const cwkp_options *options,
+  int *rc, char *message, size_t lmessage)
+{
+  (void)command; (void)options;
+  snprintf(message, lmessage, "The persistent workers are available on POSIX systems only");
+  *rc = CWKP_INVALID_ARGS;
+  return NULL;
+}
+
+const char *const *cwkp_inputs(const cwkp_pool *pool, int *ninputs)
+{
+  (void)pool; *ninputs = 0; return NULL;
+}
+
+const char *const *cwkp_outputs(const cwkp_pool *pool, int *noutputs)
+{
+  (void)pool; *noutputs = 0; return NULL;
+}
+
+int cwkp_evaluate(cwkp_pool *pool, long n, const double *x, double *y,
+  int *status, char *message, size_t lmessage)
+{
+  (void)pool; (void)n; (void)x; (void)y; (void)status;
+  snprintf(message, lmessage, "The persistent workers are available on POSIX systems only");
+  return CWKP_INVALID_ARGS;
+}
+
+void cwkp_stop(cwkp_pool *pool)
+{
+  (void)pool;
+}
+
+#endif
@@ -0,0 +1,99 @@
+/*******************************************************************************
+ * cossan_workerpool.h: pool of persistent solver workers
+ *
+ * The pool starts nworkers copies of a solver wrapper, each connected to the
+ * MATLAB process by a Unix domain socket (see cossan_worker.h), and streams
+ * the samples to them keeping up to depth samples in flight per worker. The
+ * workers stay resident between calls of cwkp_evaluate. A worker that
+ * terminates is restarted; its samples in flight are reported as lost.
+ *
+ * The pool is available on POSIX systems only.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#ifndef _COSSAN_WORKERPOOL_H
+#define _COSSAN_WORKERPOOL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Possible return values of the functions
+ */
+typedef enum {
+  CWKP_NO_WORKERS     = -5, /* all the workers terminated */
+  CWKP_PROTOCOL_ERROR = -4, /* unexpected message from a worker */
+  CWKP_START_ERROR    = -3, /* the workers cannot be started */
+  CWKP_OUT_OF_MEMORY  = -2, /* memory allocation failed */
+  CWKP_INVALID_ARGS   = -1, /* inconsistent options (or not POSIX) */
+  CWKP_SUCCESS        =  0
+} cwkp_result;
+
+/* status of a sample whose worker terminated before the result */
+#define CWKP_SAMPLE_LOST (-1000000)
+
+typedef struct {
+  int nworkers;          /* number of workers */
+  int depth;             /* samples in flight per worker */
+  int maxrestarts;       /* restarts of the workers per call of cwkp_evaluate */
+  double starttimeout;   /* time allowed to a worker to say hello [s] */
+  double killgrace;      /* time allowed to exit after CWK_EXIT [s] */
+  const char *folder;    /* working directory of the workers (can be NULL) */
+  const char *logfile;   /* stdout and stderr of the workers (appended) */
+  const char *shell;     /* shell used to execute the command (/bin/sh) */
+} cwkp_options;
+
+typedef struct cwkp_pool cwkp_pool;
+
+extern void cwkp_default_options(cwkp_options *options);
+
+/* start the workers. Returns NULL on error (rc and message) */
+extern cwkp_pool *cwkp_start(const char *command, const cwkp_options *options,
+  int *rc, char *message, size_t lmessage);
+
+/* names of the inputs and outputs announced by the workers */
+extern const char *const *cwkp_inputs(const cwkp_pool *pool, int *ninputs);
+extern const char *const *cwkp_outputs(const cwkp_pool *pool, int *noutputs);
+
+/*
+ * Evaluate n samples: x (n x ninputs) and y (n x noutputs) are stored
+ * column-wise. status[i] is 0, the error code returned by the model or
+ * CWKP_SAMPLE_LOST; the outputs of the failed samples are NaN.
+ */
+extern int cwkp_evaluate(cwkp_pool *pool, long n, const double *x, double *y,
+  int *status, char *message, size_t lmessage);
+
+/* ask the workers to exit (killed after killgrace) and release the pool */
+extern void cwkp_stop(cwkp_pool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _COSSAN_WORKERPOOL_H */
@@ -0,0 +1,28 @@
+% Script to generate the mex file used to drive the persistent solver
+% workers of the Connector (see cossan_worker.h). The workers are available
+% on POSIX systems only.
+
+disp('Compiling the worker mex files ..');
+
+assert(~isempty(OpenCossan.getCossanRoot),'openCOSSAN:makeWorker','Please initialize OpenCossan')
+
+% mex for the evaluation of the workers (Connector.run)
+mex CFLAGS#"-D_GNU_SOURCE -fPIC -pthread -fexceptions -D_FILE_OFFSET_BITS=64 -Wall -fPIC -O3" -I../ProcessPool workerx.c cossan_workerpool.c cossan_worker.c ../ProcessPool/cossan_pool.c
+
+% List of created mex files
+r=dir('*.mex*');
+
+Spath=fullfile(OpenCossan.getCossanRoot,'mex','bin');
+
+
+for n=1:length(r)
+    % Move the compiled file in the appropriate folder
+    [status,message,messageid]=movefile(r(n).name,Spath,'f');
+    
+    if status
+        disp(['MEX FILE ' r(n).name ' created and moved in ' Spath ]);
+    else
+        disp(message);
+        disp(messageid);
+    end
+end
@@ -0,0 +1,239 @@
+/*******************************************************************************
+ * workerx: persistent solver workers of the Connector - matlab MEX
+ *
+ * The workers (see cossan_worker.h) are started once and kept running,
+ * connected to MATLAB, until workerx('clear') is called or the mex file is
+ * cleared. Each sample is sent over the socket of a worker instead of
+ * writing an input deck and starting the solver.
+ *
+ * usage:
+ *   [CSinputs,CSoutputs] = workerx('info',Scommand,Sfolder)
+ *   [Moutput,Vstatus] = workerx(Scommand,Minput,Nworkers,Sfolder,Slogfile)
+ *   workerx('clear')
+ * where
+ *   Scommand  : command starting the worker (executed by /bin/sh)
+ *   Sfolder   : working directory of the workers (optional)
+ *   Nworkers  : number of workers (default 1)
+ *   Slogfile  : file collecting stdout and stderr of the workers (optional)
+ *   Minput    : inputs of the model (Nsamples x Ninputs, in the order of
+ *               CSinputs)
+ *
+ *   CSinputs  : names of the inputs announced by the worker
+ *   CSoutputs : names of the outputs announced by the worker
+ *   Moutput   : outputs of the model (Nsamples x Noutputs); NaN for the
+ *               failed samples
+ *   Vstatus   : 0, error code returned by the model or -1000000 if the
+ *               worker terminated during the evaluation (Nsamples x 1)
+ *
+ * The pools are cached by command, folder and number of workers and they
+ * are started by the first evaluation. 'info' starts a single worker, not
+ * cached, that is stopped as soon as it has announced its variables.
+ *
+ * Author: Cossan Working Group
+ * Institute for Risk and Uncertainty, University of Liverpool, UK
+ * email address: openengine@cossan.co.uk
+ * Website: http://www.cossan.co.uk
+ */
+
+/*
+ * =====================================================================
+ * This file is part of openCOSSAN.  The open general purpose matlab
+ * toolbox for numerical analysis, risk and uncertainty quantification.
+ *
+ * openCOSSAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * openCOSSAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+ * =====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+#include "cossan_workerpool.h"
+
+#define NCACHE 16
+#define LMESSAGE 512
+
+typedef struct {
+    char *Scommand, *Sfolder;
+    int nworkers;
+    cwkp_pool *pool;
+} cache_entry;
+
+static cache_entry cache[NCACHE];
+static int ncache = 0;
+
+static void clear_cache(void)
+{
+    int k;
+    for (k=0; k<ncache; k++) {
+        cwkp_stop(cache[k].pool);
+        free(cache[k].Scommand);
+        free(cache[k].Sfolder);
+    }
+    ncache = 0;
+}
+
+static char *duplicate(const char *s)
+{
+    char *d = (char *)malloc(strlen(s)+1);
+    if (d != NULL) strcpy(d, s);
+    return d;
+}
+
+/* pool of the command (from the cache if already running) */
+static cwkp_pool *get_pool(const char *Scommand, const char *Sfolder,
+    int nworkers, const char *Slogfile)
+{
+    char message[LMESSAGE];
+    cwkp_options options;
+    cwkp_pool *pool;
+    int k, rc;
+
+    for (k=0; k<ncache; k++)
+        if (strcmp(cache[k].Scommand, Scommand) == 0 &&
+            strcmp(cache[k].Sfolder, Sfolder) == 0 &&
+            cache[k].nworkers == nworkers)
+            return cache[k].pool;
+
+    if (ncache == NCACHE)
+        mexErrMsgIdAndTxt("openCOSSAN:workerx",
+            "Too many pools of workers (%d). Use workerx('clear')", NCACHE);
+    cwkp_default_options(&options);
+    options.nworkers = nworkers;
+    options.folder = Sfolder[0] != '\0' ? Sfolder : NULL;
+    options.logfile = Slogfile[0] != '\0' ? Slogfile : NULL;
+    if ((pool = cwkp_start(Scommand, &options, &rc, message, LMESSAGE)) == NULL) {
+        if (rc == CWKP_OUT_OF_MEMORY)
+            mexErrMsgIdAndTxt("openCOSSAN:workerx", "Out of memory");
+        mexErrMsgIdAndTxt("openCOSSAN:workerx:startError", "%s", message);
+    }
+    cache[ncache].Scommand = duplicate(Scommand);
+    cache[ncache].Sfolder = duplicate(Sfolder);
+    if (cache[ncache].Scommand == NULL || cache[ncache].Sfolder == NULL) {
+        free(cache[ncache].Scommand);
+        free(cache[ncache].Sfolder);
+        cwkp_stop(pool);
+        mexErrMsgIdAndTxt("openCOSSAN:workerx", "Out of memory");
+    }
+    cache[ncache].nworkers = nworkers;
+    cache[ncache].pool = pool;
+    return cache[ncache++].pool;
+}
+
+static mxArray *names(int n, const char *const *Cnames)
+{
+    mxArray *C = mxCreateCellMatrix(1, n);
+    int k;
+    for (k=0; k<n; k++)
+        mxSetCell(C, k, mxCreateString(Cnames[k]));
+    return C;
+}
+
+static char *get_string(int nrhs, const mxArray *prhs[], int k, const char *Sname)
+{
+    static char Snone[] = "";
+    if (nrhs <= k || mxIsEmpty(prhs[k]))
+        return Snone;
+    if (!mxIsChar(prhs[k]))
+        mexErrMsgIdAndTxt("openCOSSAN:workerx", "%s must be a string", Sname);
+    return mxArrayToString(prhs[k]);
+}
+
+static int get_nworkers(int nrhs, const mxArray *prhs[], int k)
+{
+    int nworkers = 1;
+    if (nrhs > k && !mxIsEmpty(prhs[k]))
+        nworkers = (int)mxGetScalar(prhs[k]);
+    if (nworkers < 1)
+        mexErrMsgIdAndTxt("openCOSSAN:workerx", "Nworkers must be positive");
+    return nworkers;
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    char message[LMESSAGE], *Scommand;
+    const char *const *Cinputs, *const *Coutputs;
+    cwkp_pool *pool;
+    double *Vstatus;
+    int *status, ninputs, noutputs, rc;
+    mwSize n, i;
+
+    mexAtExit(clear_cache);
+
+    /* check input arguments */
+    if (nrhs < 1 || nrhs > 5 || !mxIsChar(prhs[0]))
+        mexErrMsgTxt("usage: [Moutput,Vstatus] = workerx(Scommand,Minput,Nworkers,Sfolder,Slogfile) ;");
+
+    Scommand = mxArrayToString(prhs[0]);
+    if (nrhs == 1 && strcmp(Scommand, "clear") == 0) {
+        mxFree(Scommand);
+        clear_cache();
+        return;
+    }
+
+    if (strcmp(Scommand, "info") == 0) {
+        cwkp_options options;
+        char *Sworker, *Sfolder;
+        if (nrhs < 2 || nrhs > 3 || !mxIsChar(prhs[1]) || nlhs > 2)
+            mexErrMsgTxt("usage: [CSinputs,CSoutputs] = workerx('info',Scommand,Sfolder) ;");
+        Sworker = mxArrayToString(prhs[1]);
+        Sfolder = get_string(nrhs, prhs, 2, "Sfolder");
+        /* handshake of one worker, stopped after the names are read */
+        cwkp_default_options(&options);
+        options.nworkers = 1;
+        options.folder = Sfolder[0] != '\0' ? Sfolder : NULL;
+        if ((pool = cwkp_start(Sworker, &options, &rc, message, LMESSAGE)) == NULL) {
+            if (rc == CWKP_OUT_OF_MEMORY)
+                mexErrMsgIdAndTxt("openCOSSAN:workerx", "Out of memory");
+            mexErrMsgIdAndTxt("openCOSSAN:workerx:startError", "%s", message);
+        }
+        Cinputs = cwkp_inputs(pool, &ninputs);
+        Coutputs = cwkp_outputs(pool, &noutputs);
+        plhs[0] = names(ninputs, Cinputs);
+        if (nlhs > 1)
+            plhs[1] = names(noutputs, Coutputs);
+        cwkp_stop(pool);
+        return;
+    }
+
+    if (nrhs < 2 || nlhs > 2 || !mxIsDouble(prhs[1]) || mxIsComplex(prhs[1]))
+        mexErrMsgTxt("usage: [Moutput,Vstatus] = workerx(Scommand,Minput,Nworkers,Sfolder,Slogfile) ;");
+    pool = get_pool(Scommand, get_string(nrhs, prhs, 3, "Sfolder"),
+        get_nworkers(nrhs, prhs, 2), get_string(nrhs, prhs, 4, "Slogfile"));
+    cwkp_inputs(pool, &ninputs);
+    cwkp_outputs(pool, &noutputs);
+
+    n = mxGetM(prhs[1]);
+    if (mxGetN(prhs[1]) != (mwSize)ninputs && n > 0)
+        mexErrMsgIdAndTxt("openCOSSAN:workerx",
+            "The worker %s requires %d inputs (Minput has %d columns)",
+            Scommand, ninputs, (int)mxGetN(prhs[1]));
+
+    plhs[0] = mxCreateDoubleMatrix(n, noutputs, mxREAL);
+    status = (int *)mxCalloc(n > 0 ? n : 1, sizeof(int));
+    rc = cwkp_evaluate(pool, (long)n, mxGetPr(prhs[1]), mxGetPr(plhs[0]),
+        status, message, LMESSAGE);
+    if (rc == CWKP_OUT_OF_MEMORY)
+        mexErrMsgIdAndTxt("openCOSSAN:workerx", "Out of memory");
+    else if (rc != CWKP_SUCCESS && rc != CWKP_NO_WORKERS)
+        mexErrMsgIdAndTxt("openCOSSAN:workerx:evaluationError", "%s", message);
+    else if (rc == CWKP_NO_WORKERS)
+        mexWarnMsgIdAndTxt("openCOSSAN:workerx:noWorkers", "%s", message);
+
+    if (nlhs > 1) {
+        plhs[1] = mxCreateDoubleMatrix(n, 1, mxREAL);
+        Vstatus = mxGetPr(plhs[1]);
+        for (i=0; i<n; i++)
+            Vstatus[i] = (double)status[i];
+    }
+    mxFree(status);
+}
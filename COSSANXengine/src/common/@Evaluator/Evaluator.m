@@ -36,11 +36,21 @@ classdef Evaluator
         CShostnames             % Names of hostnames where evaluate solvers
         CSparallelEnvironments  % Name of the parallel environment of each solver
         Vslots                  % Number of slots used in each job
+        Vmemory                 % Memory of each job [MB] (local scheduler)
         VLcompiled              % Number of slots used in each job
         Vconcurrent             % Number of concurrent execution of each solver
         LremoteInjectExtract = false %TODO: make it true
         LverticalSplit = false  % if true split the analysis in vertical components (see wiki for more details)
         Sduration = ''          % max job duration (for jobManager ) 
+        NchunkDuration = 0      % Target duration of the jobs and of the chunks of samples of LverticalSplit [s] (0: one sample)
+        NpipelineBlock = 0      % Samples per block of the pipelined execution of the solvers (0: each solver evaluates all the samples)
+        NpipelineQueue = 2      % Max number of blocks in evaluation or waiting between two solvers (pipelined execution)
+        Sjournal = ''           % Journal of the evaluated samples, used to resume an interrupted analysis (see journalx)
+        NjournalBlock = 100     % Samples evaluated between two writes of the journal
+        NmaxRetries = 0         % Number of retries of the failed samples (NaN outputs)
+        NretryDelay = 10        % Delay before the first retry [s] (doubled at each retry)
+        Scache = ''             % Cache file of the model evaluations, shared by the analyses (see cachex)
+        NcacheEntries = 262144  % Capacity of a new cache file (number of samples)
     end
     
     properties (Dependent=true)
@@ -120,6 +130,26 @@ classdef Evaluator
                         Xev.Vconcurrent=varargin{k+1};
                     case {'vslots','nslots'}
                         Xev.Vslots=varargin{k+1};
+                    case {'vmemory','nmemory'}
+                        Xev.Vmemory=varargin{k+1};
+                    case {'nchunkduration'}
+                        Xev.NchunkDuration=varargin{k+1};
+                    case {'npipelineblock'}
+                        Xev.NpipelineBlock=varargin{k+1};
+                    case {'npipelinequeue'}
+                        Xev.NpipelineQueue=varargin{k+1};
+                    case {'sjournal'}
+                        Xev.Sjournal=varargin{k+1};
+                    case {'njournalblock'}
+                        Xev.NjournalBlock=varargin{k+1};
+                    case {'nmaxretries'}
+                        Xev.NmaxRetries=varargin{k+1};
+                    case {'nretrydelay'}
+                        Xev.NretryDelay=varargin{k+1};
+                    case {'scache'}
+                        Xev.Scache=varargin{k+1};
+                    case {'ncacheentries'}
+                        Xev.NcacheEntries=varargin{k+1};
                     case 'cxmembers'
                         % The object are retrieved from the cell array
                         for iobj=1:length(varargin{k+1})
@@ -224,6 +254,21 @@ classdef Evaluator
                 Xev.Vslots=ones(size(Xev.CXsolvers));
             end
             
+            if ~isempty(Xev.Vmemory)
+                assert(length(Xev.Vmemory)==length(Xev.CXsolvers),...
+                    'openCOSSAN:Evaluator',...
+                    ['Length of Vmemory (' num2str(length(Xev.Vmemory)) ...
+                    ') must be equal to the length of CXsolvers (' ...
+                    num2str(length(Xev.CXsolvers)) ')' ])
+            else
+                Xev.Vmemory=zeros(size(Xev.CXsolvers));
+            end
+            
+            assert(Xev.NpipelineQueue>=1,'openCOSSAN:Evaluator',...
+                'NpipelineQueue must be at least 1 (current value: %i)',Xev.NpipelineQueue)
+            assert(Xev.NjournalBlock>=1,'openCOSSAN:Evaluator',...
+                'NjournalBlock must be at least 1 (current value: %i)',Xev.NjournalBlock)
+            
             % Check for unique SwrapperName in the Mio
             for n=1:length(Xev.CXsolvers)
                 if isa(Xev.CXsolvers{n},'Mio')
@@ -315,10 +360,17 @@ classdef Evaluator
         
         Xjm=getJobManager(Xobj,varargin)
         
+        Tstats=getCacheStatistics(Xobj) % Hits and misses of the cache of the evaluations
+        
     end
     
     methods (Access=protected)
         Xout=executeWorkers(Xobj,Tinput);
+        Xout=executePipeline(Xobj,Tinput);
+        Xout=executeJournal(Xobj,Tinput);
+        Xout=executeCache(Xobj,Tinput);
+        [Minputs,CSinputs,Tinput]=getInputMatrix(Xobj,Tinput);
+        Vmodel=modelDefinition(Xobj,CSinputs,CSoutputs);
     end
     
     methods (Static)
@@ -64,8 +64,25 @@ if isempty(Xobj.CXsolvers)
     return
 end
 
+if ~isempty(Xobj.Scache)
+    % samples already evaluated read from the cache
+    XSimOut=executeCache(Xobj,Tinput);
+    return
+end
+
+if ~isempty(Xobj.Sjournal) || Xobj.NmaxRetries>0
+    % blocks of samples with journal of the results and retries
+    XSimOut=executeJournal(Xobj,Tinput);
+    return
+end
+
 if Xobj.LverticalSplit
     XSimOut=executeWorkers(Xobj,XSimInp);
+elseif Xobj.NpipelineBlock>0 && length(Xobj.CXsolvers)>1
+    % the samples flow to the next solver in blocks
+    XSimOut=executePipeline(Xobj,Tinput);
+    XSimOut=XSimInp.merge(XSimOut);
+    XSimOut.Sdescription= [XSimOut.Sdescription ' - apply(@evaluator)'];
 else
     
     
@@ -80,7 +97,8 @@ else
             Xjob=JobManager('XjobManagerInterface',Xobj.XjobInterface, ...
                 'Squeue',Xobj.CSqueues{n},'Shostname',Xobj.CShostnames{n}, ...
                 'SparallelEnvironment',Xobj.CSparallelEnvironments{n},...
-                'Nslots',Xobj.Vslots(n),...
+                'Nslots',Xobj.Vslots(n),'Nmemory',Xobj.Vmemory(n),...
+                'NchunkDuration',Xobj.NchunkDuration,...
                 'Nconcurrent',Xobj.Vconcurrent(n),...
                 'Sduration',Xobj.Sduration,...
                 'Sdescription','JobManager created by Evaluator.apply');
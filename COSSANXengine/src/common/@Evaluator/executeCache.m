@@ -0,0 +1,118 @@
+function XSimOut = executeCache(Xobj,Tinput)
+% EXECUTECACHE  This is a protected method of evaluator to run the analysis
+% with the persistent cache of the model evaluations.
+%
+% The outputs of the samples already evaluated by the same model, in this
+% or in a previous analysis, are read from the cache file Scache (see
+% cachex). The key of a sample is the hash of the definition of the model
+% (the serialized solvers with the names of the inputs and of the outputs)
+% and of the values of its inputs. The other samples are evaluated once
+% (identical samples are evaluated only once) and their outputs are stored
+% in the cache if they are numeric scalars and not NaN.
+%
+% The cache is not used if the inputs are not numeric scalars, or if the
+% existing cache file stores fewer outputs per sample than the model has.
+%
+%  Usage:  XSimout = executeCache(Xobj,Tinput)
+%
+% See Also: http://cossan.co.uk/wiki/index.php/apply@Evaluator
+%
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+assert(exist('cachex','file')==3,'openCOSSAN:Evaluator:executeCache',...
+    'The mex file cachex is not available (see mex/src/Cache/makeCache.m)')
+
+% Evaluator of the samples not in the cache
+Xev=Xobj;
+Xev.Scache='';
+
+CSoutputs=Xobj.Coutputnames(:)';
+[Minputs,CSinputs,Tinput]=Xobj.getInputMatrix(Tinput);
+if isempty(Minputs)
+    warning('openCOSSAN:Evaluator:executeCache',...
+        'The inputs are not numeric scalars: the cache is not used')
+    XSimOut=Xev.apply(Tinput);
+    return
+end
+
+%% Samples in the cache
+Vmodel=Xobj.modelDefinition(CSinputs,CSoutputs);
+cachex('open',Xobj.Scache,Xobj.NcacheEntries,max(16,length(CSoutputs)));
+% an existing cache keeps the number of outputs it was created with
+Tstats=cachex('stats');
+if Tstats.NmaxOutputs<length(CSoutputs)
+    cachex('close');
+    warning('openCOSSAN:Evaluator:executeCache',...
+        ['The cache %s stores at most %i outputs per sample (%i required): ' ...
+        'the cache is not used'],Xobj.Scache,Tstats.NmaxOutputs,length(CSoutputs))
+    XSimOut=Xev.apply(Tinput);
+    return
+end
+[Lfound,Mfound]=cachex('lookup',Vmodel,Minputs,length(CSoutputs));
+Tall=Tinput;
+for n=1:length(CSoutputs)
+    Cvalues=num2cell(Mfound(Lfound,n));
+    [Tall(Lfound).(CSoutputs{n})]=Cvalues{:};
+end
+OpenCossan.cossanDisp(sprintf('[Status:Evaluator  ]  * Cache %s: %i of %i samples found',...
+    Xobj.Scache,sum(Lfound),length(Tinput)),2)
+
+%% Evaluate the other samples (identical samples only once)
+Vmissing=find(~Lfound);
+if ~isempty(Vmissing)
+    [~,Vunique,Vmap]=unique(Minputs(Vmissing,:),'rows','stable');
+    XSimMissing=Xev.apply(Tinput(Vmissing(Vunique)));
+    Tmissing=XSimMissing.Tvalues;
+    % only the outputs are copied: the duplicates share the values of the
+    % inputs of the model, not of the other variables of Tinput
+    CSnames=intersect(CSoutputs,fieldnames(Tmissing),'stable');
+    for n=1:length(CSnames)
+        Cvalues={Tmissing.(CSnames{n})};
+        [Tall(Vmissing).(CSnames{n})]=Cvalues{Vmap};
+    end
+    
+    % store the outputs that are numeric scalars and not NaN
+    Lstore=true(length(Vunique),1);
+    for n=1:length(CSoutputs)
+        if ~isfield(Tmissing,CSoutputs{n})
+            Lstore(:)=false;
+            break
+        end
+        Lstore=Lstore & cellfun(@(x) isnumeric(x) && isscalar(x) && ~isnan(x),...
+            {Tmissing.(CSoutputs{n})})';
+    end
+    if any(Lstore)
+        Mout=zeros(sum(Lstore),length(CSoutputs));
+        for n=1:length(CSoutputs)
+            Mout(:,n)=[Tmissing(Lstore).(CSoutputs{n})];
+        end
+        cachex('insert',Vmodel,Minputs(Vmissing(Vunique(Lstore)),:),Mout);
+    end
+end
+
+%% Export results
+XSimOut=SimulationData('Tvalues',Tall);
+XSimOut.Sdescription= [XSimOut.Sdescription ' - apply(@evaluator)'];
+
+end
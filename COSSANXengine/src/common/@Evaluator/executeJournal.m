@@ -0,0 +1,160 @@
+function XSimOut = executeJournal(Xobj,Tinput)
+% EXECUTEJOURNAL  This is a protected method of evaluator to run the
+% analysis with a journal of the results and retries of the failed samples.
+%
+% The samples are evaluated in blocks of NjournalBlock samples. After each
+% block, the outputs of the samples evaluated successfully are appended to
+% the journal Sjournal (see journalx), a binary file identified by the hash
+% of the inputs of each sample. The samples already in the journal (e.g.
+% evaluated before an interruption of the analysis) are not evaluated
+% again. The journal is bound to the definition of the model (see
+% modelDefinition): a journal written by another model is not used. The
+% samples with NaN or empty outputs, or the blocks that fail with an
+% error, are evaluated again up to NmaxRetries times, after NretryDelay
+% seconds doubled at each retry.
+%
+% The inputs must be numeric scalars and only the outputs that are numeric
+% scalars are journaled.
+%
+%  Usage:  XSimout = executeJournal(Xobj,Tinput)
+%
+% See Also: http://cossan.co.uk/wiki/index.php/apply@Evaluator
+%
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+Nsamples=length(Tinput);
+CSoutputs=Xobj.Coutputnames(:)';
+
+% The values of the parameters are copied to all the samples so that the
+% blocks are self contained
+[Minputs,CSinputs,Tinput]=Xobj.getInputMatrix(Tinput);
+
+% Evaluator of the blocks
+Xev=Xobj;
+Xev.Sjournal='';
+Xev.NmaxRetries=0;
+
+Tall=Tinput;
+Lpending=true(Nsamples,1);
+
+%% Open the journal and skip the samples already evaluated
+Ljournal=~isempty(Xobj.Sjournal);
+if Ljournal
+    assert(exist('journalx','file')==3,'openCOSSAN:Evaluator:executeJournal',...
+        'The mex file journalx is not available (see mex/src/Journal/makeJournal.m)')
+    % the samples are identified by the values of their inputs
+    assert(~isempty(Minputs),'openCOSSAN:Evaluator:executeJournal',...
+        'The journal requires inputs with numeric scalar values')
+    
+    % the outputs of another model are not reused (formatError)
+    Vmodel=Xobj.modelDefinition(CSinputs,CSoutputs);
+    [Nrecords,Ndiscarded]=journalx('open',Xobj.Sjournal,CSinputs,CSoutputs,true,Vmodel);
+    XcloseJournal=onCleanup(@() journalx('close')); %#ok<NASGU>
+    if Ndiscarded>0
+        warning('openCOSSAN:Evaluator:executeJournal',...
+            'Incomplete records removed from the journal %s (%i bytes)',Xobj.Sjournal,Ndiscarded)
+    end
+    [Lfound,Mfound]=journalx('lookup',Minputs);
+    for n=1:length(CSoutputs)
+        Cvalues=num2cell(Mfound(Lfound,n));
+        [Tall(Lfound).(CSoutputs{n})]=Cvalues{:};
+    end
+    Lpending(Lfound)=false;
+    OpenCossan.cossanDisp(sprintf(['[Status:Evaluator  ]  * Journal %s (%i records): ' ...
+        '%i of %i samples already evaluated'],Xobj.Sjournal,Nrecords,sum(Lfound),Nsamples),2)
+end
+
+%% Evaluate the samples in blocks
+Nretry=0;
+while any(Lpending)
+    Vpending=find(Lpending);
+    for iblock=1:Xobj.NjournalBlock:length(Vpending)
+        Vblock=Vpending(iblock:min(end,iblock+Xobj.NjournalBlock-1));
+        try
+            XSimBlock=Xev.apply(Tinput(Vblock));
+        catch ME
+            if Nretry>=Xobj.NmaxRetries
+                rethrow(ME)
+            end
+            warning('openCOSSAN:Evaluator:executeJournal',...
+                'Evaluation of %i samples failed: %s',length(Vblock),ME.message)
+            continue
+        end
+        Tblock=XSimBlock.Tvalues;
+        CSnames=fieldnames(Tblock);
+        for n=1:length(CSnames)
+            [Tall(Vblock).(CSnames{n})]=Tblock.(CSnames{n});
+        end
+        
+        % samples evaluated successfully
+        Lfailed=false(length(Vblock),1);
+        Lscalar=true;
+        for n=1:length(CSoutputs)
+            if ~isfield(Tblock,CSoutputs{n})
+                Lfailed(:)=true;
+                continue
+            end
+            Cvalues={Tblock.(CSoutputs{n})};
+            Lfailed=Lfailed | cellfun(@(x) isempty(x) || ...
+                (isnumeric(x) && any(isnan(x(:)))),Cvalues(:));
+            Lscalar=Lscalar && all(cellfun(@(x) isnumeric(x) && isscalar(x),Cvalues));
+        end
+        Lpending(Vblock(~Lfailed))=false;
+        
+        if Ljournal && any(~Lfailed)
+            if Lscalar
+                Mout=zeros(sum(~Lfailed),length(CSoutputs));
+                for n=1:length(CSoutputs)
+                    Mout(:,n)=[Tblock(~Lfailed).(CSoutputs{n})];
+                end
+                journalx('append',Vblock(~Lfailed),Minputs(Vblock(~Lfailed),:),Mout);
+            else
+                warning('openCOSSAN:Evaluator:executeJournal',...
+                    'The outputs are not numeric scalars: the journal is not written')
+                Ljournal=false;
+            end
+        end
+    end
+    
+    if ~any(Lpending) || Nretry>=Xobj.NmaxRetries
+        break
+    end
+    % retry the failed samples
+    Nretry=Nretry+1;
+    Ndelay=Xobj.NretryDelay*2^(Nretry-1);
+    OpenCossan.cossanDisp(sprintf(['[Status:Evaluator  ]  * %i samples failed: ' ...
+        'retry %i/%i in %g s'],sum(Lpending),Nretry,Xobj.NmaxRetries,Ndelay),1)
+    pause(Ndelay);
+end
+
+if any(Lpending) && Xobj.NmaxRetries>0
+    warning('openCOSSAN:Evaluator:executeJournal',...
+        '%i samples failed after %i retries',sum(Lpending),Xobj.NmaxRetries)
+end
+
+%% Export results
+XSimOut=SimulationData('Tvalues',Tall);
+XSimOut.Sdescription= [XSimOut.Sdescription ' - apply(@evaluator)'];
+
+end
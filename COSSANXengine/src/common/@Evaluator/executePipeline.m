@@ -0,0 +1,226 @@
+function XSimOut = executePipeline(Xobj,Tinput)
+% EXECUTEPIPELINE  This is a protected method of evaluator to run the
+% solvers in a pipeline.
+%
+% The samples are split in blocks of NpipelineBlock samples. A block is
+% passed to the next solver as soon as it has been evaluated by the
+% previous one, so that the solvers are evaluated at the same time on
+% different blocks. The Connectors executed through a JobManager submit one
+% job per block and do not wait for it (see submitJobChunk@Connector): the
+% other solvers are evaluated on the blocks ready in the meantime. At most
+% NpipelineQueue blocks are evaluated or waiting between two solvers.
+%
+%  Usage:  XSimout = executePipeline(Xobj,Tinput)
+%
+% See Also: http://cossan.co.uk/wiki/index.php/apply@Evaluator
+%
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+Nsamples=length(Tinput);
+Nsolvers=length(Xobj.CXsolvers);
+Nblock=Xobj.NpipelineBlock;
+Nblocks=ceil(Nsamples/Nblock);
+
+%% Blocks of samples
+CVsamples=cell(Nblocks,1);     % samples of each block
+for b=1:Nblocks
+    CVsamples{b}=(b-1)*Nblock+1:min(Nsamples,b*Nblock);
+end
+CXblockOut=cell(Nblocks,1);    % SimulationData of the solvers evaluated on each block
+Vstage=zeros(Nblocks,1);       % number of solvers evaluated on each block
+Lrunning=false(Nblocks,1);     % block in evaluation by a job
+CTjob=cell(Nblocks,1);         % jobs of the blocks in evaluation
+LfirstJob=true(Nsolvers,1);    % no job submitted yet for the solver
+
+%% Setting the JobManagers
+% The Connectors executed through a JobManager are asynchronous (one job
+% per block), the other solvers are evaluated in this process
+CXjob=cell(Nsolvers,1);
+Lasynchronous=false(Nsolvers,1);
+for n=1:Nsolvers
+    if ~isempty(Xobj.CSqueues{n})
+        CXjob{n}=JobManager('XjobManagerInterface',Xobj.XjobInterface, ...
+            'Squeue',Xobj.CSqueues{n},'Shostname',Xobj.CShostnames{n}, ...
+            'SparallelEnvironment',Xobj.CSparallelEnvironments{n},...
+            'Nslots',Xobj.Vslots(n),'Nmemory',Xobj.Vmemory(n),...
+            'Nconcurrent',Xobj.Vconcurrent(n),...
+            'Sduration',Xobj.Sduration,'Sjobname',['CossanStage' num2str(n)],...
+            'Sdescription','JobManager created by Evaluator.executePipeline');
+        Lasynchronous(n)=isa(Xobj.CXsolvers{n},'Connector') && ...
+            ~OpenCossan.hasSSHConnection && ~strcmpi(Xobj.CXsolvers{n}.Stype,'aster');
+        if Lasynchronous(n) && Xobj.CXsolvers{n}.Lremoteprepost
+            % the pre and post execution commands are executed by the jobs
+            Xc=Xobj.CXsolvers{n};
+            CXjob{n}.Spreexecmd=Xc.SpreExecutionCommand;
+            Xc.SpreExecutionCommand='';
+            CXjob{n}.Spostexecmd=Xc.SpostExecutionCommand;
+            Xc.SpostExecutionCommand='';
+            Xobj.CXsolvers{n}=Xc;
+        end
+    end
+end
+
+while any(Vstage<Nsolvers)
+    %% Termination criteria KILL (from GUI)
+    if exist(fullfile(OpenCossan.getCossanWorkingPath,OpenCossan.getKillFilename),'file')
+        delete(fullfile(OpenCossan.getCossanWorkingPath,OpenCossan.getKillFilename));
+        OpenCossan.cossanDisp('Analysis terminated by the user',1);
+        for b=find(Lrunning)'
+            CXjob{Vstage(b)+1}.deleteJob('CSjobID',{CTjob{b}.SjobID});
+        end
+        error('openCOSSAN:Evaluator:executePipeline','Simulation killed by the user.')
+    end
+    
+    Lprogress=false;
+    
+    %% Collect the blocks evaluated by the jobs
+    for n=find(Lasynchronous)'
+        Vblocks=find(Lrunning & Vstage==n-1);
+        if isempty(Vblocks)
+            continue
+        end
+        CSjobID=cellfun(@(Tjob) Tjob.SjobID,CTjob(Vblocks),'UniformOutput',false);
+        Cstatus=CXjob{n}.getJobStatus('CSjobID',CSjobID);
+        for ib=1:length(Vblocks)
+            b=Vblocks(ib);
+            Sstate=Cstatus{ib,1};
+            if any(strcmp(Sstate,{'running','RUN','pending','PEND'}))
+                continue
+            elseif strcmp(Sstate,'Error at submission')
+                CXjob{n}.deleteJob('CSjobID',{CTjob{b}.SjobID});
+                CSjobID=CXjob{n}.submitJob('Nsimulationnumber',b,...
+                    'Sfoldername',CTjob{b}.SchunkFolder,'Lresubmit',true);
+                CTjob{b}.SjobID=CSjobID{1};
+                continue
+            elseif strncmp(Sstate,'Failed',6) || strcmp(Sstate,'EXIT')
+                warning('openCOSSAN:Evaluator:executePipeline',...
+                    'Non-zero exit status from the job of the block %i (solver %i).',b,n);
+            end
+            OpenCossan.cossanDisp(['[Status:Evaluator  ]  * Block ' num2str(b) ...
+                ' evaluated by solver ' num2str(n)],3)
+            XSimOutTmp=Xobj.CXsolvers{n}.collectJobChunk(CTjob{b});
+            CXblockOut{b}=mergeSolver(CXblockOut{b},XSimOutTmp);
+            CTjob{b}=[];
+            Lrunning(b)=false;
+            Vstage(b)=n;
+            Lprogress=true;
+        end
+    end
+    
+    %% Start the blocks ready for the next solver (the last solvers first)
+    LsynchronousDone=false; % one block in this process between two checks of the jobs
+    for n=Nsolvers:-1:1
+        Vready=find(~Lrunning & Vstage==n-1);
+        for b=Vready'
+            % bounded queue: blocks in evaluation or waiting for the solver n+1
+            if n<Nsolvers && sum(Lrunning & Vstage==n-1)+sum(~Lrunning & Vstage==n)>=Xobj.NpipelineQueue
+                break
+            end
+            if n>1
+                TinputSolver=Evaluator.addField2Structure(Xobj.CXsolvers{n},CXblockOut{b},Tinput(CVsamples{b}));
+            else
+                TinputSolver=Tinput(CVsamples{b});
+            end
+            if Lasynchronous(n)
+                if sum(Lrunning & Vstage==n-1)>=Xobj.Vconcurrent(n)
+                    break
+                end
+                OpenCossan.cossanDisp(['[Status:Evaluator  ]  * Submitting block ' ...
+                    num2str(b) '/' num2str(Nblocks) ' to solver ' num2str(n)],3)
+                CTjob{b}=Xobj.CXsolvers{n}.submitJobChunk(TinputSolver,CXjob{n},b,LfirstJob(n));
+                LfirstJob(n)=false;
+                Lrunning(b)=true;
+            else
+                if LsynchronousDone
+                    break
+                end
+                OpenCossan.cossanDisp(['[Status:Evaluator  ]  * Processing block ' ...
+                    num2str(b) '/' num2str(Nblocks) ' with solver ' num2str(n)],3)
+                XSimOutTmp=runSolver(Xobj,n,CXjob{n},TinputSolver);
+                CXblockOut{b}=mergeSolver(CXblockOut{b},XSimOutTmp);
+                Vstage(b)=n;
+                LsynchronousDone=true;
+            end
+            Lprogress=true;
+        end
+    end
+    
+    %% Wait for the jobs
+    if ~Lprogress
+        n=find(Lasynchronous,1);
+        CXjob{n}.waitForJobs(Xobj.CXsolvers{n}.sleepTime);
+    end
+end
+
+%% Merge the blocks
+XSimOut=CXblockOut{1};
+for b=2:Nblocks
+    XSimOut=XSimOut.merge(CXblockOut{b});
+end
+
+end
+
+function XSimOut=mergeSolver(XSimOut,XSimOutTmp)
+% add the outputs of a solver to the outputs of the block
+if isempty(XSimOut)
+    XSimOut=XSimOutTmp;
+else
+    XSimOut=XSimOut.merge(XSimOutTmp);
+end
+end
+
+function XSimOutTmp=runSolver(Xobj,n,Xjob,TinputSolver)
+% evaluate the solver n on a block in this process (the Mio objects are
+% evaluated with a structure)
+switch class(Xobj.CXsolvers{n})
+    case 'Connector'
+        if isempty(Xjob)
+            XSimOutTmp=Xobj.CXsolvers{n}.run(TinputSolver);
+        else
+            Xc=Xobj.CXsolvers{n};
+            if Xc.Lremoteprepost
+                Xjob.Spreexecmd = Xc.SpreExecutionCommand;
+                Xc.SpreExecutionCommand = '';
+                Xjob.Spostexecmd = Xc.SpostExecutionCommand;
+                Xc.SpostExecutionCommand = '';
+            end
+            XSimOutTmp=Xc.runJob('Tinput',TinputSolver, ...
+                'Xjobmanager',Xjob,'LremoteInjectExtract',Xobj.LremoteInjectExtract);
+        end
+    case 'Mio'
+        if isempty(Xjob)
+            XSimOutTmp=Xobj.CXsolvers{n}.run(TinputSolver);
+        else
+            XSimOutTmp=Xobj.CXsolvers{n}.runJob('Tinput',TinputSolver,'Xjobmanager',Xjob);
+        end
+    case 'SolutionSequence'
+        if ~isempty(Xjob)
+            Xobj.CXsolvers{n}.XjobManager=Xjob;
+        end
+        XSimOutTmp=Xobj.CXsolvers{n}.apply(TinputSolver);
+    otherwise
+        % Create empty SimulationData object
+        XSimOutTmp=SimulationData;
+end
+end
@@ -34,8 +34,12 @@ function XSimOut = executeWorkers(Xobj,XSimInp)
 
 
 %% The analysis is split over the number of samples
+% The samples are processed in chunks. With NchunkDuration the size of the
+% chunks is adapted to the measured runtime of each sample so that a chunk
+% lasts about NchunkDuration seconds (otherwise one sample per chunk)
 
 Nsamples=XSimInp.Nsamples;
+Nchunk=1;
 
 % Setting the JobManager
 if ~isempty(Xobj.CSqueues{1})
@@ -43,15 +47,19 @@ if ~isempty(Xobj.CSqueues{1})
     Xjob=JobManager('XjobManagerInterface',Xobj.XjobInterface, ...
         'Squeue',Xobj.CSqueues{1},'Shostname',Xobj.CShostnames{1}, ...
         'SparallelEnvironment',Xobj.CSparallelEnvironments{1},...
-        'Nslots',Xobj.Vslots(1),...
+        'Nslots',Xobj.Vslots(1),'Nmemory',Xobj.Vmemory(1),...
+        'NchunkDuration',Xobj.NchunkDuration,...
         'Nconcurrent',Xobj.Vconcurrent(1),...
         'Sdescription','JobManager created by Evaluator.executeWorkers');
 end
 
-for ns=1:Nsamples
+ns=1;
+while ns<=Nsamples
     
-    % process each sample
-    Tinput=XSimInp.Tvalues(ns);
+    % process the samples of the chunk
+    Vchunk=ns:min(Nsamples,ns+Nchunk-1);
+    Tinput=XSimInp.Tvalues(Vchunk);
+    Ntic=tic;
     
     % Predefine and reset SimulationData
     XSimOutInner=[];
@@ -140,6 +148,11 @@ for ns=1:Nsamples
         XSimOut=XSimOutInner;
     end
     
+    % size of the next chunk from the runtime per sample
+    if Xobj.NchunkDuration>0
+        Nchunk=max(1,round(Xobj.NchunkDuration*length(Vchunk)/toc(Ntic)));
+    end
+    ns=Vchunk(end)+1;
 end
 
 %% Export results
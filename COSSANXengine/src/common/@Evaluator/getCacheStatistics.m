@@ -0,0 +1,49 @@
+function Tstats = getCacheStatistics(Xobj)
+% GETCACHESTATISTICS  Statistics of the persistent cache of the model
+% evaluations of the Evaluator (Scache)
+%
+% The output structure contains the hits and misses of all the analyses
+% that used the cache file (Nhits, Nmisses, NhitRate), the number of
+% evaluations stored (Ninserts) and replaced by newer ones (Nevictions),
+% the entries in the cache (Nentries, Ncapacity) and the hits and misses
+% of the current MATLAB session (NsessionHits, NsessionMisses,
+% NsessionHitRate).
+%
+%  Usage:  Tstats = Xev.getCacheStatistics
+%
+% See Also: http://cossan.co.uk/wiki/index.php/apply@Evaluator
+%
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+assert(~isempty(Xobj.Scache),'openCOSSAN:Evaluator:getCacheStatistics',...
+    'The Evaluator does not use a cache (Scache)')
+assert(exist('cachex','file')==3,'openCOSSAN:Evaluator:getCacheStatistics',...
+    'The mex file cachex is not available (see mex/src/Cache/makeCache.m)')
+
+cachex('open',Xobj.Scache,Xobj.NcacheEntries,max(16,length(Xobj.Coutputnames)));
+Tstats=cachex('stats');
+Tstats.NhitRate=Tstats.Nhits/max(1,Tstats.Nhits+Tstats.Nmisses);
+Tstats.NsessionHitRate=Tstats.NsessionHits/max(1,Tstats.NsessionHits+Tstats.NsessionMisses);
+
+end
@@ -0,0 +1,62 @@
+function [Minputs,CSinputs,Tinput] = getInputMatrix(Xobj,Tinput)
+% GETINPUTMATRIX  This is a protected method of evaluator that returns the
+% values of the inputs of the samples as a matrix, used to identify the
+% samples in the journal and in the cache of the evaluations.
+%
+% The values of the parameters, stored in the first sample only, are
+% copied to all the samples of the output structure Tinput. The columns of
+% Minputs are the inputs of the Evaluator in alphabetical order (CSinputs).
+% Minputs is empty if an input is not a numeric scalar.
+%
+%  Usage:  [Minputs,CSinputs,Tinput] = getInputMatrix(Xobj,Tinput)
+%
+% See Also: http://cossan.co.uk/wiki/index.php/apply@Evaluator
+%
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+CSfields=fieldnames(Tinput);
+for n=1:length(CSfields)
+    Lempty=cellfun('isempty',{Tinput.(CSfields{n})});
+    if any(Lempty)
+        [Tinput(Lempty).(CSfields{n})]=deal(Tinput(1).(CSfields{n}));
+    end
+end
+
+CSinputs=CSfields;
+if ~isempty(Xobj.Cinputnames)
+    CSinputs=CSinputs(ismember(CSinputs,Xobj.Cinputnames));
+end
+CSinputs=sort(CSinputs)';
+
+Minputs=zeros(length(Tinput),length(CSinputs));
+for n=1:length(CSinputs)
+    Cvalues={Tinput.(CSinputs{n})};
+    if ~all(cellfun(@(x) isnumeric(x) && isscalar(x) && isreal(x),Cvalues))
+        Minputs=[];
+        return
+    end
+    Minputs(:,n)=double([Cvalues{:}]);
+end
+
+end
@@ -49,7 +49,8 @@ if ~isempty(Xobj.CSqueues{NsolverID})
             'Squeue',Xobj.CSqueues{NsolverID},'Shostname',Xobj.CShostnames{NsolverID}, ...
             'Sduration',Xobj.Sduration,...
             'SparallelEnvironment',Xobj.CSparallelEnvironments{NsolverID},...
-            'Nslots',Xobj.Vslots(NsolverID),...
+            'Nslots',Xobj.Vslots(NsolverID),'Nmemory',Xobj.Vmemory(NsolverID),...
+            'NchunkDuration',Xobj.NchunkDuration,...
             'Nconcurrent',Xobj.Vconcurrent(NsolverID),...
             'Sdescription','JobManager created by Evaluator.apply');
     else
@@ -57,7 +58,8 @@ if ~isempty(Xobj.CSqueues{NsolverID})
         Xjm=JobManager('XjobManagerInterface',Xobj.XjobInterface, ...
             'Squeue',Xobj.CSqueues{NsolverID},'Shostname',Xobj.CShostnames{NsolverID}, ...
             'SparallelEnvironment',Xobj.CSparallelEnvironments{NsolverID},...
-            'Nslots',Xobj.Vslots(NsolverID),...
+            'Nslots',Xobj.Vslots(NsolverID),'Nmemory',Xobj.Vmemory(NsolverID),...
+            'NchunkDuration',Xobj.NchunkDuration,...
             'Nconcurrent',Xobj.Vconcurrent(NsolverID),...
             'Sdescription','JobManager created by Evaluator.apply');
     end
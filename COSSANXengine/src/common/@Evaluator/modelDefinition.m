@@ -0,0 +1,47 @@
+function Vmodel = modelDefinition(Xobj,CSinputs,CSoutputs)
+% MODELDEFINITION  This is a protected method of evaluator that returns the
+% serialized definition of the model (uint8): the solvers and the names of
+% the inputs CSinputs and of the outputs CSoutputs. It is part of the key
+% of the cache of the evaluations and it identifies the model of the
+% journal, so that the values computed by another model are not reused.
+%
+% If the solvers cannot be serialized, the model is identified by the
+% classes of the solvers and by the names of the variables.
+%
+%  Usage:  Vmodel = modelDefinition(Xobj,CSinputs,CSoutputs)
+%
+% See Also: http://cossan.co.uk/wiki/index.php/apply@Evaluator
+%
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+CSnames=[CSinputs(:); {'->'}; CSoutputs(:)];
+try
+    Vmodel=[getByteStreamFromArray(Xobj.CXsolvers) uint8(sprintf('%s;',CSnames{:}))];
+catch ME %#ok<NASGU>
+    warning('openCOSSAN:Evaluator:modelDefinition',...
+        'The solvers cannot be serialized: changes of the solvers are not detected')
+    CSclasses=cellfun(@class,Xobj.CXsolvers,'UniformOutput',false);
+    Vmodel=uint8(sprintf('%s;',CSclasses{:},CSnames{:}));
+end
+end
@@ -568,6 +568,7 @@ classdef OpenCossan < handle
         getInfo;
         Sname=getKillFilename;     % Return the name of the kill file
         XrandomStream=getRandomStream; % Return the random stream stored in the Analysis
+        Vstate=getNativeRandomState;   % Return the state of the random number generator of the mex files
         Xobj=getSSHConnection;
         Nlevel=getVerbosityLevel;
         
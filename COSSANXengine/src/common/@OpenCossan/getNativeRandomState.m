@@ -0,0 +1,38 @@
+function Vstate=getNativeRandomState
+%%GETNATIVERANDOMSTATE
+% This static method of OpenCossan returns the state (uint32 row vector) used
+% to initialize the random number generator of the mex files (see
+% mex/src/Random/cossan_rng.h). The key of the generator is drawn from the
+% Random Stream of OpenCossan, so that the native generators are
+% reproducible after OpenCossan.resetRandomNumberGenerator.
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+XrandomStream=OpenCossan.getRandomStream;
+
+% [key(2) position(2) stream(2) ibuf magic]
+Vstate=zeros(1,8,'uint32');
+Vstate(1:2)=randi(XrandomStream,[0 double(intmax('uint32'))],1,2,'uint32');
+Vstate(7)=4;                          % no buffered words
+Vstate(8)=uint32(hex2dec('50484C58')); % magic number of the state
+end
@@ -46,12 +46,31 @@ classdef Connector
         CSmembersNames = {}; % Cell array containing the names of objects included in the Connector
         Lremoteprepost = false
         Sexecmd       % string containing placeholder for execution command assembly
+        NconcurrentRuns = 1 % number of solver processes executed at the same time by run (local execution only), threads of a plugin or persistent workers
+        NtimeoutRun = Inf % timeout of each solver process [s] (concurrent execution only)
+        LresourceUsage = false % add the resources used by each solver process to the outputs of run (local execution only, see CSresourceUsageNames)
+        LbundledTransfer = false % copy the folders of the jobs to and from the remote host (SSH, remote inject/extract) as one compressed bundle (see mex/src/Bundle)
+        SstagingMode = 'copy' % staging of the files in the working directories: 'copy', 'reflink', 'hardlink' or 'symlink'
+        SpluginLibrary = '' % shared library of the model evaluated in the MATLAB process (see mex/src/Plugin)
+        SpluginOptions = '' % string passed to the initialization of the plugin
+        SworkerCommand = '' % command starting a persistent solver worker, executed in Smaininputpath (see mex/src/Worker)
+        CSpluginInputNames = {} % names of the inputs passed to the plugin or worker (default: names defined by the plugin or worker)
+        CSpluginOutputNames = {} % names of the outputs returned by the plugin or worker (default: names defined by the plugin or worker)
     end
     
     properties (Constant)
         sleepTime = 5 % Waiting time for checking status of the jobs
         matlabInputName='ConnectorInput.mat'  % Name of the Matlab input file
         matlabOutputName='ConnectorOutput.mat' % Name of the Matlab output file
+        % stages of a simulation timed by run (columns of MstageTimes)
+        CSstageNames={'folder','copyFiles','inject','preExecution','solver',...
+            'checkForErrors','postExecution','extract','cleanup'}
+        % resources used by the solver process of each simulation, added to
+        % the outputs of run when LresourceUsage is true: wall clock, user
+        % and system cpu time [s], peak resident memory [kB], bytes read
+        % and written
+        CSresourceUsageNames={'solverWallTime','solverUserTime','solverSystemTime',...
+            'solverMaxRSS','solverBytesRead','solverBytesWritten'}
     end
     
     properties (SetAccess=private)
@@ -65,6 +84,9 @@ classdef Connector
         Sexp = '%(\w+)\>'; % regular expression used to find the identifiers in Sexecmd
         SconnectorScriptName = 'run_Connector.sh' % Name of the connector shell script
         SconnectorRelativePath= ['src' filesep 'ConnectorWrapper']
+        SrunLogName = 'cossan_run.log' % Output of the solver in the concurrent execution
+        SchunkManifestName = 'manifest.txt' % Folders of the samples of a job (runJobChunks)
+        SchunkRuntimesName = 'runtimes.txt' % Runtime of the samples of a job (runJobChunks)
     end
     
     
@@ -161,6 +183,29 @@ classdef Connector
                         Xobj.LkeepSimulationFiles = varargin{k+1};
                     case {'lremoteprepost'}
                         Xobj.Lremoteprepost = varargin{k+1};
+                    case {'nconcurrentruns'}
+                        Xobj.NconcurrentRuns = varargin{k+1};
+                    case {'ntimeoutrun'}
+                        Xobj.NtimeoutRun = varargin{k+1};
+                    case {'lresourceusage'}
+                        Xobj.LresourceUsage = varargin{k+1};
+                    case {'lbundledtransfer'}
+                        Xobj.LbundledTransfer = varargin{k+1};
+                    case {'sstagingmode'}
+                        Xobj.SstagingMode = varargin{k+1};
+                        assert(ismember(lower(Xobj.SstagingMode),{'copy','reflink','hardlink','symlink'}),...
+                            'openCOSSAN:Connector:Connector',...
+                            'SstagingMode must be ''copy'', ''reflink'', ''hardlink'' or ''symlink''')
+                    case {'spluginlibrary'}
+                        Xobj.SpluginLibrary = varargin{k+1};
+                    case {'spluginoptions'}
+                        Xobj.SpluginOptions = varargin{k+1};
+                    case {'sworkercommand'}
+                        Xobj.SworkerCommand = varargin{k+1};
+                    case {'csplugininputnames'}
+                        Xobj.CSpluginInputNames = varargin{k+1};
+                    case {'cspluginoutputnames'}
+                        Xobj.CSpluginOutputNames = varargin{k+1};
                     case ({'xinjector';'xextractor'})
                         % For compatibility reason only
                         eval([inputname(k+1) '=varargin{k+1};' ])
@@ -211,6 +256,42 @@ classdef Connector
                 ' - is different from the number of names - '...
                 num2str(length(Xobj.CSmembersNames))])
             
+            %% Model plugin or persistent workers
+            % The model is evaluated in the MATLAB process (SpluginLibrary)
+            % or by NconcurrentRuns resident copies of the solver wrapper
+            % (SworkerCommand): the input and output files, the solver and
+            % the execution command are not used. The names of the inputs
+            % and of the outputs are declared by the model.
+            if ~isempty(Xobj.SpluginLibrary) || ~isempty(Xobj.SworkerCommand)
+                assert(isempty(Xobj.SpluginLibrary) || isempty(Xobj.SworkerCommand),...
+                    'openCOSSAN:Connector:Connector',...
+                    'SpluginLibrary and SworkerCommand cannot be used together')
+                if ~isempty(Xobj.SpluginLibrary)
+                    assert(exist('pluginx','file')==3,'openCOSSAN:Connector:Connector',...
+                        'The mex file pluginx is required to use SpluginLibrary (see mex/src/Plugin)')
+                    [CSinputs,CSoutputs]=pluginx('info',Xobj.SpluginLibrary,Xobj.SpluginOptions);
+                else
+                    assert(isunix && exist('workerx','file')==3,'openCOSSAN:Connector:Connector',...
+                        'The mex file workerx is required to use SworkerCommand (see mex/src/Worker)')
+                    % a single worker announces the variables: the workers
+                    % are started by the first evaluation (see runWorker)
+                    [CSinputs,CSoutputs]=workerx('info',Xobj.SworkerCommand,...
+                        Xobj.Smaininputpath);
+                end
+                if isempty(Xobj.CSpluginInputNames)
+                    Xobj.CSpluginInputNames=CSinputs;
+                end
+                if isempty(Xobj.CSpluginOutputNames)
+                    Xobj.CSpluginOutputNames=CSoutputs;
+                end
+                assert(length(Xobj.CSpluginInputNames)==length(CSinputs) && ...
+                    length(Xobj.CSpluginOutputNames)==length(CSoutputs),...
+                    'openCOSSAN:Connector:Connector',...
+                    'The model %s has %i inputs and %i outputs',...
+                    [Xobj.SpluginLibrary Xobj.SworkerCommand],length(CSinputs),length(CSoutputs))
+                return
+            end
+            
             %% be sure Smaininputfile contains only the file name
             [Spath, Sfile, Sext] = fileparts(Xobj.Smaininputfile);
             if ~isempty(Spath)
@@ -282,12 +363,15 @@ classdef Connector
         [vargout]=test(Xconnector) % check that all the componenent of the Connector are working
         [Tout, LsuccessfullExtract] = extract(Xc,varargin) % execute the extract methods of all the Extractor inside the Connector
         [varargout] = inject(Xc,varargin)  % execute the inject methods of all the Injector inside the Connector
+        injectBatch(Xc,CSfolders,Tinput)   % inject the values of several simulations in their working directories
         display(Xconnector)
         
         
         %% Dependent Fields
         function Coutputnames=get.Coutputnames(Xobj)
-            if ~any(Xobj.Lextractors)
+            if ~isempty(Xobj.SpluginLibrary) || ~isempty(Xobj.SworkerCommand)
+                Coutputnames=Xobj.CSpluginOutputNames(:);
+            elseif ~any(Xobj.Lextractors)
                 Coutputnames={};
             else
                 Coutputnames={};
@@ -296,10 +380,16 @@ classdef Connector
                 end
                 Coutputnames = unique(Coutputnames);
             end
+            if Xobj.LresourceUsage && isempty(Xobj.SpluginLibrary) && isempty(Xobj.SworkerCommand)
+                % resources used by each solver process (see runConcurrent)
+                Coutputnames=[Coutputnames; Connector.CSresourceUsageNames(:)];
+            end
         end
         
         function Cinputnames=get.Cinputnames(Xobj)
-            if ~any(Xobj.Linjectors)
+            if ~isempty(Xobj.SpluginLibrary) || ~isempty(Xobj.SworkerCommand)
+                Cinputnames=Xobj.CSpluginInputNames(:)';
+            elseif ~any(Xobj.Linjectors)
                 Cinputnames={};
             else
                 Cinputnames={};
@@ -358,18 +448,44 @@ classdef Connector
          
     end
     
+    methods (Hidden)
+        % submit a job with a block of samples without waiting (pipelined Evaluator)
+        Tjob = submitJobChunk(Xobj,Tinput,Xjob,Nblock,LfirstJob)
+        % extract the results of a job submitted with submitJobChunk
+        [XSimOut,Tout,LerrorFound] = collectJobChunk(Xobj,Tjob)
+    end
+    
     methods (Access=private)
         LerrorFound = checkForErrors(Xobj) % check if the 3rd party solver exited with an error
         copyFiles(Xc,varargin) % copy the additional files of the Connector to a defined folder
+        string = buildExecutionCommand(Xc) % assemble the command executed in SfolderTimeStamp
+        % run the Connector on the local machine with concurrent solver processes
+        [Tout,LerrorFound,LsuccessfullExtract,MstageTimes] = runConcurrent(Xc,Tinput,LuseOriginalValues,Nsimulations,NverboseLevel)
+        % evaluate the model plugin in the MATLAB process
+        [Tout,LerrorFound,LsuccessfullExtract,MstageTimes] = runPlugin(Xc,Tinput,LuseOriginalValues,Nsimulations)
+        % evaluate the samples with the persistent solver workers
+        [Tout,LerrorFound,LsuccessfullExtract,MstageTimes] = runWorker(Xc,Tinput,LuseOriginalValues,Nsimulations)
+        % matrix of the inputs of a plugin or worker (one column per input)
+        Minput = collectInputs(Xc,Tinput,Nsimulations)
         
         % run the Connector on the Grid, with inject and extract executed locally
         [Xout,varargout] = runJobLocalInjectExtract(Xobj,varargin) 
+        % run the Connector on the Grid with chunks of samples of adaptive size
+        [Xout,varargout] = runJobChunks(Xobj,Tinput,Xjob)
+        % submit the job of a chunk of samples
+        Tchunk = submitChunk(Xobj,Xjob,Tinput,Vsamples,k,Lspeculative)
+        % command of a job that evaluates the samples of its manifest
+        Sexecmd = buildChunkCommand(Xobj)
+        % post-execution command and extraction of one sample of a job
+        [Tsample,LerrorFound,LsuccessfullExtract] = extractSample(Xobj,SextractFolderName,isample)
         % run the Connector on the Grid, with inject and extract executed remotely
         [Xout,varargout] = runJobRemoteInjectExtract(Xobj,varargin) 
         % run the Connector via SSH connection, with inject and extract executed locally
         [Xout,varargout] = runJobLocalInjectExtractSSH(Xobj,varargin) 
         % run the Connector via SSH connection, with inject and extract executed remotely
         [Xout,varargout] = runJobRemoteInjectExtractSSH(Xobj,varargin) 
+        % copy the folders of the jobs to or from the remote host as one bundle
+        Lsuccess = transferBundle(Xobj,Xssh,Sdirection,Sname,CSpaths,SremoteDir)
         
         function checkFiles(Xobj) 
             % check that user specified a main input path
@@ -0,0 +1,43 @@
+function Sexecmd = buildChunkCommand(Xobj)
+%BUILDCHUNKCOMMAND Private method of Connector. Assemble the command of a
+%job that evaluates several samples
+%
+%   The command executes the solver in each folder listed in the manifest
+%   of the job folder and appends exit status, start and end time of each
+%   sample to the runtimes file. The exit status of the command is the last
+%   non-zero status of the solver.
+%
+% See Also: http://cossan.co.uk/wiki/index.php/runJob@Connector
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+% the manifest is read on the descriptor 3: the solver keeps the standard
+% input. The times are written with the C locale (decimal point) whatever
+% the locale of the solver.
+Sexecmd = ['CHUNK_STATUS=0; chunk_time() { LC_ALL=C; echo "${EPOCHREALTIME:-$(date +%s)}"; }; ' ...
+    'while read -r SAMPLE_DIR <&3; do SAMPLE_START=$(chunk_time); ' ...
+    '(cd "$SAMPLE_DIR" && ' Xobj.SexecutionCommand '); SAMPLE_STATUS=$?; ' ...
+    'echo "$SAMPLE_STATUS $SAMPLE_START $(chunk_time) $SAMPLE_DIR" >> ' ...
+    Xobj.SchunkRuntimesName '; ' ...
+    'if [ $SAMPLE_STATUS -ne 0 ]; then CHUNK_STATUS=$SAMPLE_STATUS; fi; ' ...
+    'done 3< ' Xobj.SchunkManifestName '; (exit $CHUNK_STATUS)'];
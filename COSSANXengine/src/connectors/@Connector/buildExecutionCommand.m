@@ -0,0 +1,91 @@
+function string=buildExecutionCommand(Xc)
+%BUILDEXECUTIONCOMMAND Private method of Connector. Assemble the shell
+%command that executes the 3rd party solver in the folder SfolderTimeStamp
+%
+%   The placeholders of Sexecmd are replaced with the properties of the
+%   Connector and the command changes directory to SfolderTimeStamp.
+%
+% See Also: http://cossan.co.uk/wiki/index.php/run@Connector
+%
+% $Copyright~1993-2014,~COSSAN~Working~Group,~University~of~Liverpool,~UK$
+% $Author: Matteo Broggi and Edoardo Patelli$
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+string=Xc.Sexecmd;
+
+[tok] = regexp(string, Xc.Sexp, 'tokens');
+
+for i=1:length(tok)
+    switch (lower(tok{i}{1}))
+        case {'solverbinary','ssolverbinary'}
+            % the solver binary needs some OS dependent processing to
+            % be correctly executed
+            if ispc % in windows
+                % duplicates the '\' to avoid that they are interpreted
+                % as regexp commands
+                Ssolverbinary = strrep(Xc.Ssolverbinary,'\','\\');
+                % If there are spaces in the path, the shell will
+                % interpret them as separator between command options.
+                % If everything is in "" the problem is fixed.
+                Ssolverbinary = ['"' Ssolverbinary '"']; %#ok<*AGROW>
+            else % in *nix
+                % If there are spaces in the path, the shell will
+                % interpret them as separator between command options.
+                % A "\\" must be inserted before the space (the first
+                % to say regexp to ignore the second, and the second to
+                % say the shell to ignore the space).
+                Ssolverbinary = strrep(Xc.Ssolverbinary,' ','\\ ');
+            end
+            string=regexprep(string, Xc.Sexp,  Ssolverbinary, 1);
+        case {'executionflags','sexeflags'}
+            string=regexprep(string, Xc.Sexp, Xc.Sexeflags, 1);
+        case {'executionpath','sexepath'}
+            string=regexprep(string, Xc.Sexp, Xc.SfolderTimeStamp, 1);
+        case {'maininputfile','smaininputfile'}
+            string=regexprep(string, Xc.Sexp, Xc.Smaininputfile, 1);
+        case {'soutputfile' 'outputfile'}
+            string=regexprep(string, Xc.Sexp, Xc.Soutputfile, 1);
+        otherwise
+            error('openCOSSAN:Connector:run:unknownExecutionParameter', ...
+                ['Unknown parameter in execution string: ' tok{i}{1}])
+    end
+end
+
+% The system command is not executed from the current matlab directory.
+% Therefore it is necessary to change directory in the shell command
+% before executing external code from the system shell
+if isunix
+    string=['cd ' strrep(Xc.SfolderTimeStamp,' ','\\ ')... % solve the problem with spaces in path
+        '; pwd;' string]; %#ok<*AGROW>
+else
+    % On windows it is necessary to change the drive first and then the
+    % directory. Since Sworkingdirectory is a full path, the first 2
+    % characters of the string specify the disk.
+    % It will NOT WORK with network drives, because the shell does not
+    % allow the use of UNC directory!
+    assert(~strcmp(Xc.SfolderTimeStamp(1:2),'\\'),...
+        'OpenCossan:Connector:run',...
+        ['Due to limitations of the windows shell, it is not possible to use a network '...
+        'path as a working directory']);
+    if strcmp(Xc.Stype,'opensees')
+        string=[Xc.SfolderTimeStamp(1:2) ' & cd "' Xc.SfolderTimeStamp '" & cd & ' string,' ',Xc.Smaininputfile];
+    else
+        string=[Xc.SfolderTimeStamp(1:2) ' & cd "' Xc.SfolderTimeStamp '" & cd & ' string];
+    end
+end
@@ -0,0 +1,46 @@
+function Minput = collectInputs(Xc,Tinput,Nsimulations)
+%COLLECTINPUTS Private method of Connector. Matrix of the inputs of the
+%model plugin or of the persistent workers
+%
+%   The values of the inputs are collected in a matrix with one row for
+%   each sample and one column for each input, in the order of
+%   CSpluginInputNames.
+%
+% See Also: http://cossan.co.uk/wiki/index.php/run@Connector
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+Ninputs=length(Xc.CSpluginInputNames);
+Minput=zeros(Nsimulations,Ninputs);
+for iinput=1:Ninputs
+    Sname=Xc.CSpluginInputNames{iinput};
+    assert(isfield(Tinput,Sname),'openCOSSAN:Connector:collectInputs',...
+        'The input %s required by the model is not present in the input object',Sname)
+    Cvalues={Tinput.(Sname)};
+    % the parameters are stored only in Tinput(1) (see prepareInputStructure)
+    Cvalues(cellfun(@isempty,Cvalues))=Cvalues(1);
+    assert(all(cellfun(@(v) isnumeric(v) && isscalar(v),Cvalues)),...
+        'openCOSSAN:Connector:collectInputs',...
+        'Only scalar values of the input %s can be passed to the model',Sname)
+    Minput(:,iinput)=cell2mat(Cvalues(:));
+end
@@ -0,0 +1,70 @@
+function [XSimOut,Tout,LerrorFound] = collectJobChunk(Xobj,Tjob)
+%COLLECTJOBCHUNK Extract the results of a job submitted with
+%submitJobChunk
+%
+%   USAGE:  [XSimOut,Tout,LerrorFound]=Xc.collectJobChunk(Tjob)
+%
+%   The post-execution command is executed and the results are extracted
+%   from the folder of each sample of the job. The folders and the script
+%   of the job are removed unless LkeepSimulationFiles is true.
+%
+% See Also: http://cossan.co.uk/wiki/index.php/runJob@Connector
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+Nsamples = length(Tjob.CSfolders);
+LerrorFound = false(Nsamples,1);
+for isample = 1:Nsamples
+    [Tsample,LerrorFound(isample)] = extractSample(Xobj,Tjob.CSfolders{isample},isample);
+    CSnames = fieldnames(Tsample);
+    for in = 1:length(CSnames)
+        Tout(isample).(CSnames{in}) = Tsample.(CSnames{in}); %#ok<AGROW>
+    end
+end
+% resources used by the solver: not measured by the JobManager (see run)
+if Xobj.LresourceUsage && isempty(Xobj.SpluginLibrary) && isempty(Xobj.SworkerCommand)
+    for n = 1:length(Connector.CSresourceUsageNames)
+        [Tout.(Connector.CSresourceUsageNames{n})] = deal(NaN);
+    end
+end
+
+%% Clean the folders of the samples and of the job
+if ~Xobj.LkeepSimulationFiles
+    CSfolders = [Tjob.CSfolders(:); ...
+        {fullfile(OpenCossan.getCossanWorkingPath,Tjob.SchunkFolder)}];
+    for ifolder = 1:length(CSfolders)
+        if exist(CSfolders{ifolder},'dir')
+            try
+                rmdir(CSfolders{ifolder},'s');
+            catch ME %#ok<NASGU>
+                warning('openCOSSAN:Connector:runJob','Cannot delete folder %s\n',CSfolders{ifolder})
+            end
+        end
+    end
+    if exist(Tjob.SjobScript,'file')
+        delete(Tjob.SjobScript);
+    end
+end
+
+XSimOut = SimulationData('Tvalues',Tout);
+end
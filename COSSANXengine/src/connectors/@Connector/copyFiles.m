@@ -45,57 +45,99 @@ if ~exist('Sdestdir','var')
     Sdestdir = Xc.Sworkingdirectory;
 end
 
-%% copy main input file
-[Lstatus,Smess]=copyfile(fullfile(Ssourcedir,Xc.Smaininputfile),Sdestdir,'f');
-
-OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] Copy main input file from: ' ...
-    fullfile(Ssourcedir,Xc.Smaininputfile) ' to: ' fullfile(Sdestdir,Xc.Smaininputfile)],3)
-if ~Lstatus
-    OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] message: ' Smess],1)
-end
-
-%% copy additional files into the new folder
-if ~isempty(Xc.Caddfiles)
+%% Staging of the files that are not modified by the Injectors
+% With SstagingMode different from 'copy' the main input file and the
+% additional files are linked (or cloned) in the destination folder by the
+% mex file stagex (see mex/src/Staging). The files of the Injectors are
+% always copied because they are overwritten, also when they are in a
+% folder of the additional files (see stagedPaths).
+Lstaged = ~strcmpi(Xc.SstagingMode,'copy') && isunix && exist('stagex','file')==3;
+if Lstaged
+    CSinjected={};
+    for iinj=find(Xc.Linjectors)
+        Spath = Xc.CXmembers{iinj}.Srelativepath;
+        if strcmp(Spath,['.' filesep]) || strcmp(Spath,'./')
+            Spath='';
+        end
+        CSinjected{end+1}=regexprep(fullfile(Spath,Xc.CXmembers{iinj}.Sfile),'^\.[\\/]',''); %#ok<AGROW>
+    end
+    
+    CSsources={};
+    CSdestinations={};
+    if ismember(Xc.Smaininputfile,CSinjected)
+        [Lstatus,Smess]=copyfile(fullfile(Ssourcedir,Xc.Smaininputfile),Sdestdir,'f');
+        if ~Lstatus
+            OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] message: ' Smess],1)
+        end
+    else
+        CSsources{end+1}=fullfile(Ssourcedir,Xc.Smaininputfile);
+        CSdestinations{end+1}=fullfile(Sdestdir,Xc.Smaininputfile);
+    end
     for iaddfile=1:length(Xc.Caddfiles)
-        [Saddfilepath, Saddfilename, Saddfileext] = fileparts(Xc.Caddfiles{iaddfile});
-        if ~isempty(Saddfilepath)
-            if ~exist(fullfile(Sdestdir,Saddfilepath),'dir')
-
-                    OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] Creating folder: ' ...
-                        fullfile(Sdestdir,Saddfilepath) ],3)
+        Spath=regexprep(Xc.Caddfiles{iaddfile},{'^\.[\\/]','[\\/]+$'},'');
+        [CSsources,CSdestinations]=stagedPaths(Ssourcedir,Sdestdir,Spath,...
+            CSinjected,CSsources,CSdestinations);
+    end
+    
+    CSmethods=stagex(CSsources,CSdestinations,lower(Xc.SstagingMode));
+    for n=1:length(CSsources)
+        OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] Stage (' CSmethods{n} ') file from: ' ...
+            CSsources{n} ' to: ' CSdestinations{n}],3)
+    end
+else
+    %% copy main input file
+    [Lstatus,Smess]=copyfile(fullfile(Ssourcedir,Xc.Smaininputfile),Sdestdir,'f');
+
+    OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] Copy main input file from: ' ...
+        fullfile(Ssourcedir,Xc.Smaininputfile) ' to: ' fullfile(Sdestdir,Xc.Smaininputfile)],3)
+    if ~Lstatus
+        OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] message: ' Smess],1)
+    end
 
-                [Lstatus,mess]=mkdir(Sdestdir,Saddfilepath);
-                if ~Lstatus
-                    OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] Error Creating folder: ' ...
-                        fullfile(Sdestdir,Saddfilepath) ' mess: ' mess],3)
+    %% copy additional files into the new folder
+    if ~isempty(Xc.Caddfiles)
+        for iaddfile=1:length(Xc.Caddfiles)
+            [Saddfilepath, Saddfilename, Saddfileext] = fileparts(Xc.Caddfiles{iaddfile});
+            if ~isempty(Saddfilepath)
+                if ~exist(fullfile(Sdestdir,Saddfilepath),'dir')
+
+                        OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] Creating folder: ' ...
+                            fullfile(Sdestdir,Saddfilepath) ],3)
+
+                    [Lstatus,mess]=mkdir(Sdestdir,Saddfilepath);
+                    if ~Lstatus
+                        OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] Error Creating folder: ' ...
+                            fullfile(Sdestdir,Saddfilepath) ' mess: ' mess],3)
+                    end
                 end
-            end
-            [Lstatus,Smess]=copyfile(fullfile(Ssourcedir,Xc.Caddfiles{iaddfile}),...
-                fullfile(Sdestdir,Saddfilepath));
+                [Lstatus,Smess]=copyfile(fullfile(Ssourcedir,Xc.Caddfiles{iaddfile}),...
+                    fullfile(Sdestdir,Saddfilepath));
 
-                OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] Copy additional file from: ' ...
-                    fullfile(Ssourcedir,Xc.Caddfiles{iaddfile}) ' to: ' ...
-                    fullfile(Sdestdir,Saddfilepath,[Saddfilename Saddfileext])],3)
-                if ~Lstatus
-                    OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] message: ' Smess],3)
-                end
+                    OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] Copy additional file from: ' ...
+                        fullfile(Ssourcedir,Xc.Caddfiles{iaddfile}) ' to: ' ...
+                        fullfile(Sdestdir,Saddfilepath,[Saddfilename Saddfileext])],3)
+                    if ~Lstatus
+                        OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] message: ' Smess],3)
+                    end
 
-        else
-            [Lstatus,Smess]=copyfile(fullfile(Ssourcedir,Saddfilepath,[Saddfilename Saddfileext]),Sdestdir);
+            else
+                [Lstatus,Smess]=copyfile(fullfile(Ssourcedir,Saddfilepath,[Saddfilename Saddfileext]),Sdestdir);
             
 
-                OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] Copy additional file from: ' ...
-                    fullfile(Ssourcedir,Saddfilepath,[Saddfilename Saddfileext]) ' to: ' fullfile(Sdestdir,Saddfilepath, [Saddfilename Saddfileext])],3)
-                if ~Lstatus
-                    OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] message: ' Smess],3)
-                end
+                    OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] Copy additional file from: ' ...
+                        fullfile(Ssourcedir,Saddfilepath,[Saddfilename Saddfileext]) ' to: ' fullfile(Sdestdir,Saddfilepath, [Saddfilename Saddfileext])],3)
+                    if ~Lstatus
+                        OpenCossan.cossanDisp(['[OpenCossan:Connector:copyFiles] message: ' Smess],3)
+                    end
 
+            end
         end
     end
-end
 
 
-%% copy injector files
+    %% copy injector files
+end
+
 OpenCossan.cossanDisp('[OpenCossan:Connector:copyFiles] Copy files of the injectors',3)
 % Vinjector=fieldnames(Xc.Xinjector);
 if any(Xc.Linjectors)
@@ -142,3 +184,25 @@ if any(Xc.Linjectors)
 end
 
 end
+
+function [CSsources,CSdestinations]=stagedPaths(Ssourcedir,Sdestdir,Spath,CSinjected,CSsources,CSdestinations)
+% Add the path Spath to the staged paths. A folder that contains files of
+% the Injectors is staged entry by entry without them: the injected files
+% are copied and never written through a link to the original model.
+if ismember(Spath,CSinjected)
+    return
+end
+Sprefix=[Spath filesep];
+if ~isdir(fullfile(Ssourcedir,Spath)) || ~any(strncmp(CSinjected,Sprefix,length(Sprefix)))
+    CSsources{end+1}=fullfile(Ssourcedir,Spath);
+    CSdestinations{end+1}=fullfile(Sdestdir,Spath);
+    return
+end
+Tentries=dir(fullfile(Ssourcedir,Spath));
+for n=1:length(Tentries)
+    if ~any(strcmp(Tentries(n).name,{'.','..'}))
+        [CSsources,CSdestinations]=stagedPaths(Ssourcedir,Sdestdir,...
+            fullfile(Spath,Tentries(n).name),CSinjected,CSsources,CSdestinations);
+    end
+end
+end
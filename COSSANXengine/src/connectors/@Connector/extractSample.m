@@ -0,0 +1,50 @@
+function [Tsample,LerrorFound,LsuccessfullExtract] = extractSample(Xobj,SextractFolderName,isample)
+%EXTRACTSAMPLE Private method of Connector. Run the post-execution command
+%and extract the results of the sample isample from the folder
+%SextractFolderName
+%
+% See Also: http://cossan.co.uk/wiki/index.php/runJob@Connector
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+Xobj.SfolderTimeStamp = SextractFolderName;
+if ~isempty(Xobj.SpostExecutionCommand)
+    [status, result] = system(['cd ' SextractFolderName ';' Xobj.SpostExecutionCommand]);
+    if status ~= 0
+        warning('openCOSSAN:Connector:runJob','Non-zero exit status from post-execution command.');
+    end
+    OpenCossan.cossanDisp(['[COSSAN-X.Connector.run] Run post-execution command: ' Xobj.SpostExecutionCommand ],2)
+    OpenCossan.cossanDisp(['[COSSAN-X.Connector.run] Command output: ' result],3)
+end
+
+if ~any(Xobj.Lextractors)
+    warning('openCOSSAN:Connector:runJob','No Extractor defined in Connector');
+    Tsample.null = NaN;
+    LerrorFound = false;
+    LsuccessfullExtract = true;
+else
+    % check if the FE has been successfully executed
+    LerrorFound = Xobj.checkForErrors;
+    [Tsample,LsuccessfullExtract] = extract(Xobj,'Nsimulation',isample);
+end
+end
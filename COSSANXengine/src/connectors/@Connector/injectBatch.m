@@ -0,0 +1,51 @@
+function injectBatch(Xc,CSfolders,Tinput)
+%INJECTBATCH This method injects the input values of several simulations
+%into the INPUT ASCII FILES of their working directories
+%
+%   Tinput is a structure array with the values of each simulation (one
+%   element per folder of CSfolders, see prepareInputStructure). Each
+%   Injector writes the files of all the folders with a single call of
+%   Injector.injectBatch (a single call of injectx with the native engine).
+%
+%   EXAMPLE:  injectBatch(Xc,CSfolders,Tinput)
+%
+%   See Also: http://cossan.co.uk/wiki/index.php/inject@Connector
+%
+% $Copyright~1993-2014,~COSSAN~Working~Group,~University~of~Liverpool,~UK$
+% $Author: Edoardo Patelli and Matteo Broggi$
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+%% Check input
+if ~isa(Tinput,'struct')
+    error('openCOSSAN:connector:injectBatch', ...
+        'The third argument MUST BE an Tinput structure');
+end
+
+%% Update input files
+if ~any(Xc.Linjectors)
+    OpenCossan.cossanDisp('[COSSAN-X.Connector.injectBatch] No injector defined',2)
+    return
+end
+
+for iinj=find(Xc.Linjectors)
+    OpenCossan.cossanDisp(['[COSSAN-X.Connector.injectBatch] Injecting values in the file: '...
+        Xc.CXmembers{iinj}.Srelativepath Xc.CXmembers{iinj}.Sfile ' of ' ...
+        num2str(numel(CSfolders)) ' folders'],3)
+    injectBatch(Xc.CXmembers{iinj},CSfolders,Tinput);
+end
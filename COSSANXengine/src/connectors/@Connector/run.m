@@ -8,6 +8,17 @@ function [Xout,varargout]= run(Xc,Pinput)
 %   an Input, Samples or SimulationData object (output from a previous
 %   simulation).  It returns a SimulationOuput object.
 %
+%   [Xout,Tout,LerrorFound,LsuccessfullExtract,MstageTimes]=run(Xc,Pinput)
+%   also returns the time spent in each stage of each simulation
+%   (Nsimulations x length(Connector.CSstageNames), in seconds). The stages
+%   not performed by the execution mode (e.g. the working folders of the
+%   plugins) are zero.
+%
+%   If LresourceUsage is true the solver processes are executed by
+%   runConcurrent, also with NconcurrentRuns equal to 1, and the resources
+%   used by each of them are added to the outputs (see
+%   Connector.CSresourceUsageNames).
+%
 % See Also: http://cossan.co.uk/wiki/index.php/run@Connector
 %
 % $Copyright~1993-2014,~COSSAN~Working~Group,~University~of~Liverpool,~UK$
@@ -96,9 +107,47 @@ end
 
 
 %% Execute the simulations
-for irun=1:Nsimulations
+MstageTimes=zeros(Nsimulations,length(Connector.CSstageNames));
+Vserial=[];
+LresourceUsage=false;
+if ~isempty(Xc.SpluginLibrary)
+    % The model is evaluated in the MATLAB process (see runPlugin)
+    if LuseOriginalValues
+        Tinput=[];
+    end
+    [Tout,LerrorFound,LsuccessfullExtract,MstageTimes]=Xc.runPlugin(Tinput,...
+        LuseOriginalValues,Nsimulations);
+elseif ~isempty(Xc.SworkerCommand)
+    % The samples are sent to the persistent solver workers (see runWorker)
+    if LuseOriginalValues
+        Tinput=[];
+    end
+    [Tout,LerrorFound,LsuccessfullExtract,MstageTimes]=Xc.runWorker(Tinput,...
+        LuseOriginalValues,Nsimulations);
+elseif (Xc.NconcurrentRuns>1 || Xc.LresourceUsage) && ~Xc.Lremote && ...
+        isunix && exist('runpoolx','file')==3
+    % Keep NconcurrentRuns solver processes running (see runConcurrent)
+    if LuseOriginalValues
+        Tinput=[];
+    end
+    [Tout,LerrorFound,LsuccessfullExtract,MstageTimes]=Xc.runConcurrent(Tinput,...
+        LuseOriginalValues,Nsimulations,NverboseLevel);
+else
+    % simulations executed one after the other by the loop below
+    Vserial=1:Nsimulations;
+    LresourceUsage=Xc.LresourceUsage;
+    if LresourceUsage
+        % the outputs are still created, as declared by Coutputnames
+        warning('openCOSSAN:Connector:run',...
+            ['The resources used by the solver are measured only by the local concurrent ' ...
+            'execution (mex file runpoolx, see mex/src/ProcessPool): the outputs %s are NaN'],...
+            strjoin(Connector.CSresourceUsageNames,', '));
+    end
+end
+for irun=Vserial
     disp(['Simulation #' num2str(irun) ' of ' num2str(Nsimulations) ]);
     
+    Ntic=tic;
     if Xc.Lremote
         % This is a relative folder inside the job folder. We do not need
         % to recrate the timestamp
@@ -116,23 +165,29 @@ for irun=1:Nsimulations
     if ~isempty(mess)
         disp(['Create folder: ' Xc.SfolderTimeStamp])
     end
+    MstageTimes(irun,1)=toc(Ntic);
     
     %% copy input files to the working directory
     % if the working directory and the main input path are different
     % It should be not necessary to recopy N times the additional files
+    Ntic=tic;
     Xc.copyFiles('Sdestdir',Xc.SfolderTimeStamp);
+    MstageTimes(irun,2)=toc(Ntic);
     
     %% Inject paramaters
     % create the structure with the values to be injected (i.e., if there
     % is a parameter its values is stored in Tinput(1))
     
+    Ntic=tic;
     if ~LuseOriginalValues
         Tinject = Connector.prepareInputStructure(Tinput,irun);
         Xc.inject(Tinject); % Start injecting values
     end
+    MstageTimes(irun,3)=toc(Ntic);
     
     %% Run pre execution command
     % The pre execution command is executed on the working folder
+    Ntic=tic;
     if ~isempty(Xc.SpreExecutionCommand)
         [status,cmdout] = system(['cd ' Xc.SfolderTimeStamp ';' Xc.SpreExecutionCommand]);
         if status ~= 0
@@ -147,77 +202,21 @@ for irun=1:Nsimulations
             disp(['[COSSAN-X.Connector.run] Command output: ' cmdout])
         end
     end
+    MstageTimes(irun,4)=toc(Ntic);
     
     %% Run the external code (e.g. FE)
+    Ntic=tic;
     
     string=Xc.Sexecmd;
     
     if ~isempty(string)
-        [tok] = regexp(string, Xc.Sexp, 'tokens');
-        
-        for i=1:length(tok)
-            switch (lower(tok{i}{1}))
-                case {'solverbinary','ssolverbinary'}
-                    % the solver binary needs some OS dependent processing to
-                    % be correctly executed
-                    if ispc % in windows
-                        % duplicates the '\' to avoid that they are interpreted
-                        % as regexp commands
-                        Ssolverbinary = strrep(Xc.Ssolverbinary,'\','\\');
-                        % If there are spaces in the path, the shell will
-                        % interpret them as separator between command options.
-                        % If everything is in "" the problem is fixed.
-                        Ssolverbinary = ['"' Ssolverbinary '"']; %#ok<*AGROW>
-                    else % in *nix
-                        % If there are spaces in the path, the shell will
-                        % interpret them as separator between command options.
-                        % A "\\" must be inserted before the space (the first
-                        % to say regexp to ignore the second, and the second to
-                        % say the shell to ignore the space).
-                        Ssolverbinary = strrep(Xc.Ssolverbinary,' ','\\ ');
-                    end
-                    string=regexprep(string, Xc.Sexp,  Ssolverbinary, 1);
-                case {'executionflags','sexeflags'}
-                    string=regexprep(string, Xc.Sexp, Xc.Sexeflags, 1);
-                case {'executionpath','sexepath'}
-                    string=regexprep(string, Xc.Sexp, Xc.SfolderTimeStamp, 1);
-                case {'maininputfile','smaininputfile'}
-                    string=regexprep(string, Xc.Sexp, Xc.Smaininputfile, 1);
-                case {'soutputfile' 'outputfile'}
-                    string=regexprep(string, Xc.Sexp, Xc.Soutputfile, 1);
-                otherwise
-                    error('openCOSSAN:Connector:run:unknownExecutionParameter', ...
-                        ['Unknown parameter in execution string: ' tok{i}{1}])
-            end
-        end
-        
-        % The system command is not executed from the current matlab directory.
-        % Therefore it is necessary to change directory in the shell command
-        % before executing external code from the system shell
-        if isunix
-            string=['cd ' strrep(Xc.SfolderTimeStamp,' ','\\ ')... % solve the problem with spaces in path
-                '; pwd;' string]; %#ok<*AGROW>
-        else
-            % On windows it is necessary to change the drive first and then the
-            % directory. Since Sworkingdirectory is a full path, the first 2
-            % characters of the string specify the disk.
-            % It will NOT WORK with network drives, because the shell does not
-            % allow the use of UNC directory!
-            assert(~strcmp(Xc.SfolderTimeStamp(1:2),'\\'),...
-                'OpenCossan:Connector:run',...
-                ['Due to limitations of the windows shell, it is not possible to use a network '...
-                'path as a working directory']);
-            if strcmp(Xc.Stype,'opensees')
-                string=[Xc.SfolderTimeStamp(1:2) ' & cd "' Xc.SfolderTimeStamp '" & cd & ' string,' ',Xc.Smaininputfile];
-            else
-                string=[Xc.SfolderTimeStamp(1:2) ' & cd "' Xc.SfolderTimeStamp '" & cd & ' string];
-            end
-        end
+        string=Xc.buildExecutionCommand;
         
         disp(['[COSSAN-X.Connector.run]  Prepare execution command: ''' string ''])
         
         %% Execute 3rd party solver
         [status, cmdout]=system(string);
+        MstageTimes(irun,5)=toc(Ntic);
         % Report results
         if status ~= 0
             warning('openCOSSAN:Connector:run','Non-zero exit status from execution command.\n %s',cmdout);
@@ -234,11 +233,14 @@ for irun=1:Nsimulations
         end
         
         %% check if the FE has been successfully executed
+        Ntic=tic;
         LerrorFound(irun) = Xc.checkForErrors;
+        MstageTimes(irun,6)=toc(Ntic);
     else
         LerrorFound=false;
     end
     %% Run post execution command
+    Ntic=tic;
     if ~isempty(Xc.SpostExecutionCommand)
         [status, cmdout] = system(['cd ' Xc.SfolderTimeStamp ';' Xc.SpostExecutionCommand]);
         
@@ -255,8 +257,10 @@ for irun=1:Nsimulations
             disp(['[COSSAN-X.Connector.run] Command output: ' result])
         end
     end
+    MstageTimes(irun,7)=toc(Ntic);
     
     %% Extract paramaters
+    Ntic=tic;
     if ~any(Xc.Lextractors)
         if NverboseLevel>2
             disp('[COSSAN-X.Connector.run] No Extractor defined in Connector. An output structure is created')
@@ -277,14 +281,17 @@ for irun=1:Nsimulations
             end
         end
     end
+    MstageTimes(irun,8)=toc(Ntic);
     
     % restore original value of working directory
     %Xc.Sworkingdirectory = SworkingdirectoryOriginal;
     
     
+    Ntic=tic;
     if ~Xc.LkeepSimulationFiles
         rmdir(Xc.SfolderTimeStamp,'s')
     end
+    MstageTimes(irun,9)=toc(Ntic);
     
     % TODO: TO BE CHECKED!
     if ~isempty(OpenCossan.getDatabaseDriver)   % Add record to the Database
@@ -315,6 +322,11 @@ for irun=1:Nsimulations
     
 end
 
+if LresourceUsage
+    for n=1:length(Connector.CSresourceUsageNames)
+        [Tout(1:Nsimulations).(Connector.CSresourceUsageNames{n})]=deal(NaN);
+    end
+end
 
 %% Export results
 if NverboseLevel>2
@@ -322,7 +334,7 @@ if NverboseLevel>2
 end
 
 % create Xoutput object
-if ~exist('Tout','var')
+if ~exist('Tout','var') || isempty(Tout)
     % if no Extractor contained Reponses, the variable Tout has not yet
     % been created.
     warning('openCOSSAN:Connector:run',...
@@ -337,4 +349,5 @@ end
 varargout{1}=Tout;
 varargout{2}=LerrorFound;
 varargout{3}=LsuccessfullExtract;
+varargout{4}=MstageTimes;
 end
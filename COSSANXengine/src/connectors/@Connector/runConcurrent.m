@@ -0,0 +1,235 @@
+function [Tout,LerrorFound,LsuccessfullExtract,MstageTimes] = runConcurrent(Xc,Tinput,LuseOriginalValues,Nsimulations,NverboseLevel)
+%RUNCONCURRENT Private method of Connector. Execute the simulations on the
+%local machine keeping NconcurrentRuns solver processes running
+%
+%   The working directories of all the simulations are prepared first
+%   (copy of the files, injection and pre-execution command). The solvers
+%   are then executed by the mex file runpoolx (see mex/src/ProcessPool),
+%   each in its own folder and with the timeout NtimeoutRun. The results
+%   are extracted as soon as each process terminates, in order of
+%   completion. If LresourceUsage is true the wall clock time, the cpu
+%   time, the peak memory and the I/O volume of each solver process,
+%   measured by runpoolx, are added to the outputs (see
+%   Connector.CSresourceUsageNames), NaN for the processes killed after
+%   the timeout or not started.
+%
+% See Also: http://cossan.co.uk/wiki/index.php/run@Connector
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+CSfoldernames=cell(Nsimulations,1);
+CSfolders=cell(Nsimulations,1);
+CScommands=cell(Nsimulations,1);
+LerrorFound=false(1,Nsimulations);
+LsuccessfullExtract=false(1,Nsimulations);
+MstageTimes=zeros(Nsimulations,length(Connector.CSstageNames));
+Tout=[];
+
+%% Prepare the working directories
+Stimestamp=datestr(now,30);
+for irun=1:Nsimulations
+    OpenCossan.cossanDisp(['[COSSAN-X.Connector.runConcurrent] Prepare simulation #' ...
+        num2str(irun) ' of ' num2str(Nsimulations) ],2);
+    
+    Ntic=tic;
+    CSfoldernames{irun}=[Stimestamp '_sim_' num2str(irun)];
+    Xc.SfolderTimeStamp = fullfile(OpenCossan.getCossanWorkingPath,CSfoldernames{irun});
+    CSfolders{irun}=Xc.SfolderTimeStamp;
+    
+    [~,mess] = mkdir(Xc.SfolderTimeStamp);
+    OpenCossan.cossanDisp(['Create folder: ' Xc.SfolderTimeStamp],3)
+    if ~isempty(mess)
+        disp(['Create folder: ' Xc.SfolderTimeStamp])
+    end
+    MstageTimes(irun,1)=toc(Ntic);
+    
+    %% copy input files
+    Ntic=tic;
+    Xc.copyFiles('Sdestdir',Xc.SfolderTimeStamp);
+    MstageTimes(irun,2)=toc(Ntic);
+end
+
+%% Inject the values of all the simulations at once
+% the time of the injection is shared by the simulations
+Ntic=tic;
+if ~LuseOriginalValues
+    for irun=1:Nsimulations
+        Tinject(irun) = Connector.prepareInputStructure(Tinput,irun); %#ok<AGROW>
+    end
+    Xc.injectBatch(CSfolders,Tinject);
+end
+MstageTimes(:,3)=toc(Ntic)/Nsimulations;
+
+for irun=1:Nsimulations
+    Xc.SfolderTimeStamp = CSfolders{irun};
+    
+    %% Run pre execution command
+    Ntic=tic;
+    if ~isempty(Xc.SpreExecutionCommand)
+        [status,cmdout] = system(['cd ' Xc.SfolderTimeStamp ';' Xc.SpreExecutionCommand]);
+        if status ~= 0
+            warning('openCOSSAN:Connector:run','Non-zero exit status from pre-execution command.\n %s',cmdout);
+        end
+        if NverboseLevel>3
+            disp(['[COSSAN-X.Connector.runConcurrent] Command output: ' cmdout])
+        end
+    end
+    
+    MstageTimes(irun,4)=toc(Ntic);
+    
+    if ~isempty(Xc.Sexecmd)
+        CScommands{irun}=Xc.buildExecutionCommand;
+    end
+end
+
+%% Execute the solvers
+Ncompleted=0;
+Lsolver=~isempty(Xc.Sexecmd);
+if Lsolver
+    if NverboseLevel>2
+        disp(['[COSSAN-X.Connector.runConcurrent] Execute ' num2str(Nsimulations) ...
+            ' simulations with ' num2str(Xc.NconcurrentRuns) ' concurrent processes'])
+        disp(['[COSSAN-X.Connector.runConcurrent] Execution command: ' CScommands{1}])
+    end
+    [Vstatus,Vtime,Musage]=runpoolx(CScommands,CSfolders,Xc.NconcurrentRuns,Xc.NtimeoutRun, ...
+        @collectResults,Xc.SrunLogName);
+else
+    % no solver (as in run): only the post-execution command and the
+    % extraction of the results
+    Vstatus=zeros(Nsimulations,1);
+    Vtime=zeros(Nsimulations,1);
+    Musage=zeros(Nsimulations,length(Connector.CSresourceUsageNames)-1);
+    for irun=1:Nsimulations
+        collectResults(irun,0,0);
+    end
+end
+
+    function collectResults(irun,Nstatus,Ntime)
+        % Called by runpoolx when the simulation irun terminates
+        Ncompleted=Ncompleted+1;
+        disp(['Simulation #' num2str(irun) ' of ' num2str(Nsimulations) ...
+            ' completed (' num2str(Ncompleted) '/' num2str(Nsimulations) ')']);
+        Xc.SfolderTimeStamp=CSfolders{irun};
+        % wall time of the solver process measured by runpoolx
+        MstageTimes(irun,5)=Ntime;
+        
+        switch Nstatus
+            case -1
+                warning('openCOSSAN:Connector:run',...
+                    'Simulation #%i killed after the timeout of %g s',irun,Xc.NtimeoutRun);
+            case -2
+                warning('openCOSSAN:Connector:run',...
+                    'Simulation #%i: the solver could not be started',irun);
+            case 0
+            otherwise
+                warning('openCOSSAN:Connector:run',...
+                    'Non-zero exit status (%i) from execution command.\n See %s',...
+                    Nstatus,fullfile(Xc.SfolderTimeStamp,Xc.SrunLogName));
+        end
+        if NverboseLevel>2
+            disp(['[COSSAN-X.Connector.runConcurrent] Simulation #' num2str(irun) ...
+                ' execution time: ' num2str(Ntime) ' s'])
+        end
+        
+        %% check if the FE has been successfully executed
+        Ntic=tic;
+        LerrorFound(irun) = Lsolver && (Nstatus<0 || Xc.checkForErrors);
+        MstageTimes(irun,6)=toc(Ntic);
+        
+        %% Run post execution command
+        Ntic=tic;
+        if ~isempty(Xc.SpostExecutionCommand)
+            [status, cmdout] = system(['cd ' Xc.SfolderTimeStamp ';' Xc.SpostExecutionCommand]);
+            if status ~= 0
+                warning('openCOSSAN:Connector:run','Non-zero exit status from post-execution command.\n %s',cmdout);
+            end
+            if NverboseLevel>3
+                disp(['[COSSAN-X.Connector.runConcurrent] Command output: ' cmdout])
+            end
+        end
+        MstageTimes(irun,7)=toc(Ntic);
+        
+        %% Extract paramaters
+        Ntic=tic;
+        if ~any(Xc.Lextractors)
+            if isempty(Tout)
+                Tout=struct;
+            end
+            LsuccessfullExtract(irun)=true;
+        else
+            [Textracted,LsuccessfullExtract(irun)] = Xc.extract('Nsimulation',irun);
+            if ~isempty(Textracted)
+                Sname=fieldnames(Textracted);
+                for in=1:length(Sname)
+                    Tout(irun).(Sname{in})=Textracted.(Sname{in});
+                end
+            end
+        end
+        MstageTimes(irun,8)=toc(Ntic);
+        
+        Ntic=tic;
+        if ~Xc.LkeepSimulationFiles
+            rmdir(Xc.SfolderTimeStamp,'s')
+        end
+        MstageTimes(irun,9)=toc(Ntic);
+        
+        if ~isempty(OpenCossan.getDatabaseDriver)   % Add record to the Database
+            if LuseOriginalValues
+                XSimData=SimulationData;
+            else
+                XSimData = SimulationData('Tvalues',Tinput(irun));
+            end
+            if ~isempty(Tout) && ~isempty(fieldnames(Tout)) && irun<=length(Tout)
+                XSimData = XSimData.merge(SimulationData('Tvalues',Tout(irun)));
+            end
+            insertRecord(OpenCossan.getDatabaseDriver,'StableType','Solver',...
+                'Nid',getNextPrimaryID(OpenCossan.getDatabaseDriver,'Solver'),...
+                'XsimulationData',XSimData,...
+                'LsuccessfullExtract',LsuccessfullExtract(irun), ...
+                'SsimulationFolder',CSfolders{irun}, 'Nsimulation',irun, ...
+                'LsuccessfullExecution',~LerrorFound(irun));
+        end
+    end
+
+%% Resources used by the solver processes
+if Xc.LresourceUsage
+    if isempty(Tout)
+        Tout=struct;
+    end
+    Musage=[Vtime Musage];
+    % not measured for the processes killed or not started
+    Musage(Vstatus<0,:)=NaN;
+    for irun=1:Nsimulations
+        for n=1:length(Connector.CSresourceUsageNames)
+            Tout(irun).(Connector.CSresourceUsageNames{n})=Musage(irun,n);
+        end
+    end
+end
+
+%% Complete the structure of the outputs
+% the last simulations can terminate before the others
+if ~isempty(Tout) && length(Tout)<Nsimulations && ~isempty(fieldnames(Tout))
+    Cnames=fieldnames(Tout);
+    Tout(Nsimulations).(Cnames{1})=[];
+end
+end
@@ -94,11 +94,29 @@ if LremoteInjectExtract
     else
        [XSimOut,Tout,LerrorFound] = Xc.runJobRemoteInjectExtract(Tinput,XjobManager);
     end
+elseif XjobManager.NchunkDuration>0 && ~OpenCossan.hasSSHConnection && ...
+        ~strcmpi(Xc.Stype,'aster')
+    % several samples per job, chunk size adapted to the runtime
+    [XSimOut,Tout,LerrorFound] = Xc.runJobChunks(Tinput,XjobManager);
 else
-    % there is only one method for local inject/extract run
+    % one sample per job
     [XSimOut,Tout,LerrorFound] = Xc.runJobLocalInjectExtract(Tinput,XjobManager);
 end
 
+%% Resources used by the solver processes
+% measured only by the local execution of run: NaN, as declared by
+% Coutputnames
+if Xc.LresourceUsage && isempty(Xc.SpluginLibrary) && isempty(Xc.SworkerCommand)
+    warning('openCOSSAN:Connector:runJob',...
+        'The resources used by the solver are not measured by the JobManager: the outputs %s are NaN',...
+        strjoin(Connector.CSresourceUsageNames,', '));
+    for n=1:length(Connector.CSresourceUsageNames)
+        [Tout.(Connector.CSresourceUsageNames{n})]=deal(NaN);
+    end
+    XSimOut=XSimOut.addVariable('Cnames',Connector.CSresourceUsageNames,...
+        'Mvalues',NaN(XSimOut.Nsamples,length(Connector.CSresourceUsageNames)));
+end
+
 varargout{1} = Tout;
 varargout{2} = LerrorFound;
 
@@ -0,0 +1,256 @@
+function [Xout, varargout]= runJobChunks(Xobj,Tinput,Xjob)
+%RUNJOBCHUNKS Private method of Connector. Run the samples on the Grid with
+%jobs of adaptive size, with inject and extract executed locally
+%
+%   The samples are packed in chunks: each job evaluates one after the
+%   other the samples listed in the manifest of its folder, so that the
+%   latency of the job manager is paid once per chunk. The jobs write the
+%   runtime of each sample; the size of the next chunks is chosen from the
+%   median runtime so that a job lasts about Xjob.NchunkDuration seconds.
+%   The first jobs evaluate one sample each. With a limited number of
+%   concurrent jobs the chunks are reduced at the end of the analysis so
+%   that all the slots stay busy.
+%
+%   When all the samples have been submitted and a slot is free, a job
+%   running for more than Xjob.NstragglerFactor times its expected
+%   duration is submitted again with the samples injected in new folders:
+%   the results of the copy that completes first are extracted and the
+%   other job is deleted.
+%
+% See Also: http://cossan.co.uk/wiki/index.php/runJob@Connector
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+Ldatabase = ~isempty(OpenCossan.getDatabaseDriver);
+
+%% Run pre-processor (Only once)
+if ~isempty(Xobj.SpreExecutionCommand)
+    [status, result] = system(Xobj.SpreExecutionCommand);
+    if status ~= 0
+        warning('openCOSSAN:Connector:runJob','Non-zero exit status from pre-execution command.');
+    end
+    OpenCossan.cossanDisp(['[COSSAN-X.Connector.run] Run pre-execution command: ' Xobj.SpreExecutionCommand ],2)
+    OpenCossan.cossanDisp(['[COSSAN-X.Connector.run] Command output: ' result],3)
+end
+
+%% Set the properties of the job
+Xjob.Sworkingdirectory = OpenCossan.getCossanWorkingPath; %set the working directory
+Xjob.Smaininputpath = Xobj.Smaininputpath; %set the main input path
+Xjob.Sexecmd = Xobj.buildChunkCommand; % solver in each folder of the manifest
+SbatchName = Xobj.SfolderTimeStamp; %Unique name for EACH batch
+SjobScriptName = Xjob.SjobScriptName;
+
+Nsamples = length(Tinput);
+Nconcurrent = min(Xjob.Nconcurrent,Nsamples);
+Nprobes = min(Nconcurrent,4); % jobs of one sample that measure the runtime
+
+% chunks of samples (one job each)
+Tchunks = struct('SjobID',{},'Vsamples',{},'CSfolders',{},'Ntwin',{},...
+    'Lspeculative',{},'Lactive',{},'Tstart',{},'SchunkFolder',{});
+CSsampleFolder = cell(Nsamples,1); % folders of the extracted results
+Lextracted = false(Nsamples,1);
+LerrorFound = false(Nsamples,1);
+LsuccessfullExtract = true(Nsamples,1);
+LnonZeroReturn = false;
+Vruntime = zeros(0,1); % measured runtime of the samples
+Nnext = 1; % next sample to submit
+
+while ~all(Lextracted)
+    %% Termination criteria KILL (from GUI)
+    if exist(fullfile(OpenCossan.getCossanWorkingPath,OpenCossan.getKillFilename),'file')
+        delete(fullfile(OpenCossan.getCossanWorkingPath,OpenCossan.getKillFilename));
+        OpenCossan.cossanDisp('Analysis terminated by the user',1);
+        % Cancel submitted jobs
+        Xjob.deleteJob('CSjobID',{Tchunks([Tchunks.Lactive]).SjobID});
+        error('openCOSSAN:Connector:runJob','Simulation killed by the user.')
+    end
+    
+    %% Submit the next chunks
+    Nactive = sum([Tchunks.Lactive]);
+    while Nnext<=Nsamples && Nactive<Nconcurrent
+        Nleft = Nsamples-Nnext+1;
+        if isempty(Vruntime)
+            if length(Tchunks)<Nprobes
+                Nchunk = 1;
+            elseif Nactive>0
+                break % wait for the runtime of the first samples
+            else
+                % the probes completed without runtimes (e.g. the runtimes
+                % file was not written): the slots share the samples left
+                if Nnext==Nprobes+1
+                    warning('openCOSSAN:Connector:runJob',...
+                        'The runtime of the samples is not available: the chunks are not sized by runtime');
+                end
+                Nchunk = ceil(Nleft/(Nconcurrent-Nactive));
+            end
+        else
+            Nchunk = min(Nleft,max(1,round(Xjob.NchunkDuration/median(Vruntime))));
+            if isfinite(Xjob.Nconcurrent)
+                % keep all the slots busy until the end of the analysis
+                Nchunk = min(Nchunk,ceil(Nleft/(Nconcurrent-Nactive)));
+            end
+        end
+        Tchunks(end+1) = submitChunk(Xobj,Xjob,Tinput,Nnext:Nnext+Nchunk-1,...
+            length(Tchunks)+1,false); %#ok<AGROW>
+        Nnext = Nnext+Nchunk;
+        Nactive = Nactive+1;
+    end
+    
+    %% Check the status of the jobs
+    Xjob.waitForJobs(Xobj.sleepTime);
+    Vactive = find([Tchunks.Lactive]);
+    if isempty(Vactive)
+        continue
+    end
+    Cstatus = Xjob.getJobStatus('CSjobID',{Tchunks(Vactive).SjobID});
+    for ichunk = 1:length(Vactive)
+        k = Vactive(ichunk);
+        Sstate = Cstatus{ichunk,1};
+        if any(strcmp(Sstate,{'running','RUN'}))
+            if isempty(Tchunks(k).Tstart)
+                Tchunks(k).Tstart = tic;
+            end
+            continue
+        elseif any(strcmp(Sstate,{'pending','PEND'}))
+            continue
+        elseif strcmp(Sstate,'Error at submission')
+            Xjob.deleteJob('CSjobID',{Tchunks(k).SjobID});
+            CSjobID = Xjob.submitJob('Nsimulationnumber',k,...
+                'Sfoldername',Tchunks(k).SchunkFolder,'Lresubmit',true);
+            Tchunks(k).SjobID = CSjobID{1};
+            continue
+        end
+        
+        %% Job completed: extract the samples not extracted by its twin
+        Tchunks(k).Lactive = false;
+        LnonZeroReturn = LnonZeroReturn || strncmp(Sstate,'Failed',6) || strcmp(Sstate,'EXIT');
+        OpenCossan.cossanDisp(['Job ' Tchunks(k).SjobID ' completed (' ...
+            num2str(length(Tchunks(k).Vsamples)) ' samples)'],1);
+        Vruntime = [Vruntime; readRuntimes(Xobj,Tchunks(k).SchunkFolder)]; %#ok<AGROW>
+        if Tchunks(k).Ntwin>0 && Tchunks(Tchunks(k).Ntwin).Lactive
+            % the other copy of the chunk is no longer needed
+            Xjob.deleteJob('CSjobID',{Tchunks(Tchunks(k).Ntwin).SjobID});
+            Tchunks(Tchunks(k).Ntwin).Lactive = false;
+        end
+        for isample = 1:length(Tchunks(k).Vsamples)
+            ij = Tchunks(k).Vsamples(isample);
+            if Lextracted(ij)
+                continue
+            end
+            Lextracted(ij) = true;
+            CSsampleFolder{ij} = Tchunks(k).CSfolders{isample};
+            [Tsample,LerrorFound(ij),LsuccessfullExtract(ij)] = ...
+                extractSample(Xobj,CSsampleFolder{ij},ij);
+            CSnames = fieldnames(Tsample);
+            for in = 1:length(CSnames)
+                Tout(ij).(CSnames{in}) = Tsample.(CSnames{in}); %#ok<AGROW>
+            end
+        end
+    end
+    
+    %% Speculative resubmission of the stragglers
+    if Nnext>Nsamples && ~isempty(Vruntime) && isfinite(Xjob.NstragglerFactor)
+        Nactive = sum([Tchunks.Lactive]);
+        for k = find([Tchunks.Lactive])
+            if Nactive>=Nconcurrent
+                break
+            end
+            if Tchunks(k).Lspeculative || Tchunks(k).Ntwin>0 || isempty(Tchunks(k).Tstart)
+                continue
+            end
+            Nexpected = Xjob.NstragglerFactor*median(Vruntime)*length(Tchunks(k).Vsamples);
+            if toc(Tchunks(k).Tstart) > max(Nexpected,Xobj.sleepTime)
+                OpenCossan.cossanDisp(['Job ' Tchunks(k).SjobID ' is late: submitting a copy'],1);
+                Ntwin = length(Tchunks)+1;
+                Tchunks(Ntwin) = submitChunk(Xobj,Xjob,Tinput,Tchunks(k).Vsamples,Ntwin,true);
+                Tchunks(Ntwin).Ntwin = k;
+                Tchunks(k).Ntwin = Ntwin;
+                Nactive = Nactive+1;
+            end
+        end
+    end
+end
+
+if LnonZeroReturn
+    warning('openCOSSAN:Connector:runJob','Non-zero exit status from third-party solver.');
+end
+
+OpenCossan.cossanDisp(sprintf('All your jobs have been completed (%i jobs, median runtime %.3g s/sample)',...
+    length(Tchunks),median(Vruntime)),1);
+
+%% Add a entries in the simulation database
+if Ldatabase
+    for isample = 1:Nsamples
+        XSimData = (SimulationData('Tvalues',Tinput(isample)));
+        XSimData = XSimData.merge(SimulationData('Tvalues',Tout(isample)));
+        insertRecord(OpenCossan.getDatabaseDriver,'StableType','Solver',...
+            'Nid',getNextPrimaryID(OpenCossan.getDatabaseDriver,'Solver'),...
+            'XsimulationData',XSimData,...
+            'LsuccessfullExtract',LsuccessfullExtract(isample), ...
+            'SsimulationFolder', CSsampleFolder{isample}, 'Nsimulation',isample, ...
+            'LsuccessfullExecution',~LerrorFound(isample));
+    end
+end
+
+%% Clean the folders of the samples and of the chunks
+if ~Xobj.LkeepSimulationFiles
+    for k = 1:length(Tchunks)
+        CSfolders = [Tchunks(k).CSfolders(:); ...
+            {fullfile(OpenCossan.getCossanWorkingPath,Tchunks(k).SchunkFolder)}];
+        for ifolder = 1:length(CSfolders)
+            if exist(CSfolders{ifolder},'dir')
+                try
+                    rmdir(CSfolders{ifolder},'s');
+                catch ME %#ok<NASGU>
+                    warning('openCOSSAN:Connector:runJob','Cannot delete folder %s\n',CSfolders{ifolder})
+                end
+            end
+        end
+        Sscript = [fullfile(OpenCossan.getCossanWorkingPath,SjobScriptName) num2str(k) '.sh'];
+        if exist(Sscript,'file')
+            delete(Sscript);
+        end
+    end
+end
+
+%% Export results
+Xobj.SfolderTimeStamp = SbatchName;
+OpenCossan.cossanDisp('Writing SimulationData object',3)
+Xout=SimulationData('Tvalues',Tout);
+varargout{1}=Tout;
+varargout{2}=LerrorFound;
+end
+
+function Vruntime = readRuntimes(Xobj,SchunkFolder)
+% runtime of the samples of a chunk written by its job
+Vruntime = zeros(0,1);
+Sfile = fullfile(OpenCossan.getCossanWorkingPath,SchunkFolder,Xobj.SchunkRuntimesName);
+Nfid = fopen(Sfile,'r');
+if Nfid<0
+    return
+end
+Cvalues = textscan(Nfid,'%f %f %f %*[^\n]');
+fclose(Nfid);
+Vruntime = max(Cvalues{3}-Cvalues{2},0);
+Vruntime = Vruntime(~isnan(Vruntime));
+end
@@ -148,7 +148,7 @@ while ~all(Lsubmitted&(Lextracted|Lkilled)) % until all samples have been submit
             OpenCossan.cossanDisp('Waiting for an available slot.',1)
             LfirstWait = false;
         end
-        pause(Xobj.sleepTime)
+        Xjob.waitForJobs(Xobj.sleepTime)
         % get the index of jobs that have been submitted, thus without
         % empty string as IDs
         Lsubmitted = ~strcmp('',CSjobID);
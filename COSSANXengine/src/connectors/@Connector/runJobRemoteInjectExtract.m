@@ -171,7 +171,7 @@ while ~all(Lcompleted==1)
         error('openCOSSAN:Connector:runJob','Simulation killed by the user.')
     end
     
-    pause(Xobj.sleepTime);
+    Xjob.waitForJobs(Xobj.sleepTime);
     Cstatus(~Lcompleted,:) = Xjob.getJobStatus('CSjobID',CSjobID(~Lcompleted));
     Lcompleted = ~(strcmp('running',Cstatus(:,1))|strcmp('pending',Cstatus(:,1)));
 end
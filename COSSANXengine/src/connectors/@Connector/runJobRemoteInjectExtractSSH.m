@@ -5,6 +5,11 @@ function [XSimOut,varargout] = runJobRemoteInjectExtractSSH(Xobj,PinputALL,Xjob)
 % PinputALL: Input data
 % Xjob: JobManager object
 %
+% If LbundledTransfer is true, the folders of all the jobs are copied to
+% the remote host as a single compressed bundle before the jobs are
+% submitted, and their results are copied back in the same way (see
+% transferBundle), instead of one transfer per file and per job.
+%
 % See Also: http://cossan.co.uk/wiki/index.php/runJob@Connector
 %
 % $Copyright~1993-2014,~COSSAN~Working~Group,~University~of~Liverpool,~UK$
@@ -166,6 +171,10 @@ for ijob=1:Njobs
         end
     end
     
+    if Xobj.LbundledTransfer
+        % the folders are copied together after the loop
+        continue
+    end
     % Copy the simulation directory to the work folder of the remote host
     Xssh.putDir('SlocalDirName',Sfoldername,'SremoteDestinationDir',Xjob.Sworkingdirectory);
     
@@ -180,6 +189,21 @@ for ijob=1:Njobs
     
 end
 
+if Xobj.LbundledTransfer
+    %% Copy the folders of all the jobs with a single transfer and submit the jobs
+    CSfolderNames=arrayfun(@(ijob) [Xjob.Sfoldername Xjob.SbatchIdentification num2str(ijob)],...
+        1:Njobs,'UniformOutput',false);
+    Xobj.transferBundle(Xssh,'put',[Xjob.Sfoldername '_inputs'],CSfolderNames,...
+        Xjob.Sworkingdirectory);
+    if NverbosityLevel>=3
+        temp = tic;
+    end
+    for ijob=1:Njobs
+        CSjobID(ijob) = submitJob(Xjob,'nsimulationnumber',ijob,...
+            'Sfoldername',CSfolderNames{ijob});
+    end
+end
+
 %% Job resubmission
 % Because of problem at Daresbury Cluster try to resubmit the jobs that had
 % error at submission
@@ -241,24 +265,39 @@ PoutputALL(Njobs,1) = SimulationData;
 LerrorFound = ones(length(PinputALL),1);
 LsuccessfullExtract = ones(length(PinputALL),1);
 CfolderNames = cell(Njobs,1);
+if Xobj.LbundledTransfer
+    % copy back from remote host the folders (or only the ConnectorOutput.mat
+    % files) of all the jobs with a single transfer
+    if Xobj.LkeepSimulationFiles
+        CSpaths=CSfolderNames;
+    else
+        CSpaths=strcat(CSfolderNames,'/',Xobj.matlabOutputName);
+    end
+    Xobj.transferBundle(Xssh,'get',[Xjob.Sfoldername '_outputs'],CSpaths,...
+        Xssh.SremoteWorkFolder);
+    % remove the folders on the remote host
+    Xssh.issueCommand(['cd ' Xssh.SremoteWorkFolder ' && rm -fr ' strjoin(CSfolderNames,' ')]);
+end
 % load results form output files
 for ijob=1:Njobs
     SsimulationFolderName=[Xjob.Sfoldername Xjob.SbatchIdentification num2str(ijob)];
-    % copy back from remote host the simulation folder with SSH
-    SremoteDirName=fullfileunix(Xssh.SremoteWorkFolder,SsimulationFolderName);
-    
-    if Xobj.LkeepSimulationFiles
-        Xssh.getDir('SremoteDirName',SremoteDirName, ...
-            'SlocalDestinationDir',OpenCossan.getCossanWorkingPath,'Loverwrite',true);
-    else
-        % copy only the ConnectorOutput.mat file
-        Xssh.getFile('SremoteFileName',fullfileunix(SremoteDirName,Xobj.matlabOutputName),...
-            'SlocalDestinationFolder',fullfile(OpenCossan.getCossanWorkingPath,SsimulationFolderName));
+    if ~Xobj.LbundledTransfer
+        % copy back from remote host the simulation folder with SSH
+        SremoteDirName=fullfileunix(Xssh.SremoteWorkFolder,SsimulationFolderName);
+        
+        if Xobj.LkeepSimulationFiles
+            Xssh.getDir('SremoteDirName',SremoteDirName, ...
+                'SlocalDestinationDir',OpenCossan.getCossanWorkingPath,'Loverwrite',true);
+        else
+            % copy only the ConnectorOutput.mat file
+            Xssh.getFile('SremoteFileName',fullfileunix(SremoteDirName,Xobj.matlabOutputName),...
+                'SlocalDestinationFolder',fullfile(OpenCossan.getCossanWorkingPath,SsimulationFolderName));
+        end
+        
+        % remove the folder on the remote host
+        Xssh.issueCommand(['rm -fr ' SremoteDirName]);
     end
     
-    % remove the folder on the remote host
-    Xssh.issueCommand(['rm -fr ' SremoteDirName]);
-    
     try
         load(fullfile(OpenCossan.getCossanWorkingPath,SsimulationFolderName,Xobj.matlabOutputName));
         LerrorFound(Vstart(ijob):Vend(ijob)) = LerrorPartials;
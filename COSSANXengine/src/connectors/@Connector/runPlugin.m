@@ -0,0 +1,53 @@
+function [Tout,LerrorFound,LsuccessfullExtract,MstageTimes] = runPlugin(Xc,Tinput,LuseOriginalValues,Nsimulations)
+%RUNPLUGIN Private method of Connector. Evaluate the model plugin
+%SpluginLibrary in the MATLAB process
+%
+%   The values of the inputs are collected in a matrix (one column for each
+%   input of the plugin, in the order of CSpluginInputNames) and the whole
+%   batch is evaluated by the mex file pluginx (see mex/src/Plugin) without
+%   working directories, input/output files and solver processes. Thread-safe
+%   plugins are evaluated with NconcurrentRuns threads.
+%
+% See Also: http://cossan.co.uk/wiki/index.php/run@Connector
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+assert(~LuseOriginalValues,'openCOSSAN:Connector:runPlugin',...
+    'The values of the inputs are required to evaluate the plugin %s',Xc.SpluginLibrary)
+
+%% Collect the inputs
+Minput=Xc.collectInputs(Tinput,Nsimulations);
+
+%% Evaluate the model
+Ntic=tic;
+OpenCossan.cossanDisp(['[COSSAN-X.Connector.runPlugin] Evaluate ' ...
+    num2str(Nsimulations) ' samples with the plugin ' Xc.SpluginLibrary],2);
+Moutput=pluginx(Xc.SpluginLibrary,Minput,Xc.NconcurrentRuns,Xc.SpluginOptions);
+
+%% Export results
+% the batch is evaluated at once: the same time is assigned to each sample
+MstageTimes=zeros(Nsimulations,length(Connector.CSstageNames));
+MstageTimes(:,strcmp(Connector.CSstageNames,'solver'))=toc(Ntic)/Nsimulations;
+LerrorFound=false(1,Nsimulations);
+LsuccessfullExtract=~any(isnan(Moutput),2)';
+Tout=cell2struct(num2cell(Moutput),Xc.CSpluginOutputNames(:),2)';
@@ -0,0 +1,62 @@
+function [Tout,LerrorFound,LsuccessfullExtract,MstageTimes] = runWorker(Xc,Tinput,LuseOriginalValues,Nsimulations)
+%RUNWORKER Private method of Connector. Evaluate the samples with the
+%persistent solver workers started by SworkerCommand
+%
+%   NconcurrentRuns copies of the solver wrapper are started once in
+%   Smaininputpath and stay resident between the calls of run (see the mex
+%   file workerx in mex/src/Worker). The samples are streamed to the workers
+%   over a socket, without working directories, input decks and process
+%   start-up. A worker that terminates is restarted and its samples are
+%   reported as failed.
+%
+% See Also: http://cossan.co.uk/wiki/index.php/run@Connector
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+assert(~LuseOriginalValues,'openCOSSAN:Connector:runWorker',...
+    'The values of the inputs are required by the worker %s',Xc.SworkerCommand)
+
+%% Collect the inputs
+Minput=Xc.collectInputs(Tinput,Nsimulations);
+
+%% Evaluate the model
+Ntic=tic;
+OpenCossan.cossanDisp(['[COSSAN-X.Connector.runWorker] Evaluate ' ...
+    num2str(Nsimulations) ' samples with ' num2str(Xc.NconcurrentRuns) ...
+    ' workers ' Xc.SworkerCommand],2);
+[Moutput,Vstatus]=workerx(Xc.SworkerCommand,Minput,Xc.NconcurrentRuns,...
+    Xc.Smaininputpath,fullfile(OpenCossan.getCossanWorkingPath,'worker.log'));
+
+if any(Vstatus)
+    warning('openCOSSAN:Connector:runWorker',...
+        '%i of %i samples failed (see %s)',sum(Vstatus~=0),Nsimulations,...
+        fullfile(OpenCossan.getCossanWorkingPath,'worker.log'));
+end
+
+%% Export results
+% the batch is evaluated at once: the same time is assigned to each sample
+MstageTimes=zeros(Nsimulations,length(Connector.CSstageNames));
+MstageTimes(:,strcmp(Connector.CSstageNames,'solver'))=toc(Ntic)/Nsimulations;
+LerrorFound=(Vstatus~=0)';
+LsuccessfullExtract=~any(isnan(Moutput),2)';
+Tout=cell2struct(num2cell(Moutput),Xc.CSpluginOutputNames(:),2)';
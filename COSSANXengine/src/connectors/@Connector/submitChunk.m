@@ -0,0 +1,76 @@
+function Tchunk = submitChunk(Xobj,Xjob,Tinput,Vsamples,k,Lspeculative)
+%SUBMITCHUNK Private method of Connector. Prepare the folders of the
+%samples Vsamples of Tinput, write the manifest and submit the job k that
+%evaluates them one after the other
+%
+%   The command of the job (buildChunkCommand) and its working directory
+%   are set in Xjob by the caller. The folders of a speculative copy
+%   (Lspeculative) get the suffix '_spec'. The output structure contains
+%   the job identifier (SjobID), the folders of the samples (CSfolders) and
+%   the folder of the job (SchunkFolder).
+%
+% See Also: http://cossan.co.uk/wiki/index.php/runJob@Connector
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+Tchunk.SjobID = '';
+Tchunk.Vsamples = Vsamples;
+Tchunk.CSfolders = cell(length(Vsamples),1);
+Tchunk.Ntwin = 0;
+Tchunk.Lspeculative = Lspeculative;
+Tchunk.Lactive = true;
+Tchunk.Tstart = [];
+
+% folder of the job (manifest, runtimes and job output)
+SchunkFolder = [Xobj.SfolderTimeStamp '_chunk_' num2str(k)];
+Tchunk.SchunkFolder = SchunkFolder;
+SchunkPath = fullfile(OpenCossan.getCossanWorkingPath,SchunkFolder);
+[~,mess] = mkdir(SchunkPath);
+OpenCossan.cossanDisp(['Create folder: ' SchunkFolder ' mess: ' mess],3)
+
+for isample = 1:length(Vsamples)
+    SsimulationFolderName = [Xobj.SfolderTimeStamp Xjob.SbatchIdentification ...
+        num2str(Vsamples(isample))];
+    if Lspeculative
+        SsimulationFolderName = [SsimulationFolderName '_spec']; %#ok<AGROW>
+    end
+    Sworkingdirectory = fullfile(OpenCossan.getCossanWorkingPath,SsimulationFolderName);
+    [~,mess] = mkdir(Sworkingdirectory);
+    OpenCossan.cossanDisp(['Create folder: ' SsimulationFolderName ' mess: ' mess],3)
+    Xobj.copyFiles('Sdestdir',Sworkingdirectory);
+    Tchunk.CSfolders{isample} = Sworkingdirectory;
+    Tinject(isample) = Connector.prepareInputStructure(Tinput,Vsamples(isample)); %#ok<AGROW>
+end
+% the input files of all the samples of the chunk are written at once
+injectBatch(Xobj,Tchunk.CSfolders,Tinject);
+
+% manifest: one folder per line
+Nfid = fopen(fullfile(SchunkPath,Xobj.SchunkManifestName),'w');
+fprintf(Nfid,'%s\n',Tchunk.CSfolders{:});
+fclose(Nfid);
+
+OpenCossan.cossanDisp(sprintf('Submitting samples %i-%i (job %i)',...
+    Vsamples(1),Vsamples(end),k),2);
+CSjobID = Xjob.submitJob('Nsimulationnumber',k,'Sfoldername',SchunkFolder);
+Tchunk.SjobID = CSjobID{1};
+end
@@ -0,0 +1,64 @@
+function Tjob = submitJobChunk(Xobj,Tinput,Xjob,Nblock,LfirstJob)
+%SUBMITJOBCHUNK Submit one job that evaluates all the samples of Tinput and
+%return without waiting for it
+%
+%   USAGE:  Tjob=Xc.submitJobChunk(Tinput,Xjobmanager,Nblock,LfirstJob)
+%
+%   This method is used by the pipelined execution of the Evaluator, that
+%   evaluates the samples in blocks. Nblock is the number of the block and
+%   must be unique for the JobManager. The samples are injected locally and
+%   evaluated one after the other by the job. The job is monitored with
+%   Xjobmanager.getJobStatus('CSjobID',{Tjob.SjobID}) and, once completed,
+%   its results are read with collectJobChunk. The pre-execution command
+%   is executed once, with the first job of the solver (LfirstJob true),
+%   whatever its block; with Lremoteprepost it is left to the job script
+%   (Xjobmanager.Spreexecmd).
+%
+% See Also: http://cossan.co.uk/wiki/index.php/runJob@Connector
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+assert(~OpenCossan.hasSSHConnection,'openCOSSAN:Connector:submitJobChunk',...
+    'The jobs of the pipelined execution cannot be submitted via SSH')
+
+%% Run pre-processor (Only once)
+if LfirstJob && ~isempty(Xobj.SpreExecutionCommand)
+    [status, result] = system(Xobj.SpreExecutionCommand);
+    if status ~= 0
+        warning('openCOSSAN:Connector:runJob','Non-zero exit status from pre-execution command.');
+    end
+    OpenCossan.cossanDisp(['[COSSAN-X.Connector.run] Run pre-execution command: ' Xobj.SpreExecutionCommand ],2)
+    OpenCossan.cossanDisp(['[COSSAN-X.Connector.run] Command output: ' result],3)
+end
+
+%% Set the properties of the job
+% folders of the block: unique for the job name and the block number
+Xobj.SfolderTimeStamp = [datestr(now,30) '_' Xjob.Sjobname '_' num2str(Nblock)];
+Xjob.Sworkingdirectory = OpenCossan.getCossanWorkingPath;
+Xjob.Smaininputpath = Xobj.Smaininputpath;
+Xjob.Sexecmd = Xobj.buildChunkCommand;
+
+Tjob = submitChunk(Xobj,Xjob,Tinput,1:length(Tinput),Nblock,false);
+Tjob.SjobScript = [fullfile(OpenCossan.getCossanWorkingPath,Xjob.SjobScriptName) ...
+    num2str(Nblock) '.sh'];
+end
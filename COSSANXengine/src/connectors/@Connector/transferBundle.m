@@ -0,0 +1,101 @@
+function Lsuccess = transferBundle(Xobj,Xssh,Sdirection,Sname,CSpaths,SremoteDir)
+%transferBundle is a private method of runJobRemoteInjectExtractSSH that
+%   moves the folders or files CSpaths (relative to the working path, on
+%   both hosts) between this machine and the folder SremoteDir of the
+%   remote host as a single compressed bundle (see mex/src/Bundle), instead
+%   of one transfer per file.
+%
+%   Sdirection 'put' packs CSpaths locally, copies the bundle and unpacks
+%   it on the remote host; 'get' does the opposite, skipping the missing
+%   paths (e.g. the outputs of the failed jobs). On the remote host the
+%   bundle is handled by the program cossanbundle, placed with the
+%   compiled Connector wrapper, or by tar if cossanbundle is not
+%   available. The bundle is written in the folder Sname, removed after
+%   the transfer. Lsuccess is false if the bundle could not be retrieved.
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+assert(exist('bundlex','file')==3,'openCOSSAN:Connector:runJobRemoteInjectExtractSSH',...
+    'The mex file bundlex is not available (see mex/src/Bundle/makeBundle.m)')
+
+Sroot=OpenCossan.getCossanWorkingPath;
+Stransfer=fullfile(Sroot,Sname);
+Sbundle=fullfile(Stransfer,[Sname '.tar.gz']);
+SremoteBundle=[Sname '/' Sname '.tar.gz'];
+Shelper=quote(fullfileunix(Xssh.SremoteExternalPath,...
+    strrep(Xobj.SconnectorRelativePath,'\','/'),'cossanbundle'));
+CSquoted=cellfun(@quote,CSpaths,'UniformOutput',false);
+Lsuccess=true;
+
+[~,mess]=mkdir(Stransfer);
+if ~isempty(mess)
+    OpenCossan.cossanDisp(['Create folder: ' Stransfer ' ' mess],3)
+end
+% the local copy of the bundle is removed at the end, also on errors
+XcleanUp=onCleanup(@() rmdir(Stransfer,'s')); %#ok<NASGU>
+Ntic=tic;
+switch lower(Sdirection)
+    case 'put'
+        Tstats=bundlex('pack',Sbundle,Sroot,CSpaths);
+        Xssh.putDir('SlocalDirName',Stransfer,'SremoteDestinationDir',SremoteDir);
+        [status,result]=Xssh.issueCommand(['cd ' quote(SremoteDir) ...
+            ' && if [ -x ' Shelper ' ]; then ' Shelper ' unpack ' quote(SremoteBundle) ' . ;' ...
+            ' else tar -xzf ' quote(SremoteBundle) ' ; fi ; Nstatus=$? ;' ...
+            ' rm -fr ' quote(Sname) ' ; [ $Nstatus -eq 0 ]']);
+        assert(status==0,'openCOSSAN:Connector:runJobRemoteInjectExtractSSH',...
+            'The folders of the jobs cannot be unpacked on the remote host\n%s',result)
+    case 'get'
+        % the missing paths are skipped also by tar
+        [status,result]=Xssh.issueCommand(['cd ' quote(SremoteDir) ...
+            ' && mkdir -p ' quote(Sname) ...
+            ' && if [ -x ' Shelper ' ]; then ' Shelper ' pack ' quote(SremoteBundle) ' . ' ...
+            strjoin(CSquoted,' ') ' ; else set -- ; for Spath in ' strjoin(CSquoted,' ') ...
+            ' ; do [ -e "$Spath" ] && set -- "$@" "$Spath" ; done ;' ...
+            ' tar -czf ' quote(SremoteBundle) ' "$@" ; fi']);
+        if status==0
+            Xssh.getFile('SremoteFileName',fullfileunix(SremoteDir,SremoteBundle),...
+                'SlocalDestinationFolder',Stransfer);
+        end
+        Xssh.issueCommand(['rm -fr ' quote(fullfileunix(SremoteDir,Sname))]);
+        if status==0 && exist(Sbundle,'file')
+            Tstats=bundlex('unpack',Sbundle,Sroot);
+        else
+            warning('openCOSSAN:Connector:runJobRemoteInjectExtractSSH',...
+                'The results of the jobs cannot be retrieved from the remote host\n%s',result)
+            Lsuccess=false;
+        end
+    otherwise
+        error('openCOSSAN:Connector:transferBundle',...
+            'Sdirection must be ''put'' or ''get''')
+end
+
+if Lsuccess
+    OpenCossan.cossanDisp(sprintf(['[OpenCossan:Connector:transferBundle] %s: %i files ' ...
+        '(%.3g MB) transferred in %.3g s'],Sdirection,Tstats.Nfiles,Tstats.Nbytes/2^20,toc(Ntic)),3)
+end
+end
+
+function Squoted = quote(S)
+% quote a string for the remote shell
+Squoted=['''' strrep(S,'''','''\''''') ''''];
+end
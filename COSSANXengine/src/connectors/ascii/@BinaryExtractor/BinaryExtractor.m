@@ -0,0 +1,85 @@
+classdef BinaryExtractor < Extractor
+    % Class BINARYEXTRACTOR
+    %
+    % Objects of class BinaryExtractor read the responses from a binary
+    % result file written by the solver (see mex/src/Extractor/cossan_result.h)
+    % instead of parsing an ASCII output file. The file contains the names,
+    % the sizes and the values (little-endian float64) of the responses, so
+    % that no anchors, formats or text conversion are required.
+    %
+    % The responses are selected by name. Scalar values are returned as
+    % double, vectors and matrices as Dataseries (see Response.createOutput).
+    % The file is read with the mex file readresultx when available.
+    %
+    % See also: Extractor, Response
+    
+    methods
+        function Xobj  = BinaryExtractor(varargin)
+            % Constructor BinaryExtractor object
+            %
+            %   MANDATORY ARGUMENTS:
+            %   - Sfile:            name of the binary result file
+            %   - CSresponseNames:  names of the responses to be extracted
+            %     or
+            %   - Xresponse/CXresponse: Response objects (only Sname and the
+            %                       Dataseries options are used)
+            %
+            %   OPTIONAL ARGUMENTS:
+            %   - Sdescription:     description of the Extractor
+            %   - Srelativepath:    path of the result file
+            %   - Sworkingdirectory: set by Connector
+            %
+            %   EXAMPLE:
+            %     Xe = BinaryExtractor('Sfile','result.bin','CSresponseNames',{'out'});
+            
+            %% Processing Inputs
+            OpenCossan.validateCossanInputs(varargin{:})
+            
+            if nargin==0
+                return
+            end
+            
+            %% Set options
+            for k=1:2:length(varargin)
+                switch lower(varargin{k})
+                    case {'sdescription'}
+                        Xobj.Sdescription=varargin{k+1};
+                    case {'sfile'}
+                        Xobj.Sfile=varargin{k+1};
+                    case {'sworkingdirectory'}
+                        Xobj.Sworkingdirectory=varargin{k+1};
+                    case {'srelativepath'}
+                        Xobj.Srelativepath=varargin{k+1};
+                    case {'csresponsenames'}
+                        % the values keep the shape written by the solver
+                        CSresponseNames=varargin{k+1};
+                        for n=1:length(CSresponseNames)
+                            Xresponse(n)=Response('Sname',CSresponseNames{n},...
+                                'Nrepeat',Inf,'LisMatrix',true); %#ok<AGROW>
+                        end
+                        Xobj.Xresponse=Xresponse;
+                    case {'xresponse'}
+                        Xobj.Xresponse=varargin{k+1};
+                    case {'cxresponse'}
+                        Xobj.Xresponse=[varargin{k+1}{:}];
+                    otherwise
+                        error('openCOSSAN:BinaryExtractor','Field name %s not allowed',varargin{k});
+                end
+            end
+            if isempty(Xobj.Sfile)
+                error('openCOSSAN:BinaryExtractor','No file name specified');
+            end
+            if isempty(Xobj.Xresponse)
+                error('openCOSSAN:BinaryExtractor','No responses defined');
+            end
+        end %end constructor
+        
+        [Tout,LsuccessfullExtract] = extract(Xobj,varargin)
+    end
+    
+    methods (Static)
+        % MATLAB reader of the binary result files (same outputs of
+        % readresultx)
+        [Cvalues,Vstatus,CSnames] = readResultFile(Sfile,CSnames)
+    end
+end
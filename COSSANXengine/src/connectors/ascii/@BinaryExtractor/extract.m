@@ -0,0 +1,91 @@
+function [Tout,LsuccessfullExtract] = extract(Xobj,varargin)
+%EXTRACT  read the responses from a binary result file and create a
+%structure Tout
+%
+%   The values are read with the mex file readresultx (see
+%   mex/src/Extractor) or with BinaryExtractor.readResultFile.
+%
+%   Usage:  [Tout,LsuccessfullExtract] = Xe.extract('Nsimulation',n)
+%
+% See also: Extractor, BinaryExtractor
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+%% Initialisation
+% Nsimulation is only use to display messages.
+Nsimulation = 1;
+Xresponse = Xobj.Xresponse;
+
+%% Processing Inputs
+OpenCossan.validateCossanInputs(varargin{:});
+for iopt=1:2:length(varargin)
+    switch lower(varargin{iopt})
+        case {'nsimulation'}
+            Nsimulation = varargin{iopt+1};
+        otherwise
+            warning('OpenCossan:BinaryExtractor:extract:wrongOption',...
+                ['Optional parameter ' varargin{iopt} ' not allowed']);
+    end
+end
+
+Tout = struct;
+LsuccessfullExtract = false;
+CSnames = {Xresponse.Sname};
+
+%% Read the result file
+SfullFileName=fullfile(Xobj.Sworkingdirectory,Xobj.Srelativepath,Xobj.Sfile);
+try
+    if exist('readresultx','file')==3
+        [Cvalues,Vstatus]=readresultx(SfullFileName,CSnames);
+    else
+        [Cvalues,Vstatus]=BinaryExtractor.readResultFile(SfullFileName,CSnames);
+    end
+catch ME
+    % Return NaN values if the file is missing or corrupted
+    warning('OpenCossan:BinaryExtractor:extract:noFile',...
+        strrep(['The results file ' SfullFileName ' of simulation #' ...
+        num2str(Nsimulation) ' cannot be read: ' ME.message],'\','\\'))
+    for iresponse=1:length(CSnames)
+        Tout.(CSnames{iresponse})=NaN;
+    end
+    return
+end
+OpenCossan.cossanDisp(['[OpenCossan.BinaryExtractor.extract] File ' SfullFileName ...
+    ' read correctly'],4 )
+
+%% Create the outputs
+LresponseSuccess=true(1,length(CSnames));
+for iresponse=1:length(CSnames)
+    if Vstatus(iresponse)~=0
+        warning('OpenCossan:BinaryExtractor:extract:problemExtraction',...
+            'Response %s not found in the file %s',CSnames{iresponse},SfullFileName)
+        Tout.(CSnames{iresponse})=NaN;
+        LresponseSuccess(iresponse)=false;
+        continue
+    end
+    [Tresponse,LresponseSuccess(iresponse)]= ...
+        Xresponse(iresponse).createOutput(Cvalues{iresponse});
+    Tout.(CSnames{iresponse})=Tresponse.(CSnames{iresponse});
+end
+
+LsuccessfullExtract=all(LresponseSuccess);
@@ -0,0 +1,82 @@
+function [Cvalues,Vstatus,CSnames] = readResultFile(Sfile,CSnames)
+%READRESULTFILE Static method of BinaryExtractor. Read the responses of a
+%binary result file (see mex/src/Extractor/cossan_result.h)
+%
+%   This is the MATLAB implementation of the mex file readresultx.
+%
+%   Usage:  [Cvalues,Vstatus,CSnames] = BinaryExtractor.readResultFile(Sfile)
+%           [Cvalues,Vstatus] = BinaryExtractor.readResultFile(Sfile,CSnames)
+%
+%   Cvalues : values of the responses (cell array)
+%   Vstatus : 0 or 1 if the response is not in the file
+%   CSnames : names of the responses (all the responses of the file by
+%             default)
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+[Nfid,Serror]=fopen(Sfile,'r','ieee-le');
+assert(isempty(Serror),'openCOSSAN:BinaryExtractor:readResultFile:noFile',...
+    'Cannot open the file %s: %s',Sfile,Serror)
+Xcleanup=onCleanup(@() fclose(Nfid));
+
+%% Header
+Smagic=fread(Nfid,[1 8],'*char');
+assert(strcmp(Smagic,'COSSANRB'),'openCOSSAN:BinaryExtractor:readResultFile',...
+    'The file %s is not a binary result file',Sfile)
+Nversion=fread(Nfid,1,'uint32');
+assert(Nversion==1,'openCOSSAN:BinaryExtractor:readResultFile',...
+    'Version %i of the file %s not supported',Nversion,Sfile)
+Nresponses=fread(Nfid,1,'uint32');
+fread(Nfid,1,'uint64'); % size of the header
+
+%% Description of the responses
+CSfileNames=cell(Nresponses,1);
+Msize=zeros(Nresponses,2);
+Voffset=zeros(Nresponses,1);
+for n=1:Nresponses
+    Lname=fread(Nfid,1,'uint32');
+    fread(Nfid,1,'uint32'); % reserved
+    Msize(n,:)=fread(Nfid,[1 2],'uint64');
+    Voffset(n)=fread(Nfid,1,'uint64');
+    CSfileNames{n}=fread(Nfid,[1 Lname],'*char');
+    % names padded to a multiple of 8 bytes
+    fseek(Nfid,mod(-Lname,8),'cof');
+end
+
+%% Values
+if nargin<2
+    CSnames=CSfileNames;
+end
+Cvalues=cell(length(CSnames),1);
+Vstatus=zeros(length(CSnames),1);
+for n=1:length(CSnames)
+    iresponse=find(strcmp(CSfileNames,CSnames{n}),1);
+    if isempty(iresponse)
+        Vstatus(n)=1;
+        continue
+    end
+    fseek(Nfid,Voffset(iresponse),'bof');
+    [Cvalues{n},Nread]=fread(Nfid,Msize(iresponse,:),'double');
+    assert(Nread==prod(Msize(iresponse,:)),'openCOSSAN:BinaryExtractor:readResultFile',...
+        'Cannot read the response %s from the file %s',CSnames{n},Sfile)
+end
@@ -15,6 +15,7 @@ classdef Extractor
         Sfile                   % name of the output file     
         Sworkingdirectory = ''  % directory where the simulation is performed - set by Connector
         Xresponse               % Array of Response objects
+        LnativeEngine=false     % Extract the responses with the native engine (extractx)
     end
     
     properties (Dependent=true)        
@@ -42,6 +43,8 @@ classdef Extractor
             %   - Srelativepath:        path of the ASCII output file
             %   - Sfile:        name of the ASCII output file
             %   - Xresponse:    array of response Objects
+            %   - LnativeEngine: extract the responses with the mex file
+            %                   extractx (see mex/src/Extractor)
             %
             %   EXAMPLES:
             %   Usage:
@@ -85,6 +88,8 @@ classdef Extractor
                         Xobj.Sfile = varargin{iVopt + 1};
                     case 'xresponse'
                         Xobj.Xresponse = varargin{iVopt + 1};
+                    case 'lnativeengine'
+                        Xobj.LnativeEngine = varargin{iVopt + 1};
                     case 'cxresponse'
                         for n=1:length(varargin{iVopt + 1})
                             if ~isa(varargin{iVopt + 1}{n},'Response')
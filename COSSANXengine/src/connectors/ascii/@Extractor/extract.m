@@ -27,7 +27,6 @@ function [Tout,LsuccessfullExtract] = extract(Xobj,varargin)
 %% Initialisation
 % Nsimulation is only use to display messages.
 Nsimulation = 1;
-LresponseSuccessfullExtract = false(Xobj.Nresponse,1);
 
 % extract the property Xresponse from the extractor (performance is greatly
 % improved by using this vector of responses instead of accessing the
@@ -83,16 +82,53 @@ else
 end
 
 %% Extract the values from file
-% Initialise structure storing values of variables 
-TfileInfo=struct('Vpos',[],'out',[],'status',[]);
 LresponseSuccess=true(1,Xobj.Nresponse);
-for iresponse=1:Xobj.Nresponse
-    % Process     
-    [Tresponse,TfileInfo,LresponseSuccess(iresponse)]= ...
-        Xresponse(iresponse).extract('Nfid',Nfid,...
-        'Nsimulation',Nsimulation,'TresponsePosition',TfileInfo);
-    Tout.(Xresponse(iresponse).Sname)=Tresponse.(Xresponse(iresponse).Sname);
-    
+Lnative=Xobj.LnativeEngine && exist('extractx','file')==3;
+if Lnative
+    % The native engine scans the file once for all the anchors (see
+    % mex/src/Extractor). Regular expressions and the formats not
+    % supported by extractx are processed by the Response objects.
+    Tresponses=struct('Sname',{Xresponse.Sname}, ...
+        'Sfieldformat',{Xresponse.Sfieldformat}, ...
+        'Clookoutfor',{Xresponse.Clookoutfor}, ...
+        'Svarname',{Xresponse.Svarname}, ...
+        'Nrownum',{Xresponse.Nrownum}, ...
+        'Nrepeat',{Xresponse.Nrepeat}, ...
+        'NrepeatAnchor',{Xresponse.NrepeatAnchor}, ...
+        'LrowConcat',cellfun(@(V) ~isempty(V),{Xresponse.VcoordRow},'UniformOutput',false));
+    try
+        [Cvalues,Vstatus]=extractx(SfullFileName,Tresponses);
+    catch ME
+        if ~strcmp(ME.identifier,'openCOSSAN:extractx:unsupported')
+            rethrow(ME)
+        end
+        OpenCossan.cossanDisp(['[OpenCossan.Extractor.extract] Native extraction not available: ' ...
+            ME.message],3 )
+        Lnative=false;
+    end
+end
+
+if Lnative
+    for iresponse=1:Xobj.Nresponse
+        if Vstatus(iresponse)~=0
+            warning('OpenCossan:Extractor:extract:problemExtraction',...
+                'Problems extracting value(s) for %s (status %i)', ...
+                Xresponse(iresponse).Sname,Vstatus(iresponse))
+        end
+        [Tresponse,LresponseSuccess(iresponse)]= ...
+            Xresponse(iresponse).createOutput(Cvalues{iresponse});
+        Tout.(Xresponse(iresponse).Sname)=Tresponse.(Xresponse(iresponse).Sname);
+    end
+else
+    % Initialise structure storing values of variables 
+    TfileInfo=struct('Vpos',[],'out',[],'status',[]);
+    for iresponse=1:Xobj.Nresponse
+        % Process     
+        [Tresponse,TfileInfo,LresponseSuccess(iresponse)]= ...
+            Xresponse(iresponse).extract('Nfid',Nfid,...
+            'Nsimulation',Nsimulation,'TresponsePosition',TfileInfo);
+        Tout.(Xresponse(iresponse).Sname)=Tresponse.(Xresponse(iresponse).Sname);
+    end
 end
 
 % close the file
@@ -101,4 +137,4 @@ if ~isempty(status)
     OpenCossan.cossanDisp(['[COSSAN-X.Extractor.extract] Closing output files (status: ' status ')' ],4 )
 end
 
-LsuccessfullExtract=all(LresponseSuccessfullExtract);
\ No newline at end of file
+LsuccessfullExtract=all(LresponseSuccess);
\ No newline at end of file
@@ -54,6 +54,7 @@ classdef Injector
         Sworkingdirectory       % directory where the FE simulation is performed - set by Connector
         Xidentifier             % Array of Identifier objects
         Cinputnames
+        LnativeEngine=false     % Use the native engine (injectx) to write the input files
     end
     
     properties (Hidden=true,SetAccess = private)
@@ -111,6 +112,8 @@ classdef Injector
             %                     (mandatory with the option Stype=scan)
             %    - Sscanfilepath: path of the file with the COSSAN indentifiers
             %                     (mandatory with the option Stype=scan)
+            %    - LnativeEngine: write the input files with the mex file
+            %                     injectx (see mex/src/Injector)
             %
             %
             %
@@ -185,6 +188,8 @@ classdef Injector
                         Xinjector.Xidentifier=varargin{k+1};
                     case {'lreplaceidentifiers'}
                         Xinjector.Lreplaceidentifiers=varargin{k+1};
+                    case {'lnativeengine'}
+                        Xinjector.LnativeEngine=varargin{k+1};
                     otherwise
                         error('OpenCossan:injector:unknownInputArgument', ...
                             ' The PropertyName %s is not a valid input argument',varargin{k})
@@ -345,6 +350,8 @@ classdef Injector
         
         inject(Xi,Pinput)
         
+        injectBatch(Xi,CSworkingdirectories,Tinput)
+        
         display(Xi)
     end
     
@@ -352,6 +359,8 @@ classdef Injector
 
         Xidentifier=scanFile(Xobj,Nfid)         % Scan ASCII file with identifier
         
+        Lnative=useNativeEngine(Xobj)           % Check if injectx can be used
+        
         function Xinj = createByScan(Xinj)
             %CREATEBYSCAN Private function to create the Injector from the scanning on an input
             %file containing the OpenCossan identifiers
@@ -61,7 +61,24 @@ if OpenCossan.getVerbosityLevel>3
     type(SfullName)
 end
 
-if isa(Xi,'TableInjector')    
+Lnative=useNativeEngine(Xi);
+if Lnative
+    % Render the input file from the compiled identifiers (see injectx)
+    try
+        injectx(fullfile(Xi.Sscanfilepath,Xi.Sscanfilename),SfullName,Tinput);
+    catch ME
+        if ~strcmp(ME.identifier,'openCOSSAN:injectx:unsupportedClass')
+            rethrow(ME)
+        end
+        OpenCossan.cossanDisp(['[OpenCossan.Injector.inject] ' ME.message ...
+            ' (using Identifier.replaceValues)'],3)
+        Lnative=false;
+    end
+end
+
+if Lnative
+    OpenCossan.cossanDisp('[OpenCossan.Injector.inject] Values injected by injectx',4)
+elseif isa(Xi,'TableInjector')    
     Xi.doInject(Tinput);
 else
     
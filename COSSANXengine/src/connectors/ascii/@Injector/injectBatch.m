@@ -0,0 +1,79 @@
+function injectBatch(Xi,CSworkingdirectories,Tinput)
+%INJECTBATCH  Inject the input values into the input files of several
+%working directories
+%
+%   Arguments:
+%   ==========
+%   Xi                    Injector object
+%   CSworkingdirectories  Cell array of working directories
+%   Tinput                Structure array of the input values (one element
+%                         per working directory) or a single structure
+%                         used for all the directories
+%
+%   The input file Sfile is written in fullfile(Sworkingdirectory,
+%   Srelativepath,Sfile) of each working directory. When the native engine
+%   is enabled (LnativeEngine) all the files are rendered by a single call
+%   of injectx, otherwise the method inject is called for each directory.
+%
+%   Usage:  Xi.injectBatch(CSworkingdirectories,Tinput)
+%
+%   see also: Injector, inject
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of OpenCossan.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% OpenCossan is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% OpenCossan is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with OpenCossan.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+if ischar(CSworkingdirectories)
+    CSworkingdirectories={CSworkingdirectories};
+end
+
+assert(isa(Tinput,'struct'),'OpenCossan:injector:injectBatch', ...
+    'At least the input values must be passed as a structure');
+assert(length(Tinput)==1 || length(Tinput)==length(CSworkingdirectories), ...
+    'OpenCossan:injector:injectBatch', ...
+    'The number of realizations (%i) and working directories (%i) must agree', ...
+    length(Tinput),length(CSworkingdirectories));
+
+%% Native engine
+if useNativeEngine(Xi)
+    CSfiles=cell(size(CSworkingdirectories));
+    for n=1:numel(CSworkingdirectories)
+        CSfiles{n}=fullfile(CSworkingdirectories{n},Xi.Srelativepath,Xi.Sfile);
+    end
+    OpenCossan.cossanDisp(['[OpenCossan.Injector.injectBatch] Writing ' ...
+        num2str(numel(CSfiles)) ' input files with injectx'],3)
+    try
+        injectx(fullfile(Xi.Sscanfilepath,Xi.Sscanfilename),CSfiles,Tinput);
+        return
+    catch ME
+        if ~strcmp(ME.identifier,'openCOSSAN:injectx:unsupportedClass')
+            rethrow(ME)
+        end
+        OpenCossan.cossanDisp(['[OpenCossan.Injector.injectBatch] ' ME.message ...
+            ' (using Identifier.replaceValues)'],3)
+    end
+end
+
+%% One file at a time
+for n=1:numel(CSworkingdirectories)
+    Xi.Sworkingdirectory=CSworkingdirectories{n};
+    Xi.inject(Tinput(min(n,length(Tinput))));
+end
@@ -0,0 +1,34 @@
+function Lnative=useNativeEngine(Xobj)
+%USENATIVEENGINE Private method of Injector. Returns true if the input
+%files can be written by the mex file injectx (see mex/src/Injector).
+%
+% The native engine renders the input file from the file with the
+% identifiers. It is used only when LnativeEngine is true, the mex file is
+% available and the identifiers have been created by scanning a file.
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of OpenCossan.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% OpenCossan is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% OpenCossan is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with OpenCossan.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+Lnative = Xobj.LnativeEngine && ~isa(Xobj,'TableInjector') && ...
+    ~isempty(Xobj.Xidentifier) && ~isempty(Xobj.Sscanfilename) && ...
+    exist('injectx','file')==3 && ...
+    exist(fullfile(Xobj.Sscanfilepath,Xobj.Sscanfilename),'file')==2;
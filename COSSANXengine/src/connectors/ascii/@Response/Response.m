@@ -146,6 +146,10 @@ classdef Response
         end
         
         Xds = createDataseries(Xobj,Moutput)
+        
+        % Associate the extracted values to the output (scalar or
+        % Dataseries)
+        [Toutput,LresponseSuccess]=createOutput(Xobj,Moutput)
 
         function Ndata = get.Ndata(Xobj)
             if Xobj.LisMatrix
@@ -0,0 +1,36 @@
+function [Toutput,LresponseSuccess] = createOutput(Xresponse,Moutput)
+%CREATEOUTPUT This function associates the values extracted from the file
+%to the output of the Response. 
+%
+% A scalar value is stored directly in the output structure, vectors and
+% matrices are stored in a Dataseries (see createDataseries). The method
+% is shared by extract and by the native extractor of Extractor.
+
+LresponseSuccess=true;
+
+if any(isnan(Moutput))
+    LresponseSuccess=false;
+end
+
+% Associate read value with the output parameter
+try
+    OpenCossan.cossanDisp(['[OpenCossan:Response:extract] Response' Xresponse.Sname ': ' ],4 )
+    OpenCossan.cossanDisp('[OpenCossan:Response:extract] Value(s) extracted: ' ,4 )
+    if OpenCossan.getVerbosityLevel>3
+        disp(Moutput)
+    end
+    % check the size of Moutput to assign to the right object
+    if numel(Moutput)==1
+        % Moutput is a scalar, thus it is saved directly in the output
+        % structure
+        Toutput.(Xresponse.Sname)=Moutput;
+    else
+        % Moutput is a vector/matrix, thus it is saved in a Dataseries
+        % according to the properties of the response object
+        Toutput.(Xresponse.Sname)= Xresponse.createDataseries(Moutput);
+    end
+catch ME
+    OpenCossan.cossanDisp(['[OpenCossan:Response:extract] Failed to associate extracted value to the output ( ' ME.message ')' ],4 )
+    Toutput.(Xresponse.Sname)=NaN;
+    LresponseSuccess=false;
+end
@@ -6,7 +6,6 @@ function [Toutput,TfileInfo,LresponseSuccess] = extract(Xresponse,varargin)
 % file is identified and then the values are extracted.
 
 % Initialise parameters
-LresponseSuccess=true;
 Nsimulation=1;
 
 %% Processing Inputs
@@ -64,32 +63,9 @@ while nrep<=Xresponse.NrepeatAnchor
     nrep=nrep+1;
 end
 
-if any(isnan(Moutput))
-    LresponseSuccess=false;
-end
-
 % Associate read value with the output parameter
-try
-    OpenCossan.cossanDisp(['[OpenCossan:Response:extract] Response' Xresponse.Sname ': ' ],4 )
-    OpenCossan.cossanDisp('[OpenCossan:Response:extract] Value(s) extracted: ' ,4 )
-    if OpenCossan.getVerbosityLevel>3
-        disp(Moutput)
-    end
-    % check the size of Moutput to assign to the right object
-    if numel(Moutput)==1
-        % Moutput is a scalar, thus it is saved directly in the output
-        % structure
-        Toutput.(Xresponse.Sname)=Moutput;
-    else
-        % Moutput is a vector/matrix, thus it is saved in a Dataseries
-        % according to the properties of the response object
-        Toutput.(Xresponse.Sname)= Xresponse.createDataseries(Moutput);
-    end
-catch ME
-    OpenCossan.cossanDisp(['[OpenCossan:Response:extract] Failed to associate extracted value to the output ( ' ME.message ')' ],4 )
-    Toutput.(Xresponse.Sname)=NaN;
-    LresponseSuccess=false;
-end
+[Toutput,LresponseSuccess]=Xresponse.createOutput(Moutput);
+
 % save the position of the last extracted value
 TfileInfo.out.(Xresponse.Sname)=ftell(Nfid);
 
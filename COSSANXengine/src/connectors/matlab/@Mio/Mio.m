@@ -39,6 +39,7 @@ classdef Mio
         Sscript                         % field that  contains the script
         % to be executed (i.e. there is no file to be executed but this script)
         SwrapperName    ='mio_wrapper'  % Name of the compiled MIO
+        LsharedMemory   = false         % runJob and runCompiled pass the samples in shared memory (matrix Input/Output, jobs on this machine)
     end
     
     
@@ -61,6 +62,8 @@ classdef Mio
         
         [XSimOut,Pout] = runJob(Xobj,varargin) %Evaluates the target function using the JobManager
         
+        [XSimOut,Pout] = runCompiled(Xobj,varargin) %Evaluates the compiled Mio with concurrent local processes
+        
         [Xobj]      = compile(Xobj,varargin)    %This method allows compiling the m-function within the Mio
         
         %% Constructor
@@ -135,6 +138,8 @@ classdef Mio
                         Xobj.Lkeepsimfiles = varargin{k+1};
                     case 'sscript'
                         Xobj.Sscript = varargin{k+1};
+                    case 'lsharedmemory'
+                        Xobj.LsharedMemory = varargin{k+1};
                     case {'afunction' 'afunctionhandle'}
                         Xobj.FunctionHandle = varargin{k+1};
                     otherwise
@@ -155,7 +160,8 @@ classdef Mio
     methods (Access = private)
         Poutput = checkPinput(Xobj,Pinput)    %this method checks the correctness of the objects given to the method run of Mio
         XsimOut = createSimulationData(Xobj,Poutput)    %this method checks the correctness of the matrix/structure output from Mio and create a simulationData
-        [PoutputALL, Vresults] = retrieveResults(Xobj,Vresults,Vstart,Vend,PoutputALL,Xjob)   %method to retrieve results after evaluation of Mio
+        [PoutputALL, Vresults] = retrieveResults(Xobj,Vresults,Vstart,Vend,PoutputALL,Xjob,CSshm)   %method to retrieve results after evaluation of Mio
+        CSshm = shareInputs(Xobj,Xjob,PinputALL,Vstart,Vend)  % pass the samples of runJob and runCompiled in shared memory
     end     %of private methods
     
     methods (Access = protected)
@@ -77,8 +77,16 @@ OpenCossan.cossanDisp(['Creating ' fullfile(Xm.Spath,Sbuildnamefolder,Xm.Swrappe
 Nfid     = fopen([fullfile(Xm.Spath,Sbuildnamefolder,Xm.SwrapperName) '.m'],'w');   %creates empty wrapper file
 fprintf(Nfid, ' %% MIO wrapper generated by the method @mio/compile \n');
 fprintf(Nfid, [' %% on ' datestr(now) '\n'] );
-fprintf(Nfid, ' %% Load input from file \n');
-fprintf(Nfid, ' load mioINPUT.mat; \n');
+if Xm.LsharedMemory
+    % the samples and the outputs of runJob are exchanged in shared memory
+    fprintf(Nfid, ' %% Receive input from the shared memory \n');
+    fprintf(Nfid, ' Sshm = getenv(''COSSAN_SHM''); \n');
+    fprintf(Nfid, ' shmx(''open'',Sshm); \n');
+    fprintf(Nfid, ' Minput = shmx(''receive'',Sshm,0); \n');
+else
+    fprintf(Nfid, ' %% Load input from file \n');
+    fprintf(Nfid, ' load mioINPUT.mat; \n');
+end
 if Xm.Lfunction % the mio is a function
     fprintf(Nfid, ' %% call function \n');
     if Xm.Liostructure
@@ -108,7 +116,9 @@ else % the mio is a script
     end
 end
 fprintf(Nfid, ' %% Save output; \n');
-if Xm.Liostructure
+if Xm.LsharedMemory
+    fprintf(Nfid, ' shmx(''send'',Sshm,Moutput,0,0,0); \n');
+elseif Xm.Liostructure
     fprintf(Nfid, ' save mioOUTPUT.mat Toutput; \n');
 else
     fprintf(Nfid, ' save mioOUTPUT.mat Moutput; \n');
@@ -132,6 +142,11 @@ end;
 if ~isempty(Xm.Sadditionalpath)
     Smcc=[Smcc  ' -a ' Xm.Sadditionalpath];
 end
+if Xm.LsharedMemory
+    assert(exist('shmx','file')==3,'openCOSSAN:Mio:compile',...
+        'The mex file shmx is not available (see mex/src/Shm/makeShm.m)')
+    Smcc=[Smcc  ' -a ' which('shmx')];
+end
 
 [status,result]=system(Smcc);    %compile wrapper
 
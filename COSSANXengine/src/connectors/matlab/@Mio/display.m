@@ -47,6 +47,9 @@ if Xobj.Lfunction
     if Xobj.Lcompiled
         OpenCossan.cossanDisp(' Mio object has been already compiled ',2);
     end
+    if Xobj.LsharedMemory
+        OpenCossan.cossanDisp(' * runJob passes the samples in shared memory',2);
+    end
 else
     if isempty(Xobj.Sscript)
         OpenCossan.cossanDisp([' * Matlab script file: ' fullfile(Xobj.Spath,Xobj.Sfile) ],1);
@@ -1,7 +1,11 @@
-function [PoutputALL, Vresults] = retrieveResults(Xobj,Vresults,Vstart,Vend,PoutputALL,Xjob)
+function [PoutputALL, Vresults] = retrieveResults(Xobj,Vresults,Vstart,Vend,PoutputALL,Xjob,CSshm)
 %retrieveResults is a private method to retrieve results after evaluation of Mio
 %   object on a grid using a JobManager object
 %
+%   If the names of the segments of shared memory of the jobs are passed
+%   in CSshm (see shareInputs), the results are received from them instead
+%   of the files mioOUTPUT.mat.
+%
 %
 % Copyright~1993-2020, COSSAN Working Group
 %
@@ -44,8 +48,17 @@ for i=1:length(Vpos)
     
     % Load results from corresponding folder
     try
-        Tloaded=load(fullfile(OpenCossan.getCossanWorkingPath,...
-            [Xjob.Sfoldername '_sim_' num2str(currentJob)],'mioOUTPUT.mat'));
+        if exist('CSshm','var') && ~isempty(CSshm)
+            % the job has already terminated: its outputs, if any, are in
+            % the segment
+            [Tloaded.Moutput,~,Nstatus]=shmx('receive',CSshm{currentJob},1);
+            Tloaded.Toutput=[];
+            assert(isequal(Nstatus,0),'OpenCossan:Mio', ...
+                'Output of sim # %i is not available', currentJob)
+        else
+            Tloaded=load(fullfile(OpenCossan.getCossanWorkingPath,...
+                [Xjob.Sfoldername '_sim_' num2str(currentJob)],'mioOUTPUT.mat'));
+        end
         
         if ~isempty(Tloaded.Toutput)
             % if the Toutput is not a column vector, transpose it
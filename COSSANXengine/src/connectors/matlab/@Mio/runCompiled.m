@@ -0,0 +1,158 @@
+function [XSimOut,PoutputALL] = runCompiled(Xmio,varargin)
+%runCompiled  evaluate the compiled Mio with concurrent local processes
+%
+%   runCompiled splits the samples in Npartitions partitions of consecutive
+%   samples and evaluates each partition with an instance of the compiled
+%   Mio (see compile), running Nconcurrent instances at the same time on
+%   this machine. The instances are bound to the cpus Vcpus and exchange
+%   the samples and the outputs with MATLAB in shared memory (see
+%   mex/src/Shm), so that the Mio must have matrix Input/Output and must be
+%   compiled with LsharedMemory set to true. The outputs of a partition are
+%   collected as soon as its instance terminates and stored in the order
+%   of the samples; the outputs of the failed partitions are NaN.
+%
+%   MANDATORY ARGUMENTS:
+%
+%   - Xmio : Matlab I/O (Mio) object
+%   - 'Pinput' : the samples can be passed as a
+%						1) matrix (Minput)
+%						2) structure (Tinput)
+%						3) Input object (Xinput)
+%						4) Samples object (Xsamples)
+%
+%   OPTIONAL ARGUMENTS:
+%
+%   - Nconcurrent : number of concurrent instances (default: number of
+%   cores)
+%   - Npartitions : number of partitions (default: Nconcurrent)
+%   - Vcpus : cpus (numbered from 0) of the instances; the k-th concurrent
+%   instance runs on Vcpus(mod(k-1,end)+1). Empty: the instances are not
+%   bound (default: one core per instance)
+%   - Ntimeout : timeout of an instance [s] (default: Inf)
+%   - XSimOut : an already existing SimulationData object
+%
+%   OUTPUT:
+%
+%   - XSimOut : SimulationData object
+%   - PoutputALL : matrix of the outputs
+%
+%   EXAMPLES:
+%   - XSimOut = runCompiled(Xmio,'Xinput',Xinput)
+%   - [XSimOut,Moutput] = runCompiled(Xmio,'Minput',Minput,'Nconcurrent',8,'Npartitions',32)
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+global OPENCOSSAN
+
+OpenCossan.cossanDisp(['OpenCossan:Mio:runCompiled  - START -' datestr(clock)],2)
+
+%% Check the compiled Mio
+assert(~isempty(OPENCOSSAN.SmcrPath),'openCOSSAN:Mio:runCompiled',...
+    'The compiled Mio cannot be executed if the path of the MCR is not specified in the preferences')
+assert(Xmio.Lcompiled && Xmio.LsharedMemory,'openCOSSAN:Mio:runCompiled',...
+    'The Mio must be compiled with LsharedMemory set to true')
+Sscript=fullfile(Xmio.Spath,'bin',['run_' Xmio.SwrapperName '.sh']);
+assert(exist(Sscript,'file')==2,'openCOSSAN:Mio:runCompiled',...
+    'The compiled Mio %s does not exist. Try to recompile the Mio object',Sscript)
+assert(isunix && exist('runpoolx','file')==3,'openCOSSAN:Mio:runCompiled',...
+    'The mex file runpoolx is not available (see mex/src/ProcessPool/makeProcessPool.m)')
+
+%% Process the inputs
+OpenCossan.validateCossanInputs(varargin{:});
+Nconcurrent=feature('numcores');
+Ntimeout=Inf;
+for k=1:2:length(varargin)
+    switch lower(varargin{k})
+        case {'pinput','minput','tinput','xinput','xsamples'}
+            PinputALL = checkPinput(Xmio,varargin{k+1});
+        case {'nconcurrent'}
+            Nconcurrent = varargin{k+1};
+        case {'npartitions'}
+            Npartitions = varargin{k+1};
+        case {'vcpus'}
+            Vcpus = varargin{k+1};
+        case {'ntimeout'}
+            Ntimeout = varargin{k+1};
+        case {'xsimout','xsimulationdata'}
+            XSimOut = varargin{k+1};
+        otherwise
+            error('openCOSSAN:Mio:runCompiled',...
+                'Property Name %s not valid',varargin{k})
+    end
+end
+assert(exist('PinputALL','var')==1,'openCOSSAN:Mio:runCompiled',...
+    'The samples (Pinput) are a mandatory argument')
+assert(Nconcurrent>=1,'openCOSSAN:Mio:runCompiled',...
+    'Nconcurrent must be a positive integer')
+if ~exist('Npartitions','var')
+    Npartitions=Nconcurrent;
+end
+if ~exist('Vcpus','var')
+    Vcpus=0:min(Nconcurrent,feature('numcores'))-1;
+end
+
+%% Partitions of consecutive samples
+Nsamples=size(PinputALL,1);
+Npartitions=max(1,min(Npartitions,Nsamples));
+Vend=round((1:Npartitions)*Nsamples/Npartitions);
+Vstart=[1 Vend(1:end-1)+1];
+
+% The segments are removed at the end, also on errors
+CSshm=Xmio.shareInputs([],PinputALL,Vstart,Vend);
+XshmCleanup=onCleanup(@() cellfun(@(Sshm) shmx('close',Sshm),CSshm)); %#ok<NASGU>
+
+CScommands=cellfun(@(Sshm) sprintf('COSSAN_SHM=%s ''%s'' ''%s''',Sshm,Sscript,OPENCOSSAN.SmcrPath),...
+    CSshm,'UniformOutput',false);
+CSfolders=repmat({OpenCossan.getCossanWorkingPath},size(CScommands));
+
+%% Run the instances
+PoutputALL=NaN(Nsamples,length(Xmio.Coutputnames));
+runpoolx(CScommands,CSfolders,Nconcurrent,Ntimeout,@collectPartition,'',Vcpus);
+
+%% Export results - create output object
+Xsimtmp=SimulationData('Mvalues',PoutputALL,'Cvariablenames',Xmio.Coutputnames);
+if exist('XSimOut','var')
+    XSimOut=XSimOut.merge(Xsimtmp);
+else
+    XSimOut=Xsimtmp;
+end
+
+OpenCossan.cossanDisp(['OpenCossan:Mio:runCompiled  - STOP -' datestr(clock)],2)
+
+    function collectPartition(ipartition,Nstatus,Ntime)
+        % The instance has terminated: its outputs, if any, are already in
+        % the segment
+        [Moutput,~,Nsent]=shmx('receive',CSshm{ipartition},0);
+        shmx('close',CSshm{ipartition});
+        Vrows=Vstart(ipartition):Vend(ipartition);
+        if Nstatus==0 && isequal(Nsent,0) && ...
+                isequal(size(Moutput),[length(Vrows) length(Xmio.Coutputnames)])
+            PoutputALL(Vrows,:)=Moutput;
+            OpenCossan.cossanDisp(sprintf('[Mio:runCompiled] Partition %i of %i completed in %.3g s',...
+                ipartition,Npartitions,Ntime),3)
+        else
+            OpenCossan.cossanDisp(sprintf('[Mio:runCompiled] Partition %i of %i failed (status %i)',...
+                ipartition,Npartitions,Nstatus),1)
+        end
+    end
+end
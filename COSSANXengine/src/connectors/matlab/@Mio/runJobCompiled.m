@@ -66,6 +66,15 @@ Vend = cumsum(Vsimxjobs);  % defines number of final simulation for job
 Vstart = [1, Vend(1:end-1)+1]; % defines number of starting simulation for job
 CSjobID=cell(Njobs,1);          % cell array to store the Id of the jobs
 
+% Samples passed in shared memory (the segments are removed at the end).
+% The wrapper must have been compiled with LsharedMemory set.
+if Xmio.LsharedMemory
+    CSshm = Xmio.shareInputs(Xjob,PinputALL,Vstart,Vend);
+    XshmCleanup = onCleanup(@() cellfun(@(Sshm) shmx('close',Sshm),CSshm)); %#ok<NASGU>
+else
+    CSshm = {};
+end
+
 % iteration over the number of jobs
 for irun=1:Njobs
     %  If required, displays information on which job is being processed
@@ -74,12 +83,19 @@ for irun=1:Njobs
     Sfoldername    = [Xjob.Sfoldername '_sim_' num2str(irun)];  % defines name of folder where the job will be executed
     mkdir(Sfoldername);    % creates the folder
     % set the execution command
-    Xjob.Sexecmd = ['cd ' fullfile(Xmio.Spath,Sfoldername) '; '...
+    if Xmio.LsharedMemory
+        Senv = ['COSSAN_SHM=' CSshm{irun} ' ']; % name of the segment of the job
+    else
+        Senv = '';
+    end
+    Xjob.Sexecmd = ['cd ' fullfile(Xmio.Spath,Sfoldername) '; ' Senv ...
         './run_' Xmio.SwrapperName '.sh']; 
     % the compile mio needs as inputs the path of the MCR
     Xjob.Sexeflags = OPENCOSSAN.SmcrPath; 
     %  Copy input files into the new grid folder
-    if Xmio.Liostructure
+    if Xmio.LsharedMemory
+        % the samples are already in the segment of the job
+    elseif Xmio.Liostructure
         % copies input - case of structure
         Tinput  = PinputALL(Vstart(irun):Vend(irun));    %#ok<NASGU> 
         save ([Sfoldername filesep 'mioINPUT.mat'],'Tinput');     %saves file
@@ -120,7 +136,7 @@ while ~all(Lcompleted==1)
         Xjob.deleteJob('CsjobID',CSjobID);
         error('openCOSSAN:Mio:runJob','Simulation killed by the user.')
     end
-    pause(1);
+    Xjob.waitForJobs(1);
     Cstatus(~Lcompleted,:) = Xjob.getJobStatus('CSjobID',CSjobID(~Lcompleted)); % check the status of the one that are not yet completed only
     Lcompleted = ~(strcmp('running',Cstatus(:,1))|strcmp('pending',Cstatus(:,1)));
     
@@ -142,11 +158,11 @@ end
 PoutputALL = [];
 Vresults   = zeros(Njobs,1);  % vector to define which results have been read so far;
 %  Load results form output files
-[PoutputALL, Vresults] = Xmio.retrieveResults(Vresults,Vstart,Vend,PoutputALL,Xjob);
+[PoutputALL, Vresults] = Xmio.retrieveResults(Vresults,Vstart,Vend,PoutputALL,Xjob,CSshm);
 % In case some results are missing, try to reload
 if any(Vresults==0),
     % if not all the simulation were readed correctly try againg
-    [PoutputALL, Vresults] = Xmio.retrieveResults(Vresults,Vstart,Vend,PoutputALL,Xjob);
+    [PoutputALL, Vresults] = Xmio.retrieveResults(Vresults,Vstart,Vend,PoutputALL,Xjob,CSshm);
 end
 % Manage results that could not be loaded
 if any(Vresults==0),
@@ -72,8 +72,18 @@ end
 if ~isempty(Xmio.Sadditionalpath)
     fprintf(Nfid,'addpath(''%s'');\n',Xmio.Sadditionalpath);
 end
+if Xmio.LsharedMemory
+    % the samples and the outputs are exchanged in shared memory (shmx)
+    fprintf(Nfid,'addpath(''%s'');\n',fileparts(which('shmx')));
+    fprintf(Nfid,'Sshm = getenv(''COSSAN_SHM'');\n');
+end
 fprintf(Nfid,'try\n');
-fprintf(Nfid,'    load mioINPUT.mat\n');
+if Xmio.LsharedMemory
+    fprintf(Nfid,'    shmx(''open'',Sshm);\n');
+    fprintf(Nfid,'    Minput = shmx(''receive'',Sshm,0);\n');
+else
+    fprintf(Nfid,'    load mioINPUT.mat\n');
+end
 if Xmio.Lfunction
 %% wrapping a function
     if Xmio.Liomatrix
@@ -119,7 +129,12 @@ fprintf(Nfid,'        display(ME.stack(i).line)\n');
 fprintf(Nfid,'    end\n');
 fprintf(Nfid,'end\n');
 fprintf(Nfid,'if isempty(ME)\n');
-if Xmio.Liostructure
+if Xmio.LsharedMemory
+    fprintf(Nfid,'try, shmx(''send'',Sshm,Moutput,0,0,0); catch, end\n');
+    % a status different from 0 reports the failure of the job
+    fprintf(Nfid,'else\n');
+    fprintf(Nfid,'try, shmx(''send'',Sshm,[],0,1,0); catch, end\n');
+elseif Xmio.Liostructure
     fprintf(Nfid,'save mioOUTPUT.mat Toutput\n');
 else
     fprintf(Nfid,'save mioOUTPUT.mat Moutput\n');
@@ -137,6 +152,14 @@ Vend = cumsum(Vsimxjobs);  % defines number of final simulation for job
 Vstart = [1, Vend(1:end-1)+1]; % defines number of starting simulation for job
 CSjobID=cell(Njobs,1);          % cell array to store the Id of the jobs
 
+% Samples passed in shared memory (the segments are removed at the end)
+if Xmio.LsharedMemory
+    CSshm = Xmio.shareInputs(Xjob,PinputALL,Vstart,Vend);
+    XshmCleanup = onCleanup(@() cellfun(@(Sshm) shmx('close',Sshm),CSshm)); %#ok<NASGU>
+else
+    CSshm = {};
+end
+
 % iteration over the number of jobs
 for irun=1:Njobs
     %  If required, displays information on which job is being processed
@@ -145,11 +168,18 @@ for irun=1:Njobs
     Sfoldername    = [Xjob.Sfoldername '_sim_' num2str(irun)];  % defines name of folder where the job will be executed
     mkdir(fullfile(OpenCossan.getCossanWorkingPath,Sfoldername));    % creates the folder
     % set the execution command
-    Xjob.Sexecmd = ['cd ' fullfile(OpenCossan.getCossanWorkingPath,Sfoldername) '; '...
+    if Xmio.LsharedMemory
+        Senv = ['COSSAN_SHM=' CSshm{irun} ' ']; % name of the segment of the job
+    else
+        Senv = '';
+    end
+    Xjob.Sexecmd = ['cd ' fullfile(OpenCossan.getCossanWorkingPath,Sfoldername) '; ' Senv ...
         strrep(fullfile(OpenCossan.getMatlabPath,'bin','matlab'),' ','\\ ') ...
         ' -r ' strrep(Xmio.SwrapperName,'.m','') ' -nosplash -nodesktop'];
     %  Copy input files into the new grid folder
-    if Xmio.Liostructure
+    if Xmio.LsharedMemory
+        % the samples are already in the segment of the job
+    elseif Xmio.Liostructure
         % copies input - case of structure
         Tinput  = PinputALL(Vstart(irun):Vend(irun));    %#ok<NASGU>
         save ([OpenCossan.getCossanWorkingPath filesep Sfoldername filesep 'mioINPUT.mat'],'Tinput');     %saves file
@@ -188,7 +218,7 @@ while 1
             Xjob.deleteJob('CsjobID',CSjobID);
             error('openCOSSAN:Mio:runJob','Simulation killed by the user.')
         end
-        pause(1);
+        Xjob.waitForJobs(1);
         Cstatus(~Lcompleted,:) = Xjob.getJobStatus('CSjobID',CSjobID(~Lcompleted)); % check the status of the one that are not yet completed only
         Lcompleted = ~(strcmp('running',Cstatus(:,1))|strcmp('pending',Cstatus(:,1)) | ... % gridengine status return
             strcmp('RUN',Cstatus(:,1))|strcmp('PEND',Cstatus(:,1))); % LSF status return
@@ -222,11 +252,11 @@ PoutputALL = [];
 Vresults   = zeros(Njobs,1);  % vector to define which results have been read so far;
 
 %  Load results form output files
-[PoutputALL, Vresults] = Xmio.retrieveResults(Vresults,Vstart,Vend,PoutputALL,Xjob);
+[PoutputALL, Vresults] = Xmio.retrieveResults(Vresults,Vstart,Vend,PoutputALL,Xjob,CSshm);
 % In case some results are missing, try to reload
 if any(Vresults==0),
     % if not all the simulation were readed correctly try againg
-    [PoutputALL(Vresults==0), Vresults] = Xmio.retrieveResults(Vresults,Vstart,Vend,PoutputALL,Xjob);
+    [PoutputALL(Vresults==0), Vresults] = Xmio.retrieveResults(Vresults,Vstart,Vend,PoutputALL,Xjob,CSshm);
 end
 % Manage results that could not be loaded
 if any(Vresults==0),
@@ -0,0 +1,68 @@
+function CSshm = shareInputs(Xobj,Xjob,PinputALL,Vstart,Vend)
+%shareInputs is a private method of runJob that passes the samples of the
+%   jobs in segments of shared memory (see mex/src/Shm) instead of the
+%   files mioINPUT.mat. A segment is created for each job, sized to hold
+%   both its samples and its outputs, and its name is returned in CSshm.
+%   The job reads the name in the environment variable COSSAN_SHM and
+%   sends the outputs back in the same segment (see retrieveResults).
+%
+%   The jobs must run on this machine: the JobManager has to use the local
+%   scheduler or select this host. Xjob is empty when the samples are
+%   evaluated by local processes (see runCompiled).
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+assert(Xobj.Liomatrix,'openCOSSAN:Mio:runJob',...
+    'The shared memory transport supports only Mio with matrix Input/Output')
+assert(isunix && exist('shmx','file')==3,'openCOSSAN:Mio:runJob',...
+    'The mex file shmx is not available (see mex/src/Shm/makeShm.m)')
+if isempty(Xjob)
+    Sprefix=datestr(now,30);
+else
+    [~,Shost]=system('hostname');
+    assert((~isempty(Xjob.Xjobmanagerinterface) && strcmp(Xjob.Xjobmanagerinterface.Stype,'Local')) || ...
+        (~isempty(Xjob.Shostname) && strcmpi(strtok(Xjob.Shostname,'.'),strtok(strtrim(Shost),'.'))),...
+        'openCOSSAN:Mio:runJob',...
+        ['The shared memory transport requires the jobs to run on this machine\n'...
+        '(local scheduler or Shostname of the JobManager equal to %s)'],strtrim(Shost))
+    Sprefix=Xjob.Sfoldername;
+end
+
+% A slot holds Nrows rows of the samples or of the outputs; each segment
+% has room for all the rows of its job, so that the samples are sent
+% without waiting for the job
+Ncols=max([size(PinputALL,2) length(Xobj.Coutputnames) 1]);
+Nrows=max(1,floor(65536/Ncols));
+
+CSshm=cell(length(Vstart),1);
+for n=1:length(Vstart)
+    CSshm{n}=sprintf('cossan_mio_%i_%s_%i',feature('getpid'),Sprefix,n);
+    try
+        shmx('create',CSshm{n},ceil((Vend(n)-Vstart(n)+1)/Nrows)+1,Nrows*Ncols);
+        shmx('send',CSshm{n},PinputALL(Vstart(n):Vend(n),:),n,0,0);
+    catch ME
+        % remove the segments already created
+        cellfun(@(Sshm) shmx('close',Sshm),CSshm(1:n));
+        rethrow(ME)
+    end
+end
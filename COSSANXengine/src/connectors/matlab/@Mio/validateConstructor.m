@@ -136,5 +136,8 @@ if ~Xobj.Liomatrix && ~Xobj.Liostructure
     assert(Xobj.Lfunction,'openCOSSAN:Mio',...
         'Only functions can be used with multiple inputs and outputs');
 end
+% the shared memory transport of runJob exchanges matrices only
+assert(~Xobj.LsharedMemory || Xobj.Liomatrix,'openCOSSAN:Mio',...
+    'The flag LsharedMemory requires matrix Input/Output (Liomatrix)');
 
 
@@ -39,11 +39,15 @@ classdef JobManager
         Sduration    = ''% job timeout
         SparallelEnvironment % Specific parallel environment (e.g. openmpi) and number of process
         Nslots          % Number of slots to be used in the simulation
+        Nmemory = 0     % Memory of each job [MB] (local scheduler, 0: not checked)
+        NchunkDuration = 0 % Target duration of a job [s] (Connector, 0: one sample per job)
+        NstragglerFactor = 3 % Jobs slower than NstragglerFactor times the expected duration are submitted again (Inf: never)
     end
     
     properties (Hidden)
         Sexecmd         % job submission executable cmd. Set by runJob of connector!
         Sexeflags
+        Sspooltoken     % name of the completion marker of the job. Set by submitJob
     end
     
     properties (Hidden,SetAccess=protected)
@@ -131,6 +135,12 @@ classdef JobManager
                         Xobj.SparallelEnvironment = varargin{k+1};
                     case ('nslots')
                         Xobj.Nslots = varargin{k+1};
+                    case ('nmemory')
+                        Xobj.Nmemory = varargin{k+1};
+                    case ('nchunkduration')
+                        Xobj.NchunkDuration = varargin{k+1};
+                    case ('nstragglerfactor')
+                        Xobj.NstragglerFactor = varargin{k+1};
                     case ('sworkingdirectory')
                         Xobj.Sworkingdirectory = varargin{k+1};
                     otherwise
@@ -147,6 +157,11 @@ classdef JobManager
                 'openCOSSAN:JobManager', ...
                 'An object of class JobManagerInterface is required.');
             
+            % The local scheduler executes the jobs on this machine
+            assert(~strcmpi(Xobj.Xjobmanagerinterface.Stype,'local') || ...
+                ~OpenCossan.hasSSHConnection, 'openCOSSAN:JobManager', ...
+                'The local scheduler cannot be used with an SSH connection.');
+            
             if ~isempty(Xobj.Squeue)
                 assert(logical(ismember(Xobj.Squeue,Xobj.Xjobmanagerinterface.getQueues)), ...
                     'openCOSSAN:JobManager', ...
@@ -187,6 +202,7 @@ classdef JobManager
         
         SjobID = submitJob(Xobj,varargin)
         varargout=deleteJob(Xobj,varargin)
+        waitForJobs(Xobj,Ntimeout)
         Lsuccessfull = checkSuccessfulJobs(Xobj,ScheckFileName)
         
         display(Xobj)
@@ -196,5 +212,8 @@ classdef JobManager
     methods (Access=private)
         Sscriptname = prepareGridEngineScript(Xobj,NsimulationNumber)
         Sscriptname = prepareLSFScript(Xobj,NsimulationNumber)
+        Sscriptname = prepareLocalScript(Xobj,NsimulationNumber)
+        writeExecCommand(Xobj,Nfid)
+        writeSpoolMarker(Xobj,Nfid)
     end
 end
@@ -26,7 +26,10 @@ end
 
 for n=1:length(CSjobID)
     if ~isempty(CSjobID{n})
-        if ~OpenCossan.hasSSHConnection
+        if strcmpi(Xobj.Xjobmanagerinterface.Stype,'local')
+            schedulerx('delete',str2double(CSjobID{n}));
+            CSstatus{n}='deleted'; %#ok<AGROW>
+        elseif ~OpenCossan.hasSSHConnection
             [~,CSstatus{n}]=system([Xobj.Xjobmanagerinterface.SdeleteJob ' ' CSjobID{n}]); %#ok<AGROW>
         else
             [~,CSstatus{n}]=OpenCossan.issueSSHcommand([Xobj.Xjobmanagerinterface.SdeleteJob ' ' CSjobID{n}]); %#ok<AGROW>
@@ -35,6 +38,11 @@ for n=1:length(CSjobID)
     end
 end
 
+% the markers of the deleted jobs are not waited for
+if Xobj.Xjobmanagerinterface.useSpool
+    spoolx('forget',Xobj.Xjobmanagerinterface.Sspooldir,CSjobID(~cellfun(@isempty,CSjobID)));
+end
+
 
 
 if nargout>0
@@ -25,3 +25,18 @@ function Cstatus = getJobStatus(Xobj,varargin)
 
 %% Process optional inputs
 Cstatus = getJobStatus(Xobj.Xjobmanagerinterface,varargin{:});
+
+%% Completion markers
+% The jobs no longer running or pending leave the spool, otherwise their
+% markers would stay unreported and spoolx('wait') would not wait anymore
+if Xobj.Xjobmanagerinterface.useSpool
+    Vopt=find(strcmpi(varargin(1:2:end),'csjobid'),1);
+    if ~isempty(Vopt)
+        CSjobID=varargin{2*Vopt};
+        Lfinal=~cellfun(@(Sstate) any(strcmp(Sstate,{'running','RUN','pending','PEND'})),...
+            Cstatus(:,1));
+        if any(Lfinal)
+            spoolx('forget',Xobj.Xjobmanagerinterface.Sspooldir,CSjobID(Lfinal));
+        end
+    end
+end
@@ -117,7 +117,7 @@ end
 %% Write hostname on the out file
 fprintf(Nfid,'%s\n','hostname');
 %% Main code
-fprintf(Nfid,'%s\n',[Xobj.Sexecmd ' ' Xobj.Sexeflags]);
+Xobj.writeExecCommand(Nfid);
 
 %% Add Postprocessor
 if ~isempty(Xobj.Spostexecmd)
@@ -142,6 +142,9 @@ if ~isempty(Xobj.Sfoldername)
     end
 end
 
+%% publish the completion marker
+Xobj.writeSpoolMarker(Nfid);
+
 fclose(Nfid);
 
 end
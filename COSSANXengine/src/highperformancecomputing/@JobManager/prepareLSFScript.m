@@ -92,7 +92,7 @@ end
 %% Write hostname on the out file
 fprintf(Nfid,'%s\n','hostname');
 %% Main code
-fprintf(Nfid,'%s\n',[Xobj.Sexecmd ' ' Xobj.Sexeflags]);
+Xobj.writeExecCommand(Nfid);
 
 %% Add Postprocessor
 if ~isempty(Xobj.Spostexecmd)
@@ -111,6 +111,9 @@ end
 
 fprintf(Nfid,'%s\n','echo Script execution finished; date');
 
+%% publish the completion marker
+Xobj.writeSpoolMarker(Nfid);
+
 fclose(Nfid);
 
 end
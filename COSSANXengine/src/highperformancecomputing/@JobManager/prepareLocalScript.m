@@ -0,0 +1,93 @@
+function Sscriptname = prepareLocalScript(Xobj,NsimulationNumber)
+% This method create a job script file for the local scheduler in the
+% cossan working path
+%
+% The script is executed by schedulerx in the current folder of MATLAB (as
+% the -cwd option of GridEngine) with stdout and stderr in the file
+% Sfoldername.out, moved in the job folder at the end of the job. The
+% variables JOB_ID and NSLOTS are defined by the scheduler.
+%
+% See also: prepareGridEngineScript, submitJob
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+if ~exist('NsimulationNumber','var')
+    Sscriptname = [Xobj.SjobScriptName '.sh'];
+else
+    Sscriptname = [Xobj.SjobScriptName num2str(NsimulationNumber) '.sh'];
+end
+
+[Nfid, Serror] = fopen(fullfile(OpenCossan.getCossanWorkingPath,Sscriptname),'w');
+
+assert(isempty(Serror),'openCOSSAN:JobManager:submit','Error: %s\n Path: %s', ...
+                Serror,fullfile(OpenCossan.getCossanWorkingPath,Sscriptname))
+
+OpenCossan.cossanDisp(['Open file ' fullfile(OpenCossan.getCossanWorkingPath,Sscriptname)],3);
+
+if strcmp(Xobj.Sworkingdirectory,'./') || strcmp(Xobj.Sworkingdirectory,'.')
+    % Use current directort 
+    Xobj.Sworkingdirectory=[];
+end
+
+fprintf(Nfid,'%s\n','#!/bin/bash');
+fprintf(Nfid,'%s\n','START_DIR=`pwd` ');
+
+if ~isempty(Xobj.Sfoldername)
+    % change directory to the job work folder
+    fprintf(Nfid,'%s\n',['cd ' fullfileunix(Xobj.Sworkingdirectory,Xobj.Sfoldername) ';']);
+end
+fprintf(Nfid,'%s\n','JOB_DIR=`pwd` ');
+
+fprintf(Nfid,'%s\n','echo Script execution started; date');
+
+if ~isempty(Xobj.Xjobmanagerinterface.SMCRpreexec)
+    fprintf(Nfid,'%s\n',Xobj.Xjobmanagerinterface.SMCRpreexec);
+end
+
+if ~isempty(Xobj.Spreexecmd)
+    fprintf(Nfid,'%s\n',Xobj.Spreexecmd);
+end
+
+fprintf(Nfid,'%s\n','hostname');
+% exit status of the job in STATUS
+Xobj.writeExecCommand(Nfid);
+
+if ~isempty(Xobj.Spostexecmd)
+    fprintf(Nfid,'%s\n',Xobj.Spostexecmd);
+end
+if ~isempty(Xobj.Xjobmanagerinterface.SMCRpostexec)
+    fprintf(Nfid,'%s\n',Xobj.Xjobmanagerinterface.SMCRpostexec);
+end
+
+fprintf(Nfid,'%s\n','echo Script execution finished; date');
+
+if ~isempty(Xobj.Sfoldername)
+    % move the output of the job to the Sfoldername
+    fprintf(Nfid,'%s\n',['mv $START_DIR/' Xobj.Sfoldername '.out $JOB_DIR']);
+end
+Xobj.writeSpoolMarker(Nfid);
+fprintf(Nfid,'%s\n','exit $STATUS');
+
+fclose(Nfid);
+
+end
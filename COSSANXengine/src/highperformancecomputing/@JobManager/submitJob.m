@@ -59,16 +59,32 @@ if ~isempty(Xobj.Shostname)
     end
 end
 
+Lspool = Xobj.Xjobmanagerinterface.useSpool;
 if ~Lresubmit
     %% create the job script file
     % TODO: improve the script file/job name by getting it from the
     % analysis instead of using always "CossanJob"
     % TODO:  Should this be part of the JobmanagerInterface?
     
+    if Lspool
+        % unique name of the completion marker of the job
+        if ~exist(Xobj.Xjobmanagerinterface.Sspooldir,'dir')
+            mkdir(Xobj.Xjobmanagerinterface.Sspooldir);
+        end
+        if exist('NsimulationNumber','var')
+            Xobj.Sspooltoken = [Xobj.SjobScriptName num2str(NsimulationNumber) ...
+                '_' datestr(now,'yyyymmddTHHMMSSFFF')];
+        else
+            Xobj.Sspooltoken = [Xobj.SjobScriptName '_' datestr(now,'yyyymmddTHHMMSSFFF')];
+        end
+    end
+    
     if strcmpi(Xobj.Xjobmanagerinterface.Stype,'gridengine')
         Sscriptname = Xobj.prepareGridEngineScript(NsimulationNumber);
     elseif strcmpi(Xobj.Xjobmanagerinterface.Stype,'lsf')
         Sscriptname = Xobj.prepareLSFScript(NsimulationNumber);
+    elseif strcmpi(Xobj.Xjobmanagerinterface.Stype,'local')
+        Sscriptname = Xobj.prepareLocalScript(NsimulationNumber);
     else
         % this error should never be reached, but is kept in case the user
         % manually alter the property SsubmitJob of JobManagerInterface
@@ -81,6 +97,14 @@ else
     assert(logical(exist(fullfile(OpenCossan.getCossanWorkingPath,Sscriptname),'file')),...
         'openCOSSAN:JobManager:submit',...
         ['Cannot resubmit the job. Job script file ' Sscriptname ' does not exist.']);
+    if Lspool
+        % the resubmitted job publishes the marker of its script
+        Ctoken = regexp(fileread(fullfile(OpenCossan.getCossanWorkingPath,Sscriptname)),...
+            'SPOOL_TOKEN=(\S+)','tokens','once');
+        if ~isempty(Ctoken)
+            Xobj.Sspooltoken = Ctoken{1};
+        end
+    end
 end
 if OpenCossan.hasSSHConnection
     XsshConnection = OpenCossan.getSSHConnection();
@@ -105,6 +129,39 @@ else
     Sscriptname = fullfile(OpenCossan.getCossanWorkingPath,Sscriptname);
 end
 
+if strcmpi(Xobj.Xjobmanagerinterface.Stype,'local')
+    %% submit the job to the local scheduler (schedulerx)
+    % the job uses Nslots cores and Nmemory MB and it is killed after
+    % Sduration ([d-]hh:mm:ss, see durationSeconds)
+    assert(isempty(Xobj.Xdependent),'openCOSSAN:JobManager:submit',...
+        'Dependent jobs are not supported by the local scheduler')
+    Xobj.Xjobmanagerinterface.startLocalScheduler;
+    if isempty(Xobj.Nslots)
+        Ncores=1;
+    else
+        Ncores=Xobj.Nslots;
+    end
+    if isempty(Xobj.Sduration)
+        Ntimeout=0;
+    else
+        Ntimeout=durationSeconds(Xobj.Sduration);
+    end
+    if isempty(Xobj.Sfoldername)
+        Slogfile=[Xobj.SjobScriptName num2str(NsimulationNumber) '.out'];
+    else
+        Slogfile=[Xobj.Sfoldername '.out'];
+    end
+    OpenCossan.cossanDisp(['Submitted local job: /bin/bash '  Sscriptname],3);
+    Nid=schedulerx('submit',['/bin/bash ' Sscriptname],pwd,Slogfile,...
+        Ncores,Xobj.Nmemory,Ntimeout);
+    CSjobID={num2str(Nid)};
+    if ~isempty(Xobj.Sspooltoken)
+        spoolx('expect',Xobj.Xjobmanagerinterface.Sspooldir,CSjobID{1},Xobj.Sspooltoken);
+    end
+    OpenCossan.cossanDisp(['COSSAN-X:JobManager:submit  - STOP -' datestr(clock)],3);
+    return
+end
+
 if strcmpi(Xobj.Xjobmanagerinterface.Stype,'gridengine')
     if isempty(Xobj.Xdependent)
         if ~isempty(Xobj.Sjobname)
@@ -174,7 +231,32 @@ if length(CSjobID)>1
     CSjobID = CSjobID(1);
 end
 
+% register the completion marker of the job
+if ~isempty(Xobj.Sspooltoken)
+    spoolx('expect',Xobj.Xjobmanagerinterface.Sspooldir,CSjobID{1},Xobj.Sspooltoken);
+end
+
 OpenCossan.cossanDisp(['COSSAN-X:JobManager:submit  - STOP -' datestr(clock)],3);
 end
 
 
+function Ntimeout=durationSeconds(Sduration)
+% seconds of the duration [[hh:]mm:]ss or d-hh[:mm[:ss]]; 0 (no timeout)
+% if the format is not recognized
+Ctokens=regexp(Sduration,'^\s*(?:(\d+)-)?(\d+(?::\d+){0,2})\s*$','tokens','once');
+if isempty(Ctokens)
+    warning('openCOSSAN:JobManager:submit',...
+        'Unknown format of Sduration (%s): the job is not killed after a timeout',Sduration)
+    Ntimeout=0;
+    return
+end
+Vfields=str2double(strsplit(Ctokens{2},':'));
+if isempty(Ctokens{1})
+    % the last field is the seconds
+    Ntimeout=sum(Vfields.*60.^(length(Vfields)-1:-1:0));
+else
+    % the first field after the days is the hours
+    Vweights=[3600 60 1];
+    Ntimeout=86400*str2double(Ctokens{1})+sum(Vfields.*Vweights(1:length(Vfields)));
+end
+end
@@ -0,0 +1,33 @@
+function waitForJobs(Xobj,Ntimeout)
+%WAITFORJOBS Wait Ntimeout seconds before the next check of the status of
+%the jobs. With the completion markers (see JobManagerInterface.useSpool)
+%the wait ends as soon as a job is completed, so that its results can be
+%extracted immediately.
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+if Xobj.Xjobmanagerinterface.useSpool
+    spoolx('wait',Xobj.Xjobmanagerinterface.Sspooldir,Ntimeout);
+else
+    pause(Ntimeout)
+end
@@ -0,0 +1,55 @@
+function writeExecCommand(Xobj,Nfid)
+%WRITEEXECCOMMAND Write the execution command in the job script and store
+%its exit status in the variable STATUS.
+%
+%   With the completion spool (property Sspooltoken defined) the exit
+%   status, runtime and peak memory of the command are written to the
+%   hidden marker $SPOOL_DIR/.$SPOOL_TOKEN, published at the end of the
+%   script by writeSpoolMarker. The command is executed by the program
+%   spoolrun (mex/bin, see mex/src/Spool) in a child shell; without
+%   spoolrun the peak memory is not available.
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+Sexec = [Xobj.Sexecmd ' ' Xobj.Sexeflags];
+
+if isempty(Xobj.Sspooltoken)
+    fprintf(Nfid,'%s\n',Sexec);
+    fprintf(Nfid,'%s\n','STATUS=$?');
+    return
+end
+
+fprintf(Nfid,'%s\n',['SPOOL_DIR="' Xobj.Xjobmanagerinterface.Sspooldir '"']);
+fprintf(Nfid,'%s\n',['SPOOL_TOKEN=' Xobj.Sspooltoken]);
+Srunner = fullfile(OpenCossan.getCossanRoot,'mex','bin','spoolrun');
+if exist(Srunner,'file')
+    % quote the command for bash -c
+    fprintf(Nfid,'%s\n',[Srunner ' "$SPOOL_DIR" $SPOOL_TOKEN /bin/bash -c ''' ...
+        strrep(Sexec,'''','''\''''') '''']);
+    fprintf(Nfid,'%s\n','STATUS=$?');
+else
+    fprintf(Nfid,'%s\n','SPOOL_START=$SECONDS');
+    fprintf(Nfid,'%s\n',Sexec);
+    fprintf(Nfid,'%s\n','STATUS=$?');
+    fprintf(Nfid,'%s\n','echo "$STATUS $((SECONDS-SPOOL_START)) -1" > "$SPOOL_DIR/.$SPOOL_TOKEN"');
+end
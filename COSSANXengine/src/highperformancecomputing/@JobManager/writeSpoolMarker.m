@@ -0,0 +1,30 @@
+function writeSpoolMarker(Xobj,Nfid)
+%WRITESPOOLMARKER Write the publication of the completion marker of the
+%job at the end of the job script (see writeExecCommand). The marker is
+%renamed, so that it is never read half written.
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+if ~isempty(Xobj.Sspooltoken)
+    fprintf(Nfid,'%s\n','mv -f "$SPOOL_DIR/.$SPOOL_TOKEN" "$SPOOL_DIR/$SPOOL_TOKEN.done"');
+end
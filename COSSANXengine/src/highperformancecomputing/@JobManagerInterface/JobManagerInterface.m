@@ -14,6 +14,10 @@ classdef JobManagerInterface
         SMCRpreexec     % Preexecution commands for Matlab Component Runtime
         SMCRpostexec    % Postexecution commands for Matlab Component Runtime
         SMCRpath        % Path of the MCR (Used by remote machines)
+        Ncores          % Cores used by the local scheduler (default: all)
+        Nmemory         % Memory used by the local scheduler [MB] (default: all)
+        Sspooldir       % Shared directory of the completion markers of the jobs (absolute path, empty: polling)
+        NspoolCheck=300 % Interval of the queries of the jobs without marker [s]
     end
     
     
@@ -69,6 +73,14 @@ classdef JobManagerInterface
                         Xobj.SMCRpostexec = varargin{k+1};
                     case 'smcrpath'
                         Xobj.SMCRpath = varargin{k+1};
+                    case 'ncores'
+                        Xobj.Ncores = varargin{k+1};
+                    case 'nmemory'
+                        Xobj.Nmemory = varargin{k+1};
+                    case 'sspooldir'
+                        Xobj.Sspooldir = varargin{k+1};
+                    case 'nspoolcheck'
+                        Xobj.NspoolCheck = varargin{k+1};
                     otherwise
                         error('openCOSSAN:JobManagerInterface',...
                             ['PropertyName name (' varargin{k} ') not allowed']);
@@ -87,6 +99,8 @@ classdef JobManagerInterface
                         Xobj = lsf(Xobj);
                     case {'lsf_matlab','openlava_matlab'}
                         Xobj = lsf_matlab(Xobj);
+                    case {'local'}
+                        Xobj = localscheduler(Xobj);
                     otherwise
                         error('openCOSSAN:JobManagerInterface:JobManagerInterface',  ...
                             ['Pre-defined jobManagerInterface configuration ('  Stype ') not available']);
@@ -114,6 +128,8 @@ classdef JobManagerInterface
         % Methods to check the status of the gris
         [Lavailable, Sstatus] = checkHost(Xobj,varargin)
         Cstatus = getJobStatus(Xobj,varargin) % Get Job ID and status
+        startLocalScheduler(Xobj) % Start the scheduler of the Stype local
+        Lspool = useSpool(Xobj) % Check if the completion markers are used
         Nslot = getSlotNumber(Xobj,varargin)
         Nslot = getSlotNumberAvailable(Xobj,varargin)
         
@@ -148,6 +164,8 @@ classdef JobManagerInterface
                 Stype = 'GridEngine';
             elseif strcmpi(Xobj.SsubmitJob,'bsub')
                 Stype = 'LSF';
+            elseif strcmpi(Xobj.SsubmitJob,'schedulerx')
+                Stype = 'Local';
             else
                 % this error should never be reached, but is kept in case the user
                 % manually alter the property SsubmitJob of JobManagerInterface
@@ -185,6 +203,20 @@ classdef JobManagerInterface
             
         end
         
+        function Xobj = localscheduler(Xobj)
+            if isempty(Xobj.Sdescription)
+                Xobj.Sdescription='Local scheduler';
+            end
+            % The jobs are executed on this machine by the mex file
+            % schedulerx (see mex/src/Scheduler): no cluster, no network
+            Xobj.SsubmitJob='schedulerx';
+            Xobj.SdeleteJob='schedulerx';
+            Xobj.SqueryJob='schedulerx';
+            Xobj.SqueryGrid='';
+            Xobj.SqueryQueues='';
+            Xobj.SqueryPE='';
+        end
+        
         function Xobj = gridengine_matlab(Xobj)
             Xobj = gridengine(Xobj);
             Xobj = getMCRproperties(Xobj);
@@ -24,6 +24,18 @@ end
 Lavailable=true;
 Sstatus='';
 
+if strcmpi(Xobj.Stype,'local')
+    % the local scheduler runs only on this machine
+    if ~any(strcmpi(ShostName,[Xobj.getHosts {'localhost'}]))
+        Lavailable=false;
+        Sstatus=['The hostname ' ShostName ' is not the local machine'];
+    elseif exist('SqueueName','var') && ~strcmpi(SqueueName,'local')
+        Lavailable=false;
+        Sstatus=['The queue ' SqueueName ' is not available on host ' ShostName];
+    end
+    return
+end
+
 [XdocGrid ~] = Xobj.getXmlObject;
 
 
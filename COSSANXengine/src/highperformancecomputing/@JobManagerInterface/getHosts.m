@@ -104,6 +104,8 @@ elseif strcmpi(Xobj.Stype,'lsf')
             [~,Cnames] = getLSFHostsInfo(Xobj);
         end
     end
+elseif strcmpi(Xobj.Stype,'local')
+    Cnames = {char(java.net.InetAddress.getLocalHost().getHostName())};
 end
 
 end
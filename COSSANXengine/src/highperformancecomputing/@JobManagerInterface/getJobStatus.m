@@ -24,6 +24,38 @@ for iopt=1:2:length(varargin)
     end
 end
 
+%% Completion markers of the spool directory
+% The jobs with a marker are completed, the others are running. The job
+% manager is queried only for the jobs without registered marker and, every
+% NspoolCheck seconds, for the jobs without marker (e.g. jobs killed by the
+% job manager before the end of their script)
+if exist('CjobNumber','var') && Xobj.useSpool
+    [Vstate,Vexit,Vruntime,Vmaxrss,Lcheck]=spoolx('status',Xobj.Sspooldir,...
+        CjobNumber,Xobj.NspoolCheck);
+    Cstatus=cell(length(CjobNumber),2);
+    Cstatus(:,2)=CjobNumber(:);
+    Ldone=Vstate==1;
+    Cstatus(Ldone&Vexit==0,1)={'completed'};
+    Cstatus(Ldone&Vexit~=0,1)=arrayfun(@(n) ['Failed with status ' num2str(n)],...
+        Vexit(Ldone&Vexit~=0),'UniformOutput',false);
+    for n=find(Ldone)'
+        OpenCossan.cossanDisp(sprintf('Job %s: exit status %i, runtime %.1f s, peak memory %.0f kB',...
+            CjobNumber{n},Vexit(n),Vruntime(n),Vmaxrss(n)),3);
+    end
+    if Lcheck
+        Lquery=~Ldone;
+    else
+        Lquery=Vstate==-1;
+        Cstatus(Vstate==0,1)={'running'};
+    end
+    if any(Lquery)
+        Xpoll=Xobj;
+        Xpoll.Sspooldir='';
+        Cstatus(Lquery,:)=Xpoll.getJobStatus('CSjobID',CjobNumber(Lquery));
+    end
+    return
+end
+
 Sresults = '';
 
 if strcmpi(Xobj.Stype,'gridengine')
@@ -191,6 +223,25 @@ elseif strcmpi(Xobj.Stype,'lsf')
         return
     end
     
+elseif strcmpi(Xobj.Stype,'local')
+    % The status is kept in memory by the local scheduler
+    if exist('CjobNumber','var')
+        CjobID=CjobNumber(:);
+        Vid=str2double(CjobID);
+        Vid(isnan(Vid))=0; % jobs not submitted
+        [Cstate,Vexit]=schedulerx('status',Vid);
+    else
+        % Return all pending and running jobs
+        [Cstate,Vexit,Vid]=schedulerx('status');
+        CjobID=arrayfun(@num2str,Vid,'UniformOutput',false);
+    end
+    % Use the states of GridEngine expected by Connector and Mio
+    Lfailed=strcmp(Cstate,'completed') & Vexit~=0;
+    Cstate(Lfailed)=arrayfun(@(n) ['Failed with status ' num2str(n)],...
+        Vexit(Lfailed),'UniformOutput',false);
+    Cstate(strcmp(Cstate,'timeout'))={'Failed with status timeout'};
+    Cstate(strcmp(Cstate,'nostart'))={'Failed to start'};
+    Cstatus=[Cstate CjobID];
 end
 
 return
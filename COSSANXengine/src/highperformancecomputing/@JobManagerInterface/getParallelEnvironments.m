@@ -17,6 +17,9 @@ if strcmpi(Xobj.Stype,'gridengine')
     if isempty(Cmembers{end}) 
         Cmembers(end)=[]; % remove the last empty entry
     end
+elseif strcmpi(Xobj.Stype,'local')
+    % the cores of a job (Nslots) are allocated on this machine
+    Cmembers = {'local'};
 else
     % Parallel environment are automatically enabled by LSF
     warning('openCOSSAN:JobManager:getParallelEnvironments', ...
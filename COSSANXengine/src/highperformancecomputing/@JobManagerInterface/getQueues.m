@@ -59,6 +59,9 @@ elseif strcmpi(Xobj.Stype,'lsf')
         Cnames{iqueue} = strtrim(strrep(Clines{queueline(iqueue)},'QUEUE:',''));
     end
     
+elseif strcmpi(Xobj.Stype,'local')
+    % the local scheduler has a single queue
+    Cnames = {'local'};
 end
 
 return
\ No newline at end of file
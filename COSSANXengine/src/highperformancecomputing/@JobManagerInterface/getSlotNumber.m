@@ -80,6 +80,10 @@ elseif strcmpi(Xobj.Stype,'lsf')
             Nslots = Nslots + str2double(Thosts(selected_host).MAX);
         end
     end
+elseif strcmpi(Xobj.Stype,'local')
+    % cores of the local scheduler
+    Xobj.startLocalScheduler;
+    Nslots = schedulerx('info');
 end
 
 return
@@ -82,6 +82,10 @@ elseif strcmpi(Xobj.Stype,'lsf')
             NslotsUsed = NslotsUsed + str2double(Thosts(selected_host).NJOBS);
         end
     end
+elseif strcmpi(Xobj.Stype,'local')
+    % cores reserved by the running jobs
+    [~,~,NfreeCores] = schedulerx('info');
+    NslotsUsed = Nslots-NfreeCores;
 end
 
 NslotsAvailable=Nslots-NslotsUsed;
@@ -0,0 +1,36 @@
+function startLocalScheduler(Xobj)
+%STARTLOCALSCHEDULER Start the scheduler of the JobManagerInterface of type
+%local with Ncores cores and Nmemory MB (default: the whole machine)
+%
+%   The scheduler is the mex file schedulerx (see mex/src/Scheduler). It is
+%   not restarted if it is already running with the same resources.
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+assert(strcmpi(Xobj.Stype,'local'),'openCOSSAN:JobManagerInterface:startLocalScheduler',...
+    'The JobManagerInterface is not of type local')
+assert(isunix && exist('schedulerx','file')==3,...
+    'openCOSSAN:JobManagerInterface:startLocalScheduler',...
+    'The local scheduler requires the mex file schedulerx (POSIX only, see mex/src/Scheduler)')
+
+schedulerx('start',Xobj.Ncores,Xobj.Nmemory);
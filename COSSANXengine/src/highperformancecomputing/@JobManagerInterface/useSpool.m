@@ -0,0 +1,32 @@
+function Lspool = useSpool(Xobj)
+%USESPOOL Check if the completion of the jobs is tracked with the markers
+%of the spool directory Sspooldir (see mex/src/Spool)
+%
+%   The markers are used when Sspooldir is defined, the mex file spoolx is
+%   available and the jobs are submitted from this machine (no SSH
+%   connection). Otherwise the job manager is polled.
+%
+% Author: Cossan Working Group
+% Institute for Risk and Uncertainty, University of Liverpool, UK
+% email address: openengine@cossan.co.uk
+% Website: http://www.cossan.co.uk
+
+% =====================================================================
+% This file is part of openCOSSAN.  The open general purpose matlab
+% toolbox for numerical analysis, risk and uncertainty quantification.
+%
+% openCOSSAN is free software: you can redistribute it and/or modify
+% it under the terms of the GNU General Public License as published by
+% the Free Software Foundation, either version 3 of the License.
+%
+% openCOSSAN is distributed in the hope that it will be useful,
+% but WITHOUT ANY WARRANTY; without even the implied warranty of
+% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+% GNU General Public License for more details.
+%
+%  You should have received a copy of the GNU General Public License
+%  along with openCOSSAN.  If not, see <http://www.gnu.org/licenses/>.
+% =====================================================================
+
+Lspool = ~isempty(Xobj.Sspooldir) && ~OpenCossan.hasSSHConnection && ...
+    isunix && exist('spoolx','file')==3;
@@ -9,6 +9,7 @@ classdef EvolutionStrategy < Optimizer
         Nrho        = 2             %Number of individuals chosen for recombination, i.e. construction of intermediate parent
         Srecombination = 'discrete' %Recombination strategy to be used. Available options are 'discrete' and 'intermediate'; pass as a string
         Vsigma      = 2             %Standard deviation for performing mutation; Vsigma is the strategy parameter of the continuous design variables
+        LnativeRecombination = false %Recombine the individuals with the native kernel (mex recombx) instead of recombination.m
         Sselection  = '+'           %Scheme chosen for performing the selection steps. Two options are available: '+' implies that the selection is performed  considering both the parents and offspring while ',' implies that the selection is based in the offspring population; pass as a string
     end
     %%   Methods inherited from the superclass
@@ -108,6 +109,8 @@ classdef EvolutionStrategy < Optimizer
                         Xobj.Srecombination=varargin{k+1};
                     case  'vsigma'
                         Xobj.Vsigma=varargin{k+1};
+                    case  'lnativerecombination'
+                        Xobj.LnativeRecombination=varargin{k+1};
                     case  'toleranceobjectivefunction'
                         Xobj.toleranceObjectiveFunction=varargin{k+1};
                     case  'tolerancedesignvariables'
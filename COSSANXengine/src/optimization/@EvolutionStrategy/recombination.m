@@ -8,6 +8,25 @@ Nx=length(Xobj.Vsigma); % Number of design variables
 Moffspring  = zeros(Xobj.Nlambda,size(Mparents,2));
 
 %% Recombination
+if Xobj.LnativeRecombination
+    % Native kernel (see mex/src/SRES/recomb.c): the same Nrho partners are
+    % used for the design variables and for the standard deviations
+    assert(exist('recombx','file')==3,'openCOSSAN:EvolutionStrategy:recombination',...
+        'The mex file recombx is not available. Please run makeSRES')
+    Mchosen_parents=Mparents(1:Xobj.Nmu,1:end-1);
+    switch Xobj.Srecombination
+        case{'discrete'},
+            [Moffspring(:,1:Nx),~,Mpartners] = recombx(Mchosen_parents(:,1:Nx), ...
+                Xobj.Nlambda,'discrete',Xobj.Nrho);
+            Moffspring(:,Nx+1:2*Nx) = recombx(Mchosen_parents(:,Nx+1:2*Nx), ...
+                Xobj.Nlambda,'intermediate',Xobj.Nrho,[],[],[],Mpartners);
+        case{'intermediate'},
+            Moffspring(:,1:end-1) = recombx(Mchosen_parents,Xobj.Nlambda, ...
+                'intermediate',Xobj.Nrho);
+    end
+    return
+end
+
 switch Xobj.Srecombination
     case{'discrete'},
         for i=1:Xobj.Nlambda,
@@ -19,8 +38,8 @@ switch Xobj.Srecombination
             Moffspring(i,Nx+1:2*Nx)   = sum(Mchosen_parents(:,Nx+1:2*Nx),1)/Xobj.Nrho;
         end
     case{'intermediate'},
-        for i=1:Nlambda,
-            Vaux                    = randperm(Nmu)';
+        for i=1:Xobj.Nlambda,
+            Vaux                    = randperm(Xobj.Nmu)';
             Vselect_parents         = Vaux(1:Xobj.Nrho);
             Mchosen_parents         = Mparents(Vselect_parents,1:end-1);
             Moffspring(i,1:end-1) = sum(Mchosen_parents,1)/Xobj.Nrho;
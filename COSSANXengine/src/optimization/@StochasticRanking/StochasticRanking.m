@@ -14,6 +14,7 @@ classdef StochasticRanking < Optimizer
         probWin    = 0.45          %Probability of an individual of winning a rank exchange because of fitness comparison
         Srecombination = 'discrete' %Recombination strategy to be used. Available options are 'discrete' and 'intermediate'; pass as a string
         Vsigma                      %Standard deviation for performing mutation; Vsigma is the strategy parameter of the continuous design variables
+        LnativeEngine = false       %Run the generation loop in the native SRES engine (mex sres_matlab) instead of sres.m
     end
     %%   Methods inherited from the superclass
     methods
@@ -102,6 +103,8 @@ classdef StochasticRanking < Optimizer
                         Xobj.Srecombination=varargin{k+1};
                     case  'vsigma'
                         Xobj.Vsigma=varargin{k+1};
+                    case  'lnativeengine'
+                        Xobj.LnativeEngine=varargin{k+1};
                     case  'toleranceobjectivefunction'
                         Xobj.toleranceObjectiveFunction=varargin{k+1};
                     case  'tolerancedesignvariables'
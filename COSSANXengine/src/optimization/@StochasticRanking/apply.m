@@ -129,7 +129,20 @@ hconstraint=@(x)evaluate(Xop.Xconstraint,'Xoptimizationproblem',Xop,...
 %% Perfom the optimization
 OpenCossan.setLaptime('Sdescription',['SRES:' Xobj.Sdescription]);
 
-[XoptGlobal.VoptimalDesign,Stats,Gm] = Xobj.sres(hobjfun,hconstraint,'min',Mlowerupper,Xobj.Nlambda,Xobj.Nmax,Xobj.Nmu,Xobj.probWin,1);
+if Xobj.LnativeEngine
+    % The generation loop is performed by the native engine. The whole
+    % population is evaluated at once and the termination criteria are
+    % checked at each generation by the output function.
+    assert(exist('sres_matlab','file')==3,'OpenCossan:StochasticRanking:apply',...
+        'The mex file sres_matlab is not available. Please run makeSRES')
+    houtput=@(Tstatus)Xobj.outputFunctionOptimiser([],Tstatus,'iter');
+    [XoptGlobal.VoptimalDesign,Stats,Gm,Tstatus] = sres_matlab(hobjfun,hconstraint,...
+        Mlowerupper,Xop.Nconstraints,Xobj.Nlambda,Xobj.Nmax,Xobj.Nmu,Xobj.probWin,1,houtput);
+    OpenCossan.cossanDisp(['Native SRES: ' num2str(Tstatus.Niterations) ...
+        ' generations, ' num2str(Tstatus.Nevaluations) ' evaluations (' Tstatus.Sexitflag ')'],3)
+else
+    [XoptGlobal.VoptimalDesign,Stats,Gm] = Xobj.sres(hobjfun,hconstraint,'min',Mlowerupper,Xobj.Nlambda,Xobj.Nmax,Xobj.Nmu,Xobj.probWin,1);
+end
 %%
 XoptGlobal.VoptimalScores=Stats(Gm,1);
 